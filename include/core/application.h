@@ -62,12 +62,15 @@ struct App {
         WM_PINREQ,
         WM_QUEUEWINDOW,
         WM_CMDLINE_OPTION,
+        WM_AUTOPIN_SWEEP,
+        WM_CONFIGCHANGED,
         WM_PIN_ASSIGNWND = WM_USER,
         WM_PIN_RESETTIMER,
         WM_PIN_GETPINNEDWND,
         HOTID_ENTERPINMODE = 0,
         HOTID_TOGGLEPIN = 1,
         TIMERID_AUTOPIN = 1,
+        TIMERID_CONFIGRELOAD = 2,
     };
     App() = default;
     ~App() { 
@@ -33,11 +33,18 @@ namespace Constants {
     constexpr int MIN_AUTOPIN_DELAY = 100;   // 毫秒
     constexpr int MAX_AUTOPIN_DELAY = 10000; // 毫秒
     constexpr int DEFAULT_AUTOPIN_DELAY = 200; // 毫秒
+    constexpr int AUTOPIN_TITLE_WATCH_PERIOD = 10000; // 毫秒，新窗口标题变化的跟踪时长
+    constexpr int AUTOPIN_RECHECK_INTERVAL = 250;     // 毫秒，同一窗口两次标题重新检查的最小间隔
     constexpr int TOP_STYLE_CHECK_INTERVAL = 500; // 毫秒，层级检查间隔
     constexpr int FIX_VISIBLE_INTERVAL = 100; // 毫秒，可见性修复间隔
+    constexpr int SETTINGS_SAVE_DELAY = 500;      // 毫秒，设置变化后延迟写入，期间的变化合并为一次写入
+    constexpr int SETTINGS_SAVE_MAX_DELAY = 2000; // 毫秒，连续变化时最多推迟的时间
+    constexpr int CONFIG_RELOAD_DELAY = 300;      // 毫秒，配置文件变化后等待写入完成再重新加载
     
     // UI相关
     constexpr int DEFAULT_LAYER_WND_POS = 100; // 层窗口默认位置
+    constexpr int RULE_PREVIEW_DELAY = 150;    // 毫秒，编辑规则时停止输入后更新匹配预览
+    constexpr int LOCALE_CACHE_SIZE = 3;       // 保留最近使用的语言数，切换回来时不再重新加载
     
     // 控件ID常量
     constexpr int ID_APPLY_BUTTON = 0x3021;    // Apply按钮的ID
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "core/common.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Foundation {
+
+    // 在后台线程中写入文件。
+    // write()只保存要写入的内容并立即返回，延迟期间的多次写入合并为一次，
+    // 只有最后一次的内容被写入磁盘（每次写入都会推迟，但最多推迟maxDelay）。
+    // 文件先写入临时文件并刷新到磁盘，再原子地替换目标文件，
+    // 因此写入中途崩溃不会留下损坏的文件。
+    // append()追加的内容（完整的行）按顺序合并到尚未写入的内容之后，
+    // 没有尚未写入的替换时直接追加到文件末尾；文件末尾不是完整的行时按写入失败处理。
+    // 写入失败时内容被丢弃（尚未写入的追加也一起丢弃），由 takeFailure() 报告给调用方，
+    // 调用方应重新生成完整的内容用 write() 重写。
+    // 每个写入器只用于一个文件。
+    //
+    class AsyncFileWriter : noncopyable {
+    public:
+        AsyncFileWriter(int delay, int maxDelay);
+        ~AsyncFileWriter();   // 写入尚未写入的内容后结束线程
+
+        // 安排写入，替换尚未写入的内容
+        void write(const std::wstring& path, std::string content);
+
+        // 安排追加到文件末尾
+        void append(const std::wstring& path, const std::string& content);
+
+        // 立即写入尚未写入的内容并等待完成，返回最后一次写入是否成功
+        bool flush();
+
+        // 没有尚未写入或正在写入的内容
+        bool idle();
+
+        // 上次调用之后是否有写入失败，并清除失败标志
+        bool takeFailure();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        const std::chrono::milliseconds m_delay;
+        const std::chrono::milliseconds m_maxDelay;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;   // 通知写入线程
+        std::condition_variable m_idle;   // 通知等待flush的线程
+        std::thread m_thread;
+
+        std::wstring m_path;
+        std::string m_content;
+        bool m_pending = false;
+        bool m_replace = false;  // 尚未写入的内容替换整个文件，否则追加
+        bool m_writing = false;
+        bool m_urgent = false;   // 不再等待延迟
+        bool m_stop = false;
+        bool m_lastResult = true;
+        bool m_failed = false;   // 有写入失败，尚未由 takeFailure() 取走
+        Clock::time_point m_first;   // 第一次未写入的write()的时间
+        Clock::time_point m_last;    // 最后一次write()的时间
+
+        void schedule(const std::wstring& path);
+        void run();
+    };
+
+} // namespace Foundation
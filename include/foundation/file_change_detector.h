@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace Foundation {
+
+    // 通过比较修改时间和大小判断一组文件是否发生变化。
+    // 程序自己写入的文件用expect()记录内容，变化后的内容与之相同时不报告。
+    // 只依赖标准库：由FileWatcher的通知触发poll()，也可以定时调用。
+    //
+    class FileChangeDetector {
+    public:
+        // 添加要检测的文件并记录当前状态，返回文件编号
+        size_t add(const std::filesystem::path& path)
+        {
+            m_files.push_back({ path, stamp(path), std::string() });
+            return m_files.size() - 1;
+        }
+
+        const std::filesystem::path& path(size_t id) const { return m_files[id].path; }
+
+        // 记录程序自己写入（或即将写入）的内容，为空时不比较内容
+        void expect(size_t id, std::string content) { m_files[id].expected = std::move(content); }
+
+        // 返回自上次add()或poll()以来发生变化（包括创建和删除）的文件编号
+        std::vector<size_t> poll()
+        {
+            std::vector<size_t> changed;
+            for (size_t id = 0; id < m_files.size(); ++id) {
+                Stamp now = stamp(m_files[id].path);
+                File& file = m_files[id];
+                if (!(now == file.stamp)) {
+                    file.stamp = now;
+                    if (!isExpected(file, now)) {
+                        changed.push_back(id);
+                    }
+                }
+            }
+            return changed;
+        }
+
+    private:
+        struct Stamp {
+            bool exists = false;
+            uintmax_t size = 0;
+            std::filesystem::file_time_type time{};
+
+            bool operator==(const Stamp& other) const
+            {
+                return exists == other.exists && size == other.size && time == other.time;
+            }
+        };
+
+        struct File {
+            std::filesystem::path path;
+            Stamp stamp;
+            std::string expected;   // 程序自己写入的内容
+        };
+
+        std::vector<File> m_files;
+
+        // 大小相同时才读取文件比较内容
+        static bool isExpected(const File& file, const Stamp& now)
+        {
+            if (file.expected.empty() || !now.exists || now.size != file.expected.size())
+                return false;
+            std::ifstream in(file.path, std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            return !in.bad() && content == file.expected;
+        }
+
+        static Stamp stamp(const std::filesystem::path& path)
+        {
+            Stamp s;
+            std::error_code ec;
+            s.time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return Stamp();
+            s.size = std::filesystem::file_size(path, ec);
+            s.exists = !ec;
+            return s;
+        }
+    };
+
+} // namespace Foundation
@@ -10,6 +10,11 @@ namespace FileUtils {
     // 文件系统操作
     std::vector<std::wstring> getFiles(std::wstring mask);
     bool readFileBack(HANDLE file, void* buf, int bytes);
+    // 写入临时文件并刷新到磁盘后替换目标文件，失败时目标文件保持不变
+    bool writeFileAtomic(const std::wstring& path, const void* data, size_t size);
+    // 按行追加到文件末尾并刷新到磁盘，文件不存在时创建。
+    // 文件末尾不是完整的一行（上次追加被中断）时不追加并返回false
+    bool appendLines(const std::wstring& path, const void* data, size_t size);
     
     // 模块路径获取
     std::wstring getModulePath(HINSTANCE hInstance);
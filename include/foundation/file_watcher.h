@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace Foundation {
+
+    // 目录变化通知的接口。
+    // 实现在后台线程中等待目录中文件的变化，有变化时在该线程中调用回调。
+    // 通知不区分文件：接收方用ChangeDebouncer合并连续的通知，
+    // 再用FileChangeDetector判断哪些文件真正变化。
+    // Windows上的实现是Platform::DirectoryWatcher。
+    //
+    class FileWatcher {
+    public:
+        typedef std::function<void()> Callback;
+
+        virtual ~FileWatcher() {}
+        virtual bool start(const std::wstring& dir, Callback onChange) = 0;
+        virtual void stop() = 0;
+    };
+
+
+    // 合并连续的变化通知。
+    // 文件往往分几次写入，每次通知都把到期时间推迟到delay之后，
+    // 最后一次通知之后安静delay才到期。时间由调用方传入，只依赖标准库。
+    //
+    class ChangeDebouncer {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        explicit ChangeDebouncer(std::chrono::milliseconds delay) : m_delay(delay) {}
+
+        // 收到通知，返回之前是否没有等待中的通知（调用方此时需要启动定时器）
+        bool notify(Clock::time_point now)
+        {
+            bool first = !m_pending;
+            m_pending = true;
+            m_due = now + m_delay;
+            return first;
+        }
+
+        bool pending() const { return m_pending; }
+
+        // 到期时返回true并清除等待状态
+        bool take(Clock::time_point now)
+        {
+            if (!m_pending || now < m_due)
+                return false;
+            m_pending = false;
+            return true;
+        }
+
+        // 距离到期的时间（向上取整），用于重新设置定时器
+        std::chrono::milliseconds remaining(Clock::time_point now) const
+        {
+            if (!m_pending || now >= m_due)
+                return std::chrono::milliseconds(0);
+            return std::chrono::ceil<std::chrono::milliseconds>(m_due - now);
+        }
+
+    private:
+        std::chrono::milliseconds m_delay;
+        Clock::time_point m_due{};
+        bool m_pending = false;
+    };
+
+} // namespace Foundation
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Foundation {
+
+    // 一次解析的UTF-8 INI文档。
+    // 文件只读取和转换一次，节名、键名和值都是指向同一个UTF-16缓冲区的视图，
+    // 节按名称建立索引，因此每次查找与文件大小无关。
+    //
+    // 语法与 Options 写出的格式一致：
+    //   [节名]
+    //   ; 注释（也支持 #）
+    //   键=值
+    // 键名两侧的空白被忽略，值保持原样（只去掉行尾的回车符）。
+    // 重复的节合并为一个，重复的键以第一个为准。
+    //
+    class IniDocument {
+    public:
+        IniDocument() = default;
+        // 视图指向内部缓冲区，不能复制
+        IniDocument(const IniDocument&) = delete;
+        IniDocument& operator=(const IniDocument&) = delete;
+
+        // 读取并解析文件。文件不存在或无法读取时返回false，文档为空。
+        // 只有读取文件依赖平台代码，解析和查找都在头文件中，可以单独编译测试。
+        bool load(const std::wstring& path);
+
+        // 解析已经转换为UTF-16的文本
+        void parse(std::wstring text);
+
+        bool empty() const { return m_sections.empty(); }
+        const std::wstring& text() const { return m_text; }   // 解析前的完整文本
+        bool hasSection(std::wstring_view section) const;
+
+        // 查找值，不存在时返回false
+        bool find(std::wstring_view section, std::wstring_view key, std::wstring_view& value) const;
+
+        std::wstring get(std::wstring_view section, std::wstring_view key,
+            const std::wstring& defaultValue = std::wstring()) const;
+
+        // 整数值，不存在或为空时返回默认值
+        int getInt(std::wstring_view section, std::wstring_view key, int defaultValue) const;
+
+    private:
+        struct Section {
+            std::vector<std::pair<std::wstring_view, std::wstring_view>> values;
+        };
+
+        std::wstring m_text;     // 整个文件的内容，所有视图都指向这里
+        std::vector<Section> m_sections;
+        std::unordered_map<std::wstring_view, size_t> m_index;  // 节名 -> m_sections中的位置
+
+        const Section* findSection(std::wstring_view section) const;
+    };
+
+    namespace Detail {
+        inline std::wstring_view trimIni(std::wstring_view s)
+        {
+            size_t first = s.find_first_not_of(L" \t");
+            if (first == std::wstring_view::npos)
+                return std::wstring_view();
+            size_t last = s.find_last_not_of(L" \t");
+            return s.substr(first, last - first + 1);
+        }
+    }
+
+    inline void IniDocument::parse(std::wstring text)
+    {
+        m_text = std::move(text);
+        m_sections.clear();
+        m_index.clear();
+
+        std::wstring_view rest(m_text);
+        // 跳过UTF-8 BOM转换后的字节顺序标记
+        if (!rest.empty() && rest.front() == 0xFEFF)
+            rest.remove_prefix(1);
+
+        Section* current = nullptr;
+        while (!rest.empty()) {
+            size_t eol = rest.find(L'\n');
+            std::wstring_view line = rest.substr(0, eol);
+            rest.remove_prefix(eol == std::wstring_view::npos ? rest.size() : eol + 1);
+            if (!line.empty() && line.back() == L'\r')
+                line.remove_suffix(1);
+
+            std::wstring_view content = Detail::trimIni(line);
+            if (content.empty() || content.front() == L';' || content.front() == L'#')
+                continue;
+
+            if (content.front() == L'[') {
+                size_t close = content.find(L']');
+                if (close == std::wstring_view::npos) {
+                    current = nullptr;
+                    continue;
+                }
+                std::wstring_view name = content.substr(1, close - 1);
+                auto it = m_index.find(name);
+                if (it == m_index.end()) {
+                    it = m_index.emplace(name, m_sections.size()).first;
+                    m_sections.emplace_back();
+                }
+                current = &m_sections[it->second];
+                continue;
+            }
+
+            // 节之前的键值和没有等号的行被忽略
+            size_t eq = line.find(L'=');
+            if (!current || eq == std::wstring_view::npos)
+                continue;
+
+            std::wstring_view key = Detail::trimIni(line.substr(0, eq));
+            std::wstring_view value = line.substr(eq + 1);
+            bool duplicate = false;
+            for (const auto& entry : current->values) {
+                if (entry.first == key) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (!duplicate)
+                current->values.emplace_back(key, value);
+        }
+    }
+
+    inline const IniDocument::Section* IniDocument::findSection(std::wstring_view section) const
+    {
+        auto it = m_index.find(section);
+        return it == m_index.end() ? nullptr : &m_sections[it->second];
+    }
+
+    inline bool IniDocument::hasSection(std::wstring_view section) const
+    {
+        return findSection(section) != nullptr;
+    }
+
+    inline bool IniDocument::find(std::wstring_view section, std::wstring_view key, std::wstring_view& value) const
+    {
+        // 每节只有少量键，线性查找比再建一层索引更快
+        const Section* sec = findSection(section);
+        if (!sec)
+            return false;
+        for (const auto& entry : sec->values) {
+            if (entry.first == key) {
+                value = entry.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::wstring IniDocument::get(std::wstring_view section, std::wstring_view key,
+        const std::wstring& defaultValue) const
+    {
+        std::wstring_view value;
+        return find(section, key, value) ? std::wstring(value) : defaultValue;
+    }
+
+    inline int IniDocument::getInt(std::wstring_view section, std::wstring_view key, int defaultValue) const
+    {
+        std::wstring_view value;
+        if (!find(section, key, value) || value.empty())
+            return defaultValue;
+        return static_cast<int>(std::wcstol(std::wstring(value).c_str(), nullptr, 10));
+    }
+
+} // namespace Foundation
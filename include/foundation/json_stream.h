@@ -0,0 +1,538 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Foundation {
+namespace Json {
+
+    // UTF-8 与宽字符串互转。wchar_t 为16位时按UTF-16处理代理对。
+    // 无效的UTF-8字节序列被替换为 U+FFFD。
+    //
+    inline void appendUtf8(std::string& out, uint32_t cp)
+    {
+        if (cp < 0x80) {
+            out += char(cp);
+        }
+        else if (cp < 0x800) {
+            out += char(0xC0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            out += char(0xE0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else {
+            out += char(0xF0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3F));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    inline std::string toUtf8(std::wstring_view s)
+    {
+        std::string out;
+        out.reserve(s.size());
+        for (size_t i = 0; i < s.size(); ++i) {
+            uint32_t cp = uint32_t(s[i]);
+            if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF && i + 1 < s.size()) {
+                uint32_t lo = uint32_t(s[i + 1]);
+                if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    ++i;
+                }
+            }
+            appendUtf8(out, cp);
+        }
+        return out;
+    }
+
+    inline std::wstring toWide(std::string_view s)
+    {
+        std::wstring out;
+        out.reserve(s.size());
+        for (size_t i = 0; i < s.size(); ) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            uint32_t cp;
+            size_t len;
+            if (c < 0x80)      { cp = c;        len = 1; }
+            else if (c < 0xC2) { cp = 0xFFFD;   len = 0; }
+            else if (c < 0xE0) { cp = c & 0x1F; len = 2; }
+            else if (c < 0xF0) { cp = c & 0x0F; len = 3; }
+            else if (c < 0xF5) { cp = c & 0x07; len = 4; }
+            else               { cp = 0xFFFD;   len = 0; }
+
+            if (len == 0 || i + len > s.size()) {
+                out += wchar_t(0xFFFD);
+                ++i;
+                continue;
+            }
+            bool valid = true;
+            for (size_t k = 1; k < len; ++k) {
+                unsigned char cc = static_cast<unsigned char>(s[i + k]);
+                if ((cc & 0xC0) != 0x80) {
+                    valid = false;
+                    break;
+                }
+                cp = (cp << 6) | (cc & 0x3F);
+            }
+            if (!valid) {
+                out += wchar_t(0xFFFD);
+                ++i;
+                continue;
+            }
+            i += len;
+
+            if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+                cp -= 0x10000;
+                out += wchar_t(0xD800 + (cp >> 10));
+                out += wchar_t(0xDC00 + (cp & 0x3FF));
+            }
+            else {
+                out += wchar_t(cp);
+            }
+        }
+        return out;
+    }
+
+    enum class Token {
+        BeginObject, EndObject,
+        BeginArray, EndArray,
+        Key,        // 对象的键，text()为键名
+        String,     // text()为解码后的UTF-8字符串
+        Number,     // text()为数字的原始写法
+        True, False, Null,
+        End,        // 文档结束
+        Error,      // 语法错误，见 error() 和 offset()
+    };
+
+    // 流式（拉取式）JSON读取器。
+    // 每次 next() 返回一个记号，只保存当前记号的文本和嵌套栈，
+    // 输入按块读取，内存占用与文档大小无关，适合逐条处理很大的数组。
+    // 出错后一直返回 Token::Error。
+    //
+    class Reader {
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+        static constexpr size_t MAX_DEPTH = 256;
+
+        explicit Reader(std::istream& in, size_t bufferSize = DEFAULT_BUFFER_SIZE)
+            : m_in(&in), m_buf(bufferSize ? bufferSize : DEFAULT_BUFFER_SIZE) {}
+
+        // 读取内存中的文档，不复制数据
+        Reader(const char* data, size_t size)
+            : m_base(data), m_pos(data), m_end(data + size) {}
+
+        Token next()
+        {
+            if (m_token == Token::Error || m_token == Token::End)
+                return m_token;
+
+            m_text.clear();
+            if (offset() == 0 && !skipBom())
+                return fail("invalid byte order mark");
+            for (;;) {
+                int c = skipSpace();
+                switch (m_expect) {
+                case Expect::Done:
+                    if (c < 0)
+                        return m_token = Token::End;
+                    return fail("unexpected data after document");
+
+                case Expect::Colon:
+                    if (c != ':')
+                        return fail("expected ':'");
+                    ++m_pos;
+                    m_expect = Expect::Value;
+                    continue;
+
+                case Expect::CommaOrEnd:
+                    if (c == ',') {
+                        ++m_pos;
+                        m_expect = m_stack.back() == '{' ? Expect::Key : Expect::Value;
+                        continue;
+                    }
+                    if (c == '}' || c == ']')
+                        return close(c);
+                    return fail(c < 0 ? "unexpected end of document" : "expected ',' or closing bracket");
+
+                case Expect::KeyOrEnd:
+                    if (c == '}')
+                        return close(c);
+                    [[fallthrough]];
+                case Expect::Key:
+                    if (c != '"')
+                        return fail(c < 0 ? "unexpected end of document" : "expected object key");
+                    ++m_pos;
+                    if (!readString())
+                        return m_token;
+                    m_expect = Expect::Colon;
+                    return m_token = Token::Key;
+
+                case Expect::ValueOrEnd:
+                    if (c == ']')
+                        return close(c);
+                    [[fallthrough]];
+                case Expect::Value:
+                    return readValue(c);
+                }
+            }
+        }
+
+        Token token() const { return m_token; }
+        const std::string& text() const { return m_text; }
+        std::wstring wtext() const { return toWide(m_text); }
+        bool boolean() const { return m_token == Token::True; }
+
+        // 数字记号的整数值，不是整数时返回默认值
+        int64_t integer(int64_t defaultValue = 0) const
+        {
+            if (m_token != Token::Number)
+                return defaultValue;
+            char* end = nullptr;
+            long long n = std::strtoll(m_text.c_str(), &end, 10);
+            return *end ? defaultValue : int64_t(n);
+        }
+
+        size_t depth() const { return m_stack.size(); }
+
+        // 跳过当前值：当前记号是 BeginObject/BeginArray 时读到对应的结束记号，
+        // 其它记号不需要处理。出错时返回false。
+        bool skip()
+        {
+            if (m_token != Token::BeginObject && m_token != Token::BeginArray)
+                return m_token != Token::Error;
+            size_t target = m_stack.size() - 1;
+            while (next() != Token::Error) {
+                if (m_stack.size() == target)
+                    return true;
+            }
+            return false;
+        }
+
+        const std::string& error() const { return m_error; }
+        uint64_t offset() const { return m_consumed + (m_pos - m_base); }   // 当前读取位置（字节）
+
+    private:
+        enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Done };
+
+        std::istream* m_in = nullptr;
+        std::vector<char> m_buf;
+        const char* m_base = nullptr;   // 当前块的起始位置，用于计算偏移
+        const char* m_pos = nullptr;
+        const char* m_end = nullptr;
+        uint64_t m_consumed = 0;        // 之前各块的字节数
+
+        std::vector<char> m_stack;      // '{' 或 '['
+        Expect m_expect = Expect::Value;
+        Token m_token = Token::Null;
+        std::string m_text;
+        std::string m_error;
+
+        // 当前块读完时读取下一块，没有更多数据时返回false
+        bool fill()
+        {
+            if (m_pos < m_end)
+                return true;
+            if (!m_in)
+                return false;
+            if (m_base)
+                m_consumed += m_end - m_base;
+            m_in->read(m_buf.data(), std::streamsize(m_buf.size()));
+            size_t n = size_t(m_in->gcount());
+            m_base = m_pos = m_buf.data();
+            m_end = m_pos + n;
+            return n > 0;
+        }
+
+        int peek() { return fill() ? static_cast<unsigned char>(*m_pos) : -1; }
+        int get()  { return fill() ? static_cast<unsigned char>(*m_pos++) : -1; }
+
+        // 跳过文档开头的UTF-8 BOM
+        bool skipBom()
+        {
+            if (peek() != 0xEF)
+                return true;
+            return get() == 0xEF && get() == 0xBB && get() == 0xBF;
+        }
+
+        int skipSpace()
+        {
+            for (;;) {
+                int c = peek();
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                    return c;
+                ++m_pos;
+            }
+        }
+
+        Token fail(const char* msg)
+        {
+            m_error = msg;
+            m_text.clear();
+            return m_token = Token::Error;
+        }
+
+        void afterValue()
+        {
+            m_expect = m_stack.empty() ? Expect::Done : Expect::CommaOrEnd;
+        }
+
+        Token close(int c)
+        {
+            char open = c == '}' ? '{' : '[';
+            if (m_stack.empty() || m_stack.back() != open)
+                return fail("mismatched closing bracket");
+            ++m_pos;
+            m_stack.pop_back();
+            afterValue();
+            return m_token = c == '}' ? Token::EndObject : Token::EndArray;
+        }
+
+        Token open(char c)
+        {
+            if (m_stack.size() >= MAX_DEPTH)
+                return fail("nesting too deep");
+            ++m_pos;
+            m_stack.push_back(c);
+            m_expect = c == '{' ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+            return m_token = c == '{' ? Token::BeginObject : Token::BeginArray;
+        }
+
+        Token readValue(int c)
+        {
+            switch (c) {
+            case '{': return open('{');
+            case '[': return open('[');
+            case '"':
+                ++m_pos;
+                if (!readString())
+                    return m_token;
+                afterValue();
+                return m_token = Token::String;
+            case 't': return readLiteral("true", Token::True);
+            case 'f': return readLiteral("false", Token::False);
+            case 'n': return readLiteral("null", Token::Null);
+            case -1:  return fail("unexpected end of document");
+            default:
+                if (c == '-' || (c >= '0' && c <= '9'))
+                    return readNumber();
+                return fail("unexpected character");
+            }
+        }
+
+        Token readLiteral(const char* word, Token token)
+        {
+            for (const char* p = word; *p; ++p) {
+                if (get() != *p)
+                    return fail("invalid literal");
+            }
+            afterValue();
+            return m_token = token;
+        }
+
+        Token readNumber()
+        {
+            for (;;) {
+                int c = peek();
+                if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+                    break;
+                m_text += char(c);
+                ++m_pos;
+            }
+            char* end = nullptr;
+            std::strtod(m_text.c_str(), &end);
+            if (*end || m_text == "-")
+                return fail("invalid number");
+            afterValue();
+            return m_token = Token::Number;
+        }
+
+        int readHex4()
+        {
+            int v = 0;
+            for (int i = 0; i < 4; ++i) {
+                int c = get();
+                if (c >= '0' && c <= '9')      v = v * 16 + (c - '0');
+                else if (c >= 'a' && c <= 'f') v = v * 16 + (c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') v = v * 16 + (c - 'A' + 10);
+                else return -1;
+            }
+            return v;
+        }
+
+        // 读取开头引号之后的字符串到 m_text
+        bool readString()
+        {
+            for (;;) {
+                if (!fill()) {
+                    fail("unterminated string");
+                    return false;
+                }
+                // 批量复制不需要转义的部分
+                const char* p = m_pos;
+                while (p < m_end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+                    ++p;
+                m_text.append(m_pos, p);
+                m_pos = p;
+                if (p == m_end)
+                    continue;
+
+                char c = *m_pos++;
+                if (c == '"')
+                    return true;
+                if (c != '\\') {
+                    fail("control character in string");
+                    return false;
+                }
+
+                switch (get()) {
+                case '"':  m_text += '"';  break;
+                case '\\': m_text += '\\'; break;
+                case '/':  m_text += '/';  break;
+                case 'b':  m_text += '\b'; break;
+                case 'f':  m_text += '\f'; break;
+                case 'n':  m_text += '\n'; break;
+                case 'r':  m_text += '\r'; break;
+                case 't':  m_text += '\t'; break;
+                case 'u': {
+                    int cp = readHex4();
+                    if (cp < 0) {
+                        fail("invalid \\u escape");
+                        return false;
+                    }
+                    // 代理对：高位后面必须紧跟低位
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        int lo = -1;
+                        if (get() == '\\' && get() == 'u')
+                            lo = readHex4();
+                        if (lo < 0xDC00 || lo > 0xDFFF) {
+                            fail("invalid surrogate pair");
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+                    else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        cp = 0xFFFD;
+                    }
+                    appendUtf8(m_text, uint32_t(cp));
+                    break;
+                }
+                default:
+                    fail("invalid escape sequence");
+                    return false;
+                }
+            }
+        }
+    };
+
+    // 流式JSON写入器，直接写到输出流，不在内存中构建文档。
+    // 调用顺序由调用方保证（对象中先 key() 再写值）。
+    //
+    class Writer {
+    public:
+        explicit Writer(std::ostream& out, bool pretty = true)
+            : m_out(out), m_pretty(pretty) {}
+
+        void beginObject() { beginValue(); m_out.put('{'); m_levels.push_back(0); }
+        void endObject()   { endContainer('}'); }
+        void beginArray()  { beginValue(); m_out.put('['); m_levels.push_back(0); }
+        void endArray()    { endContainer(']'); }
+
+        void key(std::string_view name)
+        {
+            beginValue();
+            writeString(name);
+            m_out.write(m_pretty ? ": " : ":", m_pretty ? 2 : 1);
+            m_afterKey = true;
+        }
+
+        void value(std::string_view s)  { beginValue(); writeString(s); }
+        void value(const char* s)       { value(std::string_view(s)); }
+        void value(std::wstring_view s) { value(std::string_view(toUtf8(s))); }
+        void value(const wchar_t* s)    { value(std::wstring_view(s)); }
+        void value(bool b)              { beginValue(); m_out << (b ? "true" : "false"); }
+        void value(int n)               { beginValue(); m_out << n; }
+        void value(int64_t n)           { beginValue(); m_out << n; }
+        void null()                     { beginValue(); m_out << "null"; }
+
+        bool good() const { return m_out.good(); }
+
+    private:
+        std::ostream& m_out;
+        bool m_pretty;
+        bool m_afterKey = false;
+        std::vector<size_t> m_levels;   // 每层已写入的元素数
+
+        void newline()
+        {
+            if (!m_pretty)
+                return;
+            m_out.put('\n');
+            for (size_t i = 0; i < m_levels.size(); ++i)
+                m_out.write("  ", 2);
+        }
+
+        // 写值或键之前的分隔符
+        void beginValue()
+        {
+            if (m_afterKey) {
+                m_afterKey = false;
+                return;
+            }
+            if (m_levels.empty())
+                return;
+            if (m_levels.back()++ > 0)
+                m_out.put(',');
+            newline();
+        }
+
+        void endContainer(char c)
+        {
+            size_t count = m_levels.back();
+            m_levels.pop_back();
+            if (count > 0)
+                newline();
+            m_out.put(c);
+            if (m_levels.empty() && m_pretty)
+                m_out.put('\n');
+        }
+
+        void writeString(std::string_view s)
+        {
+            static const char hex[] = "0123456789abcdef";
+            m_out.put('"');
+            size_t start = 0;
+            for (size_t i = 0; i < s.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(s[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+                m_out.write(s.data() + start, std::streamsize(i - start));
+                start = i + 1;
+                switch (c) {
+                case '"':  m_out.write("\\\"", 2); break;
+                case '\\': m_out.write("\\\\", 2); break;
+                case '\n': m_out.write("\\n", 2);  break;
+                case '\r': m_out.write("\\r", 2);  break;
+                case '\t': m_out.write("\\t", 2);  break;
+                default: {
+                    char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                    m_out.write(esc, 6);
+                    break;
+                }
+                }
+            }
+            m_out.write(s.data() + start, std::streamsize(s.size() - start));
+            m_out.put('"');
+        }
+    };
+
+} // namespace Json
+} // namespace Foundation
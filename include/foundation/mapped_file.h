@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/common.h"
+#include <string>
+#include <utility>
+
+namespace Foundation {
+
+    // 文件内存映射。
+    // open() 只读映射已有的文件：映射期间文件可以被其他进程读取、重命名或删除（FILE_SHARE_DELETE），
+    // 映射的内容保持不变直到 close()。空文件不能映射。
+    // create() 新建文件并预先分配指定大小后可写映射，写入的内容由系统在后台写回磁盘，
+    // close(length) 时把文件截断为实际写入的长度。
+    //
+    class MappedFile : noncopyable {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        bool open(const std::wstring& path);
+
+        // 新建文件（已存在时失败，GetLastError() 为 ERROR_FILE_EXISTS）并可写映射 size 字节
+        bool create(const std::wstring& path, size_t size);
+
+        // 把可写映射的前 length 字节写回磁盘，返回后数据已经落盘
+        bool flush(size_t length);
+
+        // 关闭映射；可写映射的文件截断为 length 字节
+        void close(size_t length);
+        void close() { close(m_size); }
+
+        const void* data() const { return m_view; }
+        void* data() { return m_view; }
+        size_t size() const { return m_size; }
+        bool isOpen() const { return m_view != nullptr; }
+
+        void swap(MappedFile& other)
+        {
+            std::swap(m_view, other.m_view);
+            std::swap(m_size, other.m_size);
+            std::swap(m_file, other.m_file);
+        }
+
+    private:
+        void* m_view = nullptr;
+        size_t m_size = 0;
+        void* m_file = nullptr;     // 只有可写映射保留文件句柄，用于写回和截断
+    };
+
+} // namespace Foundation
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "core/common.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Foundation {
+
+    // 有界的多生产者、单消费者环形队列，不使用锁。
+    // 每个槽有一个序号：生产者用CAS占用写入位置，写入元素后发布序号；
+    // 消费者只在序号表明元素已写入时取出，并把槽的序号推进一圈表示可以再次写入。
+    // 生产者之间只在写入位置上竞争，不会等待其他生产者写完元素；队列满时 tryPush 返回false。
+    // 只依赖标准库。
+    //
+    template <typename T>
+    class MpscRing : noncopyable {
+    public:
+        // capacity 必须是2的幂
+        explicit MpscRing(size_t capacity)
+            : m_cells(new Cell[capacity]), m_mask(capacity - 1)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        size_t capacity() const { return m_mask + 1; }
+
+        // 任意线程调用。成功时 value 被移入队列
+        bool tryPush(T&& value)
+        {
+            return tryEmplace([&value](T& slot) { slot = std::move(value); });
+        }
+
+        // 任意线程调用。占用写入位置后调用 fill(T&) 直接在槽中写入元素，然后发布，
+        // 元素较大时省去一次复制。fill 应当很短：消费者在它返回之前不会取出后面的元素
+        template <typename Fill>
+        bool tryEmplace(Fill&& fill)
+        {
+            size_t pos = m_tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[pos & m_mask];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                intptr_t diff = intptr_t(seq) - intptr_t(pos);
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        fill(cell.value);
+                        cell.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;   // 消费者还没有取出上一圈的元素
+                }
+                else {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // 只能由消费者线程调用。下一个元素尚未写完时返回false
+        bool tryPop(T& value)
+        {
+            return tryConsume([&value](T& item) { value = std::move(item); });
+        }
+
+        // 只能由消费者线程调用。在槽中调用 use(T&) 处理下一个元素，之后槽可以再次写入。
+        // 下一个元素尚未写完时返回false
+        template <typename Use>
+        bool tryConsume(Use&& use)
+        {
+            Cell& cell = m_cells[m_head & m_mask];
+            if (cell.seq.load(std::memory_order_acquire) != m_head + 1)
+                return false;
+            use(cell.value);
+            cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+            m_popped.store(++m_head, std::memory_order_relaxed);
+            return true;
+        }
+
+        // 已占用的写入位置总数（包括尚未写完的），用于等待队列排空
+        uint64_t pushed() const { return m_tail.load(std::memory_order_acquire); }
+
+        // 近似的元素数，可在任意线程调用
+        size_t approxSize() const
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            size_t head = m_popped.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> seq;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        const size_t m_mask;
+        alignas(64) std::atomic<size_t> m_tail{ 0 };    // 生产者共享
+        alignas(64) size_t m_head = 0;                  // 只有消费者访问
+        std::atomic<size_t> m_popped{ 0 };              // m_head 的副本，供其他线程读取
+    };
+
+} // namespace Foundation
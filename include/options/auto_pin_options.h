@@ -18,4 +18,8 @@ protected:
     static bool evInitDialog(HWND wnd, HWND focus, LPARAM param);
 
     static bool cmAutoPinOn(HWND wnd);
+    static bool cmImport(HWND wnd);
+    static bool cmExport(HWND wnd);
+    static bool exportRules(HWND wnd);
+    static bool exportStats(HWND wnd);
 };
\ No newline at end of file
@@ -10,14 +10,15 @@ class OptHotKeys
 public:
     static BOOL CALLBACK dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lparam);
 
-protected:
-    static bool validate(HWND wnd);
-    static void apply(HWND wnd);
-
+    // 根据新旧状态注册或注销热键（配置文件热重载时也使用）
     static bool changeHotkey(HWND wnd, 
         const HotKey& newHotkey, bool newState, 
         const HotKey& oldHotkey, bool oldState);
 
+protected:
+    static bool validate(HWND wnd);
+    static void apply(HWND wnd);
+
     static bool evInitDialog(HWND wnd, HWND focus, LPARAM param);
 
     static bool cmHotkeysOn(HWND wnd);
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "foundation/error_handler.h"
+#include "options/options_delta.h"
+#include "pin/auto_pin_rules.h"
 #include "resource.h"
 #include "system/language_manager.h"
 
 struct HotKey;
+namespace Foundation { class IniDocument; class AsyncFileWriter; }
+namespace RuleFile { struct Record; }
 
 
 // Hotkey item.
@@ -62,14 +66,19 @@ struct AutoPinRule {
     std::wstring descr;
     std::wstring ttl;
     std::wstring cls;
+    std::wstring proc;             // 进程匹配模式，为空表示不限制进程
+    Pin::ProcessField procField;   // 进程匹配的属性
     bool enabled;
+    std::shared_ptr<Pin::RuleStats> stats;  // 匹配统计，规则的副本共享同一份
 
     AutoPinRule(const std::wstring& d = L"New Rule", 
         const std::wstring& t = L"", 
         const std::wstring& c = L"", 
-        bool b = true) : descr(d), ttl(t), cls(c), enabled(b) {}
-
-    bool match(HWND wnd) const;
+        bool b = true,
+        const std::wstring& p = L"",
+        Pin::ProcessField f = Pin::ProcessField::ImageName)
+        : descr(d), ttl(t), cls(c), proc(p), procField(f), enabled(b),
+          stats(std::make_shared<Pin::RuleStats>()) {}
 
     bool load(HKEY key, int i);
     bool save(HKEY key, int i) const;
@@ -195,6 +204,18 @@ typedef ScalarOption<int>        IntOption;
 typedef std::vector<AutoPinRule> AutoPinRules;
 
 
+// 配置文件热重载时设置的变化（比较在 options/options_delta.h 中）。
+// 只记录运行时需要重新应用的部分，调用方据此只更新受影响的状态。
+//
+struct OptionsDelta : OptionsReload::Changes {
+    // 变化之前的状态（由Options::reload()填入），用于只重新注册变化的热键和切换自动图钉
+    bool   oldHotkeysOn = false;
+    HotKey oldEnterPin{0};
+    HotKey oldTogglePin{0};
+    bool   oldAutoPinOn = false;
+};
+
+
 // Program options.
 // Provides default values and manages persistence.
 //
@@ -212,33 +233,59 @@ public:
     // autopin
     bool          autoPinOn;
     AutoPinRules  autoPinRules;
+    unsigned      autoPinRulesGen;   // 规则列表的版本号，规则变化时递增
     IntOption     autoPinDelay;
+    std::vector<std::wstring> autoPinProcesses;  // 进程映像名白名单，为空表示所有进程
+    bool          autoPinSweep;      // 启动时对已打开的窗口应用自动图钉规则
+    // debug
+    bool          recordEvents;      // 录制自动图钉和图钉跟踪事件，供回放工具使用
+    bool          binaryLog;         // 结构化日志写入二进制文件（重新启动后生效）
+    bool          ruleProfiling;     // 统计每条规则的评估次数和匹配耗时（规则分析器）
     // lang
     std::wstring  language;   // language code like "zh_CN", "en_US", empty means auto-detect
 
     Options();
     ~Options();
 
+    // 保存设置并等待写入完成（程序退出时使用）
     bool save() const;
     bool load();
     
-    // 立即保存设置到INI文件（用于设置更改时立即保存）
+    // 设置更改时保存到INI文件。文件在后台线程中写入，短时间内的多次更改合并为一次写入
     bool saveImmediately() const;
+
+    // 配置文件被外部修改后重新加载，只替换变化的设置和规则，变化记录在delta中。
+    // 与上次写入的内容相同的文件（程序自己的写入）被忽略。
+    // 仍有尚未写入的设置时返回false，调用方应稍后重试。
+    bool reload(bool iniChanged, bool rulesChanged, OptionsDelta& delta);
+
+    // 程序最后写入的INI文件和规则文件内容（UTF-8），不确定时为空。
+    // 用于在调用reload()之前排除程序自己的写入（见Foundation::FileChangeDetector::expect()）
+    std::string savedIniContent() const { return savedIniText(); }
+    std::string savedRulesContent() const;
+
+    // 规则列表发生变化后调用，使依赖规则的缓存（如编译后的规则集）失效
+    void autoPinRulesChanged() { ++autoPinRulesGen; }
+
+    // 根据自动图钉设置生成窗口创建监视器的过滤条件
+    WindowCreationFilter autoPinFilter() const;
     
     // INI file methods
     std::wstring getIniFilePath() const;
-    void loadLanguageFromIni();
+    std::wstring getRulesFilePath() const;   // 自动图钉规则文件，与INI文件在同一目录
     
-    // UTF-8兼容的INI文件操作方法
+    // UTF-8兼容的INI文件操作方法（文件只解析一次，各部分从同一个文档读取）
     bool loadSettingsFromIni();
-    bool loadHotKeyFromIni(HotKey& hotkey, LPCWSTR keyName);
-    bool loadAutoPinRulesFromIni();
+    void readSettingsFromIni(const Foundation::IniDocument& ini);   // 规则以外的设置
+    static void readAutoPinRulesFromIni(const Foundation::IniDocument& ini, AutoPinRules& rules);   // 旧格式，用于迁移
+    size_t mergeIniRules(const Foundation::IniDocument& ini);
     
-    // 格式化INI文件写入方法（UTF-8兼容）
-    bool saveFormattedSettingsToIni() const;
+    // 规则文件（见options/rule_file.h）
+    bool loadAutoPinRulesFromFile();
+    bool saveAutoPinRules() const;
     
-    // UTF-8兼容的INI读取辅助函数
-    std::wstring readUtf8IniValue(const std::wstring& iniPath, const std::wstring& section, const std::wstring& key, const std::wstring& defaultValue) const;
+    // 格式化INI文件写入方法（UTF-8兼容）。只有内容变化时才安排写入
+    bool saveFormattedSettingsToIni() const;
 
 protected:
     // constants
@@ -261,6 +308,43 @@ protected:
 
     // utilities
     bool REGOK(DWORD err) { return err == ERROR_SUCCESS; }
+
+    // INI文件的各个部分，分别记录上次写入的内容以判断是否需要重写
+    enum IniSection {
+        INI_SETTINGS,
+        INI_PINS,
+        INI_HOTKEYS,
+        INI_AUTOPIN,
+        INI_DEBUG,
+        INI_SECTION_COUNT
+    };
+
+    std::string formatIniSection(IniSection section) const;
+    bool updateSavedSections() const;     // 返回是否有部分发生变化
+    std::string savedIniText() const;
+    void markIniSaved(const std::wstring& fileText) const;
+
+    // 后台写入失败时清除已保存的状态，返回是否有失败。下次保存时重写整个文件
+    bool resetFailedWrites() const;
+
+    bool readRuleFile(std::vector<RuleFile::Record>& records) const;
+
+    // INI文件中规则以外的设置，与options/options_delta.h中的比较交换
+    OptionsReload::Settings iniSettings() const;
+    void applyIniSettings(const OptionsReload::Settings& settings);
+    void reloadIni(OptionsDelta& delta);
+    void reloadRules(OptionsDelta& delta);
+
+    mutable std::string m_savedSections[INI_SECTION_COUNT];
+    mutable bool        m_iniHasRules;    // INI文件中还有未迁移的旧格式规则
+    std::unique_ptr<Foundation::AsyncFileWriter> m_iniWriter;
+    OptionsReload::Settings m_defaults;   // 构造时的设置，重新加载时文件中删除的设置恢复为默认值
+
+    // 规则文件中已写入的规则（每条一行），用于判断只需追加还是重写
+    mutable std::vector<std::wstring> m_savedRuleLines;
+    mutable unsigned    m_savedRulesGen;  // 上次保存规则时的autoPinRulesGen
+    bool                m_rulesLoadFailed;  // 规则文件存在但无法读取，不能重写
+    std::unique_ptr<Foundation::AsyncFileWriter> m_rulesWriter;
 };
 
 
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "foundation/ini_document.h"
+
+#include <algorithm>
+#include <cwchar>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 配置文件热重载时的比较：INI文件中的设置读入 OptionsReload::Settings 后与当前设置比较，
+// 规则文件按行与上次的内容对应。
+// 只依赖标准库，不需要构造 Options（它带有后台写入线程），可以单独编译测试。
+//
+
+namespace OptionsReload {
+
+    // 范围受限的整数设置，超出范围的值被忽略
+    struct IntSetting {
+        int value = 0;
+        int minV = 0;
+        int maxV = 0;
+
+        bool operator==(const IntSetting& other) const { return value == other.value; }
+        bool operator!=(const IntSetting& other) const { return value != other.value; }
+    };
+
+    struct HotKeySetting {
+        unsigned vk = 0;
+        unsigned mod = 0;
+
+        bool operator==(const HotKeySetting& other) const { return vk == other.vk && mod == other.mod; }
+        bool operator!=(const HotKeySetting& other) const { return !(*this == other); }
+    };
+
+    // INI文件中规则以外的设置（与 Options 的同名成员对应）
+    struct Settings {
+        std::wstring  language;
+        std::wstring  pinImagePath;
+        IntSetting    trackRate;
+        bool          dblClkTray = false;
+        bool          hotkeysOn = false;
+        HotKeySetting hotEnterPin;
+        HotKeySetting hotTogglePin;
+        bool          autoPinOn = false;
+        IntSetting    autoPinDelay;
+        std::vector<std::wstring> autoPinProcesses;
+        bool          autoPinSweep = false;
+        bool          recordEvents = false;
+        bool          binaryLog = false;
+        bool          ruleProfiling = false;
+    };
+
+    // 配置文件热重载时需要重新应用的变化
+    struct Changes {
+        bool   language = false;
+        bool   pinImage = false;
+        bool   trackRate = false;
+        bool   hotkeys = false;
+        bool   autoPin = false;          // autoPinOn 或 autoPinDelay
+        bool   autoPinFilter = false;
+        bool   recordEvents = false;
+        size_t rulesChanged = 0;         // 新增、删除、修改或移动的规则数
+
+        bool empty() const
+        {
+            return !language && !pinImage && !trackRate && !hotkeys && !autoPin
+                && !autoPinFilter && !recordEvents && !rulesChanged;
+        }
+    };
+
+    namespace detail {
+        // 与 _wtoi 相同：忽略数字后面的内容，无法解析时为0
+        inline int iniInt(const std::wstring& value)
+        {
+            return static_cast<int>(std::wcstol(value.c_str(), nullptr, 10));
+        }
+
+        inline void readIniBool(const Foundation::IniDocument& ini, const wchar_t* section, const wchar_t* key, bool& out)
+        {
+            std::wstring value = ini.get(section, key);
+            if (!value.empty())
+                out = iniInt(value) != 0;
+        }
+
+        inline void readIniInt(const Foundation::IniDocument& ini, const wchar_t* section, const wchar_t* key, IntSetting& out)
+        {
+            std::wstring value = ini.get(section, key);
+            if (!value.empty()) {
+                int n = iniInt(value);
+                if (out.minV <= n && n <= out.maxV)
+                    out.value = n;
+            }
+        }
+
+        inline void readHotKeySetting(const Foundation::IniDocument& ini, const std::wstring& name, HotKeySetting& out)
+        {
+            std::wstring value = ini.get(L"Hotkeys", name + L"_VK");
+            if (!value.empty())
+                out.vk = static_cast<unsigned>(iniInt(value));
+            value = ini.get(L"Hotkeys", name + L"_MOD");
+            if (!value.empty())
+                out.mod = static_cast<unsigned>(iniInt(value));
+
+            // 没有虚拟键码时清除修饰键
+            if (!out.vk)
+                out.mod = 0;
+        }
+    } // namespace detail
+
+    // 读取INI文件中的设置。文件中没有的设置保持 settings 中原来的值，
+    // 语言和进程白名单除外（没有时为空，即自动检测和所有进程）
+    inline void readSettings(const Foundation::IniDocument& ini, Settings& settings)
+    {
+        settings.language = ini.get(L"Settings", L"Language");
+
+        std::wstring value = ini.get(L"Pins", L"PinImagePath");
+        if (!value.empty())
+            settings.pinImagePath = value;
+        detail::readIniInt(ini, L"Pins", L"TrackRate", settings.trackRate);
+        detail::readIniBool(ini, L"Pins", L"TrayDblClick", settings.dblClkTray);
+
+        detail::readIniBool(ini, L"Hotkeys", L"Enabled", settings.hotkeysOn);
+        detail::readHotKeySetting(ini, L"EnterPin", settings.hotEnterPin);
+        detail::readHotKeySetting(ini, L"TogglePin", settings.hotTogglePin);
+
+        detail::readIniBool(ini, L"AutoPin", L"Enabled", settings.autoPinOn);
+        detail::readIniInt(ini, L"AutoPin", L"Delay", settings.autoPinDelay);
+        detail::readIniBool(ini, L"AutoPin", L"StartupSweep", settings.autoPinSweep);
+
+        // 进程白名单，以分号分隔
+        settings.autoPinProcesses.clear();
+        value = ini.get(L"AutoPin", L"ProcessFilter");
+        size_t begin = 0;
+        while (begin <= value.size()) {
+            size_t end = value.find(L';', begin);
+            if (end == std::wstring::npos)
+                end = value.size();
+            size_t first = value.find_first_not_of(L" \t", begin);
+            if (first != std::wstring::npos && first < end) {
+                size_t last = value.find_last_not_of(L" \t", end - 1);
+                settings.autoPinProcesses.push_back(value.substr(first, last - first + 1));
+            }
+            begin = end + 1;
+        }
+
+        detail::readIniBool(ini, L"Debug", L"RecordEvents", settings.recordEvents);
+        detail::readIniBool(ini, L"Debug", L"BinaryLog", settings.binaryLog);
+        detail::readIniBool(ini, L"Debug", L"RuleProfiling", settings.ruleProfiling);
+    }
+
+    // 比较重新读取的设置与当前设置，记录需要重新应用的变化。
+    // 其余设置（如托盘双击、启动时扫描）在使用时读取，直接替换即可
+    inline void compare(const Settings& current, const Settings& fresh, Changes& changes)
+    {
+        changes.language = fresh.language != current.language;
+        changes.pinImage = fresh.pinImagePath != current.pinImagePath;
+        changes.trackRate = fresh.trackRate != current.trackRate;
+        changes.hotkeys = fresh.hotkeysOn != current.hotkeysOn
+            || fresh.hotEnterPin != current.hotEnterPin || fresh.hotTogglePin != current.hotTogglePin;
+        changes.autoPin = fresh.autoPinOn != current.autoPinOn || fresh.autoPinDelay != current.autoPinDelay;
+        changes.autoPinFilter = fresh.autoPinProcesses != current.autoPinProcesses;
+        changes.recordEvents = fresh.recordEvents != current.recordEvents;
+    }
+
+    // 按内容对应新旧规则文件的行
+    struct RuleLinesDiff {
+        static constexpr size_t NEW_LINE = size_t(-1);
+
+        std::vector<size_t> previous;   // previous[i]：新第i行对应的旧位置，新增的行为 NEW_LINE
+        size_t added = 0;
+        size_t removed = 0;
+        size_t moved = 0;
+
+        size_t changed() const { return added + removed + moved; }
+    };
+
+    // 内容相同的行对应同一条规则（重复的行按出现顺序对应）。
+    // 规则按顺序匹配，调整顺序也是变化：保留下来的行中，
+    // 不在最长的保持原有顺序的子序列中的行视为移动过（最少的移动数）
+    inline RuleLinesDiff diffRuleLines(const std::vector<std::wstring>& oldLines, const std::vector<std::wstring>& newLines)
+    {
+        std::unordered_multimap<std::wstring, size_t> byLine;
+        for (size_t i = 0; i < oldLines.size(); ++i) {
+            byLine.emplace(oldLines[i], i);
+        }
+
+        RuleLinesDiff diff;
+        diff.previous.reserve(newLines.size());
+        size_t reused = 0;
+        std::vector<size_t> inOrder;    // inOrder[k]为长度k+1的递增子序列末尾的最小原位置
+        for (const std::wstring& line : newLines) {
+            // 重复的行取最前面的旧位置
+            auto range = byLine.equal_range(line);
+            auto it = range.first;
+            for (auto other = range.first; other != range.second; ++other) {
+                if (other->second < it->second)
+                    it = other;
+            }
+            if (it == range.second) {
+                diff.previous.push_back(RuleLinesDiff::NEW_LINE);
+                ++diff.added;
+                continue;
+            }
+
+            size_t pos = it->second;
+            diff.previous.push_back(pos);
+            auto slot = std::lower_bound(inOrder.begin(), inOrder.end(), pos);
+            if (slot == inOrder.end())
+                inOrder.push_back(pos);
+            else
+                *slot = pos;
+            byLine.erase(it);
+            ++reused;
+        }
+
+        diff.removed = oldLines.size() - reused;
+        diff.moved = reused - inOrder.size();
+        return diff;
+    }
+
+} // namespace OptionsReload
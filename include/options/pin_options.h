@@ -8,12 +8,14 @@ class OptPins
 public:
     static BOOL CALLBACK dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lparam);
 
+    // 以新的跟踪频率重置所有图钉的定时器（配置文件热重载时也使用）
+    static BOOL CALLBACK resetPinTimersEnumProc(HWND wnd, LPARAM param);
+
 protected:
     static bool validate(HWND wnd);
     static void apply(HWND wnd);
 
     static void updatePinWnds();
-    static BOOL CALLBACK resetPinTimersEnumProc(HWND wnd, LPARAM param);
     
     static bool selectIconFile(HWND wnd);
     static bool resetToDefault(HWND wnd);
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "foundation/json_stream.h"
+#include "pin/auto_pin_rules.h"
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+// 自动图钉规则集的JSON导入导出，用于在不同机器和团队之间共享规则库。
+// 文件格式：
+//   {
+//     "format": "tinypin-autopin-rules",
+//     "version": 1,
+//     "rules": [
+//       { "description": "...", "title": "...", "class": "...", "process": "...",
+//         "processField": "imageName" | "imagePath" | "packageFamily", "enabled": true },
+//       ...
+//     ]
+//   }
+// 读写都是流式的：导入时逐条读取规则并立即合并，导出时逐条写出，
+// 不在内存中构建整个文档，几万条规则的文件也只需要规则本身的内存。
+// 只依赖标准库，规则类型作为模板参数，需要有 descr/ttl/cls/proc/procField/enabled 成员。
+//
+namespace RuleExchange {
+
+    constexpr char FORMAT[] = "tinypin-autopin-rules";
+    constexpr int VERSION = 1;
+
+    // 导入的规则与已有规则描述相同时的处理方式
+    enum class MergePolicy {
+        Skip,       // 保留已有规则
+        Overwrite,  // 用导入的规则替换已有规则
+        KeepBoth,   // 两者都保留，导入的规则改名为 "描述 (2)"
+    };
+
+    struct ImportResult {
+        size_t added = 0;
+        size_t replaced = 0;
+        size_t skipped = 0;
+        std::string error;      // 为空表示成功
+        uint64_t offset = 0;    // 出错位置（字节）
+
+        bool ok() const { return error.empty(); }
+        size_t total() const { return added + replaced + skipped; }
+    };
+
+    namespace detail {
+        inline const char* fieldName(Pin::ProcessField field)
+        {
+            switch (field) {
+            case Pin::ProcessField::ImagePath:     return "imagePath";
+            case Pin::ProcessField::PackageFamily: return "packageFamily";
+            default:                               return "imageName";
+            }
+        }
+
+        inline bool parseField(const Foundation::Json::Reader& reader, Pin::ProcessField& field)
+        {
+            using Foundation::Json::Token;
+            if (reader.token() == Token::Number) {
+                int64_t n = reader.integer(-1);
+                if (n < 0 || n > int64_t(Pin::ProcessField::PackageFamily))
+                    return false;
+                field = Pin::ProcessField(n);
+                return true;
+            }
+            if (reader.token() != Token::String)
+                return false;
+            const std::string& name = reader.text();
+            if (name == "imageName")          field = Pin::ProcessField::ImageName;
+            else if (name == "imagePath")     field = Pin::ProcessField::ImagePath;
+            else if (name == "packageFamily") field = Pin::ProcessField::PackageFamily;
+            else return false;
+            return true;
+        }
+
+        // 读取一个规则对象（BeginObject 已读取），未知的键被忽略
+        template <typename Rule>
+        bool readRule(Foundation::Json::Reader& reader, Rule& rule, std::string& error)
+        {
+            using Foundation::Json::Token;
+            Token t;
+            while ((t = reader.next()) == Token::Key) {
+                std::string key = reader.text();
+                Token v = reader.next();
+                std::wstring* text = nullptr;
+                if (key == "description")   text = &rule.descr;
+                else if (key == "title")    text = &rule.ttl;
+                else if (key == "class")    text = &rule.cls;
+                else if (key == "process")  text = &rule.proc;
+
+                if (text) {
+                    if (v != Token::String) {
+                        error = "\"" + key + "\" must be a string";
+                        return false;
+                    }
+                    *text = reader.wtext();
+                }
+                else if (key == "processField") {
+                    if (!parseField(reader, rule.procField)) {
+                        error = "invalid \"processField\"";
+                        return false;
+                    }
+                }
+                else if (key == "enabled") {
+                    if (v != Token::True && v != Token::False) {
+                        error = "\"enabled\" must be true or false";
+                        return false;
+                    }
+                    rule.enabled = reader.boolean();
+                }
+                else if (!reader.skip()) {
+                    break;
+                }
+            }
+            if (t == Token::EndObject)
+                return true;
+            if (t != Token::Error)
+                error = "expected rule property";
+            return false;
+        }
+
+        // 按描述合并规则。只保存描述的哈希值和规则位置，不复制描述字符串。
+        template <typename Rules>
+        class Merger {
+        public:
+            Merger(Rules& rules, MergePolicy policy) : m_rules(rules), m_policy(policy)
+            {
+                m_index.reserve(rules.size());
+                for (size_t i = 0; i < rules.size(); ++i) {
+                    if (find(rules[i].descr) == NOT_FOUND)
+                        m_index.emplace(hash(rules[i].descr), i);
+                }
+            }
+
+            void merge(typename Rules::value_type&& rule, ImportResult& result)
+            {
+                size_t i = find(rule.descr);
+                if (i == NOT_FOUND) {
+                    add(std::move(rule));
+                    ++result.added;
+                    return;
+                }
+                switch (m_policy) {
+                case MergePolicy::Skip:
+                    ++result.skipped;
+                    break;
+                case MergePolicy::Overwrite:
+                    m_rules[i] = std::move(rule);
+                    ++result.replaced;
+                    break;
+                case MergePolicy::KeepBoth: {
+                    std::wstring base = rule.descr;
+                    for (int n = 2; find(rule.descr) != NOT_FOUND; ++n)
+                        rule.descr = base + L" (" + std::to_wstring(n) + L")";
+                    add(std::move(rule));
+                    ++result.added;
+                    break;
+                }
+                }
+            }
+
+        private:
+            static constexpr size_t NOT_FOUND = size_t(-1);
+
+            Rules& m_rules;
+            MergePolicy m_policy;
+            std::unordered_multimap<size_t, size_t> m_index;   // 描述的哈希 -> 规则位置
+
+            static size_t hash(const std::wstring& s) { return std::hash<std::wstring>()(s); }
+
+            size_t find(const std::wstring& descr) const
+            {
+                auto range = m_index.equal_range(hash(descr));
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (m_rules[it->second].descr == descr)
+                        return it->second;
+                }
+                return NOT_FOUND;
+            }
+
+            void add(typename Rules::value_type&& rule)
+            {
+                m_index.emplace(hash(rule.descr), m_rules.size());
+                m_rules.push_back(std::move(rule));
+            }
+        };
+    }
+
+    // 把 [first, last) 中的规则写成JSON
+    template <typename It>
+    bool exportRules(std::ostream& out, It first, It last)
+    {
+        Foundation::Json::Writer writer(out);
+        writer.beginObject();
+        writer.key("format");
+        writer.value(FORMAT);
+        writer.key("version");
+        writer.value(VERSION);
+        writer.key("rules");
+        writer.beginArray();
+        for (; first != last && writer.good(); ++first) {
+            writer.beginObject();
+            writer.key("description");  writer.value(std::wstring_view(first->descr));
+            writer.key("title");        writer.value(std::wstring_view(first->ttl));
+            writer.key("class");        writer.value(std::wstring_view(first->cls));
+            writer.key("process");      writer.value(std::wstring_view(first->proc));
+            writer.key("processField"); writer.value(detail::fieldName(first->procField));
+            writer.key("enabled");      writer.value(bool(first->enabled));
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+        out.flush();
+        return writer.good();
+    }
+
+    // 从JSON读取规则并按描述合并到 rules 末尾。
+    // 出错时 rules 可能已经部分修改，调用方应在副本上导入，成功后再整体替换。
+    // 也接受只包含规则数组的文档。
+    template <typename Rules>
+    ImportResult importRules(std::istream& in, Rules& rules, MergePolicy policy)
+    {
+        using Foundation::Json::Reader;
+        using Foundation::Json::Token;
+
+        ImportResult result;
+        Reader reader(in);
+        detail::Merger<Rules> merger(rules, policy);
+
+        auto fail = [&](const std::string& msg) {
+            result.error = reader.token() == Token::Error ? reader.error() : msg;
+            result.offset = reader.offset();
+            return result;
+        };
+
+        // 逐条读取规则数组（BeginArray 已读取）
+        auto readRules = [&]() {
+            Token t;
+            while ((t = reader.next()) == Token::BeginObject) {
+                typename Rules::value_type rule;
+                if (!detail::readRule(reader, rule, result.error))
+                    return false;
+                merger.merge(std::move(rule), result);
+            }
+            if (t == Token::EndArray)
+                return true;
+            if (t != Token::Error)
+                result.error = "rule must be an object";
+            return false;
+        };
+
+        Token t = reader.next();
+        if (t == Token::BeginArray) {
+            if (!readRules())
+                return fail(result.error);
+        }
+        else if (t == Token::BeginObject) {
+            bool haveRules = false;
+            while ((t = reader.next()) == Token::Key) {
+                std::string key = reader.text();
+                Token v = reader.next();
+                if (key == "format") {
+                    if (v != Token::String || reader.text() != FORMAT)
+                        return fail("not a TinyPin autopin rules file");
+                }
+                else if (key == "version") {
+                    if (v != Token::Number || reader.integer(-1) < 1 || reader.integer(-1) > VERSION)
+                        return fail("unsupported file version");
+                }
+                else if (key == "rules") {
+                    if (v != Token::BeginArray)
+                        return fail("\"rules\" must be an array");
+                    if (!readRules())
+                        return fail(result.error);
+                    haveRules = true;
+                }
+                else if (!reader.skip()) {
+                    return fail(reader.error());
+                }
+            }
+            if (t != Token::EndObject)
+                return fail("expected property name");
+            if (!haveRules)
+                return fail("no \"rules\" array");
+        }
+        else {
+            return fail("not a TinyPin autopin rules file");
+        }
+
+        if (reader.next() != Token::End)
+            return fail(reader.error());
+        return result;
+    }
+
+} // namespace RuleExchange
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 自动图钉规则文件（TinyPin.rules）的读写。
+// 每条规则一行，字段以制表符分隔：
+//   启用 \t 进程匹配属性 \t 描述 \t 标题模式 \t 类名模式 \t 进程模式
+// 字段中的反斜杠、制表符、换行和回车分别写作 \\ \t \n \r。
+// 以 # 开头的行和空行被忽略，字段数不对的行（例如追加时中断留下的半行）被跳过。
+// 整个文件只需一次顺序扫描，添加规则时只在文件末尾追加新行。
+// 只依赖标准库，文件内容的UTF-8转换由调用方完成。
+//
+namespace RuleFile {
+
+    constexpr wchar_t HEADER[] = L"# TinyPin autopin rules 1\n";
+    constexpr size_t FIELD_COUNT = 6;
+
+    struct Record {
+        std::wstring descr;
+        std::wstring title;
+        std::wstring cls;
+        std::wstring process;
+        int  processField = 0;
+        bool enabled = true;
+    };
+
+    namespace detail {
+        inline void appendEscaped(std::wstring& out, const std::wstring& s)
+        {
+            for (wchar_t ch : s) {
+                switch (ch) {
+                case L'\\': out += L"\\\\"; break;
+                case L'\t': out += L"\\t";  break;
+                case L'\n': out += L"\\n";  break;
+                case L'\r': out += L"\\r";  break;
+                default:    out += ch;      break;
+                }
+            }
+        }
+
+        inline std::wstring unescape(std::wstring_view s)
+        {
+            std::wstring out;
+            out.reserve(s.size());
+            for (size_t i = 0; i < s.size(); ++i) {
+                wchar_t ch = s[i];
+                if (ch == L'\\' && i + 1 < s.size()) {
+                    switch (s[++i]) {
+                    case L't': ch = L'\t'; break;
+                    case L'n': ch = L'\n'; break;
+                    case L'r': ch = L'\r'; break;
+                    default:   ch = s[i];  break;
+                    }
+                }
+                out += ch;
+            }
+            return out;
+        }
+
+        inline int toInt(std::wstring_view s)
+        {
+            int n = 0;
+            for (wchar_t ch : s) {
+                if (ch < L'0' || ch > L'9')
+                    return -1;
+                n = n * 10 + (ch - L'0');
+            }
+            return s.empty() ? -1 : n;
+        }
+    }
+
+    // 追加一条规则（含换行符）
+    inline void format(std::wstring& out, const Record& rec)
+    {
+        out += rec.enabled ? L'1' : L'0';
+        out += L'\t';
+        out += std::to_wstring(rec.processField);
+        out += L'\t';
+        detail::appendEscaped(out, rec.descr);
+        out += L'\t';
+        detail::appendEscaped(out, rec.title);
+        out += L'\t';
+        detail::appendEscaped(out, rec.cls);
+        out += L'\t';
+        detail::appendEscaped(out, rec.process);
+        out += L'\n';
+    }
+
+    // 解析一行（不含换行符），不是有效规则时返回false
+    inline bool parseLine(std::wstring_view line, Record& rec)
+    {
+        if (!line.empty() && line.back() == L'\r')
+            line.remove_suffix(1);
+        if (line.empty() || line.front() == L'#')
+            return false;
+
+        std::wstring_view fields[FIELD_COUNT];
+        size_t count = 0;
+        for (;;) {
+            size_t tab = line.find(L'\t');
+            if (count == FIELD_COUNT)
+                return false;
+            fields[count++] = line.substr(0, tab);
+            if (tab == std::wstring_view::npos)
+                break;
+            line.remove_prefix(tab + 1);
+        }
+        if (count != FIELD_COUNT)
+            return false;
+
+        int enabled = detail::toInt(fields[0]);
+        int processField = detail::toInt(fields[1]);
+        if (enabled < 0 || processField < 0)
+            return false;
+
+        rec.enabled = enabled != 0;
+        rec.processField = processField;
+        rec.descr = detail::unescape(fields[2]);
+        rec.title = detail::unescape(fields[3]);
+        rec.cls = detail::unescape(fields[4]);
+        rec.process = detail::unescape(fields[5]);
+        return true;
+    }
+
+    // 单遍解析整个文件
+    inline void parse(std::wstring_view text, std::vector<Record>& records)
+    {
+        if (!text.empty() && text.front() == 0xFEFF)
+            text.remove_prefix(1);
+
+        Record rec;
+        while (!text.empty()) {
+            size_t eol = text.find(L'\n');
+            if (parseLine(text.substr(0, eol), rec))
+                records.push_back(std::move(rec));
+            text.remove_prefix(eol == std::wstring_view::npos ? text.size() : eol + 1);
+        }
+    }
+
+} // namespace RuleFile
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 自动图钉规则页的列表模型，供虚拟（LVS_OWNERDATA）列表控件使用。
+// 规则直接保存在一个vector中，列表控件只知道条目数；
+// 可见条目是规则位置的索引数组，按条目取规则为O(1)。
+//
+// 过滤按描述、标题模式和类名模式做不区分大小写的子串匹配。
+// 小写的匹配文本在第一次过滤时才生成；过滤文本只是在原来的基础上变长时，
+// 只在当前可见的条目中继续筛选。
+// 新添加和编辑过的规则在过滤文本改变前保持可见，即使不再匹配。
+//
+// 只依赖标准库，规则类型需要有 descr/ttl/cls 成员。
+//
+template <typename Rule>
+class RuleView {
+public:
+    using Rules = std::vector<Rule>;
+
+    void assign(Rules rules)
+    {
+        m_rules = std::move(rules);
+        m_keys.clear();
+        m_haveKeys = false;
+        refilter();
+    }
+
+    const Rules& rules() const { return m_rules; }
+
+    size_t size() const { return m_view.size(); }      // 可见条目数
+    Rule& at(size_t i) { return m_rules[m_view[i]]; }
+    const Rule& at(size_t i) const { return m_rules[m_view[i]]; }
+    bool filtered() const { return !m_filter.empty(); }
+
+    // 修改了条目 i 的规则后调用
+    void updated(size_t i)
+    {
+        if (m_haveKeys)
+            m_keys[m_view[i]] = makeKey(m_rules[m_view[i]]);
+    }
+
+    // 在末尾添加规则，返回新条目的位置
+    size_t add(Rule rule)
+    {
+        m_rules.push_back(std::move(rule));
+        if (m_haveKeys)
+            m_keys.push_back(makeKey(m_rules.back()));
+        m_view.push_back(uint32_t(m_rules.size() - 1));
+        return m_view.size() - 1;
+    }
+
+    // 删除条目，sel 为升序的条目位置。其余规则一次压缩到位。
+    void remove(const std::vector<int>& sel)
+    {
+        if (sel.empty())
+            return;
+
+        std::vector<uint32_t> newIndex(m_rules.size(), 0);
+        for (int i : sel)
+            newIndex[m_view[i]] = NONE;
+
+        uint32_t out = 0;
+        for (size_t n = 0; n < m_rules.size(); ++n) {
+            if (newIndex[n] == NONE)
+                continue;
+            if (out != n) {
+                m_rules[out] = std::move(m_rules[n]);
+                if (m_haveKeys)
+                    m_keys[out] = std::move(m_keys[n]);
+            }
+            newIndex[n] = out++;
+        }
+        m_rules.erase(m_rules.begin() + out, m_rules.end());
+        if (m_haveKeys)
+            m_keys.resize(out);
+
+        size_t v = 0;
+        for (uint32_t index : m_view) {
+            if (newIndex[index] != NONE)
+                m_view[v++] = newIndex[index];
+        }
+        m_view.resize(v);
+    }
+
+    // 把选中的条目（升序）各向上/向下移动一位，sel 更新为移动后的位置。
+    // 过滤时只在可见条目之间移动。没有可移动的条目时返回false。
+    bool moveUp(std::vector<int>& sel)
+    {
+        if (sel.empty() || sel.size() == size() || sel.front() == 0)
+            return false;
+        for (int& i : sel) {
+            swapItems(i - 1, i);
+            --i;
+        }
+        return true;
+    }
+
+    bool moveDown(std::vector<int>& sel)
+    {
+        if (sel.empty() || sel.size() == size() || sel.back() == int(size()) - 1)
+            return false;
+        for (auto it = sel.rbegin(); it != sel.rend(); ++it) {
+            swapItems(*it, *it + 1);
+            ++*it;
+        }
+        return true;
+    }
+
+    // 设置过滤文本，可见条目改变时返回true
+    bool setFilter(std::wstring_view text)
+    {
+        std::wstring filter = toLower(text);
+        if (filter == m_filter)
+            return false;
+
+        bool narrowing = !m_filter.empty() && filter.compare(0, m_filter.size(), m_filter) == 0;
+        m_filter = std::move(filter);
+        if (!narrowing) {
+            refilter();
+            return true;
+        }
+
+        // 匹配更长文本的规则一定匹配原来的文本，只需检查当前可见的条目
+        m_view.erase(std::remove_if(m_view.begin(), m_view.end(),
+            [this](uint32_t index) { return !matches(index); }), m_view.end());
+        return true;
+    }
+
+    // 从条目 start 开始查找描述以 prefix 开头的条目（不区分大小写），
+    // 到末尾后从头继续。用于列表控件的键入查找，找不到时返回-1。
+    int findPrefix(std::wstring_view prefix, size_t start) const
+    {
+        size_t cnt = size();
+        if (prefix.empty() || cnt == 0)
+            return -1;
+        for (size_t k = 0; k < cnt; ++k) {
+            size_t i = (start + k) % cnt;
+            const std::wstring& descr = at(i).descr;
+            if (descr.size() < prefix.size())
+                continue;
+            size_t n = 0;
+            while (n < prefix.size() && std::towlower(descr[n]) == std::towlower(prefix[n]))
+                ++n;
+            if (n == prefix.size())
+                return int(i);
+        }
+        return -1;
+    }
+
+private:
+    static constexpr uint32_t NONE = uint32_t(-1);
+
+    Rules m_rules;
+    std::vector<uint32_t> m_view;       // 可见条目 -> m_rules中的位置
+    std::vector<std::wstring> m_keys;   // 过滤用的小写文本，与m_rules对应，第一次过滤时生成
+    bool m_haveKeys = false;
+    std::wstring m_filter;              // 小写的过滤文本
+
+    static std::wstring toLower(std::wstring_view s)
+    {
+        std::wstring out(s);
+        for (wchar_t& ch : out)
+            ch = wchar_t(std::towlower(ch));
+        return out;
+    }
+
+    static std::wstring makeKey(const Rule& rule)
+    {
+        // 用换行分隔，过滤文本来自单行编辑框，不会跨字段匹配
+        return toLower(rule.descr) + L'\n' + toLower(rule.ttl) + L'\n' + toLower(rule.cls);
+    }
+
+    bool matches(uint32_t index) const
+    {
+        return m_keys[index].find(m_filter) != std::wstring::npos;
+    }
+
+    void refilter()
+    {
+        m_view.clear();
+        if (m_filter.empty()) {
+            m_view.reserve(m_rules.size());
+            for (size_t n = 0; n < m_rules.size(); ++n)
+                m_view.push_back(uint32_t(n));
+            return;
+        }
+
+        if (!m_haveKeys) {
+            m_keys.reserve(m_rules.size());
+            for (const Rule& rule : m_rules)
+                m_keys.push_back(makeKey(rule));
+            m_haveKeys = true;
+        }
+        for (size_t n = 0; n < m_rules.size(); ++n) {
+            if (matches(uint32_t(n)))
+                m_view.push_back(uint32_t(n));
+        }
+    }
+
+    // 交换两个条目的规则，条目位置不变
+    void swapItems(size_t a, size_t b)
+    {
+        using std::swap;
+        swap(m_rules[m_view[a]], m_rules[m_view[b]]);
+        if (m_haveKeys)
+            swap(m_keys[m_view[a]], m_keys[m_view[b]]);
+    }
+};
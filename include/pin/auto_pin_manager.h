@@ -1,27 +1,32 @@
 #pragma once
 
+#include "pin/auto_pin_queue.h"
+
 class Options;
 
-// 创建窗口的自动图钉检查。
-// 记住每个窗口添加的时间，因此在检查时
-// 只处理那些已经通过自动图钉延迟的窗口。
+// Win32窗口系统上的自动图钉宿主。
+// 为Pin::AutoPinQueue提供窗口属性、时钟和图钉创建，
+// 并用黑名单避免反复尝试图钉失败的窗口。
 //
-class PendingWindows {
+class AutoPinHost {
 public:
-    void add(HWND wnd);
-    void check(HWND wnd, const Options& opt);
+    typedef HWND Handle;
+    typedef std::shared_ptr<const Platform::ProcessInfo> ProcessRef;
 
-protected:
-    struct Entry {
-        HWND wnd;
-        std::wstring title;
-        std::wstring className;
-        ULONGLONG time;
-        Entry(HWND h = 0, const std::wstring& t = L"", const std::wstring& c = L"", ULONGLONG tm = 0) 
-            : wnd(h), title(t), className(c), time(tm) {}
-    };
-    std::vector<Entry> m_wnds;
+    HWND pinOwner = nullptr;    // 创建图钉时使用的主窗口
+    int  trackRate = Constants::DEFAULT_TRACK_RATE_NEW;
+
+    uint64_t now() const { return GetTickCount64(); }
+    bool isWindow(HWND wnd) const { return !!IsWindow(wnd); }
+    std::wstring title(HWND wnd) const;
+    std::wstring className(HWND wnd) const;
+    ProcessRef process(HWND wnd) const;
+    static void fillProcess(Pin::RuleTarget& target, const ProcessRef& info);
+    void pin(const std::vector<HWND>& targets, std::vector<char>& pinned);
+
+    void cleanupBlacklist();
 
+private:
     struct BlacklistEntry {
         HWND wnd;
         ULONGLONG time;
@@ -29,10 +34,32 @@ protected:
     };
     std::vector<BlacklistEntry> m_blacklist;
 
-    bool timeToChkWnd(ULONGLONG t, const Options& opt);
-    bool checkWnd(HWND target, const Options& opt);
     bool isErrorDialog(HWND wnd);
     bool isInBlacklist(HWND wnd);
     void addToBlacklist(HWND wnd);
-    void cleanupBlacklist();
-};
\ No newline at end of file
+};
+
+// 创建窗口的自动图钉检查。
+// 记住每个窗口添加的时间，因此在检查时
+// 只处理那些已经通过自动图钉延迟的窗口。
+// 首次检查未匹配、但有类名匹配且依赖标题的规则的窗口会继续跟踪一段时间，
+// 标题变化时只重新评估这些候选规则。
+// 队列逻辑在Pin::AutoPinQueue中，与事件回放工具共用。
+//
+class PendingWindows {
+public:
+    PendingWindows() : m_queue(m_host) {}
+
+    void add(HWND wnd);
+    void add(const std::vector<HWND>& wnds);
+    void titleChanged(HWND wnd, const std::vector<HWND>& targets, const Options& opt);
+    void check(HWND wnd, const Options& opt);
+    void sweep(HWND wnd, const Options& opt);
+
+protected:
+    AutoPinHost m_host;
+    Pin::AutoPinQueue<AutoPinHost> m_queue;
+    unsigned m_rulesGen = 0;
+
+    void update(HWND wnd, const Options& opt);
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "pin/auto_pin_rules.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Pin {
+
+    // 自动图钉队列的时间参数（毫秒）。
+    //
+    struct AutoPinTiming {
+        uint64_t delay = 200;            // 窗口入队后到首次检查的延迟
+        uint64_t watchPeriod = 10000;    // 未匹配窗口的标题跟踪时长
+        uint64_t recheckInterval = 250;  // 同一窗口两次标题重新检查的最小间隔
+    };
+
+
+    // 等待自动图钉检查的窗口队列。
+    // 与具体窗口系统无关：窗口属性、时钟和图钉创建都由宿主提供，
+    // 因此同一份逻辑既用于程序本身，也用于离线的事件回放工具。
+    //
+    // 窗口通过延迟后首次检查时评估全部规则，并记录类名和进程已匹配、
+    // 只差标题的候选规则；之后在跟踪时长内，标题变化时只重新评估这些候选规则。
+    //
+    // Host需要提供：
+    //   Handle、ProcessRef 类型
+    //   uint64_t now()                                   毫秒时钟
+    //   bool isWindow(Handle)
+    //   std::wstring title(Handle)、className(Handle)
+    //   ProcessRef process(Handle)                       入队时调用一次
+    //   void fillProcess(RuleTarget&, const ProcessRef&)
+    //   void pin(const std::vector<Handle>&, std::vector<char>& pinned)
+    //                                                    批量创建图钉，pinned返回每个窗口是否成功
+    //
+    template <typename Host>
+    class AutoPinQueue {
+    public:
+        typedef typename Host::Handle Handle;
+        typedef typename Host::ProcessRef ProcessRef;
+
+        AutoPinTiming timing;
+
+        explicit AutoPinQueue(Host& host) : m_host(host) {}
+
+        // 重新编译规则。已检查窗口的候选规则随之失效，全部重新做完整检查。
+        template <typename Iter>
+        void setRules(Iter first, Iter last)
+        {
+            m_rules.assign(first, last);
+            for (auto& entry : m_entries) {
+                entry.checked = false;
+                entry.dirty = false;
+                entry.candidates.clear();
+            }
+        }
+
+        const CompiledRuleSet& rules() const { return m_rules; }
+
+        // 是否统计规则的评估次数和匹配耗时
+        void setProfiling(bool on) { m_rules.setProfiling(on); }
+        size_t size() const { return m_entries.size(); }
+
+        bool contains(Handle wnd) const
+        {
+            for (const auto& entry : m_entries) {
+                if (entry.wnd == wnd)
+                    return true;
+            }
+            return false;
+        }
+
+        void add(Handle wnd)
+        {
+            if (!m_host.isWindow(wnd) || contains(wnd))
+                return;
+
+            // 只记录入队时间，标题和类名在检查时读取（届时标题可能已经设置好）
+            Entry entry;
+            entry.wnd = wnd;
+            entry.time = m_host.now();
+            entry.process = m_host.process(wnd);
+            m_entries.push_back(entry);
+        }
+
+        void titleChanged(const std::vector<Handle>& wnds)
+        {
+            uint64_t now = m_host.now();
+            for (Handle wnd : wnds) {
+                for (size_t n = 0; n < m_entries.size(); ++n) {
+                    Entry& entry = m_entries[n];
+                    if (entry.wnd != wnd)
+                        continue;
+
+                    // 尚未首次检查的窗口届时会读取最新标题
+                    if (entry.checked) {
+                        entry.dirty = true;
+                        // 同一窗口的重新检查限速，剩余的变化由下一次check()补上
+                        if (now - entry.lastCheck >= timing.recheckInterval && evaluate(entry, now))
+                            m_entries.erase(m_entries.begin() + n);
+                    }
+                    break;
+                }
+            }
+            flushPins();
+        }
+
+        // 定时调用：检查已通过延迟的窗口、处理限速期间积压的标题变化、移除过期窗口
+        void check()
+        {
+            uint64_t now = m_host.now();
+            for (size_t n = m_entries.size(); n-- > 0; ) {
+                Entry& entry = m_entries[n];
+                bool done;
+
+                if (!m_host.isWindow(entry.wnd)) {
+                    done = true;
+                }
+                else if (!entry.checked) {
+                    if (now - entry.time < timing.delay)
+                        continue;
+                    done = evaluate(entry, now);
+                }
+                else if (entry.dirty && now - entry.lastCheck >= timing.recheckInterval) {
+                    done = evaluate(entry, now);
+                }
+                else {
+                    done = now - entry.time >= timing.watchPeriod;
+                }
+
+                if (done)
+                    m_entries.erase(m_entries.begin() + n);
+            }
+            flushPins();
+        }
+
+    private:
+        struct Entry {
+            Handle wnd{};
+            uint64_t time = 0;          // 入队时间
+            uint64_t lastCheck = 0;     // 上次检查时间
+            bool checked = false;       // 是否已完成首次完整检查
+            bool dirty = false;         // 上次检查后标题发生过变化
+            std::vector<size_t> candidates;  // 类名和进程匹配、标题尚未匹配的规则
+            ProcessRef process{};       // 入队时解析的进程信息
+        };
+
+        Host& m_host;
+        CompiledRuleSet m_rules;
+        std::vector<Entry> m_entries;
+        std::vector<Handle> m_matched;  // 本轮匹配、等待批量创建图钉的窗口
+        std::vector<size_t> m_matchedRules;  // 与m_matched对应的匹配规则
+        std::vector<char> m_pinned;     // 与m_matched对应的图钉创建结果
+
+        // 评估窗口，匹配的窗口加入m_matched。返回窗口是否可以移出队列。
+        bool evaluate(Entry& entry, uint64_t now)
+        {
+            std::wstring title = m_host.title(entry.wnd);
+
+            size_t rule;
+            if (!entry.checked) {
+                std::wstring cls = m_host.className(entry.wnd);
+                RuleTarget target;
+                target.title = title;
+                target.cls = cls;
+                m_host.fillProcess(target, entry.process);
+                rule = m_rules.match(target, &entry.candidates);
+                entry.checked = true;
+            }
+            else {
+                rule = m_rules.matchTitle(title, entry.candidates);
+            }
+            entry.lastCheck = now;
+            entry.dirty = false;
+
+            if (rule != CompiledRuleSet::npos) {
+                m_matched.push_back(entry.wnd);
+                m_matchedRules.push_back(rule);
+                return true;
+            }
+
+            // 没有依赖标题的候选规则，或跟踪时间已到
+            return entry.candidates.empty() || now - entry.time >= timing.watchPeriod;
+        }
+
+        void flushPins()
+        {
+            if (m_matched.empty())
+                return;
+            m_pinned.assign(m_matched.size(), 0);
+            m_host.pin(m_matched, m_pinned);
+            for (size_t n = 0; n < m_matched.size(); ++n)
+                m_rules.recordPin(m_matchedRules[n], m_pinned[n] != 0);
+            m_matched.clear();
+            m_matchedRules.clear();
+        }
+    };
+
+} // namespace Pin
@@ -0,0 +1,500 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cwctype>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Pin {
+
+    // 预编译的通配符模式（* 匹配任意多个字符，? 匹配单个字符，区分大小写）。
+    // 语义与 Foundation::StringUtils::wildcardMatch 相同：空模式只匹配空字符串。
+    // 常见形式（精确、前缀、后缀、包含、全匹配）在编译时识别，匹配时走快速路径；
+    // 其余模式使用不递归的回溯匹配。
+    //
+    class WildcardPattern {
+    public:
+        WildcardPattern() : m_kind(Kind::Exact) {}
+        explicit WildcardPattern(const std::wstring& pattern) { assign(pattern); }
+
+        // ignoreCase为true时模式转换为小写，被匹配的字符串也应由调用方转换为小写
+        void assign(const std::wstring& pattern, bool ignoreCase = false)
+        {
+            m_pattern = pattern;
+            if (!ignoreCase) {
+                compile(pattern);
+                return;
+            }
+            std::wstring lower = pattern;
+            for (auto& ch : lower)
+                ch = static_cast<wchar_t>(std::towlower(ch));
+            compile(lower);
+        }
+
+        const std::wstring& pattern() const { return m_pattern; }
+
+        // 是否匹配任意字符串（模式全为 *）
+        bool matchesAll() const { return m_kind == Kind::Any; }
+
+        bool match(std::wstring_view str) const
+        {
+            const wchar_t* s = str.data();
+            const size_t len = str.size();
+            const size_t n = m_text.size();
+            switch (m_kind) {
+                case Kind::Any:
+                    return true;
+                case Kind::Exact:
+                    return len == n && m_text.compare(0, n, s, len) == 0;
+                case Kind::Prefix:
+                    return len >= n && m_text.compare(0, n, s, n) == 0;
+                case Kind::Suffix:
+                    return len >= n && m_text.compare(0, n, s + len - n, n) == 0;
+                case Kind::Contains:
+                    return len >= n && findText(s, len);
+                default:
+                    return matchGeneral(s, len);
+            }
+        }
+
+    private:
+        enum class Kind { Exact, Any, Prefix, Suffix, Contains, General };
+
+        Kind m_kind;
+        std::wstring m_text;     // 快速路径使用的字面文本，General时为完整模式
+        std::wstring m_pattern;  // 原始模式
+
+        void compile(const std::wstring& pattern)
+        {
+            if (pattern.find(L'?') != std::wstring::npos) {
+                m_kind = Kind::General;
+                m_text = pattern;
+                return;
+            }
+
+            size_t first = pattern.find_first_not_of(L'*');
+            if (first == std::wstring::npos) {
+                // 空模式或全部是 *
+                m_kind = pattern.empty() ? Kind::Exact : Kind::Any;
+                m_text.clear();
+                return;
+            }
+            size_t last = pattern.find_last_not_of(L'*');
+            std::wstring text = pattern.substr(first, last - first + 1);
+            if (text.find(L'*') != std::wstring::npos) {
+                m_kind = Kind::General;
+                m_text = pattern;
+                return;
+            }
+
+            bool lead = first > 0;
+            bool trail = last + 1 < pattern.size();
+            m_kind = lead ? (trail ? Kind::Contains : Kind::Suffix)
+                          : (trail ? Kind::Prefix : Kind::Exact);
+            m_text = text;
+        }
+
+        bool findText(const wchar_t* s, size_t len) const
+        {
+            const size_t n = m_text.size();
+            const wchar_t head = m_text[0];
+            for (size_t i = 0; i + n <= len; ++i) {
+                if (s[i] == head && m_text.compare(0, n, s + i, n) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+        bool matchGeneral(const wchar_t* s, size_t len) const
+        {
+            const wchar_t* p = m_text.data();
+            const size_t plen = m_text.size();
+            size_t pi = 0, si = 0;
+            size_t star = std::wstring::npos, mark = 0;
+
+            while (si < len) {
+                if (pi < plen && (p[pi] == L'?' || p[pi] == s[si])) {
+                    ++pi;
+                    ++si;
+                }
+                else if (pi < plen && p[pi] == L'*') {
+                    // 记录最近的 *，先尝试让它匹配零个字符
+                    star = pi++;
+                    mark = si;
+                }
+                else if (star != std::wstring::npos) {
+                    // 回溯：让最近的 * 多吞一个字符
+                    pi = star + 1;
+                    si = ++mark;
+                }
+                else {
+                    return false;
+                }
+            }
+            while (pi < plen && p[pi] == L'*')
+                ++pi;
+            return pi == plen;
+        }
+    };
+
+
+    // 规则按哪个进程属性匹配。
+    //
+    enum class ProcessField {
+        ImageName = 0,      // 映像文件名，如 notepad.exe
+        ImagePath = 1,      // 映像完整路径
+        PackageFamily = 2,  // 打包应用的包系列名
+    };
+
+    // 被匹配的窗口属性。进程属性必须已转换为小写。
+    //
+    struct RuleTarget {
+        std::wstring_view title;
+        std::wstring_view cls;
+        std::wstring_view imageName;
+        std::wstring_view imagePath;
+        std::wstring_view packageFamily;
+
+        std::wstring_view process(ProcessField field) const
+        {
+            switch (field) {
+                case ProcessField::ImagePath:     return imagePath;
+                case ProcessField::PackageFamily: return packageFamily;
+                default:                          return imageName;
+            }
+        }
+    };
+
+
+    inline int64_t unixTimeMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // 规则的匹配统计（规则分析器）。
+    // 由规则和它的所有副本共享，规则重新编译、排序或编辑后统计保留。
+    // 计数器为原子变量，任何线程都可以不加锁地更新和读取。
+    //
+    // 评估次数和耗时只在规则集启用分析时统计（CompiledRuleSet::setProfiling），
+    // 计时本身比多数模式匹配更慢，因此每TIME_SAMPLE_RATE次评估只计时一次，
+    // 按比例累加作为耗时的估计。匹配和图钉创建的计数始终记录。
+    //
+    struct RuleStats {
+        static constexpr uint64_t TIME_SAMPLE_RATE = 16;
+
+        std::atomic<uint64_t> evaluations{0};   // 评估次数
+        std::atomic<uint64_t> matches{0};       // 匹配次数
+        std::atomic<uint64_t> pinsCreated{0};   // 匹配后成功创建的图钉
+        std::atomic<uint64_t> pinsFailed{0};    // 匹配后创建失败或被列入黑名单的图钉
+        std::atomic<uint64_t> matchTime{0};     // 累计匹配耗时（纳秒，抽样估计）
+        std::atomic<int64_t>  lastMatch{0};     // 最近一次匹配的时间（Unix时间，毫秒），0表示从未匹配
+
+        // 计入一次评估，返回这次评估是否需要计时
+        bool countEvaluation()
+        {
+            return evaluations.fetch_add(1, std::memory_order_relaxed) % TIME_SAMPLE_RATE == 0;
+        }
+
+        void recordMatch(int64_t time)
+        {
+            matches.fetch_add(1, std::memory_order_relaxed);
+            // 合并多个线程的结果时保留最新的时间
+            int64_t prev = lastMatch.load(std::memory_order_relaxed);
+            while (prev < time && !lastMatch.compare_exchange_weak(prev, time, std::memory_order_relaxed)) {}
+        }
+
+        void recordPin(bool created)
+        {
+            (created ? pinsCreated : pinsFailed).fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+
+    // 单个线程的规则统计累加器。
+    // 启动扫描时每个工作线程各用一个，结束后用CompiledRuleSet::commit()一次性合并，
+    // 避免多个线程在每次评估时争用同一组原子计数器。
+    //
+    class RuleProfile {
+    public:
+        void reset(size_t rules) { m_entries.assign(rules, Entry()); }
+
+        bool countEvaluation(size_t n) { return m_entries[n].evaluations++ % RuleStats::TIME_SAMPLE_RATE == 0; }
+        void addTime(size_t n, uint64_t ns) { m_entries[n].matchTime += ns; }
+        void recordMatch(size_t n, int64_t time) { ++m_entries[n].matches; m_entries[n].lastMatch = time; }
+
+    private:
+        friend class CompiledRuleSet;
+
+        struct Entry {
+            uint64_t evaluations = 0;
+            uint64_t matches = 0;
+            uint64_t matchTime = 0;
+            int64_t  lastMatch = 0;
+        };
+        std::vector<Entry> m_entries;
+    };
+
+
+    // 编译后的自动图钉规则。
+    // 统计不放在这里（见 CompiledRuleSet::m_stats），匹配时连续访问的数据保持紧凑。
+    //
+    struct CompiledRule {
+        size_t index;            // 在原规则列表中的位置
+        WildcardPattern title;
+        WildcardPattern cls;
+        WildcardPattern proc;    // 进程模式（不区分大小写）
+        ProcessField procField;
+        bool hasProc;            // 进程模式为空时不限制进程
+
+        bool matchProcess(const RuleTarget& target) const
+        {
+            return !hasProc || proc.match(target.process(procField));
+        }
+    };
+
+
+    // 编译后的自动图钉规则集。
+    // 只包含启用的规则；规则列表变化时重新编译，
+    // 未变化的规则（同一份统计且模式相同）沿用已编译的模式。
+    // 默认不统计评估次数和耗时，评估时不访问任何原子变量；setProfiling(true)后才统计。
+    //
+    class CompiledRuleSet {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        // 从任意带 ttl/cls/proc/procField/enabled/stats 成员的规则序列编译
+        template <typename Iter>
+        void assign(Iter first, Iter last)
+        {
+            std::vector<CompiledRule> previous;
+            std::vector<std::shared_ptr<RuleStats>> previousStats;
+            previous.swap(m_rules);
+            previousStats.swap(m_stats);
+            std::unordered_map<const RuleStats*, size_t> byStats;
+            for (size_t n = 0; n < previous.size(); ++n)
+                byStats.emplace(previousStats[n].get(), n);
+
+            m_usesProcess = false;
+            for (size_t n = 0; first != last; ++first, ++n) {
+                if (!first->enabled)
+                    continue;
+
+                auto it = first->stats ? byStats.find(first->stats.get()) : byStats.end();
+                if (it != byStats.end()) {
+                    size_t p = it->second;
+                    CompiledRule& prev = previous[p];
+                    byStats.erase(it);
+                    if (prev.title.pattern() == first->ttl && prev.cls.pattern() == first->cls
+                        && prev.proc.pattern() == first->proc && prev.procField == first->procField) {
+                        prev.index = n;
+                        m_usesProcess = m_usesProcess || prev.hasProc;
+                        m_rules.push_back(std::move(prev));
+                        m_stats.push_back(std::move(previousStats[p]));
+                        continue;
+                    }
+                }
+
+                CompiledRule rule;
+                rule.index = n;
+                rule.title.assign(first->ttl);
+                rule.cls.assign(first->cls);
+                rule.proc.assign(first->proc, true);
+                rule.procField = first->procField;
+                rule.hasProc = !first->proc.empty();
+                m_usesProcess = m_usesProcess || rule.hasProc;
+                m_rules.push_back(rule);
+                m_stats.push_back(first->stats ? first->stats : std::make_shared<RuleStats>());
+            }
+        }
+
+        bool empty() const { return m_rules.empty(); }
+        size_t size() const { return m_rules.size(); }
+        const CompiledRule& operator[](size_t n) const { return m_rules[n]; }
+
+        // 是否有规则需要进程属性，没有时调用方可以跳过进程信息的查询
+        bool usesProcess() const { return m_usesProcess; }
+
+        // 是否统计每条规则的评估次数和匹配耗时（规则分析器），默认关闭
+        void setProfiling(bool on) { m_profiling = on; }
+        bool profiling() const { return m_profiling; }
+
+        // 完整匹配，返回第一个匹配规则在规则集中的位置，没有匹配时返回npos。
+        // titleCandidates非空时收集类名和进程匹配、但标题暂不匹配的规则，
+        // 窗口标题变化时只需用matchTitle()重新评估这些规则。
+        // profile非空时统计记入profile（需先reset()），否则直接记入共享的统计表。
+        // 没有启用分析时只记录匹配。
+        size_t match(const RuleTarget& target, std::vector<size_t>* titleCandidates = nullptr,
+            RuleProfile* profile = nullptr) const
+        {
+            if (titleCandidates)
+                titleCandidates->clear();
+            if (!m_profiling)
+                profile = nullptr;
+            size_t n = m_profiling ? matchRules<true>(target, titleCandidates, profile)
+                                   : matchRules<false>(target, titleCandidates, nullptr);
+            if (n != npos)
+                recordMatch(n, profile);
+            return n;
+        }
+
+        // 匹配一批目标，matched[n]为第n个目标匹配的规则位置（没有匹配时为npos）。
+        // 目标分段交给多个工作线程，每个线程只写入自己负责的区段，
+        // 启用分析时统计先记入各线程自己的RuleProfile，匹配结束后再合并。
+        // fill(n, target)填充第n个目标，会在多个线程中同时调用。
+        // workers为0时按处理器数和工作量决定线程数。
+        template <typename Fill>
+        void matchAll(size_t count, Fill fill, std::vector<size_t>& matched, size_t workers = 0) const
+        {
+            matched.assign(count, npos);
+            auto matchRange = [&](size_t first, size_t last, RuleProfile* profile) {
+                if (profile)
+                    profile->reset(m_rules.size());
+                for (size_t n = first; n < last; ++n) {
+                    RuleTarget target;
+                    fill(n, target);
+                    matched[n] = match(target, nullptr, profile);
+                }
+            };
+
+            // 工作量较小时直接在当前线程匹配，省去创建线程的开销
+            if (!workers) {
+                workers = (std::min)(size_t(std::thread::hardware_concurrency()), MAX_WORKERS);
+                if (workers < 2 || count * m_rules.size() < MIN_PARALLEL_WORK)
+                    workers = 1;
+            }
+            std::vector<RuleProfile> profiles(m_profiling ? workers : 0);
+            auto profileOf = [&](size_t w) { return m_profiling ? &profiles[w] : nullptr; };
+            if (workers == 1) {
+                matchRange(0, count, profileOf(0));
+            }
+            else {
+                const size_t chunk = (count + workers - 1) / workers;
+                std::vector<std::thread> pool;
+                for (size_t first = chunk, w = 1; first < count; first += chunk, ++w)
+                    pool.emplace_back(matchRange, first, (std::min)(first + chunk, count), profileOf(w));
+                matchRange(0, (std::min)(chunk, count), profileOf(0));
+                for (auto& worker : pool)
+                    worker.join();
+            }
+            for (const auto& profile : profiles)
+                commit(profile);
+        }
+
+        static constexpr size_t MIN_PARALLEL_WORK = 20000;  // 并行匹配的最小工作量（目标数 × 规则数）
+        static constexpr size_t MAX_WORKERS = 8;
+
+        // 只评估候选规则的标题模式（类名和进程已经匹配）
+        size_t matchTitle(std::wstring_view title, const std::vector<size_t>& candidates) const
+        {
+            for (size_t n : candidates) {
+                if (n < m_rules.size() && (m_profiling
+                        ? evaluate(n, nullptr, [&] { return m_rules[n].title.match(title); })
+                        : m_rules[n].title.match(title))) {
+                    recordMatch(n, nullptr);
+                    return n;
+                }
+            }
+            return npos;
+        }
+
+        // 记录匹配规则的图钉创建结果
+        void recordPin(size_t n, bool created) const
+        {
+            if (n < m_rules.size())
+                m_stats[n]->recordPin(created);
+        }
+
+        // 把线程本地的统计合并到共享的统计表
+        void commit(const RuleProfile& profile) const
+        {
+            for (size_t n = 0; n < m_rules.size() && n < profile.m_entries.size(); ++n) {
+                const RuleProfile::Entry& entry = profile.m_entries[n];
+                RuleStats& stats = *m_stats[n];
+                if (entry.evaluations)
+                    stats.evaluations.fetch_add(entry.evaluations, std::memory_order_relaxed);
+                if (entry.matchTime)
+                    stats.matchTime.fetch_add(entry.matchTime, std::memory_order_relaxed);
+                if (entry.matches) {
+                    stats.matches.fetch_add(entry.matches - 1, std::memory_order_relaxed);
+                    stats.recordMatch(entry.lastMatch);
+                }
+            }
+        }
+
+    private:
+        std::vector<CompiledRule> m_rules;
+        std::vector<std::shared_ptr<RuleStats>> m_stats;    // 与 m_rules 一一对应
+        bool m_usesProcess = false;
+        bool m_profiling = false;
+
+        // 按顺序评估规则，返回第一个匹配的规则（不记录匹配）。
+        // 分析关闭时是不含任何统计的循环，匹配的记录放在循环之外，不影响循环的代码
+        template <bool Profiling>
+        size_t matchRules(const RuleTarget& target, std::vector<size_t>* titleCandidates, RuleProfile* profile) const
+        {
+            if constexpr (!Profiling) {
+                for (size_t n = 0; n < m_rules.size(); ++n) {
+                    const CompiledRule& rule = m_rules[n];
+                    if (!rule.cls.match(target.cls) || !rule.matchProcess(target))
+                        continue;
+                    if (rule.title.match(target.title))
+                        return n;
+                    if (titleCandidates)
+                        titleCandidates->push_back(n);
+                }
+                return npos;
+            }
+            else {
+                for (size_t n = 0; n < m_rules.size(); ++n) {
+                    const CompiledRule& rule = m_rules[n];
+                    bool clsMatched = false;
+                    bool matched = evaluate(n, profile, [&] {
+                        clsMatched = rule.cls.match(target.cls) && rule.matchProcess(target);
+                        return clsMatched && rule.title.match(target.title);
+                    });
+                    if (matched)
+                        return n;
+                    if (clsMatched && titleCandidates)
+                        titleCandidates->push_back(n);
+                }
+                return npos;
+            }
+        }
+
+        // 评估一条规则并计入统计，部分评估抽样计时（只在启用分析时调用）
+        template <typename Fn>
+        bool evaluate(size_t n, RuleProfile* profile, Fn fn) const
+        {
+            RuleStats& stats = *m_stats[n];
+            if (!(profile ? profile->countEvaluation(n) : stats.countEvaluation()))
+                return fn();
+
+            auto start = std::chrono::steady_clock::now();
+            bool result = fn();
+            uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count()) * RuleStats::TIME_SAMPLE_RATE;
+            if (profile)
+                profile->addTime(n, ns);
+            else
+                stats.matchTime.fetch_add(ns, std::memory_order_relaxed);
+            return result;
+        }
+
+        void recordMatch(size_t n, RuleProfile* profile) const
+        {
+            if (profile)
+                profile->recordMatch(n, unixTimeMs());
+            else
+                m_stats[n]->recordMatch(unixTimeMs());
+        }
+    };
+
+} // namespace Pin
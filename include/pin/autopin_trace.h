@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Pin {
+
+    // 自动图钉和图钉跟踪事件的二进制轨迹格式。
+    // 与具体窗口系统无关，录制端（程序本身）和回放端（tools/AutoPinReplay）共用。
+    //
+    // 文件结构：
+    //   文件头   "TPTR" + 版本号(1字节)
+    //   记录     类型(1字节) + 距上一条记录的毫秒数(varint) + 内容
+    //
+    // 整数使用LEB128变长编码，有符号整数先做zigzag编码；
+    // 字符串为UTF-16代码单元数(varint) + 小端UTF-16数据。
+    //
+    namespace Trace {
+
+        const char MAGIC[4] = { 'T', 'P', 'T', 'R' };
+        const uint8_t VERSION = 1;
+        const size_t HEADER_SIZE = sizeof(MAGIC) + 1;
+
+        enum class RecordType : uint8_t {
+            WindowCreated = 1,  // 通过过滤的窗口创建事件
+            TitleChanged = 2,   // 最近入队窗口的标题变化事件
+            PinTracked = 3,     // 图钉跟踪时目标窗口的位置变化
+        };
+
+        struct Record {
+            RecordType type = RecordType::WindowCreated;
+            uint64_t time = 0;          // 距录制开始的毫秒数
+            uint64_t wnd = 0;           // 窗口句柄
+            uint32_t pid = 0;           // WindowCreated
+            std::wstring title;         // WindowCreated、TitleChanged
+            std::wstring cls;           // WindowCreated
+            std::wstring imageName;     // WindowCreated（小写）
+            std::wstring imagePath;     // WindowCreated（小写）
+            std::wstring packageFamily; // WindowCreated（小写）
+            int32_t left = 0, top = 0, right = 0, bottom = 0;  // PinTracked
+        };
+
+
+        // 将记录编码到内存缓冲区，由调用方决定何时写入文件。
+        //
+        class Writer {
+        public:
+            std::vector<uint8_t>& buffer() { return m_buf; }
+
+            void writeHeader()
+            {
+                m_buf.insert(m_buf.end(), MAGIC, MAGIC + sizeof(MAGIC));
+                m_buf.push_back(VERSION);
+            }
+
+            void write(const Record& rec)
+            {
+                m_buf.push_back(static_cast<uint8_t>(rec.type));
+                // 时间倒退（不应发生）时记为0，保证解码后的时间单调
+                putVarint(rec.time > m_lastTime ? rec.time - m_lastTime : 0);
+                if (rec.time > m_lastTime)
+                    m_lastTime = rec.time;
+                putVarint(rec.wnd);
+
+                switch (rec.type) {
+                    case RecordType::WindowCreated:
+                        putVarint(rec.pid);
+                        putString(rec.title);
+                        putString(rec.cls);
+                        putString(rec.imageName);
+                        putString(rec.imagePath);
+                        putString(rec.packageFamily);
+                        break;
+                    case RecordType::TitleChanged:
+                        putString(rec.title);
+                        break;
+                    case RecordType::PinTracked:
+                        putSigned(rec.left);
+                        putSigned(rec.top);
+                        putSigned(rec.right);
+                        putSigned(rec.bottom);
+                        break;
+                }
+            }
+
+        private:
+            std::vector<uint8_t> m_buf;
+            uint64_t m_lastTime = 0;
+
+            void putVarint(uint64_t v)
+            {
+                while (v >= 0x80) {
+                    m_buf.push_back(static_cast<uint8_t>(v | 0x80));
+                    v >>= 7;
+                }
+                m_buf.push_back(static_cast<uint8_t>(v));
+            }
+
+            void putSigned(int32_t v)
+            {
+                putVarint((static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31));
+            }
+
+            void putUnit(uint16_t u)
+            {
+                m_buf.push_back(static_cast<uint8_t>(u));
+                m_buf.push_back(static_cast<uint8_t>(u >> 8));
+            }
+
+            void putString(const std::wstring& s)
+            {
+                size_t units = 0;
+                for (wchar_t ch : s)
+                    units += static_cast<uint32_t>(ch) > 0xFFFF ? 2 : 1;
+                putVarint(units);
+                for (wchar_t ch : s) {
+                    uint32_t cp = static_cast<uint32_t>(ch);
+                    if (cp > 0xFFFF) {
+                        // 32位wchar_t平台上的增补字符拆成代理对
+                        cp -= 0x10000;
+                        putUnit(static_cast<uint16_t>(0xD800 + (cp >> 10)));
+                        putUnit(static_cast<uint16_t>(0xDC00 + (cp & 0x3FF)));
+                    }
+                    else {
+                        putUnit(static_cast<uint16_t>(cp));
+                    }
+                }
+            }
+        };
+
+
+        // 从内存缓冲区解码记录。
+        //
+        class Reader {
+        public:
+            Reader(const uint8_t* data, size_t size) : m_cur(data), m_end(data + size) {}
+
+            // 检查并跳过文件头
+            bool readHeader()
+            {
+                if (size_t(m_end - m_cur) < HEADER_SIZE || std::memcmp(m_cur, MAGIC, sizeof(MAGIC)) != 0)
+                    return false;
+                if (m_cur[sizeof(MAGIC)] != VERSION)
+                    return false;
+                m_cur += HEADER_SIZE;
+                return true;
+            }
+
+            // 读取下一条记录。数据结束或损坏时返回false，可用corrupt()区分。
+            bool next(Record& rec)
+            {
+                if (m_cur == m_end)
+                    return false;
+
+                uint8_t type = *m_cur++;
+                uint64_t delta, wnd;
+                if (!getVarint(delta) || !getVarint(wnd))
+                    return fail();
+                m_time += delta;
+
+                rec = Record();
+                rec.type = static_cast<RecordType>(type);
+                rec.time = m_time;
+                rec.wnd = wnd;
+
+                switch (rec.type) {
+                    case RecordType::WindowCreated: {
+                        uint64_t pid;
+                        if (!getVarint(pid) || !getString(rec.title) || !getString(rec.cls) ||
+                            !getString(rec.imageName) || !getString(rec.imagePath) ||
+                            !getString(rec.packageFamily))
+                            return fail();
+                        rec.pid = static_cast<uint32_t>(pid);
+                        break;
+                    }
+                    case RecordType::TitleChanged:
+                        if (!getString(rec.title))
+                            return fail();
+                        break;
+                    case RecordType::PinTracked:
+                        if (!getSigned(rec.left) || !getSigned(rec.top) ||
+                            !getSigned(rec.right) || !getSigned(rec.bottom))
+                            return fail();
+                        break;
+                    default:
+                        return fail();
+                }
+                return true;
+            }
+
+            bool corrupt() const { return m_corrupt; }
+
+        private:
+            const uint8_t* m_cur;
+            const uint8_t* m_end;
+            uint64_t m_time = 0;
+            bool m_corrupt = false;
+
+            bool fail()
+            {
+                m_corrupt = true;
+                m_cur = m_end;
+                return false;
+            }
+
+            bool getVarint(uint64_t& v)
+            {
+                v = 0;
+                for (int shift = 0; shift < 64 && m_cur != m_end; shift += 7) {
+                    uint8_t b = *m_cur++;
+                    v |= uint64_t(b & 0x7F) << shift;
+                    if (!(b & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            bool getSigned(int32_t& v)
+            {
+                uint64_t u;
+                if (!getVarint(u))
+                    return false;
+                uint32_t z = static_cast<uint32_t>(u);
+                v = static_cast<int32_t>((z >> 1) ^ (0u - (z & 1)));
+                return true;
+            }
+
+            bool getString(std::wstring& s)
+            {
+                uint64_t units;
+                if (!getVarint(units) || units > size_t(m_end - m_cur) / 2)
+                    return false;
+                s.clear();
+                s.reserve(static_cast<size_t>(units));
+                for (uint64_t n = 0; n < units; ++n, m_cur += 2) {
+                    uint32_t u = m_cur[0] | (uint32_t(m_cur[1]) << 8);
+                    if (sizeof(wchar_t) > 2 && u >= 0xD800 && u < 0xDC00 && n + 1 < units) {
+                        // 32位wchar_t平台上把代理对合并为一个字符
+                        uint32_t lo = m_cur[2] | (uint32_t(m_cur[3]) << 8);
+                        if (lo >= 0xDC00 && lo < 0xE000) {
+                            u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+                            m_cur += 2;
+                            ++n;
+                        }
+                    }
+                    s.push_back(static_cast<wchar_t>(u));
+                }
+                return true;
+            }
+        };
+
+    } // namespace Trace
+
+} // namespace Pin
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "pin/autopin_trace.h"
+
+namespace Pin {
+
+    // 自动图钉和图钉跟踪事件的录制器。
+    // 把通过过滤的窗口创建、标题变化和图钉跟踪时的窗口位置写入轨迹文件，
+    // 供 tools/AutoPinReplay 离线回放。未录制时各记录函数只检查一个标志。
+    // 所有调用都发生在UI线程上。
+    //
+    class EventRecorder {
+    public:
+        static EventRecorder& getInstance();
+
+        // 开始录制到指定文件（覆盖已有文件）
+        bool start(const std::wstring& path);
+        // 停止录制并写入剩余数据
+        void stop();
+
+        bool isRecording() const { return m_file != INVALID_HANDLE_VALUE; }
+
+        void windowCreated(HWND wnd) { if (isRecording()) recordCreated(wnd); }
+        void titleChanged(HWND wnd) { if (isRecording()) recordTitle(wnd); }
+        // 只记录位置发生变化的跟踪
+        void pinTracked(HWND wnd, const RECT& rc) { if (isRecording()) recordTracked(wnd, rc); }
+
+    private:
+        static constexpr size_t FLUSH_SIZE = 64 * 1024;
+        static constexpr size_t MAX_TRACKED = 64;
+
+        EventRecorder() = default;
+        ~EventRecorder() { stop(); }
+        EventRecorder(const EventRecorder&) = delete;
+        EventRecorder& operator=(const EventRecorder&) = delete;
+
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        ULONGLONG m_start = 0;
+        Trace::Writer m_writer;
+        std::vector<std::pair<HWND, RECT>> m_lastRects;  // 每个被跟踪窗口上次记录的位置
+
+        void recordCreated(HWND wnd);
+        void recordTitle(HWND wnd);
+        void recordTracked(HWND wnd, const RECT& rc);
+        void append(Trace::Record& rec);
+        void flush();
+    };
+
+} // namespace Pin
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace Pin {
+
+    // 图钉在目标窗口标题栏上的位置计算。
+    // 与具体窗口系统无关，图钉窗口和事件回放工具共用。
+    //
+    struct CaptionPlacement {
+        int x;
+        int y;
+    };
+
+    // 传统应用的图钉位于标题栏中央、窗口顶部下方20像素处；
+    // 现代应用的标题栏布局不同，图钉更靠近顶部，并限制在工作区内。
+    //
+    inline CaptionPlacement placeOnCaption(int left, int top, int right, int pinWidth, bool modern)
+    {
+        CaptionPlacement pos;
+        pos.x = left + (right - left - pinWidth) / 2;
+        pos.y = top + (modern ? 15 : 20);
+        return pos;
+    }
+
+    // 确保图钉不会超出工作区的左、右、上边界
+    inline void clampToWorkArea(CaptionPlacement& pos, int pinWidth,
+        int areaLeft, int areaTop, int areaRight)
+    {
+        if (pos.x < areaLeft) pos.x = areaLeft;
+        if (pos.x + pinWidth > areaRight) pos.x = areaRight - pinWidth;
+        if (pos.y < areaTop) pos.y = areaTop;
+    }
+
+} // namespace Pin
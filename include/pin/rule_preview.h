@@ -0,0 +1,149 @@
+#pragma once
+
+#include "pin/auto_pin_rules.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Pin {
+
+    // 编辑规则时的匹配预览。
+    // 对一份窗口快照评估正在编辑的规则，规则编译为 CompiledRule，
+    // 匹配逻辑与自动图钉完全相同，预览和实际运行的结果一致。
+    //
+    // 每次更新是增量的：
+    //  - 标题、类名、进程三个模式分别比较，只重新编译变化的模式；
+    //  - 只有标题模式变化时，只对类名和进程已经匹配的窗口重新评估标题；
+    //  - 只有类名或进程模式变化时，已经为当前标题模式评估过的窗口不再评估标题；
+    //  - 结果以相对上次的删除和插入位置给出，界面只需更新变化的行。
+    //
+    // 预览不记录匹配统计，不影响规则的统计。只依赖标准库。
+    //
+    class RulePreview {
+    public:
+        // 快照中的一个窗口，字符串由预览保存
+        struct Window {
+            uintptr_t id = 0;           // 调用方的窗口标识（如窗口句柄）
+            std::wstring title;
+            std::wstring cls;
+            std::wstring imageName;     // 进程属性，已转换为小写
+            std::wstring imagePath;
+            std::wstring packageFamily;
+        };
+
+        void setWindows(std::vector<Window> windows)
+        {
+            m_windows = std::move(windows);
+            m_state.assign(m_windows.size(), State());
+            m_matched.clear();
+            m_compiled = false;
+        }
+
+        size_t windowCount() const { return m_windows.size(); }
+        const Window& window(size_t n) const { return m_windows[n]; }
+
+        // 匹配的窗口在快照中的位置（升序）
+        const std::vector<size_t>& matched() const { return m_matched; }
+
+        // 上次 update() 的变化：removed 为旧结果中的位置（降序），
+        // inserted 为新结果中的位置（升序）。先按 removed 删除，再按 inserted 插入。
+        const std::vector<size_t>& removed() const { return m_removed; }
+        const std::vector<size_t>& inserted() const { return m_inserted; }
+
+        // 用规则的当前内容更新预览，结果变化时返回true。
+        // 规则类型需要有 ttl/cls/proc/procField 成员，不考虑规则是否启用。
+        template <typename Rule>
+        bool update(const Rule& rule)
+        {
+            bool titleChanged = !m_compiled || m_rule.title.pattern() != rule.ttl;
+            bool clsChanged = !m_compiled || m_rule.cls.pattern() != rule.cls;
+            bool procChanged = !m_compiled || m_rule.proc.pattern() != rule.proc || m_rule.procField != rule.procField;
+            m_removed.clear();
+            m_inserted.clear();
+            if (!titleChanged && !clsChanged && !procChanged)
+                return false;
+
+            if (titleChanged) {
+                m_rule.title.assign(rule.ttl);
+                ++m_titleGen;
+            }
+            if (clsChanged)
+                m_rule.cls.assign(rule.cls);
+            if (procChanged) {
+                m_rule.proc.assign(rule.proc, true);
+                m_rule.procField = rule.procField;
+                m_rule.hasProc = !rule.proc.empty();
+            }
+            m_compiled = true;
+
+            std::vector<size_t> matched;
+            for (size_t n = 0; n < m_windows.size(); ++n) {
+                State& state = m_state[n];
+                RuleTarget target = makeTarget(m_windows[n]);
+                if (clsChanged || procChanged)
+                    state.clsMatch = m_rule.cls.match(target.cls) && m_rule.matchProcess(target);
+                if (state.clsMatch && state.titleGen != m_titleGen) {
+                    state.titleMatch = m_rule.title.match(target.title);
+                    state.titleGen = m_titleGen;
+                }
+                if (state.clsMatch && state.titleMatch)
+                    matched.push_back(n);
+            }
+
+            diff(matched);
+            m_matched.swap(matched);
+            return !m_removed.empty() || !m_inserted.empty();
+        }
+
+    private:
+        struct State {
+            bool clsMatch = false;      // 类名和进程模式是否匹配
+            bool titleMatch = false;    // 标题模式是否匹配（titleGen为当前代时有效）
+            uint32_t titleGen = 0;
+        };
+
+        std::vector<Window> m_windows;
+        std::vector<State> m_state;
+        std::vector<size_t> m_matched;
+        std::vector<size_t> m_removed;
+        std::vector<size_t> m_inserted;
+
+        CompiledRule m_rule{};          // 只使用三个模式和进程字段，m_compiled为true时有效
+        bool m_compiled = false;
+        uint32_t m_titleGen = 0;        // 标题模式每变化一次加一
+
+        static RuleTarget makeTarget(const Window& w)
+        {
+            RuleTarget target;
+            target.title = w.title;
+            target.cls = w.cls;
+            target.imageName = w.imageName;
+            target.imagePath = w.imagePath;
+            target.packageFamily = w.packageFamily;
+            return target;
+        }
+
+        // 比较两个升序的结果，得到删除和插入的位置
+        void diff(const std::vector<size_t>& now)
+        {
+            size_t i = 0, j = 0;
+            while (i < m_matched.size() || j < now.size()) {
+                if (j == now.size() || (i < m_matched.size() && m_matched[i] < now[j])) {
+                    m_removed.push_back(i++);
+                }
+                else if (i == m_matched.size() || now[j] < m_matched[i]) {
+                    m_inserted.push_back(j++);
+                }
+                else {
+                    ++i;
+                    ++j;
+                }
+            }
+            std::reverse(m_removed.begin(), m_removed.end());
+        }
+    };
+
+} // namespace Pin
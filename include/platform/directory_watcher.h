@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/common.h"
+#include "foundation/file_watcher.h"
+#include <string>
+#include <thread>
+
+namespace Platform {
+
+    // 目录变化通知（Foundation::FileWatcher的Win32实现）。
+    // 在后台线程中等待目录中文件的写入、创建、删除和重命名，有变化时调用回调。
+    //
+    class DirectoryWatcher : public Foundation::FileWatcher, noncopyable {
+    public:
+        ~DirectoryWatcher() { stop(); }
+
+        bool start(const std::wstring& dir, Callback onChange) override;
+        void stop() override;
+
+    private:
+        HANDLE m_change = INVALID_HANDLE_VALUE;
+        HANDLE m_stopEvent = nullptr;
+        std::thread m_thread;
+
+        void run(Callback onChange);
+    };
+
+} // namespace Platform
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "core/common.h"
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace Platform {
 
@@ -30,4 +33,49 @@ namespace Platform {
         HANDLE m_mutex;
     };
 
+    // 进程元数据。所有字段均为小写，供不区分大小写的规则匹配使用。
+    struct ProcessInfo {
+        std::wstring imagePath;      // 映像完整路径
+        std::wstring imageName;      // 映像文件名
+        std::wstring packageFamily;  // 包系列名，非打包应用为空
+    };
+
+    // 进程元数据缓存。
+    // 每个PID只调用一次OpenProcess查询，结果在一段时间内复用；
+    // 超时后重新查询，以应对PID被系统复用。容量有限，满时淘汰最久未使用的项。
+    //
+    class ProcessInfoCache {
+    public:
+        static constexpr size_t MAX_ENTRIES = 128;
+        static constexpr ULONGLONG ENTRY_TTL = 60000;  // 毫秒
+
+        // 获取单例实例
+        static ProcessInfoCache& getInstance();
+
+        // 获取进程信息，缓存未命中时立即查询。查询失败时返回各字段为空的信息。
+        std::shared_ptr<const ProcessInfo> lookup(DWORD pid);
+
+        // 获取窗口所属进程的信息
+        std::shared_ptr<const ProcessInfo> lookupWindow(HWND wnd);
+
+        // 清空缓存
+        void clear();
+
+    private:
+        ProcessInfoCache() = default;
+        ProcessInfoCache(const ProcessInfoCache&) = delete;
+        ProcessInfoCache& operator=(const ProcessInfoCache&) = delete;
+
+        static std::shared_ptr<const ProcessInfo> query(DWORD pid);
+
+        struct Entry {
+            DWORD pid;
+            ULONGLONG created;   // 查询时间
+            ULONGLONG lastUse;   // 最近使用时间
+            std::shared_ptr<const ProcessInfo> info;
+        };
+        std::vector<Entry> m_entries;
+        std::mutex m_mutex;
+    };
+
 } // namespace Platform
\ No newline at end of file
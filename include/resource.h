@@ -72,6 +72,14 @@
 #define IDC_PIN_ICON_FILE               1080
 #define IDC_PIN_ICON_CHANGE             1081
 #define IDC_PIN_ICON_RESET              1082
+#define IDC_PROC_FIELD                  1083
+#define IDC_PROC                        1084
+#define IDC_EXPORT_STATS                1085
+#define IDC_IMPORT_RULES                1086
+#define IDC_RULE_FILTER                 1087
+#define IDC_RULE_PREVIEW                1088
+#define IDC_RULE_PREVIEW_GROUP          1089
+#define IDC_RULE_PREVIEW_COUNT          1090
 
 // 静态文本控件ID（用于本地化）
 #define IDC_ABOUT_VERSION               1056
@@ -93,6 +101,7 @@
 #define IDC_HOTKEYS_PINMODE_LABEL       1072
 #define IDC_HOTKEYS_TOGGLE_LABEL        1073
 #define IDC_LANG_INTERFACE_GROUP        1074
+#define IDC_RULE_PROC_LABEL             1075
 
 // 属性表选项卡标题常量
 #define IDC_TAB_PINS_TITLE              1076
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 控件映射结构
+struct ControlMapping {
+    int controlId;
+    std::wstring dialogName;
+    std::wstring elementName;
+};
+
+// 控件文本的稠密索引。
+// 控件映射按编号连续存放；控件ID（16位）经两级数组得到编号：高8位选页，低8位为页内位置。
+// 对话框名称登记为编号（0为空名称，使用控件映射中的对话框），
+// 已解析的文本按 对话框编号 * 控件数 + 控件编号 排列，每个组合在 reset() 前只解析一次。
+// 只依赖标准库，文本的来源由调用方在 text() 中提供。
+//
+class ControlTextTable {
+public:
+    // 为控件映射分配编号（Map为控件ID到ControlMapping的映射）。
+    // 映射的地址在表的生命周期内不能改变
+    template <typename Map>
+    void build(const Map& mappings)
+    {
+        m_controls.clear();
+        m_controlDialogs.clear();
+        m_pageIndex.assign(256, NO_PAGE);
+        m_pages.clear();
+        if (m_dialogNames.empty())
+            m_dialogNames.push_back(std::wstring());
+
+        for (const auto& entry : mappings) {
+            int controlId = entry.first;
+            if (controlId < 0 || controlId > 0xFFFF)
+                continue;
+
+            uint16_t& page = m_pageIndex[controlId >> 8];
+            if (page == NO_PAGE) {
+                page = uint16_t(m_pages.size() / 256);
+                m_pages.resize(m_pages.size() + 256, NO_SLOT);
+            }
+            m_pages[page * 256 + (controlId & 0xFF)] = uint16_t(m_controls.size());
+            m_controls.push_back(&entry.second);
+            m_controlDialogs.push_back(dialogIndex(entry.second.dialogName));
+        }
+        m_texts.assign(m_dialogNames.size() * m_controls.size(), std::wstring_view());
+    }
+
+    // 对话框名称的编号。空名称为0，其他名称第一次使用时登记，编号在表的生命周期内不变
+    int dialogIndex(const std::wstring& dialogName)
+    {
+        if (dialogName.empty())
+            return 0;
+        for (size_t i = 1; i < m_dialogNames.size(); ++i) {
+            if (m_dialogNames[i] == dialogName)
+                return int(i);
+        }
+
+        // 新的对话框名称：为每个控件增加一组文本
+        m_dialogNames.push_back(dialogName);
+        m_texts.resize(m_dialogNames.size() * m_controls.size());
+        return int(m_dialogNames.size() - 1);
+    }
+
+    // 根据控件ID查找映射的编号，没有映射时返回-1
+    int findSlot(int controlId) const
+    {
+        if (controlId < 0 || controlId > 0xFFFF || m_pageIndex.empty())
+            return -1;
+        uint16_t page = m_pageIndex[controlId >> 8];
+        if (page == NO_PAGE)
+            return -1;
+        uint16_t slot = m_pages[page * 256 + (controlId & 0xFF)];
+        return slot == NO_SLOT ? -1 : int(slot);
+    }
+
+    size_t size() const { return m_controls.size(); }
+    size_t pageCount() const { return m_pages.size() / 256; }
+    const ControlMapping& mapping(int slot) const { return *m_controls[slot]; }
+
+    // 控件在指定对话框编号下使用的对话框名称（编号0时为控件映射中的对话框）
+    const std::wstring& dialogName(int slot, int dialog) const
+    {
+        return m_dialogNames[dialog ? dialog : m_controlDialogs[slot]];
+    }
+
+    // 语言文件中的键：tray.元素、strings.元素 或 dialogs.对话框.元素
+    std::wstring textKey(int slot, int dialog) const
+    {
+        const std::wstring& dialogName = this->dialogName(slot, dialog);
+        const std::wstring& element = m_controls[slot]->elementName;
+        if (dialogName == L"tray" || dialogName == L"strings")
+            return dialogName + L"." + element;
+        return L"dialogs." + dialogName + L"." + element;
+    }
+
+    // 已解析的文本，尚未解析时调用 resolve(slot, dialog) 并保存结果。
+    // 没有映射或对话框编号无效时返回空字符串
+    template <typename Resolve>
+    std::wstring_view text(int controlId, int dialog, Resolve resolve)
+    {
+        int slot = findSlot(controlId);
+        if (slot < 0 || dialog < 0 || size_t(dialog) >= m_dialogNames.size())
+            return std::wstring_view(L"");
+
+        std::wstring_view& text = m_texts[size_t(dialog) * m_controls.size() + slot];
+        if (!text.data())
+            text = resolve(slot, dialog);
+        return text;
+    }
+
+    // 清空已解析的文本（加载语言后调用）
+    void reset()
+    {
+        m_texts.assign(m_texts.size(), std::wstring_view());
+    }
+
+private:
+    static constexpr uint16_t NO_PAGE = 0xFFFF;
+    static constexpr uint16_t NO_SLOT = 0xFFFF;
+
+    std::vector<const ControlMapping*> m_controls;
+    std::vector<int> m_controlDialogs;          // 控件映射中对话框名称的编号
+    std::vector<uint16_t> m_pageIndex;          // 高8位 -> 页号
+    std::vector<uint16_t> m_pages;              // 每页256项，控件编号
+    std::vector<std::wstring> m_dialogNames;    // 对话框编号 -> 名称
+    std::vector<std::wstring_view> m_texts;     // data()为空表示尚未解析
+};
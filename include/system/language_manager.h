@@ -1,15 +1,15 @@
 #pragma once
 
+#include "system/control_text_table.h"
+#include "system/locale_table.h"
+#include "system/locale_manifest.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
-
-// 控件映射结构
-struct ControlMapping {
-    int controlId;
-    std::wstring dialogName;
-    std::wstring elementName;
-};
+#include <mutex>
+#include <deque>
+#include <string_view>
+#include <vector>
 
 // 语言管理器类
 // 负责加载和管理多语言资源
@@ -41,12 +41,24 @@ public:
     // 获取当前语言代码
     const std::wstring& getCurrentLanguage() const { return m_currentLanguage; }
     
-    // 获取本地化字符串
+    // 获取本地化字符串。结果（包括回退到RC资源和找不到时返回的键名）按当前语言缓存，
+    // 同一个键在切换语言前只解析一次
     std::wstring getString(const std::wstring& key) const;
     
+    // 当前语言中缺少翻译的键数（getString 用到的键中语言文件和RC资源都没有的），用于检查翻译是否完整
+    size_t getMissingStringCount() const;
+    
     // 根据控件ID获取本地化文本
     std::wstring getControlText(int controlId, const std::wstring& dialogName = L"") const;
     
+    // 对话框名称的编号，用于 controlText()。空名称为0（使用控件映射中的对话框），
+    // 其他名称第一次使用时登记，编号在程序运行期间不变
+    int dialogIndex(const std::wstring& dialogName) const;
+    
+    // 按控件ID和对话框编号获取本地化文本，每个控件和对话框的组合在每次加载语言后只解析一次。
+    // 返回的视图在下次切换语言前有效
+    std::wstring_view controlText(int controlId, int dialog) const;
+    
     // 获取可用语言列表
     std::vector<std::pair<std::wstring, std::wstring>> getAvailableLanguages() const;
     
@@ -68,15 +80,15 @@ private:
     LanguageManager(const LanguageManager&) = delete;
     LanguageManager& operator=(const LanguageManager&) = delete;
     
-    // 加载语言文件
+    // 加载语言文件：优先使用最近用过的表，否则映射预编译文件，不存在或已过期时从JSON重新编译
     bool loadLanguageFile(const std::wstring& languageCode);
     
-    // 解析JSON文件
-    bool parseJsonFile(const std::wstring& filePath);
-    
     // 获取系统语言
     std::wstring getSystemLanguage() const;
     
+    // 获取语言文件目录（以路径分隔符结尾）
+    std::wstring getLanguageDirectory() const;
+    
     // 获取语言文件路径
     std::wstring getLanguageFilePath(const std::wstring& languageCode) const;
     
@@ -86,8 +98,17 @@ private:
     // 初始化控件映射
     void initializeControlMappings();
     
-    // 根据控件ID查找映射
-    const ControlMapping* findControlMapping(int controlId) const;
+    // 解析一个控件在指定对话框中的文本
+    std::wstring_view resolveControlText(int slot, int dialog) const;
+    
+    // 加载语言后清空已解析的控件文本
+    void resetControlTexts();
+    
+    // 解析字符串：语言文件、strings前缀、RC资源，都没有时返回键名并设置 missing
+    std::wstring resolveString(const LocaleTable* table, const std::wstring& key, bool& missing) const;
+    
+    // 字符串缓存使用的键哈希
+    static uint64_t hashStringKey(const std::wstring& key);
     
     // 初始化字符串键到RC资源ID的映射
     void initializeStringResourceMappings();
@@ -97,17 +118,41 @@ private:
 
 private:
     std::wstring m_currentLanguage;
-    std::unordered_map<std::wstring, std::wstring> m_strings;
+    std::shared_ptr<const LocaleTable> m_table;                 // 当前语言的字符串，用 std::atomic_load/atomic_store 访问
+    std::vector<std::shared_ptr<const LocaleTable>> m_recentTables;  // 最近使用的语言，最近的在前，包含当前的表
     std::vector<std::wstring> m_availableLanguages;
     std::unordered_map<int, ControlMapping> m_controlMappings;
+    
+    mutable ControlTextTable m_controlTexts;            // 控件ID和对话框编号 -> 已解析的文本
+    mutable std::deque<std::wstring> m_fallbackTexts;   // 回退文本的存储，地址不变
     std::unordered_map<std::wstring, int> m_stringResourceMappings; // 字符串键到RC资源ID的映射
+    
+    // getString 的结果缓存，按 hashStringKey() 的哈希查找（哈希已经计算，不再对键重新哈希），
+    // 保存键用于排除哈希冲突。属于 m_stringCacheTable，当前表变化后第一次写入时清空
+    struct CachedString {
+        std::wstring key;
+        std::wstring text;
+    };
+    struct PrehashedKey {
+        size_t operator()(uint64_t hash) const { return size_t(hash ^ (hash >> 32)); }
+    };
+    mutable std::mutex m_stringCacheMutex;
+    mutable std::unordered_map<uint64_t, CachedString, PrehashedKey> m_stringCache;
+    mutable std::shared_ptr<const LocaleTable> m_stringCacheTable;
+    mutable size_t m_missingStringCount = 0;
     bool m_initialized = false;
-    mutable std::unordered_map<std::wstring, std::wstring> m_languageNameCache; // 语言名称缓存
+    mutable std::vector<LocaleManifest::Entry> m_locales; // 语言文件清单，按代码排序
     std::vector<LanguageConfig> m_supportedLanguages; // 支持的语言配置
     
-    // 扫描语言文件目录
+    // 扫描语言文件目录，用目录项中的大小和修改时间校验语言文件清单
     void scanLanguageFiles();
     
+    // 保存语言文件清单，目录不可写时忽略
+    void saveLocaleManifest() const;
+    
+    // 查找清单中的语言文件
+    const LocaleManifest::Entry* findLocale(const std::wstring& languageCode) const;
+    
     // 验证语言代码格式
     bool isValidLanguageCode(const std::wstring& langCode) const;
     
@@ -120,10 +165,7 @@ private:
     // 查找语言配置
     const LanguageConfig* findLanguageConfig(const std::wstring& languageCode) const;
     
-    // 字符串清理辅助方法
-    void trimString(std::string& str) const;
-    std::string extractJsonValue(const std::string& line, size_t colonPos) const;
-    void processEscapeSequences(std::wstring& str) const;
+    // 英文回退文本
     std::wstring getEnglishFallback(int controlId, const std::wstring& elementName) const;
 };
 
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 预编译的语言文件（assets/locales/*.bin）。
+// JSON语言文件仍然是源文件，编译结果是一个可以直接内存映射的二进制块：
+//
+//   Header      固定头部，记录源JSON的大小和修改时间，用于判断是否过期
+//   seeds[]     完美哈希的桶位移，每桶一个uint32
+//   entries[]   条目表，每个槽一个条目（键和值在字符串池中的位置和长度）
+//   pool[]      UTF-16字符串池，每个字符串以 \0 结尾（不计入长度），可以直接传给Windows API
+//
+// 查找只计算一次键的哈希，按桶位移得到唯一的槽，再比较一次键，
+// 返回指向映射内存的视图，不分配内存。所有整数为小端序。
+//
+// 完美哈希用“哈希-位移”方法构造：键按哈希分到平均4个键的桶中，
+// 从大到小为每个桶寻找一个位移，使桶内的键落到互不冲突的空槽上；
+// 只有一个键的桶直接记录槽位置。槽数等于键数，没有空槽。
+//
+// 只依赖标准库，编译工具（tools/LocaleCompiler）和程序共用。
+//
+namespace LocaleBlob {
+
+    // 字符串池的字符类型：Windows上为wchar_t，查找结果可以直接当作 std::wstring_view 使用
+#if WCHAR_MAX == 0xFFFF
+    using Char = wchar_t;
+#else
+    using Char = char16_t;
+#endif
+    using StringView = std::basic_string_view<Char>;
+
+    constexpr char MAGIC[4] = { 'T', 'P', 'L', 'B' };
+    constexpr uint32_t VERSION = 2;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;    // 源JSON文件的大小
+        uint64_t sourceTime;    // 源JSON文件的修改时间（FILETIME）
+        uint32_t seed;          // 键哈希的种子
+        uint32_t count;         // 条目数，也是槽数
+        uint32_t bucketCount;
+        uint32_t poolSize;      // 字符串池长度（字符数）
+    };
+
+    struct Entry {
+        uint32_t keyOffset;
+        uint32_t keyLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+    };
+
+    static_assert(sizeof(Header) == 40, "unexpected header layout");
+    static_assert(sizeof(Entry) == 16, "unexpected entry layout");
+
+    namespace detail {
+        constexpr uint32_t DIRECT = 0x80000000;     // 桶位移的最高位：低31位直接是槽位置
+
+        inline uint64_t mix(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        inline uint64_t hash(const Char* s, size_t n, uint32_t seed)
+        {
+            uint64_t h = 0xCBF29CE484222325ull ^ seed;
+            for (size_t i = 0; i < n; ++i)
+                h = (h ^ uint16_t(s[i])) * 0x100000001B3ull;
+            return mix(h);
+        }
+
+        inline uint32_t bucket(uint64_t h, uint32_t bucketCount)
+        {
+            return uint32_t(h % bucketCount);
+        }
+
+        inline uint32_t slot(uint64_t h, uint32_t displacement, uint32_t count)
+        {
+            if (displacement & DIRECT)
+                return displacement & ~DIRECT;
+            return uint32_t(mix((h >> 32 | h << 32) + displacement * 0x9E3779B97F4A7C15ull) % count);
+        }
+
+        // 宽字符串转换为池中的字符，wchar_t为32位时拆分为代理对
+        inline void append(std::basic_string<Char>& out, std::wstring_view s)
+        {
+            for (wchar_t ch : s) {
+                uint32_t cp = uint32_t(ch);
+                if (sizeof(wchar_t) > 2 && cp >= 0x10000) {
+                    cp -= 0x10000;
+                    out += Char(0xD800 + (cp >> 10));
+                    out += Char(0xDC00 + (cp & 0x3FF));
+                }
+                else {
+                    out += Char(cp);
+                }
+            }
+        }
+    }
+
+    // 只读视图，指向映射的文件或内存中的二进制块
+    class View {
+    public:
+        // 检查头部和所有条目的范围，无效时返回false
+        bool open(const void* data, size_t size)
+        {
+            close();
+            if (!data || size < sizeof(Header))
+                return false;
+
+            const char* base = static_cast<const char*>(data);
+            const Header* header = reinterpret_cast<const Header*>(base);
+            if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION)
+                return false;
+            if ((header->count == 0) != (header->bucketCount == 0) || header->count >= detail::DIRECT)
+                return false;
+
+            uint64_t expected = sizeof(Header) + uint64_t(header->bucketCount) * sizeof(uint32_t)
+                + uint64_t(header->count) * sizeof(Entry) + uint64_t(header->poolSize) * sizeof(Char);
+            if (expected != size)
+                return false;
+
+            const uint32_t* seeds = reinterpret_cast<const uint32_t*>(base + sizeof(Header));
+            const Entry* entries = reinterpret_cast<const Entry*>(seeds + header->bucketCount);
+            for (uint32_t b = 0; b < header->bucketCount; ++b) {
+                if ((seeds[b] & detail::DIRECT) && (seeds[b] & ~detail::DIRECT) >= header->count)
+                    return false;
+            }
+            const Char* pool = reinterpret_cast<const Char*>(entries + header->count);
+            for (uint32_t i = 0; i < header->count; ++i) {
+                const Entry& e = entries[i];
+                if (uint64_t(e.keyOffset) + e.keyLength >= header->poolSize ||
+                    uint64_t(e.valueOffset) + e.valueLength >= header->poolSize ||
+                    pool[e.keyOffset + e.keyLength] != 0 || pool[e.valueOffset + e.valueLength] != 0)
+                    return false;
+            }
+
+            m_header = header;
+            m_seeds = seeds;
+            m_entries = entries;
+            m_pool = pool;
+            return true;
+        }
+
+        void close() { *this = View(); }
+        bool valid() const { return m_header != nullptr; }
+
+        uint64_t sourceSize() const { return m_header ? m_header->sourceSize : 0; }
+        uint64_t sourceTime() const { return m_header ? m_header->sourceTime : 0; }
+        size_t size() const { return m_header ? m_header->count : 0; }
+
+        // 按槽位置访问条目，用于遍历
+        StringView key(size_t i) const { return string(m_entries[i].keyOffset, m_entries[i].keyLength); }
+        StringView value(size_t i) const { return string(m_entries[i].valueOffset, m_entries[i].valueLength); }
+
+        // 查找键，找到时 value 指向块中以 \0 结尾的字符串
+        bool find(StringView key, StringView& value) const
+        {
+            if (!m_header || m_header->count == 0)
+                return false;
+            uint64_t h = detail::hash(key.data(), key.size(), m_header->seed);
+            uint32_t displacement = m_seeds[detail::bucket(h, m_header->bucketCount)];
+            const Entry& e = m_entries[detail::slot(h, displacement, m_header->count)];
+            if (e.keyLength != key.size() ||
+                std::memcmp(m_pool + e.keyOffset, key.data(), key.size() * sizeof(Char)) != 0)
+                return false;
+            value = string(e.valueOffset, e.valueLength);
+            return true;
+        }
+
+    private:
+        const Header* m_header = nullptr;
+        const uint32_t* m_seeds = nullptr;
+        const Entry* m_entries = nullptr;
+        const Char* m_pool = nullptr;
+
+        StringView string(uint32_t offset, uint32_t length) const { return StringView(m_pool + offset, length); }
+    };
+
+    // 从键值对构造二进制块
+    class Builder {
+    public:
+        // 添加一个条目，重复的键保留第一个（与JSON解析时相同）
+        void add(std::wstring_view key, std::wstring_view value)
+        {
+            size_t keyOffset = m_pool.size();
+            detail::append(m_pool, key);
+            size_t keyLength = m_pool.size() - keyOffset;
+            m_pool += Char(0);
+            StringView k(m_pool.data() + keyOffset, keyLength);
+            uint64_t h = detail::hash(k.data(), k.size(), 0);
+            auto range = m_index.equal_range(h);
+            for (auto it = range.first; it != range.second; ++it) {
+                const Item& item = m_items[it->second];
+                if (m_pool.compare(item.keyOffset, item.keyLength, k) == 0) {
+                    m_pool.resize(keyOffset);
+                    return;
+                }
+            }
+            m_index.emplace(h, m_items.size());
+
+            Item item;
+            item.keyOffset = uint32_t(keyOffset);
+            item.keyLength = uint32_t(k.size());
+            item.valueOffset = uint32_t(m_pool.size());
+            detail::append(m_pool, value);
+            item.valueLength = uint32_t(m_pool.size() - item.valueOffset);
+            m_pool += Char(0);
+            m_items.push_back(item);
+        }
+
+        size_t size() const { return m_items.size(); }
+
+        // 生成二进制块，失败（无法构造完美哈希）时返回空
+        std::vector<char> build(uint64_t sourceSize, uint64_t sourceTime) const
+        {
+            Header header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.sourceSize = sourceSize;
+            header.sourceTime = sourceTime;
+            header.count = uint32_t(m_items.size());
+            header.bucketCount = header.count ? (header.count + 3) / 4 : 0;
+            header.poolSize = uint32_t(m_pool.size());
+
+            std::vector<uint32_t> seeds(header.bucketCount, 0);
+            std::vector<uint32_t> slots(m_items.size(), 0);     // 条目 -> 槽
+            bool ok = header.count == 0;
+            for (uint32_t seed = 1; !ok && seed <= 16; ++seed) {
+                header.seed = seed;
+                ok = place(header, seeds, slots);
+            }
+            if (!ok)
+                return {};
+
+            std::vector<Entry> entries(m_items.size());
+            for (size_t i = 0; i < m_items.size(); ++i) {
+                const Item& item = m_items[i];
+                entries[slots[i]] = { item.keyOffset, item.keyLength, item.valueOffset, item.valueLength };
+            }
+
+            std::vector<char> blob;
+            blob.reserve(sizeof(Header) + seeds.size() * sizeof(uint32_t)
+                + entries.size() * sizeof(Entry) + m_pool.size() * sizeof(Char));
+            auto put = [&blob](const void* p, size_t n) {
+                blob.insert(blob.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+            };
+            put(&header, sizeof(header));
+            put(seeds.data(), seeds.size() * sizeof(uint32_t));
+            put(entries.data(), entries.size() * sizeof(Entry));
+            put(m_pool.data(), m_pool.size() * sizeof(Char));
+            return blob;
+        }
+
+    private:
+        struct Item {
+            uint32_t keyOffset;
+            uint32_t keyLength;
+            uint32_t valueOffset;
+            uint32_t valueLength;
+        };
+
+        std::vector<Item> m_items;
+        std::basic_string<Char> m_pool;
+        std::unordered_multimap<uint64_t, size_t> m_index;     // 键的哈希 -> 条目，用于去重
+
+        // 用给定种子为所有桶寻找位移
+        bool place(const Header& header, std::vector<uint32_t>& seeds, std::vector<uint32_t>& slots) const
+        {
+            const uint32_t count = header.count;
+            std::vector<uint64_t> hashes(count);
+            std::vector<std::vector<uint32_t>> buckets(header.bucketCount);
+            for (uint32_t i = 0; i < count; ++i) {
+                const Item& item = m_items[i];
+                hashes[i] = detail::hash(m_pool.data() + item.keyOffset, item.keyLength, header.seed);
+                buckets[detail::bucket(hashes[i], header.bucketCount)].push_back(i);
+            }
+
+            std::vector<uint32_t> order(header.bucketCount);
+            for (uint32_t b = 0; b < header.bucketCount; ++b)
+                order[b] = b;
+            std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+                return buckets[a].size() > buckets[b].size();
+            });
+
+            std::vector<bool> taken(count, false);
+            std::vector<uint32_t> tried;
+            uint32_t nextFree = 0;
+            std::fill(seeds.begin(), seeds.end(), 0);
+            for (uint32_t b : order) {
+                const std::vector<uint32_t>& keys = buckets[b];
+                if (keys.empty())
+                    break;
+
+                if (keys.size() == 1) {
+                    while (taken[nextFree])
+                        ++nextFree;
+                    taken[nextFree] = true;
+                    slots[keys[0]] = nextFree;
+                    seeds[b] = detail::DIRECT | nextFree;
+                    continue;
+                }
+
+                bool placed = false;
+                for (uint32_t d = 0; d < (1u << 20) && !placed; ++d) {
+                    tried.clear();
+                    for (uint32_t i : keys) {
+                        uint32_t s = detail::slot(hashes[i], d, count);
+                        if (taken[s] || std::find(tried.begin(), tried.end(), s) != tried.end())
+                            break;
+                        tried.push_back(s);
+                    }
+                    if (tried.size() != keys.size())
+                        continue;
+                    for (size_t k = 0; k < keys.size(); ++k) {
+                        taken[tried[k]] = true;
+                        slots[keys[k]] = tried[k];
+                    }
+                    seeds[b] = d;
+                    placed = true;
+                }
+                if (!placed)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+} // namespace LocaleBlob
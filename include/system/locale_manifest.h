@@ -0,0 +1,134 @@
+#pragma once
+
+#include "foundation/json_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 语言文件清单（assets/locales/locales.manifest）。
+// 记录每个语言文件的代码、语言名称（language_info.name）、大小和修改时间，
+// 启动时只需扫描一次目录（目录项中已有大小和修改时间）并读取清单，
+// 不再打开每个语言文件读取名称；大小或修改时间变化的语言文件在需要名称时才重新读取。
+//
+// 文件格式为UTF-8文本，第一行是格式标识，之后每行一个语言文件：
+//   代码<Tab>大小<Tab>修改时间<Tab>名称
+// 修改时间为FILETIME（1601年起的100纳秒数）。
+// 只依赖标准库，编译工具（tools/LocaleCompiler）和程序共用。
+//
+namespace LocaleManifest {
+
+    constexpr char HEADER[] = "# TinyPin locale manifest 1";
+
+    struct Entry {
+        std::wstring code;
+        std::wstring name;      // 语言文件中的 language_info.name，可以为空
+        uint64_t size = 0;      // JSON文件的大小
+        uint64_t time = 0;      // JSON文件的修改时间
+        bool named = false;     // name 与当前文件一致
+    };
+
+    // 生成清单文本，只写入名称有效的条目
+    inline std::string format(const std::vector<Entry>& entries)
+    {
+        std::string out = HEADER;
+        out += '\n';
+        for (const Entry& e : entries) {
+            if (!e.named)
+                continue;
+            std::string name = Foundation::Json::toUtf8(e.name);
+            std::replace_if(name.begin(), name.end(), [](char ch) {
+                return ch == '\t' || ch == '\r' || ch == '\n';
+            }, ' ');
+            out += Foundation::Json::toUtf8(e.code);
+            out += '\t';
+            out += std::to_string(e.size);
+            out += '\t';
+            out += std::to_string(e.time);
+            out += '\t';
+            out += name;
+            out += '\n';
+        }
+        return out;
+    }
+
+    // 读取清单，格式不对时返回false。结果按代码排序
+    inline bool parse(std::string_view text, std::vector<Entry>& entries)
+    {
+        entries.clear();
+        size_t eol = text.find('\n');
+        std::string_view header = text.substr(0, eol);
+        if (!header.empty() && header.back() == '\r')
+            header.remove_suffix(1);
+        if (header != HEADER)
+            return false;
+
+        while (eol != text.npos) {
+            text.remove_prefix(eol + 1);
+            eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            if (line.empty())
+                continue;
+
+            std::string_view fields[4];
+            for (int n = 0; n < 3; ++n) {
+                size_t tab = line.find('\t');
+                if (tab == line.npos)
+                    return false;
+                fields[n] = line.substr(0, tab);
+                line.remove_prefix(tab + 1);
+            }
+            fields[3] = line;
+
+            Entry e;
+            e.code = Foundation::Json::toWide(fields[0]);
+            std::string number(fields[1]);
+            char* end = nullptr;
+            e.size = std::strtoull(number.c_str(), &end, 10);
+            if (number.empty() || *end)
+                return false;
+            number.assign(fields[2]);
+            e.time = std::strtoull(number.c_str(), &end, 10);
+            if (number.empty() || *end || e.code.empty())
+                return false;
+            e.name = Foundation::Json::toWide(fields[3]);
+            e.named = true;
+            entries.push_back(std::move(e));
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.code < b.code; });
+        return true;
+    }
+
+    // 用目录扫描的结果（代码、大小、修改时间）更新清单：
+    // 大小和修改时间都没有变化的语言文件沿用清单中的名称，其余的名称需要重新读取。
+    // 返回清单内容是否有变化（需要保存）。
+    inline bool merge(std::vector<Entry>& manifest, std::vector<Entry> scanned)
+    {
+        std::sort(scanned.begin(), scanned.end(), [](const Entry& a, const Entry& b) { return a.code < b.code; });
+
+        bool changed = scanned.size() != manifest.size();
+        for (Entry& e : scanned) {
+            auto it = std::lower_bound(manifest.begin(), manifest.end(), e.code,
+                [](const Entry& m, const std::wstring& code) { return m.code < code; });
+            if (it != manifest.end() && it->code == e.code && it->named &&
+                it->size == e.size && it->time == e.time) {
+                e.name = std::move(it->name);
+                e.named = true;
+            }
+            else {
+                e.name.clear();
+                e.named = false;
+                changed = true;
+            }
+        }
+        manifest = std::move(scanned);
+        return changed;
+    }
+
+} // namespace LocaleManifest
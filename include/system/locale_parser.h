@@ -0,0 +1,150 @@
+#pragma once
+
+#include "foundation/json_stream.h"
+
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 语言文件（assets/locales/*.json）的解析。
+// 用流式JSON读取器单遍扫描整个文件缓冲区，格式不限（空白、换行、转义都按JSON处理），
+// 嵌套对象展开为点分键，如 {"dialogs":{"about":{"title":"..."}}} -> dialogs.about.title。
+//
+// 键路径保存在同一个缓冲区中，进入对象时记录长度、离开时截断，不按层拼接字符串。
+// 所有键和值以UTF-8依次追加到一个字符串池中（每项以 \0 结尾），
+// 由调用方一次整体转换为UTF-16，再用 split() 逐项取出。
+// 只依赖标准库。
+//
+namespace LocaleParser {
+
+    // 把语言文件展开为字符串池：键\0值\0键\0值\0...，只收集字符串值。
+    // 返回收集的条目数，出错时返回-1并设置 error。
+    inline long flatten(const char* data, size_t size, std::string& pool, std::string& error)
+    {
+        using Foundation::Json::Reader;
+        using Foundation::Json::Token;
+
+        Reader reader(data, size);
+        if (reader.next() != Token::BeginObject) {
+            error = reader.token() == Token::Error ? reader.error() : "root must be an object";
+            return -1;
+        }
+
+        pool.clear();
+        pool.reserve(size);
+        std::string path;
+        std::vector<size_t> parents(1, 0);   // 每层对象的路径长度
+        long count = 0;
+
+        for (;;) {
+            Token t = reader.next();
+            if (t == Token::EndObject) {
+                parents.pop_back();
+                if (parents.empty())
+                    break;
+                continue;
+            }
+            if (t != Token::Key) {
+                error = t == Token::Error ? reader.error() : "expected key";
+                return -1;
+            }
+
+            path.resize(parents.back());
+            if (!path.empty())
+                path += '.';
+            path += reader.text();
+
+            t = reader.next();
+            if (t == Token::BeginObject) {
+                parents.push_back(path.size());
+            }
+            else if (t == Token::String) {
+                // 值中的 \0 会破坏字符串池的分隔，直接去掉
+                const std::string& value = reader.text();
+                pool += path;
+                pool += '\0';
+                for (char ch : value) {
+                    if (ch)
+                        pool += ch;
+                }
+                pool += '\0';
+                ++count;
+            }
+            else if (t == Token::Error || !reader.skip()) {
+                error = reader.error();
+                return -1;
+            }
+        }
+
+        if (reader.next() != Token::End) {
+            error = reader.error();
+            return -1;
+        }
+        return count;
+    }
+
+    // 逐项取出转换后的字符串池：fn(key, value)
+    template <typename Char, typename Fn>
+    void split(std::basic_string_view<Char> pool, Fn fn)
+    {
+        while (!pool.empty()) {
+            size_t keyEnd = pool.find(Char(0));
+            if (keyEnd == pool.npos)
+                return;
+            size_t valueEnd = pool.find(Char(0), keyEnd + 1);
+            if (valueEnd == pool.npos)
+                return;
+            fn(pool.substr(0, keyEnd), pool.substr(keyEnd + 1, valueEnd - keyEnd - 1));
+            pool.remove_prefix(valueEnd + 1);
+        }
+    }
+
+    // 只查找一个点分键的字符串值（如 language_info.name），找到后立即停止读取。
+    // 用于列出语言时读取语言名称，不需要解析整个文件。
+    inline bool findString(std::istream& in, std::string_view key, std::string& value)
+    {
+        using Foundation::Json::Reader;
+        using Foundation::Json::Token;
+
+        // 小缓冲区：语言名称位于文件开头
+        Reader reader(in, 4096);
+        if (reader.next() != Token::BeginObject)
+            return false;
+
+        std::string path;
+        std::vector<size_t> parents(1, 0);
+        for (;;) {
+            Token t = reader.next();
+            if (t == Token::EndObject) {
+                parents.pop_back();
+                if (parents.empty())
+                    return false;
+                continue;
+            }
+            if (t != Token::Key)
+                return false;
+
+            path.resize(parents.back());
+            if (!path.empty())
+                path += '.';
+            path += reader.text();
+
+            // 不在目标键路径上的值直接跳过
+            bool onPath = key.compare(0, path.size(), path) == 0 &&
+                (key.size() == path.size() || key[path.size()] == '.');
+            t = reader.next();
+            if (t == Token::BeginObject && onPath) {
+                parents.push_back(path.size());
+            }
+            else if (t == Token::String && onPath && key.size() == path.size()) {
+                value = reader.text();
+                return true;
+            }
+            else if (!reader.skip()) {
+                return false;
+            }
+        }
+    }
+
+} // namespace LocaleParser
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "foundation/mapped_file.h"
+#include "system/locale_blob.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 一种语言的字符串表，加载后不再改变，可以在多个线程中同时读取。
+// 字符串来自映射的预编译语言文件，或者无法写入预编译文件时在内存中编译的结果。
+//
+// LanguageManager 用 shared_ptr 持有当前的表和最近使用过的几张表，
+// 切换语言时原子地替换当前的表；正在读取旧表的线程持有自己的引用，
+// 旧表在最后一个读取者释放后才销毁，读取者不会看到加载到一半的表。
+//
+class LocaleTable : noncopyable {
+public:
+    // 加载语言文件：映射预编译文件，不存在或已过期时从JSON重新编译并保存。失败时返回空
+    static std::shared_ptr<const LocaleTable> load(const std::wstring& code, const std::wstring& jsonPath,
+                                                   uint64_t sourceSize, uint64_t sourceTime);
+
+    const std::wstring& code() const { return m_code; }
+
+    // 加载时源JSON的大小和修改时间
+    uint64_t sourceSize() const { return m_strings.sourceSize(); }
+    uint64_t sourceTime() const { return m_strings.sourceTime(); }
+
+    // 查找字符串，value 指向表中以 \0 结尾的字符串，在表销毁前有效
+    bool find(std::wstring_view key, std::wstring_view& value) const { return m_strings.find(key, value); }
+
+private:
+    LocaleTable() = default;
+
+    // 把JSON语言文件编译为二进制块，失败时返回空
+    static std::vector<char> compile(const std::wstring& jsonPath, uint64_t sourceSize, uint64_t sourceTime);
+
+    std::wstring m_code;
+    Foundation::MappedFile m_file;      // 映射的预编译语言文件
+    std::vector<char> m_data;           // 无法写入预编译文件时在内存中编译的结果
+    LocaleBlob::View m_strings;         // 指向 m_file 或 m_data
+};
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// 延迟格式化的二进制日志格式。
+// 每个日志调用点第一次执行时登记一条格式描述（级别、源文件、行号、格式字符串），
+// 之后每次调用只记录描述编号、时间和原始参数，程序中不做格式化和编码转换；
+// 解码工具（tools/LogDecoder）读取文件后再按格式字符串生成文本。
+// 只依赖标准库，程序和解码工具共用。
+//
+// 文件结构：
+//   文件头   "TPLG" + 版本号(1字节) + 开始时间(8字节) + UTC偏移分钟数(2字节，有符号)
+//   记录     类型(1字节) + 距上一条记录的时间差(zigzag varint) + 内容
+//     Site   编号(varint) + 级别(1字节) + 行号(varint) + 源文件(字符串) + 格式(字符串)
+//     Event  编号(varint) + 参数字节数(varint) + 参数
+//   参数     类型(1字节) + 值
+//     Int        zigzag varint
+//     UInt       varint
+//     Double     8字节小端
+//     String     字节数(varint) + UTF-8
+//     WString    代码单元数(varint) + 小端UTF-16
+//     Pointer    varint
+//
+// 时间为1970年起的100纳秒数（UTC），多个线程的记录按放入队列的顺序写入，时间差可以为负。
+// 格式字符串为UTF-8，{} 依次替换为参数，{:x} 输出十六进制，{{ 和 }} 输出花括号本身。
+//
+namespace BinaryLog {
+
+    const char MAGIC[4] = { 'T', 'P', 'L', 'G' };
+    const uint8_t VERSION = 1;
+    const size_t HEADER_SIZE = sizeof(MAGIC) + 1 + 8 + 2;
+
+    // 一次调用的参数最多占用的字节数，超出的字符串被截断
+    const size_t MAX_ARGS_SIZE = 240;
+
+    // 级别名称（与文本日志相同），按 LogLevel 的顺序
+    const char* const LEVEL_NAMES[] = { u8"调试", u8"信息", u8"警告", u8"错误", u8"致命" };
+    const uint8_t LEVEL_COUNT = 5;
+
+    enum class RecordType : uint8_t {
+        Site = 1,
+        Event = 2,
+    };
+
+    enum class ArgType : uint8_t {
+        Int = 1,
+        UInt = 2,
+        Double = 3,
+        String = 4,
+        WString = 5,
+        Pointer = 6,
+    };
+
+    namespace detail {
+        inline uint8_t* putVarint(uint8_t* p, uint64_t v)
+        {
+            while (v >= 0x80) {
+                *p++ = static_cast<uint8_t>(v | 0x80);
+                v >>= 7;
+            }
+            *p++ = static_cast<uint8_t>(v);
+            return p;
+        }
+
+        inline uint64_t zigzag(int64_t v)
+        {
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+
+        inline int64_t unzigzag(uint64_t v)
+        {
+            return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+        }
+
+        inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+        {
+            v = 0;
+            for (int shift = 0; p < end && shift < 64; shift += 7) {
+                uint8_t b = *p++;
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        template <typename T>
+        struct Unsupported : std::false_type {};
+    }
+
+
+    // 把一次调用的参数编码到调用方提供的固定缓冲区，不分配内存。
+    // 放不下的字符串截断到能放下的长度，之后的参数丢弃。
+    //
+    class ArgWriter {
+    public:
+        ArgWriter(uint8_t* buf, size_t capacity) : m_begin(buf), m_cur(buf), m_end(buf + capacity) {}
+
+        size_t size() const { return size_t(m_cur - m_begin); }
+
+        template <typename T>
+        void add(const T& value)
+        {
+            using D = std::decay_t<T>;
+            using E = std::remove_cv_t<std::remove_extent_t<T>>;
+            if constexpr (std::is_array_v<T> && std::is_same_v<E, char>) {
+                addString(std::string_view(value));
+            }
+            else if constexpr (std::is_array_v<T> && std::is_same_v<E, wchar_t>) {
+                addWString(std::wstring_view(value));
+            }
+            else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+                addString(value ? std::string_view(value) : std::string_view());
+            }
+            else if constexpr (std::is_same_v<D, const wchar_t*> || std::is_same_v<D, wchar_t*>) {
+                addWString(value ? std::wstring_view(value) : std::wstring_view());
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                addString(std::string_view(value));
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::wstring_view>) {
+                addWString(std::wstring_view(value));
+            }
+            else if constexpr (std::is_same_v<D, bool>) {
+                addNumber(ArgType::UInt, value ? 1 : 0);
+            }
+            else if constexpr (std::is_enum_v<D>) {
+                add(static_cast<std::underlying_type_t<D>>(value));
+            }
+            else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+                addNumber(ArgType::Int, detail::zigzag(static_cast<int64_t>(value)));
+            }
+            else if constexpr (std::is_integral_v<D>) {
+                addNumber(ArgType::UInt, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_floating_point_v<D>) {
+                double d = static_cast<double>(value);
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                if (room() < 9)
+                    return full();
+                *m_cur++ = static_cast<uint8_t>(ArgType::Double);
+                for (int i = 0; i < 8; ++i)
+                    *m_cur++ = static_cast<uint8_t>(bits >> (i * 8));
+            }
+            else if constexpr (std::is_pointer_v<D>) {
+                addNumber(ArgType::Pointer, reinterpret_cast<uintptr_t>(value));
+            }
+            else {
+                static_assert(detail::Unsupported<T>::value, "unsupported log argument type");
+            }
+        }
+
+    private:
+        uint8_t* m_begin;
+        uint8_t* m_cur;
+        uint8_t* m_end;
+
+        size_t room() const { return size_t(m_end - m_cur); }
+        void full() { m_end = m_cur; }
+
+        void addNumber(ArgType type, uint64_t v)
+        {
+            if (room() < 11)
+                return full();
+            *m_cur++ = static_cast<uint8_t>(type);
+            m_cur = detail::putVarint(m_cur, v);
+        }
+
+        void addString(std::string_view s)
+        {
+            if (room() < 4)
+                return full();
+            // 长度最多占3字节
+            size_t n = s.size() < room() - 4 ? s.size() : room() - 4;
+            // 截断时不拆开多字节字符
+            while (n < s.size() && n > 0 && (static_cast<uint8_t>(s[n]) & 0xC0) == 0x80)
+                --n;
+            *m_cur++ = static_cast<uint8_t>(ArgType::String);
+            m_cur = detail::putVarint(m_cur, n);
+            std::memcpy(m_cur, s.data(), n);
+            m_cur += n;
+            if (n < s.size())
+                full();
+        }
+
+        // 一次扫描：边转换边写入，长度在最后补上。
+        // 长度只占1字节，超过127个代码单元的字符串被截断（MAX_ARGS_SIZE 以内不会超过）
+        void addWString(std::wstring_view s)
+        {
+            if (room() < 4)
+                return full();
+            size_t limit = (room() - 4) / 2;
+            if (limit > 127)
+                limit = 127;
+            uint8_t* start = m_cur;
+            m_cur += 2;
+            size_t units = 0, n = 0;
+            for (; n < s.size(); ++n) {
+                uint32_t cp = static_cast<uint32_t>(s[n]);
+                if (cp > 0xFFFF) {
+                    // 32位wchar_t平台上的增补字符拆成代理对
+                    if (units + 2 > limit)
+                        break;
+                    cp -= 0x10000;
+                    putUnit(static_cast<uint16_t>(0xD800 + (cp >> 10)));
+                    putUnit(static_cast<uint16_t>(0xDC00 + (cp & 0x3FF)));
+                    units += 2;
+                }
+                else {
+                    if (units == limit)
+                        break;
+                    putUnit(static_cast<uint16_t>(cp));
+                    ++units;
+                }
+            }
+            // 不拆开代理对（16位wchar_t）
+            if (n < s.size() && n > 0 && (static_cast<uint32_t>(s[n]) & 0xFC00) == 0xDC00) {
+                --n;
+                --units;
+                m_cur -= 2;
+            }
+            start[0] = static_cast<uint8_t>(ArgType::WString);
+            start[1] = static_cast<uint8_t>(units);
+            if (n < s.size())
+                full();
+        }
+
+        void putUnit(uint16_t u)
+        {
+            *m_cur++ = static_cast<uint8_t>(u);
+            *m_cur++ = static_cast<uint8_t>(u >> 8);
+        }
+    };
+
+
+    namespace detail {
+        inline void appendUtf8(std::string& out, uint32_t cp)
+        {
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+            }
+            else if (cp < 0x800) {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000) {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else {
+                out += static_cast<char>(0xF0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+
+        inline void appendHex(std::string& out, uint64_t v)
+        {
+            char buf[16];
+            int n = 0;
+            do {
+                buf[n++] = "0123456789abcdef"[v & 0xF];
+                v >>= 4;
+            } while (v);
+            while (n)
+                out += buf[--n];
+        }
+
+        // 输出下一个参数，参数不完整时返回false
+        inline bool appendArg(std::string& out, const uint8_t*& p, const uint8_t* end, bool hex)
+        {
+            if (p >= end)
+                return false;
+            ArgType type = static_cast<ArgType>(*p++);
+            uint64_t v = 0;
+            switch (type) {
+                case ArgType::Int:
+                case ArgType::UInt:
+                case ArgType::Pointer:
+                    if (!getVarint(p, end, v))
+                        return false;
+                    if (type == ArgType::Pointer) {
+                        out += "0x";
+                        appendHex(out, v);
+                    }
+                    else if (hex) {
+                        appendHex(out, type == ArgType::Int ? static_cast<uint64_t>(unzigzag(v)) : v);
+                    }
+                    else {
+                        out += type == ArgType::Int ? std::to_string(unzigzag(v)) : std::to_string(v);
+                    }
+                    return true;
+                case ArgType::Double: {
+                    if (end - p < 8)
+                        return false;
+                    for (int i = 0; i < 8; ++i)
+                        v |= static_cast<uint64_t>(p[i]) << (i * 8);
+                    p += 8;
+                    double d;
+                    std::memcpy(&d, &v, sizeof(d));
+                    char buf[32];
+                    std::snprintf(buf, sizeof(buf), "%g", d);
+                    out += buf;
+                    return true;
+                }
+                case ArgType::String:
+                    if (!getVarint(p, end, v) || v > uint64_t(end - p))
+                        return false;
+                    out.append(reinterpret_cast<const char*>(p), size_t(v));
+                    p += v;
+                    return true;
+                case ArgType::WString:
+                    if (!getVarint(p, end, v) || v > uint64_t(end - p) / 2)
+                        return false;
+                    for (uint64_t i = 0; i < v; ++i) {
+                        uint32_t u = p[0] | (p[1] << 8);
+                        p += 2;
+                        if (u >= 0xD800 && u < 0xDC00 && i + 1 < v) {
+                            uint32_t lo = p[0] | (p[1] << 8);
+                            if (lo >= 0xDC00 && lo < 0xE000) {
+                                u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+                                p += 2;
+                                ++i;
+                            }
+                        }
+                        appendUtf8(out, u);
+                    }
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    // 按格式字符串把编码后的参数输出为UTF-8文本。
+    // 参数不足时保留多余的 {}，多余的参数忽略
+    inline void render(std::string_view format, const uint8_t* args, size_t size, std::string& out)
+    {
+        const uint8_t* p = args;
+        const uint8_t* end = args + size;
+        for (size_t i = 0; i < format.size(); ++i) {
+            char ch = format[i];
+            if ((ch == '{' || ch == '}') && i + 1 < format.size() && format[i + 1] == ch) {
+                out += ch;
+                ++i;
+            }
+            else if (ch == '{' && format.compare(i, 2, "{}") == 0) {
+                if (!detail::appendArg(out, p, end, false))
+                    out += "{}";
+                ++i;
+            }
+            else if (ch == '{' && format.compare(i, 4, "{:x}") == 0) {
+                if (!detail::appendArg(out, p, end, true))
+                    out += "{:x}";
+                i += 3;
+            }
+            else {
+                out += ch;
+            }
+        }
+    }
+
+
+    // 将记录编码到内存缓冲区，由调用方决定何时写入文件。
+    //
+    class Writer {
+    public:
+        std::vector<uint8_t>& buffer() { return m_buf; }
+
+        void writeHeader(int64_t startTime, int16_t utcOffset)
+        {
+            m_buf.insert(m_buf.end(), MAGIC, MAGIC + sizeof(MAGIC));
+            m_buf.push_back(VERSION);
+            for (int i = 0; i < 8; ++i)
+                m_buf.push_back(static_cast<uint8_t>(static_cast<uint64_t>(startTime) >> (i * 8)));
+            m_buf.push_back(static_cast<uint8_t>(utcOffset));
+            m_buf.push_back(static_cast<uint8_t>(static_cast<uint16_t>(utcOffset) >> 8));
+            m_lastTime = startTime;
+        }
+
+        void writeSite(uint32_t id, uint8_t level, uint32_t line, std::string_view file, std::string_view format, int64_t time)
+        {
+            putType(RecordType::Site, time);
+            putVarint(id);
+            m_buf.push_back(level);
+            putVarint(line);
+            putVarint(file.size());
+            m_buf.insert(m_buf.end(), file.begin(), file.end());
+            putVarint(format.size());
+            m_buf.insert(m_buf.end(), format.begin(), format.end());
+        }
+
+        void writeEvent(uint32_t id, int64_t time, const uint8_t* args, size_t size)
+        {
+            putType(RecordType::Event, time);
+            putVarint(id);
+            putVarint(size);
+            m_buf.insert(m_buf.end(), args, args + size);
+        }
+
+    private:
+        std::vector<uint8_t> m_buf;
+        int64_t m_lastTime = 0;
+
+        void putType(RecordType type, int64_t time)
+        {
+            m_buf.push_back(static_cast<uint8_t>(type));
+            putVarint(detail::zigzag(time - m_lastTime));
+            m_lastTime = time;
+        }
+
+        void putVarint(uint64_t v)
+        {
+            uint8_t tmp[10];
+            m_buf.insert(m_buf.end(), tmp, detail::putVarint(tmp, v));
+        }
+    };
+
+
+    struct Record {
+        RecordType type = RecordType::Event;
+        int64_t time = 0;               // 1970年起的100纳秒数（UTC）
+        uint32_t id = 0;
+        uint8_t level = 0;              // Site
+        uint32_t line = 0;              // Site
+        std::string_view file;          // Site
+        std::string_view format;        // Site
+        const uint8_t* args = nullptr;  // Event
+        size_t argsSize = 0;            // Event
+    };
+
+    // 从内存缓冲区解码记录，字符串指向缓冲区。
+    //
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t size) : m_cur(data), m_end(data + size) {}
+
+        // 检查并跳过文件头
+        bool readHeader()
+        {
+            if (size_t(m_end - m_cur) < HEADER_SIZE || std::memcmp(m_cur, MAGIC, sizeof(MAGIC)) != 0)
+                return false;
+            if (m_cur[sizeof(MAGIC)] != VERSION)
+                return false;
+            const uint8_t* p = m_cur + sizeof(MAGIC) + 1;
+            uint64_t start = 0;
+            for (int i = 0; i < 8; ++i)
+                start |= static_cast<uint64_t>(p[i]) << (i * 8);
+            m_startTime = m_time = static_cast<int64_t>(start);
+            m_utcOffset = static_cast<int16_t>(p[8] | (p[9] << 8));
+            m_cur += HEADER_SIZE;
+            return true;
+        }
+
+        int64_t startTime() const { return m_startTime; }
+        int16_t utcOffset() const { return m_utcOffset; }   // 分钟
+
+        // 读取下一条记录，到达末尾或数据不完整（如程序异常结束）时返回false
+        bool next(Record& rec)
+        {
+            const uint8_t* p = m_cur;
+            if (p >= m_end)
+                return false;
+            rec = Record();
+            rec.type = static_cast<RecordType>(*p++);
+            uint64_t delta, id, v;
+            if (!detail::getVarint(p, m_end, delta) || !detail::getVarint(p, m_end, id))
+                return false;
+            rec.time = m_time + detail::unzigzag(delta);
+            rec.id = static_cast<uint32_t>(id);
+
+            if (rec.type == RecordType::Site) {
+                if (p >= m_end)
+                    return false;
+                rec.level = *p++;
+                if (!detail::getVarint(p, m_end, v))
+                    return false;
+                rec.line = static_cast<uint32_t>(v);
+                if (!getString(p, rec.file) || !getString(p, rec.format))
+                    return false;
+            }
+            else if (rec.type == RecordType::Event) {
+                if (!detail::getVarint(p, m_end, v) || v > uint64_t(m_end - p))
+                    return false;
+                rec.args = p;
+                rec.argsSize = size_t(v);
+                p += v;
+            }
+            else {
+                return false;
+            }
+
+            m_time = rec.time;
+            m_cur = p;
+            return true;
+        }
+
+        bool atEnd() const { return m_cur >= m_end; }
+
+    private:
+        const uint8_t* m_cur;
+        const uint8_t* m_end;
+        int64_t m_startTime = 0;
+        int64_t m_time = 0;
+        int16_t m_utcOffset = 0;
+
+        bool getString(const uint8_t*& p, std::string_view& s)
+        {
+            uint64_t n;
+            if (!detail::getVarint(p, m_end, n) || n > uint64_t(m_end - p))
+                return false;
+            s = std::string_view(reinterpret_cast<const char*>(p), size_t(n));
+            p += n;
+            return true;
+        }
+    };
+
+} // namespace BinaryLog
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "system/log_binary.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// 日志格式化：按与二进制日志相同的格式字符串（见 log_binary.h），
+// 把参数直接以UTF-8追加到日志行的缓冲区，不构造中间的宽字符串。
+// {} 依次替换为参数，{:x} 输出十六进制，{{ 和 }} 输出花括号本身；
+// 参数的输出与 LogDecoder 解码二进制日志的结果相同。
+// 只依赖标准库。
+//
+namespace LogFormat {
+
+    // 宽字符串转换为UTF-8追加到 out（16位wchar_t按UTF-16处理代理对）
+    inline void appendWide(std::string& out, std::wstring_view s)
+    {
+        for (size_t i = 0; i < s.size(); ++i) {
+            uint32_t cp = static_cast<uint32_t>(s[i]);
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < s.size()) {
+                uint32_t lo = static_cast<uint32_t>(s[i + 1]);
+                if (lo >= 0xDC00 && lo < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    ++i;
+                }
+            }
+            BinaryLog::detail::appendUtf8(out, cp);
+        }
+    }
+
+    template <typename T>
+    void appendArg(std::string& out, const T& value, bool hex)
+    {
+        using D = std::decay_t<T>;
+        using E = std::remove_cv_t<std::remove_extent_t<T>>;
+        if constexpr (std::is_array_v<T> && std::is_same_v<E, char>) {
+            out += std::string_view(value);
+        }
+        else if constexpr (std::is_array_v<T> && std::is_same_v<E, wchar_t>) {
+            appendWide(out, std::wstring_view(value));
+        }
+        else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            if (value)
+                out += value;
+        }
+        else if constexpr (std::is_same_v<D, const wchar_t*> || std::is_same_v<D, wchar_t*>) {
+            if (value)
+                appendWide(out, std::wstring_view(value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            out += std::string_view(value);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::wstring_view>) {
+            appendWide(out, std::wstring_view(value));
+        }
+        else if constexpr (std::is_same_v<D, bool>) {
+            out += value ? '1' : '0';
+        }
+        else if constexpr (std::is_enum_v<D>) {
+            appendArg(out, static_cast<std::underlying_type_t<D>>(value), hex);
+        }
+        else if constexpr (std::is_integral_v<D>) {
+            if (hex) {
+                // 有符号数按64位补码输出，与二进制日志相同
+                BinaryLog::detail::appendHex(out, static_cast<uint64_t>(static_cast<std::conditional_t<
+                    std::is_signed_v<D>, int64_t, uint64_t>>(value)));
+            }
+            else {
+                using Wide = std::conditional_t<std::is_signed_v<D>, long long, unsigned long long>;
+                char buf[24];
+                out.append(buf, std::to_chars(buf, buf + sizeof(buf), static_cast<Wide>(value)).ptr);
+            }
+        }
+        else if constexpr (std::is_floating_point_v<D>) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%g", static_cast<double>(value));
+            out += buf;
+        }
+        else if constexpr (std::is_pointer_v<D>) {
+            out += "0x";
+            BinaryLog::detail::appendHex(out, reinterpret_cast<uintptr_t>(value));
+        }
+        else {
+            static_assert(BinaryLog::detail::Unsupported<T>::value, "unsupported log argument type");
+        }
+    }
+
+    namespace detail {
+        // 输出格式字符串直到下一个占位符，返回占位符是否为 {:x}；没有占位符时 pos 为 npos
+        inline bool appendLiteral(std::string& out, std::string_view format, size_t& pos)
+        {
+            while (pos < format.size()) {
+                char ch = format[pos];
+                if ((ch == '{' || ch == '}') && pos + 1 < format.size() && format[pos + 1] == ch) {
+                    out += ch;
+                    pos += 2;
+                }
+                else if (ch == '{' && format.compare(pos, 2, "{}") == 0) {
+                    pos += 2;
+                    return false;
+                }
+                else if (ch == '{' && format.compare(pos, 4, "{:x}") == 0) {
+                    pos += 4;
+                    return true;
+                }
+                else {
+                    out += ch;
+                    ++pos;
+                }
+            }
+            pos = std::string_view::npos;
+            return false;
+        }
+
+        inline void formatArgs(std::string&, std::string_view, size_t&) {}
+
+        template <typename T, typename... Rest>
+        void formatArgs(std::string& out, std::string_view format, size_t& pos, const T& value, const Rest&... rest)
+        {
+            bool hex = appendLiteral(out, format, pos);
+            if (pos == std::string_view::npos)
+                return;     // 多余的参数忽略
+            appendArg(out, value, hex);
+            formatArgs(out, format, pos, rest...);
+        }
+    }
+
+    // 按格式字符串把参数追加到 out。参数不足时保留多余的占位符
+    template <typename... Args>
+    void format(std::string& out, std::string_view format, const Args&... args)
+    {
+        size_t pos = 0;
+        detail::formatArgs(out, format, pos, args...);
+        if (pos < format.size()) {
+            // 剩余部分：字面文本和没有参数的占位符
+            BinaryLog::render(format.substr(pos), nullptr, 0, out);
+        }
+    }
+
+} // namespace LogFormat
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 日志级别和日志宏。
+// 宏展开为对 Logger（system/logger.h）的调用：Logger::isEnabled() 检查级别，
+// Logger::getInstance() 的 debug()..fatal()、event() 和 limitedEvent() 写入日志。
+// 只依赖标准库，测试工具可以提供自己的 Logger 来测量宏本身的开销。
+//
+
+// 日志级别枚举
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERR,  // 避免使用 ERROR 关键字，它可能是 Windows API 中的预定义宏
+    FATAL
+};
+
+// 编译时的最低日志级别（LogLevel 的数值）。低于它的日志宏连同参数表达式一起不生成代码，
+// 可以在编译选项中覆盖，如 /DLOG_MIN_LEVEL=2 只保留警告以上
+#ifndef LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define LOG_MIN_LEVEL 0     // 调试
+#else
+#define LOG_MIN_LEVEL 1     // 信息：Release版本运行时默认只记录警告以上，保留信息以便需要时降低级别
+#endif
+#endif
+
+// 结构化日志的调用点，由 LOG_EVENT 宏在每个调用位置定义一个静态实例。
+// 第一次执行时登记格式字符串并分配编号，之后只记录编号和参数
+struct LogSite {
+    constexpr LogSite(LogLevel level, const char* file, int line) : level(level), file(file), line(line) {}
+
+    const LogLevel level;
+    const char* const file;
+    const int line;
+    const char* format = nullptr;       // 登记时设置
+    std::atomic<uint32_t> id{ 0 };      // 登记后的编号，从1开始
+    std::atomic<uint32_t> rateSlot{ 0 };  // LOG_EVENT_LIMITED 的频率限制槽位，从1开始，与 id 无关
+};
+
+// 全局日志宏，方便使用。
+// 先检查级别再计算参数：级别低于 LOG_MIN_LEVEL 的调用不生成代码，
+// 运行时被关闭的级别只读取一次当前级别，不构造消息字符串
+#define LOG_AT_LEVEL(level, call) do { \
+        if constexpr (int(level) >= LOG_MIN_LEVEL) { \
+            if (Logger::isEnabled(level)) { \
+                call; \
+            } \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(message) LOG_AT_LEVEL(LogLevel::DEBUG, Logger::getInstance().debug(message))
+#define LOG_INFO(message) LOG_AT_LEVEL(LogLevel::INFO, Logger::getInstance().info(message))
+#define LOG_WARNING(message) LOG_AT_LEVEL(LogLevel::WARNING, Logger::getInstance().warning(message))
+#define LOG_ERROR(message) LOG_AT_LEVEL(LogLevel::ERR, Logger::getInstance().error(message))
+#define LOG_FATAL(message) LOG_AT_LEVEL(LogLevel::FATAL, Logger::getInstance().fatal(message))
+
+// 结构化日志：LOG_EVENT(LogLevel::WARNING, "窗口句柄: {}", wnd)
+// 级别必须是常量，格式字符串必须是字符串字面量，每个调用位置只登记一次
+#define LOG_EVENT(level, ...) do { \
+        if constexpr (int(level) >= LOG_MIN_LEVEL) { \
+            if (Logger::isEnabled(level)) { \
+                static LogSite logSite_(level, __FILE__, __LINE__); \
+                Logger::getInstance().event(logSite_, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// 限制频率的结构化日志，用于可能在定时器中反复触发的警告：
+// LOG_EVENT_LIMITED(LogLevel::WARNING, "现代应用窗口矩形无效: {}", wnd)
+#define LOG_EVENT_LIMITED(level, ...) do { \
+        if constexpr (int(level) >= LOG_MIN_LEVEL) { \
+            if (Logger::isEnabled(level)) { \
+                static LogSite logSite_(level, __FILE__, __LINE__); \
+                Logger::getInstance().limitedEvent(logSite_, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// 按级别的结构化日志：LOGF_INFO("已重新加载配置文件，变化的规则数: {}", count)
+#define LOGF_DEBUG(...) LOG_EVENT(LogLevel::DEBUG, __VA_ARGS__)
+#define LOGF_INFO(...) LOG_EVENT(LogLevel::INFO, __VA_ARGS__)
+#define LOGF_WARNING(...) LOG_EVENT(LogLevel::WARNING, __VA_ARGS__)
+#define LOGF_ERROR(...) LOG_EVENT(LogLevel::ERR, __VA_ARGS__)
+#define LOGF_FATAL(...) LOG_EVENT(LogLevel::FATAL, __VA_ARGS__)
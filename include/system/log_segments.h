@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// 文本日志段的文件名和保留策略。
+// 日志段命名为 tinypin_YYYYMMDD_HHMMSS[_段号].log，启动时间和段号都从文件名解析，
+// 排序和删除旧日志只需要目录项，不读取文件属性。只依赖标准库。
+//
+namespace LogSegments {
+
+    // 文件名中表示一次运行的部分：tinypin_YYYYMMDD_HHMMSS
+    constexpr size_t STEM_LENGTH = 23;
+
+    // 日志目录中的一个日志段
+    struct FileName {
+        uint64_t time = 0;      // 文件名中的时间，YYYYMMDDHHMMSS
+        uint32_t segment = 0;   // 段号，第一段为0
+        std::wstring name;
+    };
+
+    // 从文件名解析时间和段号，不是日志段时返回false
+    inline bool parse(const std::wstring& name, FileName& file)
+    {
+        if (name.size() < STEM_LENGTH + 4 || name.compare(0, 8, L"tinypin_") != 0 ||
+            name.compare(name.size() - 4, 4, L".log") != 0)
+            return false;
+
+        uint64_t time = 0;
+        for (size_t i = 8; i < STEM_LENGTH; ++i) {
+            if (i == 16) {
+                if (name[i] != L'_')
+                    return false;
+                continue;
+            }
+            if (name[i] < L'0' || name[i] > L'9')
+                return false;
+            time = time * 10 + (name[i] - L'0');
+        }
+
+        uint32_t segment = 0;
+        size_t end = name.size() - 4;
+        if (end > STEM_LENGTH) {
+            if (name[STEM_LENGTH] != L'_' || end == STEM_LENGTH + 1 || end - STEM_LENGTH > 8)
+                return false;
+            for (size_t i = STEM_LENGTH + 1; i < end; ++i) {
+                if (name[i] < L'0' || name[i] > L'9')
+                    return false;
+                segment = segment * 10 + (name[i] - L'0');
+            }
+        }
+
+        file.time = time;
+        file.segment = segment;
+        file.name = name;
+        return true;
+    }
+
+    // 从旧到新：先按启动时间，同一次运行按段号
+    inline bool older(const FileName& a, const FileName& b)
+    {
+        return a.time != b.time ? a.time < b.time : a.segment < b.segment;
+    }
+
+    // 删除最旧的日志段，只保留最近的 keepCount 段（至少保留最后一段，即当前的日志段）。
+    // files 从旧到新排列，每删除一段调用 removeSegment(name)；
+    // 一次运行的日志段都删除后调用 retireRun(stem)，用于删除这次运行的二进制日志
+    template <typename RemoveSegment, typename RetireRun>
+    void trim(std::deque<FileName>& files, size_t keepCount, RemoveSegment removeSegment, RetireRun retireRun)
+    {
+        while (files.size() > (std::max)(keepCount, size_t(1))) {
+            FileName file = std::move(files.front());
+            files.pop_front();
+            removeSegment(file.name);
+
+            bool runLeft = std::any_of(files.begin(), files.end(),
+                                       [&file](const FileName& other) { return other.time == file.time; });
+            if (!runLeft)
+                retireRun(file.name.substr(0, STEM_LENGTH));
+        }
+    }
+
+} // namespace LogSegments
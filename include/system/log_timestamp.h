@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <string>
+
+// 日志行的时间戳：YYYY-MM-DD HH:MM:SS.mmm（本地时间，UTF-8）。
+// 缓存当前这一秒格式化好的日期和时间，同一秒内只改写毫秒的三位数字，
+// 秒数变化时才转换为本地时间重新写入各个数字。只依赖标准库。
+//
+namespace LogTimestamp {
+
+    constexpr size_t LENGTH = 23;
+
+    class Cache {
+    public:
+        // 把 1970 年起的毫秒数（不小于0）对应的本地时间追加到 out
+        void append(std::string& out, long long ms)
+        {
+            long long second = ms / 1000;
+            unsigned milli = static_cast<unsigned>(ms % 1000);
+            if (second != m_second) {
+                std::time_t time = static_cast<std::time_t>(second);
+                std::tm tm_buf = {};
+#ifdef _WIN32
+                localtime_s(&tm_buf, &time);
+#else
+                localtime_r(&time, &tm_buf);
+#endif
+                digits(m_text, tm_buf.tm_year + 1900, 4);
+                digits(m_text + 5, tm_buf.tm_mon + 1, 2);
+                digits(m_text + 8, tm_buf.tm_mday, 2);
+                digits(m_text + 11, tm_buf.tm_hour, 2);
+                digits(m_text + 14, tm_buf.tm_min, 2);
+                digits(m_text + 17, tm_buf.tm_sec, 2);
+                m_second = second;
+            }
+
+            digits(m_text + 20, static_cast<int>(milli), 3);
+            out.append(m_text, LENGTH);
+        }
+
+    private:
+        long long m_second = -1;
+        char m_text[LENGTH + 1] = "0000-00-00 00:00:00.000";
+
+        // 把 value 的最后 count 位十进制数字写入 p
+        static void digits(char* p, int value, int count)
+        {
+            for (int i = count - 1; i >= 0; --i) {
+                p[i] = char('0' + value % 10);
+                value /= 10;
+            }
+        }
+    };
+
+    // 把当前时间追加到 out，每个线程使用自己的缓存
+    inline void append(std::string& out)
+    {
+        thread_local Cache cache;
+        long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        cache.append(out, ms);
+    }
+
+} // namespace LogTimestamp
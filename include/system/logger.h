@@ -1,22 +1,30 @@
 #pragma once
 
+#include "foundation/mapped_file.h"
+#include "foundation/mpsc_ring.h"
+#include "system/log_binary.h"
+#include "system/log_format.h"
+#include "system/log_level.h"
+#include "system/log_segments.h"
 #include <string>
-#include <fstream>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <chrono>
 #include <iomanip>
 #include <filesystem>
 
-// 日志级别枚举
-enum class LogLevel {
-    DEBUG,
-    INFO,
-    WARNING,
-    ERR,  // 避免使用 ERROR 关键字，它可能是 Windows API 中的预定义宏
-    FATAL
-};
-
 // 日志系统类
+// 调用线程只格式化日志行并放入无锁队列，由单独的写入线程批量写入文件：
+//   调试、信息、警告：最迟在 m_flushInterval 内写入，队列积累到四分之一时提前写入
+//   错误：立即唤醒写入线程写入
+//   致命：写入并刷新到磁盘后才返回
+// 文本日志按 SEGMENT_SIZE 分段，每段预先分配并映射到内存，写满后由写入线程切换到下一段，
+// 同时删除最旧的日志段，只保留最近 KEEP_SEGMENTS 段
 class Logger {
 public:
     // 获取单例实例
@@ -28,6 +36,59 @@ public:
     // 写入日志
     void log(LogLevel level, const std::wstring& message);
 
+    // 是否记录指定级别的日志：日志宏在计算参数之前检查，未初始化或已关闭时不记录任何级别
+    static bool isEnabled(LogLevel level) {
+        return int(level) >= s_enabledLevel.load(std::memory_order_relaxed);
+    }
+
+    // 写入结构化日志：format 为UTF-8格式字符串（{} 依次替换为参数，见 log_format.h）。
+    // 启用二进制日志时只记录调用点编号和原始参数，否则直接格式化到日志行的缓冲区。
+    // 由 LOG_EVENT 等宏调用，级别已经检查过
+    template <typename... Args>
+    void event(LogSite& site, const char* format, const Args&... args) {
+        if (m_binary) {
+            // 参数直接编码到队列的槽中，不在栈上组装再复制整条记录
+            uint32_t id = site.id.load(std::memory_order_acquire);
+            if (!id) {
+                id = registerSite(site, format);
+            }
+            auto fill = [&](BinaryEvent& ev) {
+                ev.time = currentTime();
+                ev.site = id;
+                BinaryLog::ArgWriter writer(ev.args, sizeof(ev.args));
+                (writer.add(args), ...);
+                ev.size = uint16_t(writer.size());
+            };
+            while (!m_binaryQueue->tryEmplace(fill)) {
+                wakeWriter();
+                std::this_thread::yield();
+            }
+            binaryPushed(site.level);
+            return;
+        }
+        LogRecord record;
+        beginRecord(record, site.level);
+        LogFormat::format(record.text, format, args...);
+        push(std::move(record));
+    }
+
+    // 限制频率的结构化日志：每个调用点先允许连续 RATE_BURST 条，之后每 RATE_INTERVAL 一条，
+    // 其余的只计数，下一条被记录时先输出一行"省略了 N 次"。由 LOG_EVENT_LIMITED 宏调用
+    template <typename... Args>
+    void limitedEvent(LogSite& site, const char* format, const Args&... args) {
+        uint32_t repeated = 0;
+        if (!admit(site, repeated)) {
+            return;
+        }
+        if (repeated) {
+            reportRepeated(site, repeated);
+        }
+        event(site, format, args...);
+    }
+
+    // 启用二进制日志：结构化日志写入与文本日志同名的 .tplog 文件，用 tools/LogDecoder 解码
+    bool enableBinaryLog();
+
     // 不同级别的日志方法
     void debug(const std::wstring& message);
     void info(const std::wstring& message);
@@ -41,14 +102,11 @@ public:
     // 获取当前日志级别
     LogLevel getLogLevel() const;
 
-    // 清理旧的日志文件，只保留最近的指定数量
-    void cleanupOldLogFiles(int keepCount = 10);
-
     // 程序退出时的清理工作
     void shutdown();
 
-    // 强制刷新缓冲区
-    void flush();
+    // 等待此前的日志全部写入文件，sync 为 true 时还要等待刷新到磁盘
+    void flush(bool sync = false);
 
 private:
     // 私有构造函数，防止外部创建实例
@@ -61,45 +119,154 @@ private:
     Logger(Logger&&) = delete;
     Logger& operator=(Logger&&) = delete;
 
-    // 获取日志级别的字符串表示
-    std::wstring getLevelString(LogLevel level) const;
-
     // 获取当前时间的字符串表示
     std::wstring getCurrentTimeString() const;
 
     // 创建日志目录
     bool createLogDirectory(const std::wstring& logDir);
 
-    // 生成日志文件名
+    // 生成日志文件名（不含段号和扩展名）
     std::wstring generateLogFileName() const;
 
-    // 批量写入缓冲区到文件
-    void flushBuffer();
+    // 读取日志目录中已有的日志段（只读取目录项，不读取文件属性），按文件名中的时间排序
+    void scanLogFiles();
+
+    // 截断上次运行没有正常结束时留下的日志段（末尾是预先分配的空字符）
+    void trimOrphanedSegments();
+
+    // 新建并映射下一个日志段
+    bool openSegment();
+
+    // 当前日志段写满：截断并关闭，打开下一段，删除多余的旧日志段
+    void rotateSegment();
+
+    // 删除最旧的日志段，只保留最近的指定数量
+    void cleanupOldLogFiles(size_t keepCount);
+
+    // 删除一次运行的二进制日志，当前运行的除外
+    void removeBinaryLogs(const std::wstring& stem);
+
+    // 写入线程：取出队列中的日志，复制到映射的日志段
+    void writerThread();
+
+    // 唤醒写入线程
+    void wakeWriter();
+
+    // 停止写入线程，队列中的日志写完后返回
+    void stopWriter();
+
+    // 取出队列中的日志写入文件，count/events 返回取出的文本日志和结构化日志数（调用时没有其他线程在取）
+    void writeQueued(uint64_t& count, uint64_t& events);
+
+    // 把已写入的日志刷新到磁盘
+    void syncFiles();
 
-    // 检查是否需要刷新缓冲区
-    bool shouldFlush(LogLevel level) const;
+    // 写入当前日志段，写满时切换到下一段（调用时没有其他线程在写）
+    void writeFile(std::string_view text);
+
+    // 队列中的一行日志
+    struct LogRecord {
+        std::string text;   // UTF-8，包括行尾
+        LogLevel level = LogLevel::DEBUG;
+    };
+
+    // 队列中的一条结构化日志，固定大小，放入队列时不分配内存
+    struct BinaryEvent {
+        int64_t time = 0;       // 1970年起的100纳秒数（UTC）
+        uint32_t site = 0;
+        uint16_t size = 0;
+        uint8_t args[BinaryLog::MAX_ARGS_SIZE];
+    };
+
+    // 开始一行文本日志：时间和级别
+    void beginRecord(LogRecord& record, LogLevel level) const;
+
+    // 补上行尾后放入文本日志队列，按级别唤醒写入线程
+    void push(LogRecord&& record);
+
+    // 结构化日志放入队列后按级别唤醒写入线程，致命错误等待刷新到磁盘
+    void binaryPushed(LogLevel level);
+
+    // 登记调用点，返回编号
+    uint32_t registerSite(LogSite& site, const char* format);
+
+    // 写入线程：把结构化日志编码到 m_binaryWriter，需要时先写入新登记的调用点
+    void encodeEvent(const BinaryEvent& ev);
+
+    // 1970年起的100纳秒数（UTC）
+    static int64_t currentTime();
+
+    static constexpr size_t SEGMENT_SIZE = 4 * 1024 * 1024;   // 每个日志段的大小
+    static constexpr size_t KEEP_SEGMENTS = 20;                // 保留的日志段数
+
+    // 频率限制：每个限制频率的调用点第一次执行时分配一个固定的槽位（GCRA，与令牌桶等价），
+    // 槽位的编号与二进制日志的调用点编号分开，只用原子操作，不分配内存。
+    // 超过 RATE_SLOTS 个限制频率的调用点时，之后的调用点不限制
+    static constexpr size_t RATE_SLOTS = 64;
+    static constexpr uint32_t NO_RATE_SLOT = UINT32_MAX;  // 槽位已用完
+    static constexpr int64_t RATE_BURST = 5;             // 连续允许的条数
+    static constexpr int64_t RATE_INTERVAL = 10000;      // 之后每条的间隔（毫秒）
+
+    struct RateSlot {
+        std::atomic<int64_t> due{ 0 };          // 理论上下一条到达的时间（毫秒）
+        std::atomic<uint32_t> suppressed{ 0 };  // 省略的条数
+    };
+
+    // 是否记录这一条：不记录时计数；记录时通过 repeated 返回此前省略的条数
+    bool admit(LogSite& site, uint32_t& repeated);
+
+    // 为调用点分配频率限制槽位，返回槽位编号，已用完时返回 NO_RATE_SLOT
+    uint32_t assignRateSlot(LogSite& site);
+
+    // 记录调用点省略的条数
+    void reportRepeated(const LogSite& site, uint32_t repeated);
+
+    // 关闭前输出所有调用点尚未报告的省略条数
+    void reportAllRepeated();
 
     // 成员变量
-    std::ofstream m_logFile;
-    std::mutex m_mutex;
-    LogLevel m_logLevel;
+    Foundation::MappedFile m_segment;          // 当前的日志段，只在写入线程中（或写入线程启动前、停止后）使用
+    size_t m_segmentUsed;                      // 当前日志段已写入的字节数
+    uint32_t m_segmentIndex;                   // 下一个日志段的段号
+    std::deque<LogSegments::FileName> m_logFiles;  // 日志目录中的日志段，从旧到新
+    std::mutex m_mutex;                        // 初始化、关闭和设置级别
+    std::atomic<LogLevel> m_logLevel;
     std::wstring m_logDir;
-    std::wstring m_logFilePath;
-    bool m_initialized;
+    std::wstring m_logStem;                    // 本次运行的日志段文件名，不含段号和扩展名
+    std::wstring m_logFilePath;                // 第一个日志段
+    std::atomic<bool> m_initialized;
+    static std::atomic<int> s_enabledLevel;    // 实际生效的级别，未初始化或已关闭时高于所有级别
     
-    // 批量写入相关成员
-    std::vector<std::string> m_logBuffer;      // 日志缓冲区
-    size_t m_bufferSize;                       // 缓冲区大小限制
-    std::chrono::steady_clock::time_point m_lastFlush;  // 上次刷新时间
-    std::chrono::milliseconds m_flushInterval;          // 刷新间隔
+    // 写入线程相关成员
+    Foundation::MpscRing<LogRecord> m_queue;   // 等待写入的日志
+    std::thread m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;            // 唤醒写入线程
+    std::condition_variable m_drained;         // 通知等待 flush() 的线程
+    std::atomic<bool> m_writerWaiting;         // 写入线程正在等待唤醒
+    std::atomic<bool> m_urgent;                // 需要立即写入
+    std::atomic<bool> m_syncRequested;         // 写入后刷新到磁盘
+    std::atomic<bool> m_stop;
+    bool m_open;                               // 写入线程已启动且 shutdown() 尚未写完剩余的日志，由 m_wakeMutex 保护
+    std::atomic<uint64_t> m_written;           // 已写入的日志数
+    uint64_t m_synced;                         // 最近一次刷新到磁盘时已写入的日志数，由 m_wakeMutex 保护
+    
+    // 二进制日志相关成员
+    std::unique_ptr<Foundation::MpscRing<BinaryEvent>> m_binaryQueue;
+    std::atomic<bool> m_binary;                // 已启用二进制日志
+    HANDLE m_binaryFile;
+    BinaryLog::Writer m_binaryWriter;          // 只在写入线程中使用
+    std::atomic<uint64_t> m_binaryWritten;     // 已写入的结构化日志数
+    uint64_t m_binarySynced;                   // 最近一次刷新到磁盘时已写入的结构化日志数
+    std::mutex m_siteMutex;
+    std::vector<const LogSite*> m_sites;       // 已登记的调用点，下标为编号-1
+    size_t m_sitesWritten;                     // 已写入文件的调用点数，只在写入线程中使用
+    RateSlot m_rateSlots[RATE_SLOTS];          // 限制频率的调用点，下标为槽位编号-1
+    const LogSite* m_rateSites[RATE_SLOTS];    // 占用各个槽位的调用点，由 m_siteMutex 保护
+    size_t m_rateSiteCount;                    // 已分配的槽位数，由 m_siteMutex 保护
+    static LogSite s_repeatSites[];            // "省略了 N 次"的日志，每个级别一个
+    std::chrono::milliseconds m_flushInterval; // 写入间隔
     
     // 辅助方法：将宽字符串转换为UTF-8
     std::string wstringToUtf8(const std::wstring& wstr) const;
 };
-
-// 全局日志宏，方便使用
-#define LOG_DEBUG(message) Logger::getInstance().debug(message)
-#define LOG_INFO(message) Logger::getInstance().info(message)
-#define LOG_WARNING(message) Logger::getInstance().warning(message)
-#define LOG_ERROR(message) Logger::getInstance().error(message)
-#define LOG_FATAL(message) Logger::getInstance().fatal(message)
\ No newline at end of file
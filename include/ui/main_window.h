@@ -36,6 +36,9 @@ private:
     static bool setupTrayIcon(HWND wnd);
     static void setupHotkeys(HWND wnd, Options* opt);
     static void initializeDpiSettings(HWND wnd, Options* opt);
+    static void startEventRecording();
+    static void startConfigWatcher(HWND wnd, Options* opt);
+    static void reloadConfig(HWND wnd, WindowCreationMonitor& winCreMon, Options* opt);
 private:
     
     // 状态处理方法
@@ -1,16 +1,45 @@
 #pragma once
 
+// 窗口创建事件过滤条件。
+// 在钩子回调中就地过滤，只有通过过滤的顶级窗口才会进入队列。
+//
+struct WindowCreationFilter {
+    bool topLevelOnly = true;       // 只接受顶级窗口（丢弃子窗口和仅消息窗口）
+    bool skipToolWindows = true;    // 丢弃WS_EX_TOOLWINDOW窗口（工具提示、浮动面板等）
+    std::vector<std::wstring> processes;  // 进程映像名白名单（如 notepad.exe），为空表示不限制
+    ULONGLONG titleWatchPeriod = Constants::AUTOPIN_TITLE_WATCH_PERIOD;  // 入队后多长时间内报告标题变化（毫秒）
+};
+
+// 窗口创建监视器的统计计数。
+//
+struct WindowCreationStats {
+    ULONGLONG received = 0;     // 收到的EVENT_OBJECT_CREATE事件
+    ULONGLONG filtered = 0;     // 被过滤条件丢弃的事件
+    ULONGLONG duplicates = 0;   // 同一批次内重复的窗口
+    ULONGLONG queued = 0;       // 进入队列的窗口
+    ULONGLONG batches = 0;      // 发送给客户端窗口的批次消息数
+    ULONGLONG postFailures = 0; // 发送批次消息失败的次数（如消息队列已满），下一个事件时重新发送
+    ULONGLONG titleChanges = 0; // 报告给客户端的标题变化（仅限最近入队的窗口）
+};
+
 // 用于监控系统窗口创建的抽象基类。
-// 每当创建窗口时向客户端窗口发送消息。
+// 窗口被合并为批次，每个批次只向客户端窗口发送一条消息，
+// 客户端收到消息后调用takeBatch()取走整批窗口。
+// 最近入队的窗口改变标题时也会进入批次，以便重新评估依赖标题的规则。
 //
 class WindowCreationMonitor {
 public:
     virtual ~WindowCreationMonitor() {}
     virtual bool init(HWND wnd, int msgId) = 0;
     virtual bool term() = 0;
+    virtual void setFilter(const WindowCreationFilter& filter) = 0;
+    virtual void takeBatch(std::vector<HWND>& created, std::vector<HWND>& renamed) = 0;
+    virtual WindowCreationStats getStats() const = 0;
 };
 
 // 使用SetWinEventHook()的窗口创建监视器。
+// WINEVENT_OUTOFCONTEXT回调在安装钩子的线程（UI线程）的消息循环中执行，
+// 因此批次和统计数据无需加锁。
 //
 class EventHookWindowCreationMonitor : public WindowCreationMonitor, ::noncopyable {
 public:
@@ -19,12 +48,30 @@ public:
 
     bool init(HWND wnd, int msgId);
     bool term();
+    void setFilter(const WindowCreationFilter& filter);
+    void takeBatch(std::vector<HWND>& created, std::vector<HWND>& renamed);
+    WindowCreationStats getStats() const;
 
 private:
     static HWINEVENTHOOK hook;
+    static HWINEVENTHOOK nameHook;
     static HWND wnd;
     static int msgId;
 
+    static WindowCreationFilter filter;
+    static WindowCreationStats stats;
+    static std::vector<HWND> batch;             // 等待客户端取走的窗口
+    static std::vector<HWND> renamed;           // 等待客户端取走的标题变化窗口
+    static std::vector<std::pair<HWND, ULONGLONG>> recent;  // 最近入队的窗口及入队时间（按时间排序）
+    static bool posted;                         // 已发送批次消息，客户端尚未取走
+
+    static bool accept(HWND hwnd, DWORD eventThread);
+    static bool processAllowed(HWND hwnd);
+    static void logStats();
+    static void postBatch();
+    static void pruneRecent(ULONGLONG now);
+    static bool isRecent(HWND hwnd);
+
     static VOID CALLBACK proc(HWINEVENTHOOK hook, DWORD event,
         HWND hwnd, LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime);
-};
\ No newline at end of file
+};
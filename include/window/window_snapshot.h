@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/common.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Window {
+
+    // 顶级窗口快照。
+    // 一次EnumWindows收集窗口句柄、标题和类名，所有字符串紧凑地存放在同一缓冲区中，
+    // 快照创建后只读，可以安全地在多个线程中同时访问。
+    //
+    class WindowSnapshot {
+    public:
+        struct Item {
+            HWND wnd;
+            DWORD pid;
+            UINT32 title;       // 标题在文本缓冲区中的偏移
+            UINT32 titleLen;
+            UINT32 cls;         // 类名在文本缓冲区中的偏移
+            UINT32 clsLen;
+        };
+
+        // 枚举可见的顶级窗口（不含工具窗口和本进程窗口）
+        void capture();
+
+        size_t size() const { return m_items.size(); }
+        bool empty() const { return m_items.empty(); }
+        const Item& operator[](size_t n) const { return m_items[n]; }
+
+        std::wstring_view title(size_t n) const
+        {
+            return std::wstring_view(m_text.data() + m_items[n].title, m_items[n].titleLen);
+        }
+
+        std::wstring_view className(size_t n) const
+        {
+            return std::wstring_view(m_text.data() + m_items[n].cls, m_items[n].clsLen);
+        }
+
+    private:
+        std::vector<Item> m_items;
+        std::vector<wchar_t> m_text;
+
+        UINT32 appendText(const wchar_t* s, int len);
+        static BOOL CALLBACK enumProc(HWND wnd, LPARAM param);
+    };
+
+} // namespace Window
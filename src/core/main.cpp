@@ -36,6 +36,11 @@ int WINAPI WinMain(HINSTANCE inst, HINSTANCE, LPSTR, int)
     // 尽快加载设置
     opt.load();
 
+    // 调试：结构化日志写入二进制文件，供 tools/LogDecoder 解码
+    if (opt.binaryLog) {
+        Logger::getInstance().enableBinaryLog();
+    }
+
     // 初始化语言管理器
     if (!LANG_MGR.initialize()) {
         LOG_WARNING(LANG_MGR.getString(L"language_manager_init_failed"));
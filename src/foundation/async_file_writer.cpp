@@ -0,0 +1,135 @@
+#include "core/stdafx.h"
+#include "foundation/async_file_writer.h"
+#include "system/logger.h"
+
+namespace Foundation {
+
+AsyncFileWriter::AsyncFileWriter(int delay, int maxDelay)
+    : m_delay(delay), m_maxDelay(maxDelay)
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_urgent = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void AsyncFileWriter::write(const std::wstring& path, std::string content)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_content = std::move(content);
+        m_replace = true;
+        schedule(path);
+    }
+    m_wake.notify_one();
+}
+
+void AsyncFileWriter::append(const std::wstring& path, const std::string& content)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending)
+            m_replace = false;
+        m_content += content;
+        schedule(path);
+    }
+    m_wake.notify_one();
+}
+
+// 调用时已持有m_mutex
+void AsyncFileWriter::schedule(const std::wstring& path)
+{
+    Clock::time_point now = Clock::now();
+    if (!m_pending)
+        m_first = now;
+    m_last = now;
+    m_path = path;
+    m_pending = true;
+
+    // 线程在第一次写入时才创建
+    if (!m_thread.joinable())
+        m_thread = std::thread(&AsyncFileWriter::run, this);
+}
+
+bool AsyncFileWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pending) {
+        m_urgent = true;
+        m_wake.notify_one();
+    }
+    m_idle.wait(lock, [this] { return !m_pending && !m_writing; });
+    return m_lastResult;
+}
+
+bool AsyncFileWriter::idle()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_pending && !m_writing;
+}
+
+bool AsyncFileWriter::takeFailure()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool failed = m_failed;
+    m_failed = false;
+    return failed;
+}
+
+void AsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_pending || m_stop; });
+        if (!m_pending)
+            break;
+
+        // 等到最后一次写入之后延迟结束，期间的写入合并
+        while (!m_urgent) {
+            Clock::time_point due = (std::min)(m_last + m_delay, m_first + m_maxDelay);
+            if (Clock::now() >= due)
+                break;
+            m_wake.wait_until(lock, due);
+        }
+
+        std::wstring path = m_path;
+        std::string content = std::move(m_content);
+        bool replace = m_replace;
+        m_content.clear();
+        m_pending = false;
+        m_urgent = m_stop;   // 退出时不再等待之后的写入
+        m_writing = true;
+
+        lock.unlock();
+        bool ok = replace
+            ? FileUtils::writeFileAtomic(path, content.data(), content.size())
+            : FileUtils::appendLines(path, content.data(), content.size());
+        if (!ok)
+            LOG_ERROR(L"写入文件失败: " + path);
+        lock.lock();
+
+        if (!ok) {
+            // 之后的追加依赖失败的内容，一起丢弃，等调用方重写整个文件
+            m_failed = true;
+            if (m_pending && !m_replace) {
+                m_content.clear();
+                m_pending = false;
+            }
+        }
+
+        m_writing = false;
+        m_lastResult = ok;
+        if (!m_pending)
+            m_idle.notify_all();
+    }
+}
+
+} // namespace Foundation
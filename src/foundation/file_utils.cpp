@@ -42,6 +42,65 @@ bool Foundation::FileUtils::readFileBack(HANDLE file, void* buf, int bytes)
         && SetFilePointer(file, -bytes, 0, FILE_CURRENT) != -1;
 }
 
+namespace {
+    bool writeAll(HANDLE file, const void* data, size_t size)
+    {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            DWORD chunk = static_cast<DWORD>((std::min)(size, size_t(1) << 30));
+            DWORD written = 0;
+            if (!WriteFile(file, p, chunk, &written, nullptr) || written != chunk)
+                return false;
+            p += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+}
+
+bool Foundation::FileUtils::writeFileAtomic(const std::wstring& path, const void* data, size_t size)
+{
+    std::wstring tmpPath = path + L".tmp";
+    HANDLE file = CreateFileW(tmpPath.c_str(), GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    // 替换之前确保内容已经在磁盘上，否则断电后可能得到空文件
+    bool ok = writeAll(file, data, size) && FlushFileBuffers(file);
+    CloseHandle(file);
+
+    if (ok)
+        ok = !!MoveFileExW(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    if (!ok)
+        DeleteFileW(tmpPath.c_str());
+    return ok;
+}
+
+bool Foundation::FileUtils::appendLines(const std::wstring& path, const void* data, size_t size)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | FILE_APPEND_DATA, FILE_SHARE_READ, nullptr,
+        OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    // 检查最后一个字节，接在不完整的行后面会把两行合成一行
+    LARGE_INTEGER fileSize;
+    bool ok = GetFileSizeEx(file, &fileSize) != FALSE;
+    if (ok && fileSize.QuadPart > 0) {
+        LARGE_INTEGER last;
+        last.QuadPart = fileSize.QuadPart - 1;
+        char ch = 0;
+        DWORD read = 0;
+        ok = SetFilePointerEx(file, last, nullptr, FILE_BEGIN)
+            && ReadFile(file, &ch, 1, &read, nullptr) && read == 1 && ch == '\n';
+    }
+
+    ok = ok && writeAll(file, data, size) && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+}
+
 // 模块路径获取功能实现
 
 // 获取模块路径
@@ -0,0 +1,27 @@
+#include "core/stdafx.h"
+#include "foundation/ini_document.h"
+
+namespace Foundation {
+
+bool IniDocument::load(const std::wstring& path)
+{
+    m_text.clear();
+    m_sections.clear();
+    m_index.clear();
+
+    try {
+        std::ifstream file(StringUtils::wideToUtf8(path), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        parse(StringUtils::utf8ToWide(content));
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace Foundation
@@ -0,0 +1,93 @@
+#include "core/stdafx.h"
+#include "foundation/mapped_file.h"
+
+namespace Foundation {
+
+bool MappedFile::open(const std::wstring& path)
+{
+    close();
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || uint64_t(size.QuadPart) > SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // 映射对象和视图都保持文件打开，句柄可以立即关闭
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    m_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!m_view)
+        return false;
+
+    m_size = size_t(size.QuadPart);
+    return true;
+}
+
+bool MappedFile::create(const std::wstring& path, size_t size)
+{
+    close();
+    if (size == 0)
+        return false;
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    // 映射对象按指定大小扩展文件，一次分配好磁盘空间
+    ULARGE_INTEGER mapSize;
+    mapSize.QuadPart = size;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, mapSize.HighPart, mapSize.LowPart, nullptr);
+    if (mapping) {
+        m_view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+        CloseHandle(mapping);
+    }
+    if (!m_view) {
+        // 删除创建了一半的文件
+        CloseHandle(file);
+        DeleteFileW(path.c_str());
+        return false;
+    }
+
+    m_file = file;
+    m_size = size;
+    return true;
+}
+
+bool MappedFile::flush(size_t length)
+{
+    if (!m_view || !m_file)
+        return false;
+    return FlushViewOfFile(m_view, length) && FlushFileBuffers(m_file);
+}
+
+void MappedFile::close(size_t length)
+{
+    if (m_view)
+        UnmapViewOfFile(m_view);
+
+    // 视图和映射对象都关闭后才能截断文件
+    if (m_file) {
+        LARGE_INTEGER end;
+        end.QuadPart = LONGLONG(length < m_size ? length : m_size);
+        if (SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN))
+            SetEndOfFile(m_file);
+        CloseHandle(m_file);
+    }
+
+    m_view = nullptr;
+    m_size = 0;
+    m_file = nullptr;
+}
+
+} // namespace Foundation
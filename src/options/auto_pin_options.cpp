@@ -1,10 +1,15 @@
 #include "core/stdafx.h"
 #include "options/auto_pin_options.h"
+#include "options/rule_exchange.h"
+#include "options/rule_view.h"
+#include "pin/rule_preview.h"
 #include "core/application.h"
 #include "pin/auto_pin_manager.h"
 #include "window/window_monitor.h"
 #include "window/window_helper.h"
+#include "window/window_snapshot.h"
 #include "system/language_manager.h"
+#include "system/logger.h"
 
 
 // 静态控件子类，显示一个可以开/关切换的图标。
@@ -83,6 +88,104 @@ private:
 
 
 namespace {
+    const UINT_PTR PREVIEW_TIMER_ID = 1;
+
+    // 从编辑规则对话框读取规则
+    void readRuleFields(HWND wnd, AutoPinRule& rule)
+    {
+        WCHAR buf[Constants::MAX_CLASSNAME_LEN];
+        GetDlgItemText(wnd, IDC_DESCR, buf, ARRAYSIZE(buf));  rule.descr = buf;
+        GetDlgItemText(wnd, IDC_TITLE, buf, ARRAYSIZE(buf));  rule.ttl = buf;
+        GetDlgItemText(wnd, IDC_CLASS, buf, ARRAYSIZE(buf));  rule.cls = buf;
+        WCHAR procBuf[MAX_PATH];
+        GetDlgItemText(wnd, IDC_PROC, procBuf, ARRAYSIZE(procBuf));  rule.proc = procBuf;
+        LRESULT procField = SendDlgItemMessage(wnd, IDC_PROC_FIELD, CB_GETCURSEL, 0, 0);
+        rule.procField = procField == CB_ERR ? Pin::ProcessField::ImageName
+            : static_cast<Pin::ProcessField>(procField);
+    }
+
+    // 当前顶级窗口的快照，作为规则预览的匹配对象（对话框打开时获取一次）
+    std::vector<Pin::RulePreview::Window> capturePreviewWindows()
+    {
+        Window::WindowSnapshot snapshot;
+        snapshot.capture();
+
+        auto& cache = Platform::ProcessInfoCache::getInstance();
+        std::vector<Pin::RulePreview::Window> windows(snapshot.size());
+        for (size_t n = 0; n < snapshot.size(); ++n) {
+            Pin::RulePreview::Window& w = windows[n];
+            w.id = uintptr_t(snapshot[n].wnd);
+            w.title = snapshot.title(n);
+            w.cls = snapshot.className(n);
+            if (auto info = cache.lookup(snapshot[n].pid)) {
+                w.imageName = info->imageName;
+                w.imagePath = info->imagePath;
+                w.packageFamily = info->packageFamily;
+            }
+        }
+        return windows;
+    }
+
+    void initPreviewList(HWND list)
+    {
+        ListView_SetExtendedListViewStyle(list, LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+
+        RECT rc;
+        GetClientRect(list, &rc);
+        std::wstring titleText = LANG_MGR.getString(L"dialogs.edit_rule.preview_title");
+        std::wstring classText = LANG_MGR.getString(L"dialogs.edit_rule.preview_class");
+
+        LVCOLUMN lvc;
+        lvc.mask = LVCF_FMT | LVCF_TEXT | LVCF_WIDTH;
+        lvc.fmt  = LVCFMT_LEFT;
+        lvc.cx   = (rc.right - rc.left) * 3 / 5;
+        lvc.pszText = const_cast<LPWSTR>(titleText.c_str());
+        ListView_InsertColumn(list, 0, &lvc);
+        lvc.cx   = (rc.right - rc.left) - lvc.cx - GetSystemMetrics(SM_CXVSCROLL);
+        lvc.pszText = const_cast<LPWSTR>(classText.c_str());
+        ListView_InsertColumn(list, 1, &lvc);
+    }
+
+    // 用对话框中的规则更新预览，列表中只删除和插入变化的行
+    void updatePreview(HWND wnd, Pin::RulePreview& preview)
+    {
+        AutoPinRule rule;
+        readRuleFields(wnd, rule);
+        if (preview.update(rule)) {
+            HWND list = GetDlgItem(wnd, IDC_RULE_PREVIEW);
+            const size_t MANY_CHANGES = 64;   // 变化较多时暂停重绘，最后一次性绘制
+            bool many = preview.removed().size() + preview.inserted().size() > MANY_CHANGES;
+            if (many)
+                SendMessage(list, WM_SETREDRAW, FALSE, 0);
+
+            for (size_t pos : preview.removed())
+                ListView_DeleteItem(list, int(pos));
+
+            for (size_t pos : preview.inserted()) {
+                const Pin::RulePreview::Window& w = preview.window(preview.matched()[pos]);
+                LVITEM lvi;
+                lvi.mask = LVIF_TEXT | LVIF_PARAM;
+                lvi.iItem = int(pos);
+                lvi.iSubItem = 0;
+                lvi.pszText = const_cast<LPWSTR>(w.title.c_str());
+                lvi.lParam = LPARAM(w.id);
+                int i = ListView_InsertItem(list, &lvi);
+                if (i >= 0)
+                    ListView_SetItemText(list, i, 1, const_cast<LPWSTR>(w.cls.c_str()));
+            }
+
+            if (many) {
+                SendMessage(list, WM_SETREDRAW, TRUE, 0);
+                InvalidateRect(list, nullptr, TRUE);
+            }
+        }
+
+        WCHAR buf[Constants::MEDIUM_BUFFER_SIZE];
+        wsprintf(buf, LANG_MGR.getString(L"dialogs.edit_rule.preview_count").c_str(),
+            UINT(preview.matched().size()), UINT(preview.windowCount()));
+        SetDlgItemText(wnd, IDC_RULE_PREVIEW_COUNT, buf);
+    }
+
     BOOL CALLBACK apEditRuleDlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lparam)
     {
         static int tracking = 0;    // 0: none, 1: title, 2: class
@@ -91,6 +194,7 @@ namespace {
         static SIZE listMarg;
         static int  btnMarg;
         static HWND tooltip = nullptr;
+        static std::unique_ptr<Pin::RulePreview> preview;
 
         switch (msg) {
             case WM_INITDIALOG: {
@@ -109,6 +213,25 @@ namespace {
                 SetDlgItemText(wnd, IDC_DESCR, rule.descr.c_str());
                 SetDlgItemText(wnd, IDC_TITLE, rule.ttl.c_str());
                 SetDlgItemText(wnd, IDC_CLASS, rule.cls.c_str());
+                SetDlgItemText(wnd, IDC_PROC, rule.proc.c_str());
+
+                // 进程匹配属性，顺序与Pin::ProcessField一致
+                LPCWSTR procFields[] = {
+                    L"dialogs.edit_rule.process_name",
+                    L"dialogs.edit_rule.process_path",
+                    L"dialogs.edit_rule.process_package",
+                };
+                for (LPCWSTR key : procFields) {
+                    SendDlgItemMessage(wnd, IDC_PROC_FIELD, CB_ADDSTRING, 0, 
+                        LPARAM(LANG_MGR.getString(key).c_str()));
+                }
+                SendDlgItemMessage(wnd, IDC_PROC_FIELD, CB_SETCURSEL, WPARAM(rule.procField), 0);
+
+                // 匹配预览：窗口快照只获取一次，之后每次输入只重新匹配
+                preview = std::make_unique<Pin::RulePreview>();
+                preview->setWindows(capturePreviewWindows());
+                initPreviewList(GetDlgItem(wnd, IDC_RULE_PREVIEW));
+                updatePreview(wnd, *preview);
 
                 HICON target = LoadCursor(app.inst, MAKEINTRESOURCE(IDC_BULLSEYE));
                 IconCtl::subclass(GetDlgItem(wnd, IDC_TTLPICK), target);
@@ -141,6 +264,16 @@ namespace {
             }
             case WM_DESTROY: {
                 DestroyWindow(tooltip);
+                KillTimer(wnd, PREVIEW_TIMER_ID);
+                preview.reset();
+                return true;
+            }
+            case WM_TIMER: {
+                if (wparam == PREVIEW_TIMER_ID) {
+                    KillTimer(wnd, PREVIEW_TIMER_ID);
+                    if (preview)
+                        updatePreview(wnd, *preview);
+                }
                 return true;
             }
             case WM_MOUSEMOVE: {
@@ -193,10 +326,7 @@ namespace {
                     case IDOK: {
                         AutoPinRule& rule = 
                             *reinterpret_cast<AutoPinRule*>(GetWindowLongPtr(wnd, GWLP_USERDATA));
-                        WCHAR buf[Constants::MAX_CLASSNAME_LEN];
-                        GetDlgItemText(wnd, IDC_DESCR, buf, sizeof(buf));  rule.descr = buf;
-                        GetDlgItemText(wnd, IDC_TITLE, buf, sizeof(buf));  rule.ttl = buf;
-                        GetDlgItemText(wnd, IDC_CLASS, buf, sizeof(buf));  rule.cls = buf;
+                        readRuleFields(wnd, rule);
                         // allow empty strings (at least title can be empty...)
                         //if (rule.ttl.empty()) rule.ttl = "*";
                         //if (rule.cls.empty()) rule.cls = "*";          
@@ -204,6 +334,16 @@ namespace {
                     case IDCANCEL:
                         EndDialog(wnd, id);
                         return true;
+                    case IDC_TITLE:
+                    case IDC_CLASS:
+                    case IDC_PROC:
+                    case IDC_PROC_FIELD: {
+                        // 输入停顿后再更新预览，连续输入只匹配一次
+                        WORD code = HIWORD(wparam);
+                        if (code == EN_CHANGE || code == CBN_SELCHANGE)
+                            SetTimer(wnd, PREVIEW_TIMER_ID, Constants::RULE_PREVIEW_DELAY, nullptr);
+                        return true;
+                    }
                     case IDC_TTLPICK:
                     case IDC_CLSPICK: {
                         if (HIWORD(wparam) == STN_CLICKED) {
@@ -226,6 +366,88 @@ namespace {
 }
 
 
+namespace {
+    // 规则列表的统计列（第0列为规则描述）
+    enum StatsColumn {
+        COL_EVALUATIONS = 1,
+        COL_MATCHES,
+        COL_PINS,
+        COL_FAILED,
+        COL_TIME,
+        COL_LAST_MATCH,
+        COL_COUNT
+    };
+
+    const struct {
+        LPCWSTR key;        // dialogs.autopin 下的本地化键
+        LPCWSTR fallback;   // 本地化失败时的英文标题
+        int fmt;
+    } STATS_COLUMNS[] = {
+        { L"stats_evaluations", L"Evaluations", LVCFMT_RIGHT },
+        { L"stats_matches",     L"Matches",     LVCFMT_RIGHT },
+        { L"stats_pins",        L"Pins",        LVCFMT_RIGHT },
+        { L"stats_failed",      L"Failed",      LVCFMT_RIGHT },
+        { L"stats_time",        L"Time (ms)",   LVCFMT_RIGHT },
+        { L"stats_last_match",  L"Last match",  LVCFMT_LEFT },
+    };
+
+    const UINT_PTR STATS_TIMER_ID = 1;
+    const UINT STATS_REFRESH_INTERVAL = 1000;   // 统计列刷新间隔（毫秒）
+
+    // 最近匹配时间（Unix时间，毫秒）转换为本地时间文本
+    std::wstring formatLastMatch(int64_t unixMs)
+    {
+        if (unixMs <= 0)
+            return L"";
+
+        // FILETIME以1601-01-01为起点，单位100纳秒
+        ULARGE_INTEGER li;
+        li.QuadPart = (ULONGLONG(unixMs) + 11644473600000ULL) * 10000ULL;
+        FILETIME ft = { li.LowPart, li.HighPart };
+        SYSTEMTIME utc, local;
+        if (!FileTimeToSystemTime(&ft, &utc) || !SystemTimeToTzSpecificLocalTime(nullptr, &utc, &local))
+            return L"";
+
+        WCHAR buf[32];
+        swprintf_s(buf, L"%04u-%02u-%02u %02u:%02u:%02u",
+            local.wYear, local.wMonth, local.wDay, local.wHour, local.wMinute, local.wSecond);
+        return buf;
+    }
+
+    std::wstring formatStat(const Pin::RuleStats& stats, int col)
+    {
+        switch (col) {
+            case COL_EVALUATIONS: return std::to_wstring(stats.evaluations.load(std::memory_order_relaxed));
+            case COL_MATCHES:     return std::to_wstring(stats.matches.load(std::memory_order_relaxed));
+            case COL_PINS:        return std::to_wstring(stats.pinsCreated.load(std::memory_order_relaxed));
+            case COL_FAILED:      return std::to_wstring(stats.pinsFailed.load(std::memory_order_relaxed));
+            case COL_TIME: {
+                WCHAR buf[32];
+                swprintf_s(buf, L"%.2f", stats.matchTime.load(std::memory_order_relaxed) / 1e6);
+                return buf;
+            }
+            case COL_LAST_MATCH:  return formatLastMatch(stats.lastMatch.load(std::memory_order_relaxed));
+            default:              return L"";
+        }
+    }
+
+    // CSV字段：包含分隔符、引号或换行时加引号并转义
+    std::wstring csvField(const std::wstring& s)
+    {
+        if (s.find_first_of(L",\"\r\n") == std::wstring::npos)
+            return s;
+        std::wstring out = L"\"";
+        for (wchar_t ch : s) {
+            if (ch == L'"')
+                out += L'"';
+            out += ch;
+        }
+        out += L'"';
+        return out;
+    }
+}
+
+
 // 处理与列表控件交互的实用类。
 //
 class RulesList {
@@ -236,27 +458,35 @@ public:
     void term();
 
     void setAll(const AutoPinRules& rules);
-    void getAll(AutoPinRules& rules);
-    void remove(std::vector<int> indices);
+    void getAll(AutoPinRules& rules) const;
+    void remove(const std::vector<int>& indices);
 
-    int  addNew();
+    int  add(const AutoPinRule& rule);
     bool getRule(int i, AutoPinRule& rule) const;
     bool setRule(int i, const AutoPinRule& rule);
+    void toggleEnabled(int i);
 
     void selectSingleRule(int i);
     int  getFirstSel() const;
     std::vector<int> getSel() const;
-    void setItemSel(int i, bool sel);
     bool getItemSel(int i) const;
 
     void moveSelUp();
     void moveSelDown();
 
+    void setFilter(const std::wstring& text);
+    int  findItem(const NMLVFINDITEM& find) const;
+    const AutoPinRule* getData(int i) const;
+
+    void refreshStats();
+    bool exportStats(const std::wstring& path) const;
+
     operator HWND() const
     {
         return list;
     }
 
+    // 虚拟列表不会自动切换复选框，点击状态图标时由这里切换
     void checkClick(HWND page)
     {
         DWORD xy = GetMessagePos();
@@ -266,6 +496,7 @@ public:
         ScreenToClient(list, &hti.pt);
         int i = ListView_HitTest(list, &hti);
         if (i >= 0 && hti.flags & LVHT_ONITEMSTATEICON) {
+            toggleEnabled(i);
             Window::psChanged(page);
         }
     }
@@ -273,10 +504,10 @@ public:
 protected:
     HWND list;
     std::wstring m_columnHeaderText; // 存储本地化的列标题文本
+    RuleView<AutoPinRule> m_rules;   // 列表显示的规则，列表控件只保存条目数
 
-    AutoPinRule* getData(int i) const;
-    bool setData(int i, AutoPinRule* rule);
-
+    void setSel(const std::vector<int>& sel);
+    void updateCount();
 };
 
 
@@ -288,7 +519,7 @@ RulesList::RulesList() : list(nullptr)
 void RulesList::init(HWND wnd)
 {
     list = wnd;
-    ListView_SetExtendedListViewStyle(list, LVS_EX_CHECKBOXES);
+    ListView_SetExtendedListViewStyle(list, LVS_EX_CHECKBOXES | LVS_EX_DOUBLEBUFFER);
     ListView_SetCallbackMask(list, LVIS_STATEIMAGEMASK);
 
     // 调整列宽度以适应客户区宽度
@@ -317,106 +548,81 @@ void RulesList::init(HWND wnd)
     
     lvc.pszText = const_cast<LPWSTR>(m_columnHeaderText.c_str());
     ListView_InsertColumn(list, 0, LPARAM(&lvc));
+
+    // 规则统计列，位于规则描述右侧（水平滚动查看）
+    for (int n = 0; n < COL_COUNT - 1; ++n) {
+        std::wstring key = std::wstring(L"dialogs.autopin.") + STATS_COLUMNS[n].key;
+        std::wstring text = LANG_MGR.getString(key);
+        if (text.empty() || text == key) {
+            text = STATS_COLUMNS[n].fallback;
+        }
+        lvc.fmt = STATS_COLUMNS[n].fmt;
+        lvc.pszText = const_cast<LPWSTR>(text.c_str());
+        ListView_InsertColumn(list, n + 1, LPARAM(&lvc));
+        ListView_SetColumnWidth(list, n + 1, LVSCW_AUTOSIZE_USEHEADER);
+    }
 }
 
 
 void RulesList::term()
 {
     list = nullptr;
+    m_rules.assign(AutoPinRules());
 }
 
 
-// set all the rules to the list
+// 列表条目数改变后通知列表控件（虚拟列表只需要条目数）
 //
-void RulesList::setAll(const AutoPinRules& rules)
+void RulesList::updateCount()
 {
-    for (int n = 0; n < int(rules.size()); ++n) {
-        int i = addNew();
-        if (i < 0)
-            continue;
-        AutoPinRule* rule = getData(i);
-        if (!rule)
-            continue;
-        *rule = rules[n];
-    }
+    ListView_SetItemCountEx(list, int(m_rules.size()), LVSICF_NOSCROLL);
+    InvalidateRect(list, nullptr, FALSE);
 }
 
 
-// get all the rules from the list
+// set all the rules to the list
 //
-void RulesList::getAll(AutoPinRules& rules)
+void RulesList::setAll(const AutoPinRules& rules)
 {
-    rules.clear();
-
-    int cnt = ListView_GetItemCount(list);
-    for (int n = 0; n < cnt; ++n) {
-        const AutoPinRule* rule = getData(n);
-        if (!rule)
-            continue;
-        rules.push_back(*rule);
-    }
+    m_rules.assign(rules);
+    ListView_SetItemState(list, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    updateCount();
 }
 
 
-void RulesList::remove(std::vector<int> indices)
+// get all the rules from the list (including those hidden by the filter)
+//
+void RulesList::getAll(AutoPinRules& rules) const
 {
-    for (int n = static_cast<int>(indices.size())-1; n >= 0; --n)
-        ListView_DeleteItem(list, indices[n]);
+    rules = m_rules.rules();
 }
 
 
-// add a new, empty list item (with a valid data object)
-//
-int RulesList::addNew()
+void RulesList::remove(const std::vector<int>& indices)
 {
-    // 获取本地化的新规则描述文本
-    std::wstring newRuleDesc = LANG_MGR.getString(L"strings.new_rule_description");
-    if (newRuleDesc.empty() || newRuleDesc == L"strings.new_rule_description") {
-        // 回退到英文
-        newRuleDesc = L"<New>";
-    }
-    
-    // 使用智能指针管理内存，并传入本地化的描述文本
-    std::unique_ptr<AutoPinRule> rule = std::make_unique<AutoPinRule>(newRuleDesc);
-
-    LVITEM lvi;
-    lvi.mask = LVIF_TEXT | LVIF_PARAM;
-    lvi.iItem = ListView_GetItemCount(list);
-    lvi.iSubItem = 0;
-    lvi.pszText = LPSTR_TEXTCALLBACK;
-    lvi.lParam = LPARAM(rule.get());
-    int i = ListView_InsertItem(list, &lvi);
-    if (i >= 0) {
-        rule.release(); // 成功插入，释放所有权给列表控件
-    }
-    // 如果插入失败，智能指针会自动清理内存
-
-    return i;
+    if (indices.empty())
+        return;
+    m_rules.remove(indices);
+    ListView_SetItemState(list, -1, 0, LVIS_SELECTED);
+    updateCount();
 }
 
 
-// get the data object of an item
+// 在末尾添加规则，返回新条目的位置
 //
-AutoPinRule* RulesList::getData(int i) const
+int RulesList::add(const AutoPinRule& rule)
 {
-    LVITEM lvi;
-    lvi.mask = LVIF_PARAM;
-    lvi.iItem = i;
-    lvi.iSubItem = 0;
-    return ListView_GetItem(list, &lvi) ? (AutoPinRule*)lvi.lParam : nullptr;
+    int i = int(m_rules.add(rule));
+    updateCount();
+    return i;
 }
 
 
-// set the data object of an item
+// get the rule of an item (or null if out of range)
 //
-bool RulesList::setData(int i, AutoPinRule* rule)
+const AutoPinRule* RulesList::getData(int i) const
 {
-    LVITEM lvi;
-    lvi.mask = LVIF_PARAM;
-    lvi.iItem = i;
-    lvi.iSubItem = 0;
-    lvi.lParam = LPARAM(rule);
-    return !!ListView_SetItem(list, &lvi);
+    return i >= 0 && i < int(m_rules.size()) ? &m_rules.at(i) : nullptr;
 }
 
 
@@ -436,24 +642,31 @@ bool RulesList::getRule(int i, AutoPinRule& rule) const
 //
 bool RulesList::setRule(int i, const AutoPinRule& rule)
 {
-    AutoPinRule* r = getData(i);
-    if (!r)
+    if (!getData(i))
         return false;
-    *r = rule;
+    m_rules.at(i) = rule;
+    m_rules.updated(i);
     ListView_Update(list, i);
-    // use this to update the focus rect size
-    ListView_SetItemText(list, i, 0, LPSTR_TEXTCALLBACK);
     return true;
 }
 
 
+void RulesList::toggleEnabled(int i)
+{
+    if (!getData(i))
+        return;
+    m_rules.at(i).enabled = !m_rules.at(i).enabled;
+    ListView_Update(list, i);
+}
+
+
 // select (highlight) an item and de-select the rest
 //
 void RulesList::selectSingleRule(int i)
 {
-    int cnt = ListView_GetItemCount(list);
-    for (int n = 0; n < cnt; ++n)
-        ListView_SetItemState(list, n, n==i ? LVIS_SELECTED : 0, LVIS_SELECTED);
+    ListView_SetItemState(list, -1, 0, LVIS_SELECTED);
+    ListView_SetItemState(list, i, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_EnsureVisible(list, i, FALSE);
 }
 
 
@@ -462,13 +675,7 @@ void RulesList::selectSingleRule(int i)
 //
 int RulesList::getFirstSel() const
 {
-    int cnt = ListView_GetItemCount(list);
-    for (int n = 0; n < cnt; ++n) {
-        UINT state = ListView_GetItemState(list, n, LVIS_SELECTED);
-        if (state & LVIS_SELECTED)
-            return n;
-    }
-    return -1;
+    return ListView_GetNextItem(list, -1, LVNI_SELECTED);
 }
 
 
@@ -477,22 +684,18 @@ int RulesList::getFirstSel() const
 std::vector<int> RulesList::getSel() const
 {
     std::vector<int> ret;
-    int cnt = ListView_GetItemCount(list);
-    for (int n = 0; n < cnt; ++n) {
-        UINT state = ListView_GetItemState(list, n, LVIS_SELECTED);
-        if (state & LVIS_SELECTED)
-            ret.push_back(n);
-    }
+    ret.reserve(ListView_GetSelectedCount(list));
+    for (int i = -1; (i = ListView_GetNextItem(list, i, LVNI_SELECTED)) != -1; )
+        ret.push_back(i);
     return ret;
 }
 
 
-void RulesList::setItemSel(int i, bool sel)
+void RulesList::setSel(const std::vector<int>& sel)
 {
-    UINT state = ListView_GetItemState(list, i, LVIS_SELECTED);
-    bool curSel = (state & LVIS_SELECTED) != 0;
-    if (curSel != sel)
-        ListView_SetItemState(list, i, sel ? LVIS_SELECTED : 0, LVIS_SELECTED);
+    ListView_SetItemState(list, -1, 0, LVIS_SELECTED);
+    for (int i : sel)
+        ListView_SetItemState(list, i, LVIS_SELECTED, LVIS_SELECTED);
 }
 
 
@@ -503,61 +706,103 @@ bool RulesList::getItemSel(int i) const
 }
 
 
+// 选中的规则整体移动一位，然后一次重绘受影响的范围
+//
 void RulesList::moveSelUp()
 {
-    int cnt = ListView_GetItemCount(list);
     std::vector<int> sel = getSel();
-    // nop if:
-    // - nothing's selected
-    // - everything's selected
-    // - the first item is selected
-    if (!sel.size() || sel.size() == cnt || sel.front() == 0)
+    if (!m_rules.moveUp(sel))
         return;
+    setSel(sel);
+    ListView_EnsureVisible(list, sel.front(), FALSE);
+    ListView_RedrawItems(list, sel.front(), sel.back() + 1);
+}
 
-    // swap each selected item with the one before it
-    for (int n = 0; n < int(sel.size()); ++n) {
-        int i = sel[n];
-        // move data
-        AutoPinRule* tmp = getData(i-1);
-        setData(i-1, getData(i));
-        setData(i,   tmp);
-        // move selection
-        setItemSel(i-1, true);
-        setItemSel(i,   false);
-        // notify for text change
-        ListView_SetItemText(list, i-1, 0, LPSTR_TEXTCALLBACK);
-        ListView_SetItemText(list, i, 0, LPSTR_TEXTCALLBACK);
-    }
 
+void RulesList::moveSelDown()
+{
+    std::vector<int> sel = getSel();
+    if (!m_rules.moveDown(sel))
+        return;
+    setSel(sel);
+    ListView_EnsureVisible(list, sel.back(), FALSE);
+    ListView_RedrawItems(list, sel.front() - 1, sel.back());
 }
 
 
-void RulesList::moveSelDown()
+// 按描述、标题和类名过滤显示的规则
+//
+void RulesList::setFilter(const std::wstring& text)
+{
+    if (!m_rules.setFilter(text))
+        return;
+    ListView_SetItemState(list, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_SetItemCountEx(list, int(m_rules.size()), 0);
+}
+
+
+// 列表控件的键入查找（LVN_ODFINDITEM），按描述前缀匹配
+//
+int RulesList::findItem(const NMLVFINDITEM& find) const
+{
+    if (!(find.lvfi.flags & (LVFI_STRING | LVFI_PARTIAL)) || !find.lvfi.psz)
+        return -1;
+    int start = find.iStart < 0 || find.iStart >= int(m_rules.size()) ? 0 : find.iStart;
+    int i = m_rules.findPrefix(find.lvfi.psz, start);
+    // 不允许回绕时，不接受位于起点之前的结果
+    if (i >= 0 && i < start && !(find.lvfi.flags & LVFI_WRAP))
+        return -1;
+    return i;
+}
+
+
+// 重绘统计列（统计由自动图钉检查实时更新），只重绘可见的行
+//
+void RulesList::refreshStats()
 {
     int cnt = ListView_GetItemCount(list);
-    std::vector<int> sel = getSel();
-    // nop if:
-    // - nothing's selected
-    // - everything's selected
-    // - the last item is selected
-    if (!sel.size() || sel.size() == cnt || sel.back() == cnt-1)
+    if (cnt <= 0)
         return;
+    int top = ListView_GetTopIndex(list);
+    int last = (std::min)(cnt - 1, top + ListView_GetCountPerPage(list));
+    ListView_RedrawItems(list, top, last);
+}
+
 
-    // swap each selected item with the one after it
-    for (int n = static_cast<int>(sel.size())-1; n >= 0 ; --n) {
-        int i = sel[n];
-        // move data
-        AutoPinRule* tmp = getData(i+1);
-        setData(i+1, getData(i));
-        setData(i,   tmp);
-        // move selection
-        setItemSel(i+1, true);
-        setItemSel(i,   false);
-        // notify for text change
-        ListView_SetItemText(list, i+1, 0, LPSTR_TEXTCALLBACK);
-        ListView_SetItemText(list, i, 0, LPSTR_TEXTCALLBACK);
+// 把所有规则（包括被过滤隐藏的）的统计导出为UTF-8 CSV文件
+//
+bool RulesList::exportStats(const std::wstring& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    std::wstringstream csv;
+    csv << L"Description,Title,Class,Process,Enabled,Evaluations,Matches,PinsCreated,PinsFailed,"
+           L"MatchTimeMs,AvgMatchNs,LastMatch\r\n";
+
+    for (const AutoPinRule& rule : m_rules.rules()) {
+        const Pin::RuleStats& stats = *rule.stats;
+        uint64_t evaluations = stats.evaluations.load(std::memory_order_relaxed);
+        uint64_t matchTime = stats.matchTime.load(std::memory_order_relaxed);
+        csv << csvField(rule.descr) << L','
+            << csvField(rule.ttl) << L','
+            << csvField(rule.cls) << L','
+            << csvField(rule.proc) << L','
+            << (rule.enabled ? 1 : 0) << L','
+            << evaluations << L','
+            << formatStat(stats, COL_MATCHES) << L','
+            << formatStat(stats, COL_PINS) << L','
+            << formatStat(stats, COL_FAILED) << L','
+            << formatStat(stats, COL_TIME) << L','
+            << (evaluations ? matchTime / evaluations : 0) << L','
+            << formatLastMatch(stats.lastMatch.load(std::memory_order_relaxed)) << L"\r\n";
     }
 
+    // 带BOM，方便表格软件识别编码
+    std::string utf8 = "\xEF\xBB\xBF" + Foundation::StringUtils::wideToUtf8(csv.str());
+    file.write(utf8.data(), utf8.size());
+    return file.good();
 }
 
 
@@ -623,6 +868,8 @@ bool OptAutoPin::evInitDialog(HWND wnd, HWND focus, LPARAM param)
 
     rlist.init(GetDlgItem(wnd, IDC_LIST));
     rlist.setAll(opt.autoPinRules);
+    Edit_SetCueBannerText(GetDlgItem(wnd, IDC_RULE_FILTER), LANG_MGR.getString(L"dialogs.autopin.filter").c_str());
+    SetTimer(wnd, STATS_TIMER_ID, STATS_REFRESH_INTERVAL, nullptr);
 
     uiUpdate(wnd);
 
@@ -652,12 +899,165 @@ void OptAutoPin::apply(HWND wnd, WindowCreationMonitor& winCreMon)
         KillTimer(app.mainWnd, App::TIMERID_AUTOPIN);
 
     rlist.getAll(opt.autoPinRules);
+    opt.autoPinRulesChanged();
     
     // 立即保存设置到INI文件
     opt.saveImmediately();
 }
 
 
+// 在按钮下方弹出菜单，菜单项为 dialogs.autopin 下的本地化文本。
+// 返回选中项的序号（从1开始），取消时返回0。
+//
+static int buttonMenu(HWND wnd, int buttonId, std::initializer_list<LPCWSTR> keys)
+{
+    HMENU menu = CreatePopupMenu();
+    if (!menu)
+        return 0;
+
+    UINT id = 0;
+    for (LPCWSTR key : keys)
+        AppendMenu(menu, MF_STRING, ++id, LANG_MGR.getString(std::wstring(L"dialogs.autopin.") + key).c_str());
+
+    RECT rc;
+    GetWindowRect(GetDlgItem(wnd, buttonId), &rc);
+    int cmd = TrackPopupMenu(menu, TPM_RETURNCMD | TPM_NONOTIFY | TPM_LEFTALIGN | TPM_TOPALIGN,
+        rc.left, rc.bottom, 0, wnd, nullptr);
+    DestroyMenu(menu);
+    return cmd;
+}
+
+
+// 从JSON文件导入规则，按描述与列表中的规则合并。
+// 导入在副本上进行，失败时列表不变；按“应用”后和其它修改一起一次写入规则文件。
+//
+bool OptAutoPin::cmImport(HWND wnd)
+{
+    static const RuleExchange::MergePolicy policies[] = {
+        RuleExchange::MergePolicy::Skip,
+        RuleExchange::MergePolicy::Overwrite,
+        RuleExchange::MergePolicy::KeepBoth,
+    };
+    int cmd = buttonMenu(wnd, IDC_IMPORT_RULES, { L"import_skip", L"import_overwrite", L"import_keep_both" });
+    if (cmd <= 0)
+        return true;
+
+    WCHAR path[MAX_PATH] = L"";
+    OPENFILENAME ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = wnd;
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrFilter = L"JSON文件\0*.json\0所有文件\0*.*\0";
+    ofn.nFilterIndex = 1;
+    ofn.lpstrDefExt = L"json";
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
+
+    if (!GetOpenFileName(&ofn))
+        return true;
+
+    AutoPinRules rules;
+    rlist.getAll(rules);
+
+    RuleExchange::ImportResult res;
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (file.is_open())
+        res = RuleExchange::importRules(file, rules, policies[cmd - 1]);
+    else
+        res.error = "cannot open file";
+
+    if (!res.ok()) {
+        std::wstring detail = Foundation::StringUtils::utf8ToWide(res.error) +
+            L" (offset " + std::to_wstring(res.offset) + L")";
+        LOG_WARNING(std::wstring(L"导入自动图钉规则失败: ") + path + L": " + detail);
+
+        std::wstring msg = LANG_MGR.getString(L"strings.rules_import_error");
+        size_t pos = msg.find(L"%s");
+        if (pos != std::wstring::npos)
+            msg.replace(pos, 2, detail);
+        Foundation::ErrorHandler::error(wnd, msg.c_str());
+        return true;
+    }
+
+    rlist.setAll(rules);
+    uiUpdate(wnd);
+    Window::psChanged(wnd);
+
+    LOG_EVENT(LogLevel::INFO, "导入自动图钉规则: {}, 新增 {}, 替换 {}, 跳过 {}",
+        path, res.added, res.replaced, res.skipped);
+
+    WCHAR buf[Constants::MEDIUM_BUFFER_SIZE];
+    wsprintf(buf, LANG_MGR.getString(L"strings.rules_import_result").c_str(),
+        UINT(res.total()), UINT(res.added), UINT(res.replaced), UINT(res.skipped));
+    Foundation::ErrorHandler::Handler::show(wnd, Foundation::ErrorHandler::ErrorLevel::Info, buf);
+    return true;
+}
+
+
+bool OptAutoPin::cmExport(HWND wnd)
+{
+    switch (buttonMenu(wnd, IDC_EXPORT_STATS, { L"export_rules", L"export_stats_csv" })) {
+        case 1:  return exportRules(wnd);
+        case 2:  return exportStats(wnd);
+        default: return true;
+    }
+}
+
+
+// 把列表中的规则导出为JSON，可以用“导入”在其它机器上合并
+//
+bool OptAutoPin::exportRules(HWND wnd)
+{
+    WCHAR path[MAX_PATH] = L"autopin_rules.json";
+    OPENFILENAME ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = wnd;
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrFilter = L"JSON文件\0*.json\0所有文件\0*.*\0";
+    ofn.nFilterIndex = 1;
+    ofn.lpstrDefExt = L"json";
+    ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_HIDEREADONLY;
+
+    if (!GetSaveFileName(&ofn))
+        return true;
+
+    AutoPinRules rules;
+    rlist.getAll(rules);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !RuleExchange::exportRules(file, rules.begin(), rules.end())) {
+        LOG_WARNING(std::wstring(L"导出自动图钉规则失败: ") + path);
+        Foundation::ErrorHandler::error(wnd, LANG_MGR.getString(L"strings.rules_export_error").c_str());
+    }
+    return true;
+}
+
+
+bool OptAutoPin::exportStats(HWND wnd)
+{
+    WCHAR path[MAX_PATH] = L"autopin_stats.csv";
+    OPENFILENAME ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = wnd;
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrFilter = L"CSV文件\0*.csv\0所有文件\0*.*\0";
+    ofn.nFilterIndex = 1;
+    ofn.lpstrDefExt = L"csv";
+    ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_HIDEREADONLY;
+
+    if (!GetSaveFileName(&ofn))
+        return true;
+
+    if (!rlist.exportStats(path)) {
+        LOG_WARNING(std::wstring(L"导出规则统计失败: ") + path);
+        Foundation::ErrorHandler::error(wnd, LANG_MGR.getString(L"strings.stats_export_error").c_str());
+    }
+    return true;
+}
+
+
 bool OptAutoPin::validate(HWND wnd)
 {
     Options& opt = reinterpret_cast<OptionsPropSheetData*>(GetWindowLongPtr(wnd, GWLP_USERDATA))->opt;
@@ -672,9 +1072,17 @@ BOOL CALLBACK OptAutoPin::dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lpar
             return evInitDialog(wnd, HWND(wparam), lparam);
         }
         case WM_DESTROY: {
+            KillTimer(wnd, STATS_TIMER_ID);
             rlist.term();
             return true;
         }
+        case WM_TIMER: {
+            if (wparam == STATS_TIMER_ID) {
+                rlist.refreshStats();
+                return true;
+            }
+            return false;
+        }
         case WM_NOTIFY: {
             NMHDR nmhdr = *reinterpret_cast<NMHDR*>(lparam);
             switch (nmhdr.code) {
@@ -710,6 +1118,26 @@ BOOL CALLBACK OptAutoPin::dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lpar
                 if (nmlv.uChanged == LVIF_STATE) uiUpdate(wnd);
                 return true;
             }
+            case LVN_ODSTATECHANGED: {
+                // 虚拟列表中一次选中一个范围时只发送这个通知
+                uiUpdate(wnd);
+                return true;
+            }
+            case LVN_ODFINDITEM: {
+                const NMLVFINDITEM& find = *(NMLVFINDITEM*)lparam;
+                SetWindowLongPtr(wnd, DWLP_MSGRESULT, rlist.findItem(find));
+                return true;
+            }
+            case LVN_KEYDOWN: {
+                // 空格切换选中规则的启用状态（虚拟列表不会自动切换复选框）
+                const NMLVKEYDOWN& kd = *(NMLVKEYDOWN*)lparam;
+                if (kd.wVKey == VK_SPACE) {
+                    for (int i : rlist.getSel())
+                        rlist.toggleEnabled(i);
+                    Window::psChanged(wnd);
+                }
+                return true;
+            }
             case NM_CLICK: {
                 rlist.checkClick(wnd);
                 return true;
@@ -737,44 +1165,25 @@ BOOL CALLBACK OptAutoPin::dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lpar
                 }
                 return true;
             }
-            case LVN_DELETEITEM: {
-                NMLISTVIEW& nmlv = *(NMLISTVIEW*)lparam;
-                LVITEM lvi;
-                lvi.mask = TVIF_PARAM;
-                lvi.iItem = nmlv.iItem;
-                lvi.iSubItem = 0;
-                if (ListView_GetItem(nmlv.hdr.hwndFrom, &lvi))
-                    delete (AutoPinRule*)lvi.lParam;
-                return true;
-            }
             case LVN_GETDISPINFO: {
                 NMLVDISPINFO& di = *(NMLVDISPINFO*)lparam;
-                const AutoPinRule* rule = (AutoPinRule*)di.item.lParam;
+                const AutoPinRule* rule = rlist.getData(di.item.iItem);
                 if (!rule)
                     return false;
                 // fill in the requested fields
                 if (di.item.mask & LVIF_TEXT) {
                     //di.item.cchTextMax is 260..264 bytes
-                    std::wstring s = rule->descr;
+                    std::wstring s = di.item.iSubItem == 0 ? rule->descr : formatStat(*rule->stats, di.item.iSubItem);
                     if (int(s.length()) > di.item.cchTextMax-1)
                         s = s.substr(0, di.item.cchTextMax-1);
                     wcscpy_s(di.item.pszText, di.item.cchTextMax, s.c_str());
                 }
-                if (di.item.mask & LVIF_STATE) {
+                if ((di.item.mask & LVIF_STATE) && di.item.iSubItem == 0) {
                     di.item.stateMask = LVIS_STATEIMAGEMASK;
                     di.item.state = INDEXTOSTATEIMAGEMASK(rule->enabled ? 2 : 1);
                 }
                 return true;
             }
-            case LVN_ITEMCHANGING: {
-                NMLISTVIEW& nm = *(NMLISTVIEW*)lparam;
-                AutoPinRule* rule = (AutoPinRule*)nm.lParam;
-                if (nm.uChanged & LVIF_STATE && nm.uNewState & LVIS_STATEIMAGEMASK) {
-                    rule->enabled = !rule->enabled;
-                    ListView_Update(nm.hdr.hwndFrom, nm.iItem);
-                }
-                return true;
-            }
             default:
                 return false;
             }
@@ -795,9 +1204,7 @@ BOOL CALLBACK OptAutoPin::dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lpar
                     int res = Util::Res::LocalizedDialogBoxParam(WORD(IDD_EDIT_AUTOPIN_RULE), 
                             wnd, (DLGPROC)apEditRuleDlgProc, LPARAM(&rule));
                     if (res == IDOK) {
-                        int i = rlist.addNew();
-                        if (i >= 0 && rlist.setRule(i, rule))
-                            rlist.selectSingleRule(i);
+                        rlist.selectSingleRule(rlist.add(rule));
                         Window::psChanged(wnd);
                     }
                     return true;
@@ -830,10 +1237,20 @@ BOOL CALLBACK OptAutoPin::dlgProc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lpar
                     Window::psChanged(wnd);
                     return true;
                 }
+                case IDC_IMPORT_RULES:  return cmImport(wnd);
+                case IDC_EXPORT_STATS:  return cmExport(wnd);
                 case IDC_RULE_DELAY:
                     if (code == EN_CHANGE)
                         Window::psChanged(wnd);
                     return true;
+                case IDC_RULE_FILTER:
+                    if (code == EN_CHANGE) {
+                        WCHAR text[Constants::MEDIUM_BUFFER_SIZE];
+                        GetDlgItemText(wnd, IDC_RULE_FILTER, text, Constants::MEDIUM_BUFFER_SIZE);
+                        rlist.setFilter(text);
+                        uiUpdate(wnd);
+                    }
+                    return true;
                 default:
                     return false;
             }
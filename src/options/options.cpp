@@ -1,10 +1,15 @@
 #include "core/stdafx.h"
 #include "options/options.h"
+#include "foundation/ini_document.h"
+#include "foundation/async_file_writer.h"
+#include "options/rule_file.h"
 #include "core/application.h"
 #include "system/logger.h"
 #include "system/language_manager.h"
 #include "foundation/string_utils.h"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <fstream>
 
 
@@ -53,26 +58,6 @@ HotKey::save(HKEY key, LPCWSTR val) const
 }
 
 
-bool 
-AutoPinRule::match(HWND wnd) const
-{
-    if (!enabled) {
-        return false;
-    }
-        
-    // 使用WndHelper获取窗口信息
-    Window::WndHelper helper(wnd);
-    std::wstring windowTitle = helper.getText();
-    std::wstring className = helper.getClassName();
-    
-    // 使用简单的通配符匹配
-    bool titleMatch = Foundation::StringUtils::wildcardMatch(ttl.c_str(), windowTitle.c_str());
-        bool classMatch = Foundation::StringUtils::wildcardMatch(cls.c_str(), className.c_str());
-    
-    return titleMatch && classMatch;
-}
-
-
 class NumFlagValueName {
     const int num;
 public:
@@ -170,18 +155,32 @@ Options::Options() :
     hotEnterPin(App::HOTID_ENTERPINMODE, VK_F11, MOD_CONTROL),
     hotTogglePin(App::HOTID_TOGGLEPIN, VK_F12, MOD_CONTROL),
     autoPinOn(false),
+    autoPinRulesGen(1),
     autoPinDelay(Constants::DEFAULT_AUTOPIN_DELAY, Constants::MIN_AUTOPIN_DELAY, Constants::MAX_AUTOPIN_DELAY, Constants::SMALL_BUFFER_SIZE),
-    language(L"")    // empty means auto-detect
+    autoPinSweep(false),
+    recordEvents(false),
+    binaryLog(false),
+    ruleProfiling(false),
+    language(L""),    // empty means auto-detect
+    m_iniHasRules(false),
+    m_iniWriter(std::make_unique<Foundation::AsyncFileWriter>(
+        Constants::SETTINGS_SAVE_DELAY, Constants::SETTINGS_SAVE_MAX_DELAY)),
+    m_savedRulesGen(0),
+    m_rulesLoadFailed(false),
+    m_rulesWriter(std::make_unique<Foundation::AsyncFileWriter>(
+        Constants::SETTINGS_SAVE_DELAY, Constants::SETTINGS_SAVE_MAX_DELAY))
 {
     // 为Win2K+设置更高的跟踪频率（更高的WM_TIMER分辨率）
     // Windows 2000的主版本号为5
     if (Platform::SystemInfo::getOsMajorVersion() >= 5)
         trackRate.value = Constants::DEFAULT_TRACK_RATE_NEW;
+    m_defaults = iniSettings();
 }
 
 
 Options::~Options()
 {
+    // 写入器析构时写入尚未写入的设置和规则
 }
 
 
@@ -189,7 +188,13 @@ bool
 Options::save() const
 {
     // 使用UTF-8兼容的格式化保存方法，避免中文乱码
-    if (!saveFormattedSettingsToIni()) {
+    // 程序即将退出，等待后台写入完成
+    bool ok = saveFormattedSettingsToIni() && m_rulesWriter->flush() && m_iniWriter->flush();
+    if (!ok && resetFailedWrites()) {
+        // 后台写入失败：重写整个文件再试一次
+        ok = saveFormattedSettingsToIni() && m_rulesWriter->flush() && m_iniWriter->flush();
+    }
+    if (!ok) {
         LOG_ERROR(L"保存设置到INI文件失败");
         return false;
     }
@@ -248,231 +253,417 @@ std::wstring Options::getIniFilePath() const
     return path;
 }
 
-void Options::loadLanguageFromIni()
+std::wstring Options::getRulesFilePath() const
 {
-    std::wstring iniPath = getIniFilePath();
-    
-    std::wstring value = readUtf8IniValue(iniPath, L"Settings", L"Language", L"");
-    
-    if (!value.empty()) {
-        language = value;
-    } else {
-        language = L"";  // 空字符串表示自动检测
-    }
+    std::wstring path = getIniFilePath();
+    return path.substr(0, path.size() - wcslen(L".ini")) + L".rules";
 }
 
 bool Options::loadSettingsFromIni()
 {
     std::wstring iniPath = getIniFilePath();
     
-    // 检查文件是否存在
-    if (GetFileAttributesW(iniPath.c_str()) == INVALID_FILE_ATTRIBUTES) {
-        return false;
+    // 整个文件只读取和解析一次，以下所有设置都从索引中读取。
+    // INI文件不存在或无法读取时（例如删除它以恢复默认设置）使用默认设置，但仍然加载规则文件
+    Foundation::IniDocument ini;
+    bool iniLoaded = ini.load(iniPath);
+    if (iniLoaded) {
+        readSettingsFromIni(ini);
     }
     
-    // 加载语言设置
-    loadLanguageFromIni();
-    
-    // 加载图钉设置
-    std::wstring value;
-    
-    value = readUtf8IniValue(iniPath, L"Pins", L"PinImagePath", L"");
-    if (!value.empty()) {
-        pinImagePath = value;
-    }
-    
-    value = readUtf8IniValue(iniPath, L"Pins", L"TrackRate", L"");
-    if (!value.empty()) {
-        int rate = _wtoi(value.c_str());
-        if (trackRate.inRange(rate)) {
-            trackRate = rate;
+    // 加载自动图钉规则，规则文件不存在时使用INI文件中的旧格式规则。
+    // 规则文件存在但无法读取时不使用旧格式规则，并且在重新读取成功之前不重写它
+    std::error_code ec;
+    bool rulesFileExists = std::filesystem::exists(getRulesFilePath(), ec) || ec;
+    if (rulesFileExists) {
+        if (!loadAutoPinRulesFromFile()) {
+            m_rulesLoadFailed = true;
+            LOG_ERROR(L"无法读取自动图钉规则文件，在重新读取成功之前不会修改它: " + getRulesFilePath());
+        } else if (iniLoaded) {
+            // 迁移之后INI文件中又出现了旧格式规则（例如恢复了旧的INI文件），合并后再次迁移
+            size_t added = mergeIniRules(ini);
+            if (m_iniHasRules) {
+                LOG_WARNING(L"INI文件中有旧格式的自动图钉规则，合并到规则文件，新增规则数: " + std::to_wstring(added));
+            }
         }
+    } else if (iniLoaded) {
+        mergeIniRules(ini);
     }
     
-    value = readUtf8IniValue(iniPath, L"Pins", L"TrayDblClick", L"");
-    if (!value.empty()) {
-        dblClkTray = (_wtoi(value.c_str()) != 0);
-    }
-    
-    // 加载热键设置
-    value = readUtf8IniValue(iniPath, L"Hotkeys", L"Enabled", L"");
-    if (!value.empty()) {
-        hotkeysOn = (_wtoi(value.c_str()) != 0);
+    if (!iniLoaded) {
+        return false;
     }
     
-    loadHotKeyFromIni(hotEnterPin, L"EnterPin");
-    loadHotKeyFromIni(hotTogglePin, L"TogglePin");
+    // 记录已保存的内容，设置没有变化时退出不再重写文件
+    markIniSaved(ini.text());
     
-    // 加载自动图钉设置
-    value = readUtf8IniValue(iniPath, L"AutoPin", L"Enabled", L"");
-    if (!value.empty()) {
-        autoPinOn = (_wtoi(value.c_str()) != 0);
-    }
-    
-    value = readUtf8IniValue(iniPath, L"AutoPin", L"Delay", L"");
-    if (!value.empty()) {
-        int delay = _wtoi(value.c_str());
-        if (autoPinDelay.inRange(delay)) {
-            autoPinDelay = delay;
+    // 自动迁移：写出规则文件，再重写不含规则的INI文件
+    if (m_iniHasRules) {
+        if (saveFormattedSettingsToIni()) {
+            LOG_INFO(L"自动图钉规则已迁移到规则文件: " + getRulesFilePath());
+        } else {
+            LOG_ERROR(L"迁移自动图钉规则失败");
         }
     }
     
-    loadAutoPinRulesFromIni();
-    
     return true;
 }
 
-bool Options::loadHotKeyFromIni(HotKey& hotkey, LPCWSTR keyName)
+void Options::readSettingsFromIni(const Foundation::IniDocument& ini)
 {
-    std::wstring iniPath = getIniFilePath();
+    // 文件中没有的设置保持当前值
+    OptionsReload::Settings settings = iniSettings();
+    OptionsReload::readSettings(ini, settings);
+    applyIniSettings(settings);
+}
+
+OptionsReload::Settings Options::iniSettings() const
+{
+    OptionsReload::Settings settings;
+    settings.language = language;
+    settings.pinImagePath = pinImagePath;
+    settings.trackRate = { trackRate.value, trackRate.minV, trackRate.maxV };
+    settings.dblClkTray = dblClkTray;
+    settings.hotkeysOn = hotkeysOn;
+    settings.hotEnterPin = { hotEnterPin.vk, hotEnterPin.mod };
+    settings.hotTogglePin = { hotTogglePin.vk, hotTogglePin.mod };
+    settings.autoPinOn = autoPinOn;
+    settings.autoPinDelay = { autoPinDelay.value, autoPinDelay.minV, autoPinDelay.maxV };
+    settings.autoPinProcesses = autoPinProcesses;
+    settings.autoPinSweep = autoPinSweep;
+    settings.recordEvents = recordEvents;
+    settings.binaryLog = binaryLog;
+    settings.ruleProfiling = ruleProfiling;
+    return settings;
+}
+
+void Options::applyIniSettings(const OptionsReload::Settings& settings)
+{
+    language = settings.language;
+    pinImagePath = settings.pinImagePath;
+    trackRate = settings.trackRate.value;
+    dblClkTray = settings.dblClkTray;
+    hotkeysOn = settings.hotkeysOn;
+    hotEnterPin.vk = settings.hotEnterPin.vk;
+    hotEnterPin.mod = settings.hotEnterPin.mod;
+    hotTogglePin.vk = settings.hotTogglePin.vk;
+    hotTogglePin.mod = settings.hotTogglePin.mod;
+    autoPinOn = settings.autoPinOn;
+    autoPinDelay = settings.autoPinDelay.value;
+    autoPinProcesses = settings.autoPinProcesses;
+    autoPinSweep = settings.autoPinSweep;
+    recordEvents = settings.recordEvents;
+    binaryLog = settings.binaryLog;    // 重新启动后生效
+    ruleProfiling = settings.ruleProfiling;
+}
+
+void Options::readAutoPinRulesFromIni(const Foundation::IniDocument& ini, AutoPinRules& rules)
+{
+    rules.clear();
     
-    // 加载虚拟键码
-    std::wstring vkKeyName = std::wstring(keyName) + L"_VK";
-    std::wstring value = readUtf8IniValue(iniPath, L"Hotkeys", vkKeyName, L"");
-    if (!value.empty()) {
-        hotkey.vk = static_cast<UINT>(_wtoi(value.c_str()));
+    // 加载规则数量
+    int ruleCount = ini.getInt(L"AutoPin", L"RuleCount", 0);
+    if (ruleCount <= 0) {
+        return; // 没有规则，这是正常的
     }
     
-    // 加载修饰键
-    std::wstring modKeyName = std::wstring(keyName) + L"_MOD";
-    value = readUtf8IniValue(iniPath, L"Hotkeys", modKeyName, L"");
-    if (!value.empty()) {
-        hotkey.mod = static_cast<UINT>(_wtoi(value.c_str()));
+    // 加载每个规则
+    rules.reserve(ruleCount);
+    std::wstring sectionName;
+    for (int i = 0; i < ruleCount; ++i) {
+        sectionName = L"AutoPinRule" + std::to_wstring(i);
+        AutoPinRule rule;
+        
+        // 加载描述
+        rule.descr = ini.get(sectionName, L"Description");
+        
+        // 加载标题匹配模式
+        rule.ttl = ini.get(sectionName, L"Title");
+        
+        // 加载类名匹配模式
+        rule.cls = ini.get(sectionName, L"Class");
+        
+        // 加载进程匹配模式和匹配属性
+        rule.proc = ini.get(sectionName, L"Process");
+        int procField = ini.getInt(sectionName, L"ProcessField", 0);
+        if (procField >= int(Pin::ProcessField::ImageName) && procField <= int(Pin::ProcessField::PackageFamily)) {
+            rule.procField = static_cast<Pin::ProcessField>(procField);
+        }
+        
+        // 加载启用状态
+        rule.enabled = ini.getInt(sectionName, L"Enabled", 1) != 0;
+        
+        rules.push_back(rule);
     }
-    
-    // 如果没有虚拟键码，清除修饰键
-    if (!hotkey.vk) {
-        hotkey.mod = 0;
+}
+
+namespace {
+    RuleFile::Record toRecord(const AutoPinRule& rule)
+    {
+        RuleFile::Record rec;
+        rec.descr = rule.descr;
+        rec.title = rule.ttl;
+        rec.cls = rule.cls;
+        rec.process = rule.proc;
+        rec.processField = int(rule.procField);
+        rec.enabled = rule.enabled;
+        return rec;
     }
-    
-    return true;
 }
 
-// UTF-8兼容的INI读取辅助函数
-std::wstring Options::readUtf8IniValue(const std::wstring& iniPath, const std::wstring& section, const std::wstring& key, const std::wstring& defaultValue) const
+bool Options::readRuleFile(std::vector<RuleFile::Record>& records) const
 {
     try {
-        // 使用utilities中的转换函数
-        std::string utf8Path = Foundation::StringUtils::wideToUtf8(iniPath);
-        
-        // 读取整个文件内容
-        std::ifstream file(utf8Path, std::ios::binary);
+        // 使用宽字符路径，安装路径中有非ASCII字符时也能打开
+        std::ifstream file(std::filesystem::path(getRulesFilePath()), std::ios::binary);
         if (!file.is_open()) {
-            return defaultValue;
+            return false;
         }
         
+        // 整个文件一次读入和转换，单遍解析
         std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        file.close();
-        
-        // 使用utilities中的转换函数
-        std::wstring wideContent = Foundation::StringUtils::utf8ToWide(content);
-        
-        // 查找目标section
-        std::wstring sectionHeader = L"[" + section + L"]";
-        size_t sectionPos = wideContent.find(sectionHeader);
-        if (sectionPos == std::wstring::npos) {
-            return defaultValue;
-        }
-        
-        // 从section开始位置查找key
-        size_t searchStart = sectionPos + sectionHeader.length();
-        size_t nextSectionPos = wideContent.find(L"[", searchStart);
-        if (nextSectionPos == std::wstring::npos) {
-            nextSectionPos = wideContent.length();
+        if (file.bad()) {
+            return false;
         }
-        
-        std::wstring sectionContent = wideContent.substr(searchStart, nextSectionPos - searchStart);
-        
-        // 查找key=value行
-        std::wstring keyPattern = key + L"=";
-        size_t keyPos = sectionContent.find(keyPattern);
-        if (keyPos == std::wstring::npos) {
-            return defaultValue;
+        RuleFile::parse(Foundation::StringUtils::utf8ToWide(content), records);
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool Options::loadAutoPinRulesFromFile()
+{
+    try {
+        std::vector<RuleFile::Record> records;
+        if (!readRuleFile(records)) {
+            return false;
         }
         
-        // 确保找到的是行的开始（前面是换行符或空白）
-        if (keyPos > 0) {
-            wchar_t prevChar = sectionContent[keyPos - 1];
-            if (prevChar != L'\n' && prevChar != L'\r' && prevChar != L' ' && prevChar != L'\t') {
-                // 继续查找下一个匹配
-                size_t nextPos = keyPos + keyPattern.length();
-                while (nextPos < sectionContent.length()) {
-                    keyPos = sectionContent.find(keyPattern, nextPos);
-                    if (keyPos == std::wstring::npos) {
-                        return defaultValue;
-                    }
-                    if (keyPos == 0 || sectionContent[keyPos - 1] == L'\n' || sectionContent[keyPos - 1] == L'\r') {
-                        break;
-                    }
-                    nextPos = keyPos + keyPattern.length();
-                }
-                if (keyPos == std::wstring::npos) {
-                    return defaultValue;
-                }
+        autoPinRules.clear();
+        autoPinRulesChanged();
+        autoPinRules.reserve(records.size());
+        m_savedRuleLines.clear();
+        m_savedRuleLines.reserve(records.size());
+        for (auto& rec : records) {
+            AutoPinRule rule(rec.descr, rec.title, rec.cls, rec.enabled, rec.process);
+            if (rec.processField >= int(Pin::ProcessField::ImageName) && rec.processField <= int(Pin::ProcessField::PackageFamily)) {
+                rule.procField = static_cast<Pin::ProcessField>(rec.processField);
             }
+            autoPinRules.push_back(std::move(rule));
+            
+            // 记录文件中已有的规则，之后添加的规则直接追加
+            std::wstring line;
+            RuleFile::format(line, toRecord(autoPinRules.back()));
+            m_savedRuleLines.push_back(std::move(line));
         }
-        
-        // 提取值
-        size_t valueStart = keyPos + keyPattern.length();
-        size_t lineEnd = sectionContent.find(L'\n', valueStart);
-        if (lineEnd == std::wstring::npos) {
-            lineEnd = sectionContent.length();
+        m_savedRulesGen = autoPinRulesGen;
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+// 把INI文件中的旧格式规则加入规则列表，已有相同内容的规则不重复添加，返回新增的规则数。
+// 有旧格式规则时设置m_iniHasRules，下次保存时写出规则文件并从INI文件中删除它们
+size_t Options::mergeIniRules(const Foundation::IniDocument& ini)
+{
+    AutoPinRules oldRules;
+    readAutoPinRulesFromIni(ini, oldRules);
+    if (oldRules.empty()) {
+        return 0;
+    }
+    m_iniHasRules = true;
+    
+    std::unordered_set<std::wstring> existing;
+    std::wstring line;
+    for (const AutoPinRule& rule : autoPinRules) {
+        line.clear();
+        RuleFile::format(line, toRecord(rule));
+        existing.insert(line);
+    }
+    
+    size_t added = 0;
+    for (AutoPinRule& rule : oldRules) {
+        line.clear();
+        RuleFile::format(line, toRecord(rule));
+        if (existing.insert(line).second) {
+            autoPinRules.push_back(std::move(rule));
+            ++added;
+        }
+    }
+    if (added) {
+        autoPinRulesChanged();
+    }
+    return added;
+}
+
+// 保存规则到规则文件。
+// 只在末尾添加了规则时追加新行，其他变化重写整个文件
+bool Options::saveAutoPinRules() const
+{
+    if (m_savedRulesGen == autoPinRulesGen) {
+        return true;
+    }
+    if (m_rulesLoadFailed) {
+        return false;   // 规则文件存在但没有读取成功，重写会丢失其中的规则
+    }
+    
+    try {
+        std::vector<std::wstring> lines;
+        lines.reserve(autoPinRules.size());
+        for (const AutoPinRule& rule : autoPinRules) {
+            std::wstring line;
+            RuleFile::format(line, toRecord(rule));
+            lines.push_back(std::move(line));
         }
         
-        std::wstring value = sectionContent.substr(valueStart, lineEnd - valueStart);
+        size_t common = 0;
+        size_t limit = (std::min)(lines.size(), m_savedRuleLines.size());
+        while (common < limit && lines[common] == m_savedRuleLines[common]) {
+            ++common;
+        }
         
-        // 移除行尾的回车符
-        if (!value.empty() && value.back() == L'\r') {
-            value.pop_back();
+        std::wstring text;
+        if (!m_savedRuleLines.empty() && common == m_savedRuleLines.size()) {
+            for (size_t i = common; i < lines.size(); ++i) {
+                text += lines[i];
+            }
+            if (!text.empty()) {
+                m_rulesWriter->append(getRulesFilePath(), Foundation::StringUtils::wideToUtf8(text));
+            }
+        } else {
+            text = RuleFile::HEADER;
+            for (const std::wstring& line : lines) {
+                text += line;
+            }
+            m_rulesWriter->write(getRulesFilePath(), Foundation::StringUtils::wideToUtf8(text));
         }
         
-        return value;
+        m_savedRuleLines = std::move(lines);
+        m_savedRulesGen = autoPinRulesGen;
+        return true;
     }
     catch (const std::exception&) {
-        return defaultValue;
+        return false;
     }
 }
 
-bool Options::loadAutoPinRulesFromIni()
+bool Options::reload(bool iniChanged, bool rulesChanged, OptionsDelta& delta)
 {
-    std::wstring iniPath = getIniFilePath();
-    
-    // 清空现有规则
-    autoPinRules.clear();
+    // 正在写入的文件可能只有一部分，等写入完成后再比较
+    if (!m_iniWriter->idle() || !m_rulesWriter->idle()) {
+        return false;
+    }
     
-    // 加载规则数量
-    std::wstring ruleCountStr = readUtf8IniValue(iniPath, L"AutoPin", L"RuleCount", L"0");
-    if (ruleCountStr.empty() || ruleCountStr == L"0") {
-        return true; // 没有规则，这是正常的
+    // 上次写入失败时文件不是程序的设置，先重新写入，不能把它当作外部修改读回
+    if (resetFailedWrites()) {
+        saveFormattedSettingsToIni();
+        return false;
     }
     
-    int ruleCount = _wtoi(ruleCountStr.c_str());
+    delta.oldHotkeysOn = hotkeysOn;
+    delta.oldEnterPin = hotEnterPin;
+    delta.oldTogglePin = hotTogglePin;
+    delta.oldAutoPinOn = autoPinOn;
     
-    // 加载每个规则
-    for (int i = 0; i < ruleCount; ++i) {
-        std::wstring sectionName = L"AutoPinRule" + std::to_wstring(i);
-        AutoPinRule rule;
-        
-        // 加载描述
-        rule.descr = readUtf8IniValue(iniPath, sectionName, L"Description", L"");
-        
-        // 加载标题匹配模式
-        rule.ttl = readUtf8IniValue(iniPath, sectionName, L"Title", L"");
-        
-        // 加载类名匹配模式
-        rule.cls = readUtf8IniValue(iniPath, sectionName, L"Class", L"");
-        
-        // 加载启用状态
-        std::wstring enabledStr = readUtf8IniValue(iniPath, sectionName, L"Enabled", L"1");
-        rule.enabled = (_wtoi(enabledStr.c_str()) != 0);
-        
-        autoPinRules.push_back(rule);
+    // 先读取规则文件：INI文件中的旧格式规则合并到读取后的规则列表
+    if (rulesChanged) {
+        reloadRules(delta);
+    }
+    if (iniChanged) {
+        reloadIni(delta);
     }
     
+    // 修改后的INI文件中有旧格式规则：已合并到规则列表，写出规则文件并从INI文件中删除
+    if (m_iniHasRules) {
+        saveFormattedSettingsToIni();
+    }
     return true;
 }
 
-// 立即保存设置到INI文件（用于设置更改时立即保存）
+void Options::reloadIni(OptionsDelta& delta)
+{
+    Foundation::IniDocument ini;
+    if (!ini.load(getIniFilePath())) {
+        return;     // 文件被删除或暂时无法读取时保持当前设置
+    }
+    
+    // 程序自己写入的内容
+    std::string saved = savedIniText();
+    if (!saved.empty() && Foundation::StringUtils::utf8ToWide(saved) == ini.text()) {
+        return;
+    }
+    
+    // 从默认值开始读取，文件中删除的设置恢复为默认值。
+    // 只有运行时需要重新应用的变化记录在delta中，其余设置在使用时读取
+    OptionsReload::Settings fresh = m_defaults;
+    OptionsReload::readSettings(ini, fresh);
+    OptionsReload::compare(iniSettings(), fresh, delta);
+    applyIniSettings(fresh);
+    
+    markIniSaved(ini.text());
+    
+    // 旧版本或恢复的INI文件可能带有旧格式规则，不能忽略（下次保存INI文件时会删除它们）
+    size_t added = mergeIniRules(ini);
+    if (m_iniHasRules) {
+        LOG_WARNING(L"INI文件中有旧格式的自动图钉规则，合并到规则文件，新增规则数: " + std::to_wstring(added));
+        delta.rulesChanged += added;
+    }
+}
+
+// 按内容对应新旧规则：内容未变的规则保留原对象（包括统计），
+// 编译后的规则集也只重新编译变化的规则
+void Options::reloadRules(OptionsDelta& delta)
+{
+    std::vector<RuleFile::Record> records;
+    if (!readRuleFile(records)) {
+        return;
+    }
+    
+    std::vector<std::wstring> lines;
+    lines.reserve(records.size());
+    for (const auto& rec : records) {
+        std::wstring line;
+        RuleFile::format(line, rec);
+        lines.push_back(std::move(line));
+    }
+    m_rulesLoadFailed = false;  // 规则文件重新读取成功，以它的内容为准
+    if (lines == m_savedRuleLines) {
+        return;     // 程序自己写入的内容
+    }
+    
+    // 上次读取或写入的行与当前的规则一一对应（规则列表在此之后被修改时只比较对应的部分）
+    std::vector<std::wstring> previous(m_savedRuleLines.begin(),
+        m_savedRuleLines.begin() + (std::min)(m_savedRuleLines.size(), autoPinRules.size()));
+    OptionsReload::RuleLinesDiff diff = OptionsReload::diffRuleLines(previous, lines);
+    
+    AutoPinRules rules;
+    rules.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (diff.previous[i] != OptionsReload::RuleLinesDiff::NEW_LINE) {
+            rules.push_back(autoPinRules[diff.previous[i]]);
+            continue;
+        }
+        const RuleFile::Record& rec = records[i];
+        AutoPinRule rule(rec.descr, rec.title, rec.cls, rec.enabled, rec.process);
+        if (rec.processField >= int(Pin::ProcessField::ImageName) && rec.processField <= int(Pin::ProcessField::PackageFamily)) {
+            rule.procField = static_cast<Pin::ProcessField>(rec.processField);
+        }
+        rules.push_back(std::move(rule));
+    }
+    
+    // 不在previous中的旧规则（列表比文件多出的部分）也算作删除
+    delta.rulesChanged = diff.changed() + (autoPinRules.size() - previous.size());
+    autoPinRules = std::move(rules);
+    autoPinRulesChanged();
+    m_savedRuleLines = std::move(lines);
+    m_savedRulesGen = autoPinRulesGen;
+}
+
+// 设置更改时保存到INI文件，文件在后台写入
 bool Options::saveImmediately() const
 {
     // 使用格式化的INI文件保存方法
@@ -499,26 +690,120 @@ bool Options::saveImmediately() const
     return true;
 }
 
+WindowCreationFilter Options::autoPinFilter() const
+{
+    WindowCreationFilter filter;
+    filter.processes = autoPinProcesses;
+    return filter;
+}
+
+// 后台写入失败时清除已保存的状态，返回是否有失败。下次保存时重写整个文件
+bool Options::resetFailedWrites() const
+{
+    bool failed = false;
+    if (m_iniWriter->takeFailure()) {
+        for (std::string& section : m_savedSections) {
+            section.clear();
+        }
+        failed = true;
+    }
+    if (m_rulesWriter->takeFailure()) {
+        // 追加失败后文件缺少一部分规则，不能再追加
+        m_savedRuleLines.clear();
+        m_savedRulesGen = autoPinRulesGen - 1;
+        failed = true;
+    }
+    return failed;
+}
+
 // 格式化INI文件写入方法
 bool Options::saveFormattedSettingsToIni() const
 {
-    std::wstring iniPath = getIniFilePath();
+    resetFailedWrites();
     
     try {
-        // 使用utilities中的转换函数
-        std::string utf8Path = Foundation::StringUtils::wideToUtf8(iniPath);
+        // 规则保存在单独的规则文件中
+        bool rulesSaved = saveAutoPinRules();
         
-        // 使用普通文件流写入UTF-8编码的INI内容
-        std::ofstream file(utf8Path, std::ios::out | std::ios::trunc | std::ios::binary);
-        if (!file.is_open()) {
-            return false;
+        // INI文件中还有旧格式的规则时，规则文件写入磁盘后才能重写INI文件
+        if (m_iniHasRules) {
+            if (!rulesSaved || !m_rulesWriter->flush()) {
+                return false;
+            }
+            m_iniHasRules = false;
         }
         
-        // 辅助函数：将宽字符串转换为UTF-8字符串
-        auto toUtf8 = [](const std::wstring& wstr) -> std::string {
-            return Foundation::StringUtils::wideToUtf8(wstr);
-        };
+        if (!updateSavedSections()) {
+            return rulesSaved;    // 内容没有变化，不需要重写文件
+        }
         
+        m_iniWriter->write(getIniFilePath(), savedIniText());
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+// 重新格式化各部分并与上次写入的内容比较
+bool Options::updateSavedSections() const
+{
+    bool changed = false;
+    for (int i = 0; i < INI_SECTION_COUNT; ++i) {
+        std::string text = formatIniSection(IniSection(i));
+        if (text != m_savedSections[i]) {
+            m_savedSections[i] = std::move(text);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+std::string Options::savedRulesContent() const
+{
+    // 没有规则或写入失败后不确定文件内容
+    if (m_savedRuleLines.empty()) {
+        return std::string();
+    }
+    std::wstring text = RuleFile::HEADER;
+    for (const std::wstring& line : m_savedRuleLines) {
+        text += line;
+    }
+    return Foundation::StringUtils::wideToUtf8(text);
+}
+
+std::string Options::savedIniText() const
+{
+    std::string content;
+    for (const std::string& section : m_savedSections) {
+        content += section;
+    }
+    return content;
+}
+
+// 加载后记录文件内容。只有文件与程序将要写出的内容完全一致时才视为已保存，
+// 这样手动编辑过或缺少设置项的文件在下次保存时仍会被重写
+void Options::markIniSaved(const std::wstring& fileText) const
+{
+    updateSavedSections();
+    
+    if (Foundation::StringUtils::utf8ToWide(savedIniText()) != fileText) {
+        for (std::string& section : m_savedSections) {
+            section.clear();
+        }
+    }
+}
+
+std::string Options::formatIniSection(IniSection section) const
+{
+    // 辅助函数：将宽字符串转换为UTF-8字符串
+    auto toUtf8 = [](const std::wstring& wstr) -> std::string {
+        return Foundation::StringUtils::wideToUtf8(wstr);
+    };
+    
+    std::ostringstream file;
+    switch (section) {
+    case INI_SETTINGS:
         // 写入文件头注释
         file << "; 微钉 配置文件\n";
         file << "; 此文件包含所有 微钉 设置\n";
@@ -530,7 +815,9 @@ bool Options::saveFormattedSettingsToIni() const
         file << "; 语言设置 (例如：zh_CN, en_US, 空值表示自动检测)\n";
         file << "Language=" << toUtf8(language) << "\n";
         file << "\n";
+        break;
         
+    case INI_PINS:
         // [Pins] 部分 - 图钉设置
         file << "[Pins]\n";
         file << "; 图钉图像文件路径 (相对于程序目录)\n";
@@ -540,7 +827,9 @@ bool Options::saveFormattedSettingsToIni() const
         file << "; 托盘图标双击行为 (0=单击, 1=双击)\n";
         file << "TrayDblClick=" << (dblClkTray ? 1 : 0) << "\n";
         file << "\n";
+        break;
         
+    case INI_HOTKEYS:
         // [Hotkeys] 部分 - 热键设置
         file << "[Hotkeys]\n";
         file << "; 启用热键 (0=禁用, 1=启用)\n";
@@ -553,40 +842,41 @@ bool Options::saveFormattedSettingsToIni() const
         file << "TogglePin_VK=" << hotTogglePin.vk << "\n";
         file << "TogglePin_MOD=" << hotTogglePin.mod << "\n";
         file << "\n";
+        break;
         
+    case INI_AUTOPIN:
         // [AutoPin] 部分 - 自动图钉设置
         file << "[AutoPin]\n";
         file << "; 启用自动图钉 (0=禁用, 1=启用)\n";
         file << "Enabled=" << (autoPinOn ? 1 : 0) << "\n";
         file << "; 自动图钉延迟时间，单位毫秒 (100-10000)\n";
         file << "Delay=" << autoPinDelay.value << "\n";
-        file << "; 自动图钉规则数量\n";
-        file << "RuleCount=" << autoPinRules.size() << "\n";
+        file << "; 只对这些进程的窗口自动图钉，以分号分隔 (例如：notepad.exe;calc.exe，空值表示所有进程)\n";
+        file << "ProcessFilter=";
+        for (size_t i = 0; i < autoPinProcesses.size(); ++i) {
+            file << (i ? ";" : "") << toUtf8(autoPinProcesses[i]);
+        }
         file << "\n";
+        file << "; 启动时对已打开的窗口应用规则 (0=禁用, 1=启用)\n";
+        file << "StartupSweep=" << (autoPinSweep ? 1 : 0) << "\n";
+        file << "; 自动图钉规则保存在 TinyPin.rules 中\n";
+        file << "\n";
+        break;
         
-        // 自动图钉规则部分
-        for (size_t i = 0; i < autoPinRules.size(); ++i) {
-            const AutoPinRule& rule = autoPinRules[i];
-            file << "[AutoPinRule" << i << "]\n";
-            file << "; 规则描述\n";
-            file << "Description=" << toUtf8(rule.descr) << "\n";
-            file << "; 窗口标题匹配模式 (* 表示通配符)\n";
-            file << "Title=" << toUtf8(rule.ttl) << "\n";
-            file << "; 窗口类名匹配模式\n";
-            file << "Class=" << toUtf8(rule.cls) << "\n";
-            file << "; 规则启用状态 (0=禁用, 1=启用)\n";
-            file << "Enabled=" << (rule.enabled ? 1 : 0) << "\n";
-            
-            // 在规则之间添加空行（除了最后一个）
-            if (i < autoPinRules.size() - 1) {
-                file << "\n";
-            }
-        }
+    case INI_DEBUG:
+        // [Debug] 部分 - 调试设置
+        file << "[Debug]\n";
+        file << "; 录制自动图钉事件到 log 目录，供 AutoPinReplay 回放 (0=禁用, 1=启用)\n";
+        file << "RecordEvents=" << (recordEvents ? 1 : 0) << "\n";
+        file << "; 结构化日志写入二进制文件，用 LogDecoder 解码，重新启动后生效 (0=禁用, 1=启用)\n";
+        file << "BinaryLog=" << (binaryLog ? 1 : 0) << "\n";
+        file << "; 统计每条规则的评估次数和匹配耗时，在规则统计中显示，会使匹配变慢 (0=禁用, 1=启用)\n";
+        file << "RuleProfiling=" << (ruleProfiling ? 1 : 0) << "\n";
+        file << "\n";
+        break;
         
-        file.close();
-        return true;
-    }
-    catch (const std::exception&) {
-        return false;
+    default:
+        break;
     }
+    return file.str();
 }
@@ -3,83 +3,190 @@
 #include "core/application.h"
 #include "options/options.h"
 #include "pin/pin_manager.h"
+#include "system/logger.h"
+#include "window/window_snapshot.h"
 
-void PendingWindows::add(HWND wnd) {
-	if (!IsWindow(wnd)) return;
+std::wstring AutoPinHost::title(HWND wnd) const
+{
+    return Window::WndHelper(wnd).getText();
+}
 
-	// 获取窗口标题和类名
-	Window::WndHelper helper(wnd);
-	std::wstring title = helper.getText();
-	std::wstring className = helper.getClassName();
+std::wstring AutoPinHost::className(HWND wnd) const
+{
+    return Window::WndHelper(wnd).getClassName();
+}
 
-	// 添加到队列
-	m_wnds.push_back({ wnd, title, className, GetTickCount64() });
+// 进程信息在入队时通过缓存解析，规则评估时不再查询进程
+AutoPinHost::ProcessRef AutoPinHost::process(HWND wnd) const
+{
+    return Platform::ProcessInfoCache::getInstance().lookupWindow(wnd);
 }
 
-void PendingWindows::check(HWND wnd, const Options& opt)
+// 将进程信息填入规则匹配目标（信息缺失时进程属性为空）
+void AutoPinHost::fillProcess(Pin::RuleTarget& target, const ProcessRef& info)
 {
-    if (m_wnds.empty()) return;
+    if (info) {
+        target.imageName = info->imageName;
+        target.imagePath = info->imagePath;
+        target.packageFamily = info->packageFamily;
+    }
+}
+
+void AutoPinHost::pin(const std::vector<HWND>& targets, std::vector<char>& pinned)
+{
+    pinned.assign(targets.size(), 0);
+
+    bool pending = false;
+    for (size_t n = 0; n < targets.size(); ++n) {
+        HWND target = targets[n];
+        // 检查窗口是否仍然有效、是否在黑名单中
+        if (!IsWindow(target) || isInBlacklist(target))
+            continue;
+
+        // 检查是否为错误对话框
+        if (isErrorDialog(target)) {
+            addToBlacklist(target);
+            continue;
+        }
+
+        // 尝试图钉正常窗口
+        Pin::PinManager::pinWindow(pinOwner, target, trackRate, true);
+        pinned[n] = 1;
+        pending = true;
+    }
+
+    if (!pending)
+        return;
 
-    // 批量处理窗口，减少频繁的Sleep调用
-    const int BATCH_SIZE = 5;
-    int processedCount = 0;
+    // 给系统一点时间来创建图钉（整批只等待一次）
+    Sleep(Constants::DEFAULT_BLINK_DELAY);
     
-    for (int n = static_cast<int>(m_wnds.size())-1; n >= 0; --n) {
-        if (timeToChkWnd(m_wnds[n].time, opt)) {
-            HWND targetWnd = m_wnds[n].wnd;
-            
-            if (checkWnd(targetWnd, opt)) {
-                // 检查窗口是否仍然有效
-                if (IsWindow(targetWnd)) {
-                    // 检查窗口是否在黑名单中
-                    if (!isInBlacklist(targetWnd)) {
-                        // 检查是否为错误对话框
-                        if (isErrorDialog(targetWnd)) {
-                            addToBlacklist(targetWnd);
-                        } else {
-                            // 尝试图钉正常窗口
-                            Pin::PinManager::pinWindow(wnd, targetWnd, opt.trackRate.value, true);
-                            
-                            // 给系统一点时间来创建图钉
-                            Sleep(Constants::DEFAULT_BLINK_DELAY);
-                            
-                            // 检查图钉是否成功创建
-                            if (!Pin::PinManager::hasPin(targetWnd)) {
-                                addToBlacklist(targetWnd);
-                            }
-                        }
-                    }
-                }
-            }
-            m_wnds.erase(m_wnds.begin() + n);
-            
-            // 批量处理后再Sleep，减少频繁的Sleep调用
-            if (++processedCount >= BATCH_SIZE) {
-                Sleep(1); // 减少Sleep时间
-                processedCount = 0;
-            }
+    // 检查图钉是否成功创建
+    for (size_t n = 0; n < targets.size(); ++n) {
+        if (pinned[n] && !Pin::PinManager::hasPin(targets[n])) {
+            addToBlacklist(targets[n]);
+            pinned[n] = 0;
         }
     }
+}
+
+void PendingWindows::add(HWND wnd) {
+	m_queue.add(wnd);
+}
+
+void PendingWindows::add(const std::vector<HWND>& wnds) {
+	for (HWND wnd : wnds)
+		m_queue.add(wnd);
+}
+
+void PendingWindows::titleChanged(HWND wnd, const std::vector<HWND>& targets, const Options& opt)
+{
+    update(wnd, opt);
+    m_queue.titleChanged(targets);
+}
+
+void PendingWindows::check(HWND wnd, const Options& opt)
+{
+    if (!m_queue.size()) return;
+
+    update(wnd, opt);
+    m_queue.check();
     
     // 清理过期的黑名单条目
-    cleanupBlacklist();
+    m_host.cleanupBlacklist();
 }
 
-bool PendingWindows::timeToChkWnd(ULONGLONG t, const Options& opt)
+// 同步宿主参数和队列的时间参数，规则列表变化时重新编译
+void PendingWindows::update(HWND wnd, const Options& opt)
 {
-    // 使用GetTickCount64避免32位溢出问题
-    return GetTickCount64() - t >= ULONGLONG(opt.autoPinDelay.value);
+    m_host.pinOwner = wnd;
+    m_host.trackRate = opt.trackRate.value;
+
+    m_queue.timing.delay = ULONGLONG(opt.autoPinDelay.value);
+    m_queue.timing.watchPeriod = Constants::AUTOPIN_TITLE_WATCH_PERIOD;
+    m_queue.timing.recheckInterval = Constants::AUTOPIN_RECHECK_INTERVAL;
+    m_queue.setProfiling(opt.ruleProfiling);
+
+    if (m_rulesGen != opt.autoPinRulesGen) {
+        m_queue.setRules(opt.autoPinRules.begin(), opt.autoPinRules.end());
+        m_rulesGen = opt.autoPinRulesGen;
+    }
 }
 
-bool PendingWindows::checkWnd(HWND target, const Options& opt)
+// 对已经打开的窗口应用自动图钉规则（程序启动时调用一次）。
+// 与窗口创建事件一样只考虑进程白名单（Options::autoPinProcesses）中的窗口，
+// 这些窗口分段交给多个工作线程匹配，匹配完成后在UI线程上批量创建图钉。
+//
+void PendingWindows::sweep(HWND wnd, const Options& opt)
 {
-    for (int n = 0; n < int(opt.autoPinRules.size()); ++n)
-        if (opt.autoPinRules[n].match(target))
-            return true;
-    return false;
+    update(wnd, opt);
+    const Pin::CompiledRuleSet& rules = m_queue.rules();
+    if (rules.empty())
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    Window::WindowSnapshot snapshot;
+    snapshot.capture();
+    const size_t count = snapshot.size();
+
+    // 进程信息在UI线程上预先解析，工作线程只读取
+    const std::vector<std::wstring>& allowed = opt.autoPinProcesses;
+    std::vector<std::shared_ptr<const Platform::ProcessInfo>> processes(count);
+    if (rules.usesProcess() || !allowed.empty()) {
+        auto& cache = Platform::ProcessInfoCache::getInstance();
+        for (size_t n = 0; n < count; ++n) {
+            processes[n] = cache.lookup(snapshot[n].pid);
+        }
+    }
+
+    // 进程白名单：与窗口创建事件的过滤条件（Options::autoPinFilter）相同，按映像名比较，不区分大小写
+    std::vector<size_t> windows;
+    windows.reserve(count);
+    for (size_t n = 0; n < count; ++n) {
+        bool accepted = allowed.empty();
+        for (size_t i = 0; i < allowed.size() && !accepted; ++i) {
+            accepted = processes[n] && _wcsicmp(processes[n]->imageName.c_str(), allowed[i].c_str()) == 0;
+        }
+        if (accepted) {
+            windows.push_back(n);
+        }
+    }
+
+    std::vector<size_t> matched;
+    rules.matchAll(windows.size(), [&](size_t i, Pin::RuleTarget& target) {
+        size_t n = windows[i];
+        target.title = snapshot.title(n);
+        target.cls = snapshot.className(n);
+        AutoPinHost::fillProcess(target, processes[n]);
+    }, matched);
+
+    std::vector<HWND> targets;
+    std::vector<size_t> targetRules;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        HWND target = snapshot[windows[i]].wnd;
+        if (matched[i] != Pin::CompiledRuleSet::npos && !m_queue.contains(target) &&
+            !Pin::PinManager::hasPin(target))
+        {
+            targets.push_back(target);
+            targetRules.push_back(matched[i]);
+        }
+    }
+
+    auto matchTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::vector<char> pinned;
+    m_host.pin(targets, pinned);
+    for (size_t n = 0; n < targets.size(); ++n) {
+        rules.recordPin(targetRules[n], pinned[n] != 0);
+    }
+
+    LOG_EVENT(LogLevel::INFO, "启动扫描: {} 个窗口（进程白名单内 {} 个）, {} 条规则, 匹配 {} 个, 快照和匹配耗时 {} 微秒",
+        count, windows.size(), rules.size(), targets.size(), matchTime.count());
 }
 
-bool PendingWindows::isErrorDialog(HWND wnd)
+bool AutoPinHost::isErrorDialog(HWND wnd)
 {
     if (!wnd || !IsWindow(wnd)) return false;
     
@@ -98,7 +205,7 @@ bool PendingWindows::isErrorDialog(HWND wnd)
     return false;
 }
 
-bool PendingWindows::isInBlacklist(HWND wnd)
+bool AutoPinHost::isInBlacklist(HWND wnd)
 {
     for (const auto& entry : m_blacklist) {
         if (entry.wnd == wnd) {
@@ -108,7 +215,7 @@ bool PendingWindows::isInBlacklist(HWND wnd)
     return false;
 }
 
-void PendingWindows::addToBlacklist(HWND wnd)
+void AutoPinHost::addToBlacklist(HWND wnd)
 {
     // 检查是否已经在黑名单中
     if (!isInBlacklist(wnd)) {
@@ -117,7 +224,7 @@ void PendingWindows::addToBlacklist(HWND wnd)
     }
 }
 
-void PendingWindows::cleanupBlacklist()
+void AutoPinHost::cleanupBlacklist()
 {
     const ULONGLONG BLACKLIST_TIMEOUT = 120000; // 2分钟超时
     ULONGLONG currentTime = GetTickCount64();
@@ -0,0 +1,125 @@
+#include "core/stdafx.h"
+#include "pin/event_recorder.h"
+#include "system/logger.h"
+
+namespace Pin {
+
+    EventRecorder& EventRecorder::getInstance()
+    {
+        static EventRecorder instance;
+        return instance;
+    }
+
+    bool EventRecorder::start(const std::wstring& path)
+    {
+        stop();
+
+        m_file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            LOG_WARNING(L"无法创建事件录制文件: " + path);
+            return false;
+        }
+
+        m_start = GetTickCount64();
+        m_writer = Trace::Writer();
+        m_writer.writeHeader();
+        m_lastRects.clear();
+        LOG_INFO(L"开始录制自动图钉事件: " + path);
+        return true;
+    }
+
+    void EventRecorder::stop()
+    {
+        if (!isRecording())
+            return;
+
+        flush();
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        m_lastRects.clear();
+    }
+
+    void EventRecorder::recordCreated(HWND wnd)
+    {
+        Window::WndHelper helper(wnd);
+        Trace::Record rec;
+        rec.type = Trace::RecordType::WindowCreated;
+        rec.wnd = reinterpret_cast<uintptr_t>(wnd);
+        rec.title = helper.getText();
+        rec.cls = helper.getClassName();
+
+        DWORD pid = 0;
+        GetWindowThreadProcessId(wnd, &pid);
+        rec.pid = pid;
+        auto info = Platform::ProcessInfoCache::getInstance().lookup(pid);
+        rec.imageName = info->imageName;
+        rec.imagePath = info->imagePath;
+        rec.packageFamily = info->packageFamily;
+        append(rec);
+    }
+
+    void EventRecorder::recordTitle(HWND wnd)
+    {
+        Trace::Record rec;
+        rec.type = Trace::RecordType::TitleChanged;
+        rec.wnd = reinterpret_cast<uintptr_t>(wnd);
+        rec.title = Window::WndHelper(wnd).getText();
+        append(rec);
+    }
+
+    void EventRecorder::recordTracked(HWND wnd, const RECT& rc)
+    {
+        auto it = std::find_if(m_lastRects.begin(), m_lastRects.end(),
+            [wnd](const std::pair<HWND, RECT>& entry) { return entry.first == wnd; });
+        if (it != m_lastRects.end()) {
+            if (EqualRect(&it->second, &rc))
+                return;
+            it->second = rc;
+        }
+        else {
+            // 列表变长时先移除已销毁的窗口
+            if (m_lastRects.size() >= MAX_TRACKED) {
+                m_lastRects.erase(std::remove_if(m_lastRects.begin(), m_lastRects.end(),
+                    [](const std::pair<HWND, RECT>& entry) { return !IsWindow(entry.first); }),
+                    m_lastRects.end());
+            }
+            m_lastRects.emplace_back(wnd, rc);
+        }
+
+        Trace::Record rec;
+        rec.type = Trace::RecordType::PinTracked;
+        rec.wnd = reinterpret_cast<uintptr_t>(wnd);
+        rec.left = rc.left;
+        rec.top = rc.top;
+        rec.right = rc.right;
+        rec.bottom = rc.bottom;
+        append(rec);
+    }
+
+    void EventRecorder::append(Trace::Record& rec)
+    {
+        rec.time = GetTickCount64() - m_start;
+        m_writer.write(rec);
+        if (m_writer.buffer().size() >= FLUSH_SIZE)
+            flush();
+    }
+
+    void EventRecorder::flush()
+    {
+        std::vector<uint8_t>& buf = m_writer.buffer();
+        if (buf.empty())
+            return;
+
+        DWORD written = 0;
+        if (!WriteFile(m_file, buf.data(), DWORD(buf.size()), &written, nullptr) || written != buf.size()) {
+            LOG_WARNING(L"写入事件录制文件失败，停止录制");
+            buf.clear();
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+            return;
+        }
+        buf.clear();
+    }
+
+} // namespace Pin
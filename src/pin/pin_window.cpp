@@ -2,6 +2,8 @@
 #include "core/application.h"
 #include "pin/pin_shape.h"
 #include "pin/pin_window.h"
+#include "pin/pin_placement.h"
+#include "pin/event_recorder.h"
 #include "window/window_cache.h"  // 添加窗口缓存支持
 #include "resource.h"
 #include "system/logger.h"
@@ -394,8 +396,7 @@ bool PinWnd::evPinAssignWnd(HWND wnd, Data& pd, HWND target, int pollRate)
         if (!SetWindowLongPtr(wnd, GWLP_HWNDPARENT, reinterpret_cast<LONG_PTR>(pinOwner)) && GetLastError()) {
             // 对于某些现代Windows应用（如设置、计算器等），SetWindowLongPtr可能会失败
             // 但这不影响图钉的基本功能（置顶），所以只记录警告而不显示错误弹窗
-            LOG_WARNING(std::wstring(L"无法设置图钉的父窗口关系，但图钉功能仍然正常。目标窗口句柄: 0x") + 
-                       std::to_wstring(reinterpret_cast<uintptr_t>(pinOwner)));
+            LOG_EVENT_LIMITED(LogLevel::WARNING, "无法设置图钉的父窗口关系，但图钉功能仍然正常。目标窗口句柄: {}", pinOwner);
         }
     } else if (pd.proxyMode) {
         // 在代理模式下，代理窗口会在后续的定时器中通过selectProxy函数查找
@@ -599,35 +600,29 @@ void PinWnd::placeOnCaption(HWND wnd, const Data& pd)
         // 对于现代Windows应用，使用特殊的矩形获取方法
         if (!Window::getVisibleWindowRect(pinOwner, pinned)) {
             if (!Window::Cached::getWindowRect(pinOwner, pinned)) {
-                LOG_WARNING(L"无法获取现代应用窗口矩形");
+                LOG_EVENT_LIMITED(LogLevel::WARNING, "无法获取现代应用窗口矩形: {}", pinOwner);
                 return;
             }
         }
         
         // 检查窗口矩形是否有效
         if (pinned.right <= pinned.left || pinned.bottom <= pinned.top) {
-            LOG_WARNING(L"现代应用窗口矩形无效，跳过位置更新");
+            LOG_EVENT_LIMITED(LogLevel::WARNING, "现代应用窗口矩形无效，跳过位置更新: {}", pinOwner);
             return;
         }
         
-        // 对于现代Windows应用，可能需要调整位置计算
-        // 因为它们的标题栏可能有不同的布局
-        int windowWidth = pinned.right - pinned.left;
+        Pin::EventRecorder::getInstance().pinTracked(pd.topMostWnd, pinned);
+
+        // 对于现代Windows应用，标题栏布局不同，图钉更靠近窗口顶部
         int pinWidth = app.pinShape.getW();
-        int x = pinned.left + (windowWidth - pinWidth) / 2;
-        
-        // 对于现代应用，图钉位置可能需要更靠近窗口顶部
-        int y = pinned.top + 15;  // 减少偏移量，更靠近顶部
+        Pin::CaptionPlacement pos = Pin::placeOnCaption(pinned.left, pinned.top, pinned.right, pinWidth, true);
         
         // 确保图钉不会超出屏幕边界
         RECT screenRect;
         SystemParametersInfo(SPI_GETWORKAREA, 0, &screenRect, 0);
+        Pin::clampToWorkArea(pos, pinWidth, screenRect.left, screenRect.top, screenRect.right);
         
-        if (x < screenRect.left) x = screenRect.left;
-        if (x + pinWidth > screenRect.right) x = screenRect.right - pinWidth;
-        if (y < screenRect.top) y = screenRect.top;
-        
-        SetWindowPos(wnd, NULL, x, y, 0, 0, 
+        SetWindowPos(wnd, NULL, pos.x, pos.y, 0, 0, 
             SWP_NOSIZE | SWP_NOACTIVATE | SWP_NOZORDER);
         // 窗口位置改变后，使缓存失效
         Window::WindowCache::getInstance().invalidateWindow(wnd);
@@ -637,12 +632,12 @@ void PinWnd::placeOnCaption(HWND wnd, const Data& pd)
             return;
         }
         
-        int windowWidth = pinned.right - pinned.left;
-        int pinWidth = app.pinShape.getW();
-        int x = pinned.left + (windowWidth - pinWidth) / 2;
-        int y = pinned.top + 20;
+        Pin::EventRecorder::getInstance().pinTracked(pd.topMostWnd, pinned);
+
+        Pin::CaptionPlacement pos = Pin::placeOnCaption(pinned.left, pinned.top, pinned.right,
+            app.pinShape.getW(), false);
         
-        SetWindowPos(wnd, NULL, x, y, 0, 0, 
+        SetWindowPos(wnd, NULL, pos.x, pos.y, 0, 0, 
             SWP_NOSIZE | SWP_NOACTIVATE | SWP_NOZORDER);
         // 窗口位置改变后，使缓存失效
         Window::WindowCache::getInstance().invalidateWindow(wnd);
@@ -697,8 +692,7 @@ BOOL CALLBACK PinWnd::enumThreadWndProc(HWND wnd, LPARAM param)
             SetLastError(0);
             if (!SetWindowLongPtr(pin, GWLP_HWNDPARENT, reinterpret_cast<LONG_PTR>(wnd)) && GetLastError()) {
                 // 对于某些现代Windows应用，设置父窗口关系可能失败，但不影响基本功能
-                LOG_WARNING(std::wstring(L"无法设置代理窗口的父子关系，但图钉功能仍然正常。代理窗口句柄: 0x") + 
-                           std::to_wstring(reinterpret_cast<uintptr_t>(wnd)));
+                LOG_EVENT_LIMITED(LogLevel::WARNING, "无法设置代理窗口的父子关系，但图钉功能仍然正常。代理窗口句柄: {}", wnd);
             }
             
             // 重新计算图钉位置，因为现在有了有效的代理窗口
@@ -748,8 +742,7 @@ BOOL CALLBACK PinWnd::enumChildWndProc(HWND wnd, LPARAM param)
             // 设置代理窗口为图钉的父窗口
             SetLastError(0);
             if (!SetWindowLongPtr(pin, GWLP_HWNDPARENT, reinterpret_cast<LONG_PTR>(wnd)) && GetLastError()) {
-                LOG_WARNING(std::wstring(L"无法设置子窗口代理的父子关系，但图钉功能仍然正常。代理窗口句柄: 0x") + 
-                           std::to_wstring(reinterpret_cast<uintptr_t>(wnd)));
+                LOG_EVENT_LIMITED(LogLevel::WARNING, "无法设置子窗口代理的父子关系，但图钉功能仍然正常。代理窗口句柄: {}", wnd);
             }
             
             // 重新计算图钉位置
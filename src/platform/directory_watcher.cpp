@@ -0,0 +1,58 @@
+#include "core/stdafx.h"
+#include "platform/directory_watcher.h"
+#include "system/logger.h"
+
+namespace Platform {
+
+bool DirectoryWatcher::start(const std::wstring& dir, Callback onChange)
+{
+    stop();
+
+    m_change = FindFirstChangeNotificationW(dir.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (m_change == INVALID_HANDLE_VALUE) {
+        LOG_WARNING(L"无法监视目录: " + dir);
+        return false;
+    }
+
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent) {
+        FindCloseChangeNotification(m_change);
+        m_change = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    m_thread = std::thread(&DirectoryWatcher::run, this, std::move(onChange));
+    return true;
+}
+
+void DirectoryWatcher::stop()
+{
+    if (m_thread.joinable()) {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+    if (m_change != INVALID_HANDLE_VALUE) {
+        FindCloseChangeNotification(m_change);
+        m_change = INVALID_HANDLE_VALUE;
+    }
+    if (m_stopEvent) {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+    }
+}
+
+void DirectoryWatcher::run(Callback onChange)
+{
+    HANDLE handles[] = { m_stopEvent, m_change };
+    for (;;) {
+        DWORD res = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (res != WAIT_OBJECT_0 + 1)
+            break;
+        onChange();
+        if (!FindNextChangeNotification(m_change))
+            break;
+    }
+}
+
+} // namespace Platform
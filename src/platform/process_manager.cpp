@@ -1,5 +1,7 @@
 #include "core/stdafx.h"
 #include "platform/process_manager.h"
+#include <appmodel.h>  // 用于PACKAGE_FAMILY_NAME_MAX_LENGTH
+#include <cwctype>
 
 // 进程实例检查类实现
 
@@ -56,4 +58,102 @@ bool Platform::PrevInstance::isRunning() const {
         // 无法获取所有权，说明有其他实例在运行
         return true;
     }
-}
\ No newline at end of file
+}
+
+
+// 进程元数据缓存实现
+
+namespace {
+    void toLower(std::wstring& s) {
+        for (auto& ch : s) {
+            ch = static_cast<wchar_t>(std::towlower(ch));
+        }
+    }
+}
+
+Platform::ProcessInfoCache& Platform::ProcessInfoCache::getInstance() {
+    static ProcessInfoCache instance;
+    return instance;
+}
+
+std::shared_ptr<const Platform::ProcessInfo> Platform::ProcessInfoCache::lookup(DWORD pid) {
+    ULONGLONG now = GetTickCount64();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : m_entries) {
+            if (entry.pid == pid && now - entry.created < ENTRY_TTL) {
+                entry.lastUse = now;
+                return entry.info;
+            }
+        }
+    }
+
+    // 查询在锁外进行，避免阻塞其他线程的缓存命中
+    std::shared_ptr<const ProcessInfo> info = query(pid);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+        [pid](const Entry& entry) { return entry.pid == pid; });
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= MAX_ENTRIES) {
+            // 淘汰最久未使用的项
+            it = std::min_element(m_entries.begin(), m_entries.end(),
+                [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        }
+        else {
+            it = m_entries.insert(m_entries.end(), Entry());
+        }
+    }
+    it->pid = pid;
+    it->created = now;
+    it->lastUse = now;
+    it->info = info;
+    return info;
+}
+
+std::shared_ptr<const Platform::ProcessInfo> Platform::ProcessInfoCache::lookupWindow(HWND wnd) {
+    DWORD pid = 0;
+    GetWindowThreadProcessId(wnd, &pid);
+    return lookup(pid);
+}
+
+void Platform::ProcessInfoCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+std::shared_ptr<const Platform::ProcessInfo> Platform::ProcessInfoCache::query(DWORD pid) {
+    auto info = std::make_shared<ProcessInfo>();
+    if (!pid) {
+        return info;
+    }
+
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!process) {
+        return info;
+    }
+
+    WCHAR path[MAX_PATH] = {0};
+    DWORD size = MAX_PATH;
+    if (QueryFullProcessImageNameW(process, 0, path, &size)) {
+        info->imagePath.assign(path, size);
+        toLower(info->imagePath);
+        info->imageName = PathFindFileNameW(info->imagePath.c_str());
+    }
+
+    // GetPackageFamilyName从Windows 8开始才有，动态获取以便在Windows 7上启动；
+    // 取不到时包家族名保持为空
+    typedef LONG (WINAPI *GetPackageFamilyNameFunc)(HANDLE, UINT32*, PWSTR);
+    static const GetPackageFamilyNameFunc getPackageFamilyName = reinterpret_cast<GetPackageFamilyNameFunc>(
+        GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "GetPackageFamilyName"));
+    
+    WCHAR family[PACKAGE_FAMILY_NAME_MAX_LENGTH + 1] = {0};
+    UINT32 length = PACKAGE_FAMILY_NAME_MAX_LENGTH + 1;
+    if (getPackageFamilyName && getPackageFamilyName(process, &length, family) == ERROR_SUCCESS) {
+        info->packageFamily = family;
+        toLower(info->packageFamily);
+    }
+
+    CloseHandle(process);
+    return info;
+}
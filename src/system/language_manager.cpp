@@ -4,18 +4,17 @@
 #include "foundation/file_utils.h"
 #include "core/application.h"
 #include "system/logger.h"
+#include "system/locale_parser.h"
+#include "system/locale_table.h"
 #include "resource.h"
 #include <fstream>
 #include <sstream>
-#include <locale>
-#include <codecvt>
 #include <algorithm>
 
 // 移除硬编码的语言列表，改为动态扫描
 
 LanguageManager::LanguageManager() : m_initialized(false) {
     initializeSupportedLanguages();
-    scanLanguageFiles();
 }
 
 LanguageManager& LanguageManager::getInstance() {
@@ -57,53 +56,16 @@ std::wstring LanguageManager::getLanguageNameFromFile(const std::wstring& langua
         return L"";
     }
     
-    std::ifstream file(filePath);
+    std::ifstream file(filePath, std::ios::binary);
     if (!file.is_open()) {
         LOG_WARNING(L"无法打开语言文件: " + filePath);
         return L"";
     }
     
-    // 简单解析JSON文件，只查找language_info.name
-    std::string line;
-    bool inLanguageInfo = false;
-    
-    try {
-        while (std::getline(file, line)) {
-            trimString(line);
-            
-            if (line.empty()) {
-                continue;
-            }
-            
-            // 检查是否进入language_info对象
-            if (line.find("\"language_info\"") != std::string::npos && line.back() == '{') {
-                inLanguageInfo = true;
-                continue;
-            }
-            
-            // 如果在language_info对象中，查找name字段
-            if (inLanguageInfo) {
-                // 检查是否退出language_info对象
-                if (line == "}" || line == "},") {
-                    break; // 已经处理完language_info，可以退出
-                }
-                
-                // 查找name字段
-                if (line.find("\"name\"") != std::string::npos) {
-                    size_t colonPos = line.find(':');
-                    if (colonPos != std::string::npos) {
-                        std::string value = extractJsonValue(line, colonPos);
-                        
-                        if (!value.empty()) {
-                            return Foundation::StringUtils::utf8ToWide(value);
-                        }
-                    }
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-        LOG_ERROR(L"解析语言文件时发生异常: " + filePath + L" - " + Foundation::StringUtils::utf8ToWide(e.what()));
-        return L"";
+    // 只读取到language_info.name为止，不解析整个文件
+    std::string value;
+    if (LocaleParser::findString(file, "language_info.name", value) && !value.empty()) {
+        return Foundation::StringUtils::utf8ToWide(value);
     }
     
     LOG_WARNING(L"在语言文件中未找到language_info.name: " + filePath);
@@ -155,17 +117,72 @@ bool LanguageManager::setLanguage(const std::wstring& languageCode) {
 }
 
 std::wstring LanguageManager::getString(const std::wstring& key) const {
+    // 取当前表的引用，其他线程切换语言时本次查找仍使用同一张表
+    std::shared_ptr<const LocaleTable> table = std::atomic_load(&m_table);
+    uint64_t hash = hashStringKey(key);
+    {
+        std::lock_guard<std::mutex> lock(m_stringCacheMutex);
+        if (m_stringCacheTable == table) {
+            auto it = m_stringCache.find(hash);
+            if (it != m_stringCache.end() && it->second.key == key) {
+                return it->second.text;
+            }
+        }
+    }
+    
+    bool missing = false;
+    std::wstring text = resolveString(table.get(), key, missing);
+    
+    size_t missingCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_stringCacheMutex);
+        if (m_stringCacheTable != table) {
+            // 期间又切换了语言，结果只用于本次调用
+            if (table != std::atomic_load(&m_table)) {
+                return text;
+            }
+            // 新的语言：丢弃上一种语言的结果
+            m_stringCache.clear();
+            m_stringCacheTable = table;
+            m_missingStringCount = 0;
+        }
+        // 哈希相同的另一个键已经缓存时不替换，该键每次重新解析
+        if (!m_stringCache.emplace(hash, CachedString{ key, text }).second || !missing) {
+            return text;
+        }
+        missingCount = ++m_missingStringCount;
+    }
+    
+    // 每种语言中每个缺少的键只记录一次
+    LOG_EVENT(LogLevel::DEBUG, "缺少翻译 ({}): {}", missingCount, key);
+    return text;
+}
+
+size_t LanguageManager::getMissingStringCount() const {
+    std::lock_guard<std::mutex> lock(m_stringCacheMutex);
+    return m_stringCacheTable == std::atomic_load(&m_table) ? m_missingStringCount : 0;
+}
+
+uint64_t LanguageManager::hashStringKey(const std::wstring& key) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (wchar_t ch : key) {
+        hash = (hash ^ uint16_t(ch)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::wstring LanguageManager::resolveString(const LocaleTable* table, const std::wstring& key, bool& missing) const {
     // 首先尝试直接查找键
-    auto it = m_strings.find(key);
-    if (it != m_strings.end()) {
-        return it->second;
+    std::wstring_view value;
+    if (table && table->find(key, value)) {
+        return std::wstring(value);
     }
     
     // 如果没找到，尝试在strings前缀下查找
     std::wstring stringsKey = L"strings." + key;
-    it = m_strings.find(stringsKey);
-    if (it != m_strings.end()) {
-        return it->second;
+    if (table && table->find(stringsKey, value)) {
+        return std::wstring(value);
     }
     
     // 如果在语言文件中找不到，尝试从RC资源文件中加载
@@ -184,93 +201,106 @@ std::wstring LanguageManager::getString(const std::wstring& key) const {
     }
     
     // 如果找不到，返回键名
+    missing = true;
     return key;
 }
 
 
 
 std::wstring LanguageManager::getControlText(int controlId, const std::wstring& dialogName) const {
-    const ControlMapping* mapping = findControlMapping(controlId);
-    if (mapping) {
-        // 如果指定了对话框名称，优先使用指定的
-        std::wstring targetDialog = dialogName.empty() ? mapping->dialogName : dialogName;
-        
-        // 根据对话框名称构建不同的键前缀
-        std::wstring key;
-        if (targetDialog == L"tray") {
-            // 托盘菜单项
-            key = L"tray." + mapping->elementName;
-        } else if (targetDialog == L"strings") {
-            // 字符串资源
-            key = L"strings." + mapping->elementName;
-        } else {
-            // 对话框控件
-            key = L"dialogs." + targetDialog + L"." + mapping->elementName;
-        }
-        
-        auto it = m_strings.find(key);
-        if (it != m_strings.end()) {
-            return it->second;
-        }
-        
-        // 如果没有找到翻译文本，提供回退机制
-        // 对于字符串资源（如IDS_TRAYTIP），直接从RC资源文件中加载
-        if (targetDialog == L"strings" && controlId > 0) {
-            WCHAR buffer[Constants::MAX_CLASSNAME_LEN];
-            if (LoadString(app.inst, controlId, buffer, Constants::MAX_CLASSNAME_LEN) > 0) {
-                return std::wstring(buffer);
-            }
-        }
-        
-        // 对于其他控件，使用英文回退
-        std::wstring fallback = getEnglishFallback(controlId, mapping->elementName);
-        if (!fallback.empty()) {
-            return fallback;
+    return std::wstring(controlText(controlId, dialogIndex(dialogName)));
+}
+
+int LanguageManager::dialogIndex(const std::wstring& dialogName) const {
+    return m_controlTexts.dialogIndex(dialogName);
+}
+
+std::wstring_view LanguageManager::controlText(int controlId, int dialog) const {
+    // 如果没有找到映射，返回空字符串
+    return m_controlTexts.text(controlId, dialog, [this](int slot, int target) {
+        return resolveControlText(slot, target);
+    });
+}
+
+std::wstring_view LanguageManager::resolveControlText(int slot, int dialog) const {
+    const ControlMapping& mapping = m_controlTexts.mapping(slot);
+    
+    // 如果指定了对话框名称，优先使用指定的
+    const std::wstring& targetDialog = m_controlTexts.dialogName(slot, dialog);
+    
+    // 根据对话框名称构建不同的键前缀（托盘菜单项、字符串资源或对话框控件）
+    std::wstring key = m_controlTexts.textKey(slot, dialog);
+    
+    // 当前表始终在最近使用的表中，返回的文本在下次切换语言（清空控件文本）前有效
+    std::shared_ptr<const LocaleTable> table = std::atomic_load(&m_table);
+    std::wstring_view value;
+    if (table && table->find(key, value)) {
+        return value;
+    }
+    
+    // 如果没有找到翻译文本，提供回退机制
+    // 对于字符串资源（如IDS_TRAYTIP），直接从RC资源文件中加载
+    if (targetDialog == L"strings" && mapping.controlId > 0) {
+        WCHAR buffer[Constants::MAX_CLASSNAME_LEN];
+        if (LoadString(app.inst, mapping.controlId, buffer, Constants::MAX_CLASSNAME_LEN) > 0) {
+            m_fallbackTexts.emplace_back(buffer);
+            return m_fallbackTexts.back();
         }
     }
     
-    // 如果没有找到映射或文本，返回空字符串
-    return L"";
+    // 对于其他控件，使用英文回退
+    std::wstring fallback = getEnglishFallback(mapping.controlId, mapping.elementName);
+    if (!fallback.empty()) {
+        m_fallbackTexts.push_back(std::move(fallback));
+        return m_fallbackTexts.back();
+    }
+    
+    return std::wstring_view(L"");
 }
 
-
+void LanguageManager::resetControlTexts() {
+    m_controlTexts.reset();
+    m_fallbackTexts.clear();
+}
 
 std::vector<std::pair<std::wstring, std::wstring>> LanguageManager::getAvailableLanguages() const {
     std::vector<std::pair<std::wstring, std::wstring>> result;
-    
-    for (const auto& lang : m_availableLanguages) {
-        std::wstring name;
+    bool changed = false;
+    
+    for (auto& locale : m_locales) {
+        // 只有清单中没有名称（新的或修改过的语言文件）时才读取语言文件
+        if (!locale.named) {
+            locale.name = getLanguageNameFromFile(locale.code);
+            locale.named = true;
+            changed = true;
+        }
         
-        // 首先检查缓存
-        auto cacheIt = m_languageNameCache.find(lang);
-        if (cacheIt != m_languageNameCache.end()) {
-            name = cacheIt->second;
-        } else {
-            // 从对应的语言文件中读取本地化的语言名称
-            name = getLanguageNameFromFile(lang);
-            
-            // 如果无法从文件中读取，使用配置中的回退名称
-            if (name.empty()) {
-                const LanguageConfig* config = findLanguageConfig(lang);
-                if (config) {
-                    name = config->displayName;
-                } else {
-                    name = lang; // 使用语言代码作为最终回退
-                }
+        std::wstring name = locale.name;
+        
+        // 如果无法从文件中读取，使用配置中的回退名称
+        if (name.empty()) {
+            const LanguageConfig* config = findLanguageConfig(locale.code);
+            if (config) {
+                name = config->displayName;
+            } else {
+                name = locale.code; // 使用语言代码作为最终回退
             }
-            
-            // 缓存结果
-            m_languageNameCache[lang] = name;
         }
         
-        result.emplace_back(lang, name);
+        result.emplace_back(locale.code, name);
     }
     
+    if (changed) {
+        saveLocaleManifest();
+    }
     return result;
 }
 
 void LanguageManager::clearLanguageNameCache() {
-    m_languageNameCache.clear();
+    // 下次获取语言列表时重新读取所有语言名称
+    for (auto& locale : m_locales) {
+        locale.named = false;
+    }
 }
 
 bool LanguageManager::isLanguageAvailable(const std::wstring& languageCode) const {
@@ -289,69 +319,47 @@ std::wstring LanguageManager::getLanguageFileDescription(const std::wstring& pat
 
 bool LanguageManager::loadLanguageFile(const std::wstring& languageCode) {
     std::wstring filePath = getLanguageFilePath(languageCode);
-    return parseJsonFile(filePath);
-}
-
-bool LanguageManager::parseJsonFile(const std::wstring& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        LOG_ERROR(L"无法打开语言文件: " + filePath);
-        return false;
-    }
-    
-    // 简单的JSON解析器（仅支持我们需要的格式）
-    m_strings.clear();
-    std::string line;
-    std::vector<std::wstring> keyStack;
     
-    while (std::getline(file, line)) {
-        trimString(line);
-        
-        if (line.empty() || line == "{") {
-            continue;
-        }
-        
-        // 处理对象结束
-        if (line == "}" || line == "},") {
-            if (!keyStack.empty()) {
-                keyStack.pop_back();
-            }
-            continue;
-        }
-        
-        // 处理对象开始
-        if (line.back() == '{') {
-            std::string key = line.substr(1, line.find('\"', 1) - 1);
-            std::wstring wkey = Foundation::StringUtils::utf8ToWide(key);
-            keyStack.push_back(wkey);
-            continue;
+    // 大小和修改时间来自扫描目录时的目录项，不再单独获取文件属性
+    uint64_t sourceSize = 0;
+    uint64_t sourceTime = 0;
+    if (const LocaleManifest::Entry* locale = findLocale(languageCode)) {
+        sourceSize = locale->size;
+        sourceTime = locale->time;
+    } else {
+        WIN32_FILE_ATTRIBUTE_DATA attr;
+        if (!GetFileAttributesExW(filePath.c_str(), GetFileExInfoStandard, &attr)) {
+            LOG_ERROR(L"无法打开语言文件: " + filePath);
+            return false;
         }
-        
-        // 处理键值对
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos) {
-            std::string key = line.substr(1, line.find('\"', 1) - 1);
-            std::string value = extractJsonValue(line, colonPos);
-            
-            // 构建完整键名
-            std::wstring fullKey;
-            if (!keyStack.empty()) {
-                for (size_t i = 0; i < keyStack.size(); ++i) {
-                    if (i > 0) fullKey += L".";
-                    fullKey += keyStack[i];
-                }
-                fullKey += L"." + Foundation::StringUtils::utf8ToWide(key);
-            } else {
-                fullKey = Foundation::StringUtils::utf8ToWide(key);
-            }
-            
-            // 转换值并处理转义字符
-            std::wstring wvalue = Foundation::StringUtils::utf8ToWide(value);
-            processEscapeSequences(wvalue);
-            
-            m_strings[fullKey] = wvalue;
+        sourceSize = (uint64_t(attr.nFileSizeHigh) << 32) | attr.nFileSizeLow;
+        sourceTime = (uint64_t(attr.ftLastWriteTime.dwHighDateTime) << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    }
+    
+    // 最近使用过且语言文件没有变化的表直接使用
+    std::shared_ptr<const LocaleTable> table;
+    auto it = std::find_if(m_recentTables.begin(), m_recentTables.end(),
+        [&](const std::shared_ptr<const LocaleTable>& t) {
+            return t->code() == languageCode && t->sourceSize() == sourceSize && t->sourceTime() == sourceTime;
+        });
+    if (it != m_recentTables.end()) {
+        table = *it;
+        m_recentTables.erase(it);
+    } else {
+        table = LocaleTable::load(languageCode, filePath, sourceSize, sourceTime);
+        if (!table) {
+            return false;
         }
     }
+    
+    // 最近使用的在前，超出数量的表在没有读取者后释放
+    m_recentTables.insert(m_recentTables.begin(), table);
+    if (m_recentTables.size() > size_t(Constants::LOCALE_CACHE_SIZE)) {
+        m_recentTables.resize(Constants::LOCALE_CACHE_SIZE);
+    }
+    
+    std::atomic_store(&m_table, std::shared_ptr<const LocaleTable>(table));
+    resetControlTexts();
     return true;
 }
 
@@ -378,7 +386,7 @@ std::wstring LanguageManager::getSystemLanguage() const {
     return L"en_US"; // 默认英文
 }
 
-std::wstring LanguageManager::getLanguageFilePath(const std::wstring& languageCode) const {
+std::wstring LanguageManager::getLanguageDirectory() const {
     WCHAR modulePath[MAX_PATH] = {0};
     GetModuleFileNameW(app.inst, modulePath, MAX_PATH);
     std::wstring exePath = modulePath;
@@ -389,7 +397,11 @@ std::wstring LanguageManager::getLanguageFilePath(const std::wstring& languageCo
         exePath = exePath.substr(0, lastSlash + 1);
     }
     
-    return exePath + L"assets\\locales\\" + languageCode + L".json";
+    return exePath + L"assets\\locales\\";
+}
+
+std::wstring LanguageManager::getLanguageFilePath(const std::wstring& languageCode) const {
+    return getLanguageDirectory() + languageCode + L".json";
 }
 
 void LanguageManager::setWindowsThreadLanguage(const std::wstring& languageCode) {
@@ -438,6 +450,8 @@ void LanguageManager::initializeControlMappings() {
     m_controlMappings[IDC_RULE_DESC_LABEL] = {IDC_RULE_DESC_LABEL, L"edit_rule", L"description_label"};
     m_controlMappings[IDC_RULE_TITLE_LABEL] = {IDC_RULE_TITLE_LABEL, L"edit_rule", L"title_label"};
     m_controlMappings[IDC_RULE_CLASS_LABEL] = {IDC_RULE_CLASS_LABEL, L"edit_rule", L"class_label"};
+    m_controlMappings[IDC_RULE_PROC_LABEL] = {IDC_RULE_PROC_LABEL, L"edit_rule", L"process_label"};
+    m_controlMappings[IDC_RULE_PREVIEW_GROUP] = {IDC_RULE_PREVIEW_GROUP, L"edit_rule", L"preview_group"};
     m_controlMappings[IDC_DESCR] = {IDC_DESCR, L"edit_rule", L"description"};
     m_controlMappings[IDC_TITLE] = {IDC_TITLE, L"edit_rule", L"window_title"};
     m_controlMappings[IDC_CLASS] = {IDC_CLASS, L"edit_rule", L"window_class"};
@@ -465,6 +479,8 @@ void LanguageManager::initializeControlMappings() {
     m_controlMappings[IDC_EDIT] = {IDC_EDIT, L"autopin", L"edit"};
     m_controlMappings[IDC_UP] = {IDC_UP, L"autopin", L"move_up"};
     m_controlMappings[IDC_DOWN] = {IDC_DOWN, L"autopin", L"move_down"};
+    m_controlMappings[IDC_IMPORT_RULES] = {IDC_IMPORT_RULES, L"autopin", L"import_rules"};
+    m_controlMappings[IDC_EXPORT_STATS] = {IDC_EXPORT_STATS, L"autopin", L"export_stats"};
     m_controlMappings[IDC_RULE_DELAY] = {IDC_RULE_DELAY, L"autopin", L"delay"};
     
     // Hotkeys选项页映射
@@ -510,6 +526,10 @@ void LanguageManager::initializeControlMappings() {
     m_controlMappings[IDS_ERR_TRAYSETWND] = {IDS_ERR_TRAYSETWND, L"strings", L"tray_set_window_error"};
     m_controlMappings[IDS_ERR_TRAYCREATE] = {IDS_ERR_TRAYCREATE, L"strings", L"tray_create_error"};
     m_controlMappings[IDS_TRAYTIP] = {IDS_TRAYTIP, L"strings", L"tray_tip"};
+    
+    // 为控件映射分配连续的编号，建立控件ID到编号的索引
+    m_controlTexts.build(m_controlMappings);
+    m_fallbackTexts.clear();
 }
 
 void LanguageManager::initializeStringResourceMappings() {
@@ -540,14 +560,6 @@ void LanguageManager::initializeStringResourceMappings() {
     m_stringResourceMappings[L"strings.tray_tip"] = IDS_TRAYTIP;
 }
 
-const ControlMapping* LanguageManager::findControlMapping(int controlId) const {
-    auto it = m_controlMappings.find(controlId);
-    if (it != m_controlMappings.end()) {
-        return &it->second;
-    }
-    return nullptr;
-}
-
 int LanguageManager::findStringResourceId(const std::wstring& key) const {
     auto it = m_stringResourceMappings.find(key);
     if (it != m_stringResourceMappings.end()) {
@@ -558,23 +570,12 @@ int LanguageManager::findStringResourceId(const std::wstring& key) const {
 
 void LanguageManager::scanLanguageFiles() {
     m_availableLanguages.clear();
-    m_languageNameCache.clear(); // 清空缓存，确保重新扫描时获取最新数据
     
-    // 获取语言文件目录路径
-    WCHAR modulePath[MAX_PATH] = {0};
-    GetModuleFileNameW(app.inst, modulePath, MAX_PATH);
-    std::wstring exePath = modulePath;
-    
-    // 获取目录部分
-    size_t lastSlash = exePath.find_last_of(L"\\/");
-    if (lastSlash != std::wstring::npos) {
-        exePath = exePath.substr(0, lastSlash + 1);
-    }
-    
-    std::wstring langDir = exePath + L"assets\\locales\\";
+    std::wstring langDir = getLanguageDirectory();
     std::wstring searchPattern = langDir + L"*.json";
     
-    // 使用FindFirstFile/FindNextFile扫描目录
+    // 使用FindFirstFile/FindNextFile扫描目录，目录项中已有大小和修改时间
+    std::vector<LocaleManifest::Entry> scanned;
     WIN32_FIND_DATAW findData;
     HANDLE hFind = FindFirstFileW(searchPattern.c_str(), &findData);
     
@@ -596,11 +597,11 @@ void LanguageManager::scanLanguageFiles() {
                 
                 // 验证语言代码格式（例如：en_US, zh_CN, ja_JP等）
                 if (isValidLanguageCode(langCode)) {
-                    // 验证文件是否可以正常读取
-                    std::wstring fullPath = langDir + fileName;
-                    if (GetFileAttributesW(fullPath.c_str()) != INVALID_FILE_ATTRIBUTES) {
-                        m_availableLanguages.push_back(langCode);
-                    }
+                    LocaleManifest::Entry entry;
+                    entry.code = langCode;
+                    entry.size = (uint64_t(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
+                    entry.time = (uint64_t(findData.ftLastWriteTime.dwHighDateTime) << 32) | findData.ftLastWriteTime.dwLowDateTime;
+                    scanned.push_back(std::move(entry));
                 }
             }
         } while (FindNextFileW(hFind, &findData));
@@ -608,8 +609,43 @@ void LanguageManager::scanLanguageFiles() {
         FindClose(hFind);
     }
     
+    // 读取清单，清单中的名称只对大小和修改时间都没有变化的语言文件有效
+    std::ifstream file(langDir + L"locales.manifest", std::ios::binary);
+    if (file.is_open()) {
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!LocaleManifest::parse(text, m_locales)) {
+            m_locales.clear();
+        }
+    } else {
+        m_locales.clear();
+    }
+    bool changed = LocaleManifest::merge(m_locales, std::move(scanned));
+    
     // 按语言代码排序，确保一致的显示顺序
-    std::sort(m_availableLanguages.begin(), m_availableLanguages.end());
+    for (const auto& locale : m_locales) {
+        m_availableLanguages.push_back(locale.code);
+    }
+    
+    // 只删除了语言文件时立即更新清单；有新的或修改过的语言文件时，
+    // 等到获取语言列表读取了名称后再保存
+    if (changed && std::all_of(m_locales.begin(), m_locales.end(),
+                               [](const LocaleManifest::Entry& e) { return e.named; })) {
+        saveLocaleManifest();
+    }
+}
+
+void LanguageManager::saveLocaleManifest() const {
+    std::string text = LocaleManifest::format(m_locales);
+    std::wstring path = getLanguageDirectory() + L"locales.manifest";
+    if (!Foundation::FileUtils::writeFileAtomic(path, text.data(), text.size())) {
+        LOG_WARNING(L"无法保存语言文件清单: " + path);
+    }
+}
+
+const LocaleManifest::Entry* LanguageManager::findLocale(const std::wstring& languageCode) const {
+    auto it = std::lower_bound(m_locales.begin(), m_locales.end(), languageCode,
+        [](const LocaleManifest::Entry& e, const std::wstring& code) { return e.code < code; });
+    return it != m_locales.end() && it->code == languageCode ? &*it : nullptr;
 }
 
 void LanguageManager::initializeSupportedLanguages() {
@@ -633,42 +669,6 @@ const LanguageConfig* LanguageManager::findLanguageConfig(const std::wstring& la
     return nullptr;
 }
 
-void LanguageManager::trimString(std::string& str) const {
-    // 移除前后空白字符
-    str.erase(0, str.find_first_not_of(" \t\r\n"));
-    str.erase(str.find_last_not_of(" \t\r\n") + 1);
-}
-
-std::string LanguageManager::extractJsonValue(const std::string& line, size_t colonPos) const {
-    std::string value = line.substr(colonPos + 1);
-    
-    // 移除值的引号、逗号和空白字符
-    value.erase(0, value.find_first_not_of(" \t\""));
-    if (!value.empty() && value.back() == ',') {
-        value.pop_back();
-    }
-    if (!value.empty() && value.back() == '\"') {
-        value.pop_back();
-    }
-    
-    return value;
-}
-
-void LanguageManager::processEscapeSequences(std::wstring& str) const {
-    // 处理 \\r\\n 转义
-    size_t pos = 0;
-    while ((pos = str.find(L"\\r\\n", pos)) != std::wstring::npos) {
-        str.replace(pos, 4, L"\r\n");
-        pos += 2;
-    }
-    // 处理单独的 \\n 转义
-    pos = 0;
-    while ((pos = str.find(L"\\n", pos)) != std::wstring::npos) {
-        str.replace(pos, 2, L"\n");
-        pos += 1;
-    }
-}
-
 std::wstring LanguageManager::getEnglishFallback(int controlId, const std::wstring& elementName) const {
     // 基于控件ID的回退
     if (controlId == IDOK) {
@@ -0,0 +1,73 @@
+#include "core/stdafx.h"
+#include "system/locale_table.h"
+#include "system/locale_parser.h"
+#include "system/logger.h"
+#include "foundation/file_utils.h"
+#include "foundation/string_utils.h"
+#include <fstream>
+
+std::shared_ptr<const LocaleTable> LocaleTable::load(const std::wstring& code, const std::wstring& jsonPath,
+                                                     uint64_t sourceSize, uint64_t sourceTime) {
+    std::shared_ptr<LocaleTable> table(new LocaleTable());
+    table->m_code = code;
+    
+    // 预编译文件与JSON文件同名，记录了编译时JSON的大小和修改时间
+    std::wstring blobPath = jsonPath.substr(0, jsonPath.find_last_of(L'.')) + L".bin";
+    if (table->m_file.open(blobPath) && table->m_strings.open(table->m_file.data(), table->m_file.size()) &&
+        table->m_strings.sourceSize() == sourceSize && table->m_strings.sourceTime() == sourceTime) {
+        return table;
+    }
+    table->m_strings.close();
+    table->m_file.close();
+    
+    std::vector<char> blob = compile(jsonPath, sourceSize, sourceTime);
+    if (blob.empty()) {
+        return nullptr;
+    }
+    
+    // 保存编译结果，下次直接映射；安装目录不可写时只在内存中使用
+    if (!Foundation::FileUtils::writeFileAtomic(blobPath, blob.data(), blob.size())) {
+        LOG_WARNING(L"无法保存预编译语言文件: " + blobPath);
+    }
+    table->m_data.swap(blob);
+    if (!table->m_strings.open(table->m_data.data(), table->m_data.size())) {
+        return nullptr;
+    }
+    return table;
+}
+
+std::vector<char> LocaleTable::compile(const std::wstring& jsonPath, uint64_t sourceSize, uint64_t sourceTime) {
+    std::ifstream file(jsonPath, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR(L"无法打开语言文件: " + jsonPath);
+        return {};
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    // 单遍解析，键和值以UTF-8收集到一个字符串池中
+    std::string pool;
+    std::string error;
+    long count = LocaleParser::flatten(data.data(), data.size(), pool, error);
+    if (count < 0) {
+        LOG_ERROR(L"解析语言文件失败: " + jsonPath + L" - " + Foundation::StringUtils::utf8ToWide(error));
+        return {};
+    }
+    
+    // 整个字符串池一次转换为UTF-16（显式长度，保留分隔用的 \0）
+    std::wstring wide;
+    if (!pool.empty()) {
+        int len = MultiByteToWideChar(CP_UTF8, 0, pool.data(), int(pool.size()), nullptr, 0);
+        wide.resize(len);
+        MultiByteToWideChar(CP_UTF8, 0, pool.data(), int(pool.size()), &wide[0], len);
+    }
+    
+    LocaleBlob::Builder builder;
+    LocaleParser::split(std::wstring_view(wide), [&builder](std::wstring_view key, std::wstring_view value) {
+        builder.add(key, value);
+    });
+    std::vector<char> blob = builder.build(sourceSize, sourceTime);
+    if (blob.empty()) {
+        LOG_ERROR(L"编译语言文件失败: " + jsonPath);
+    }
+    return blob;
+}
@@ -1,7 +1,20 @@
 #include "core/stdafx.h"
 #include "system/logger.h"
+#include "system/log_timestamp.h"
 #include "core/application.h"
 
+// 未初始化时不记录任何级别
+std::atomic<int> Logger::s_enabledLevel(int(LogLevel::FATAL) + 1);
+
+// "省略了 N 次"的日志，每个级别一个调用点
+LogSite Logger::s_repeatSites[] = {
+    { LogLevel::DEBUG, __FILE__, __LINE__ },
+    { LogLevel::INFO, __FILE__, __LINE__ },
+    { LogLevel::WARNING, __FILE__, __LINE__ },
+    { LogLevel::ERR, __FILE__, __LINE__ },
+    { LogLevel::FATAL, __FILE__, __LINE__ },
+};
+
 // 获取单例实例
 Logger& Logger::getInstance() {
     static Logger instance;
@@ -10,17 +23,31 @@ Logger& Logger::getInstance() {
 
 // 构造函数
 Logger::Logger()
+    : m_segmentUsed(0),
+      m_segmentIndex(0)
 #ifdef _DEBUG
-    : m_logLevel(LogLevel::DEBUG)
+    , m_logLevel(LogLevel::DEBUG)
 #else
-    : m_logLevel(LogLevel::WARNING)  // Release版本只记录警告和错误
+    , m_logLevel(LogLevel::WARNING)  // Release版本只记录警告和错误
 #endif
     , m_initialized(false),
-      m_bufferSize(50),  // 缓冲区最多存储50条日志
-      m_flushInterval(std::chrono::milliseconds(2000))  // 2秒刷新间隔
+      m_queue(4096),  // 队列最多存储4096条日志，满时调用线程等待写入线程
+      m_writerWaiting(false),
+      m_urgent(false),
+      m_syncRequested(false),
+      m_stop(false),
+      m_open(false),
+      m_written(0),
+      m_synced(0),
+      m_binary(false),
+      m_binaryFile(INVALID_HANDLE_VALUE),
+      m_binaryWritten(0),
+      m_binarySynced(0),
+      m_sitesWritten(0),
+      m_rateSites{},
+      m_rateSiteCount(0),
+      m_flushInterval(std::chrono::milliseconds(2000))  // 2秒写入间隔
 {
-    m_lastFlush = std::chrono::steady_clock::now();
-    m_logBuffer.reserve(m_bufferSize);  // 预分配缓冲区空间
 }
 
 // 析构函数
@@ -32,21 +59,53 @@ Logger::~Logger() {
 void Logger::shutdown() {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    // 先刷新缓冲区，确保所有日志都被写入
-    flushBuffer();
+    if (!m_initialized) {
+        return;
+    }
     
-    // 先清理旧的日志文件（此时日志文件还开着，可以记录删除操作）
-    cleanupOldLogFiles(10);
+    // 不再接受新的日志，写入线程写完队列中的日志后结束
+    reportAllRepeated();
+    s_enabledLevel = int(LogLevel::FATAL) + 1;
+    m_initialized = false;
+    stopWriter();
     
-    if (m_logFile.is_open()) {
-        // 写入日志结束标记
-        m_logFile << wstringToUtf8(L"===================================") << std::endl;
-        m_logFile << wstringToUtf8(L"微钉 日志结束 - " + getCurrentTimeString()) << std::endl;
-        m_logFile << wstringToUtf8(L"===================================") << std::endl;
-        m_logFile.close();
+    // 调用线程可能在关闭前通过了级别检查，写入线程结束后才放入队列：
+    // 在这里写完（包括已占用位置、还在写入的）并刷新到磁盘，之后 flush() 不再等待
+    uint64_t written = m_written;
+    uint64_t binaryWritten = m_binaryWritten;
+    for (;;) {
+        uint64_t count, events;
+        writeQueued(count, events);
+        written += count;
+        binaryWritten += events;
+        if (written >= m_queue.pushed() && (!m_binary || binaryWritten >= m_binaryQueue->pushed())) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    syncFiles();
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_written = written;
+        m_binaryWritten = binaryWritten;
+        m_synced = m_written;
+        m_binarySynced = m_binaryWritten;
+        m_open = false;
     }
+    m_drained.notify_all();
     
-    m_initialized = false;
+    if (m_segment.isOpen()) {
+        // 写入日志结束标记，文件截断为实际写入的长度
+        writeFile(wstringToUtf8(L"===================================\r\n"
+                                L"微钉 日志结束 - " + getCurrentTimeString() + L"\r\n"
+                                L"===================================\r\n"));
+        m_segment.close(m_segmentUsed);
+    }
+    if (m_binaryFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_binaryFile);
+        m_binaryFile = INVALID_HANDLE_VALUE;
+    }
+    m_binary = false;
 }
 
 // 初始化日志系统
@@ -69,93 +128,361 @@ bool Logger::init(const std::wstring& logDir) {
         return false;
     }
     
-    // 生成日志文件名
-    m_logFilePath = m_logDir + L"\\" + generateLogFileName();
-    
-    // 打开日志文件
-    m_logFile.open(m_logFilePath, std::ios::out | std::ios::app);
-    if (!m_logFile.is_open()) {
+    // 生成日志文件名，先读取已有的日志段再新建第一段
+    m_logStem = generateLogFileName();
+    m_segmentIndex = 0;
+    scanLogFiles();
+    trimOrphanedSegments();
+    if (!openSegment()) {
         return false;
     }
+    m_logFilePath = m_logDir + L"\\" + m_logFiles.back().name;
     
-    // 写入UTF-8 BOM以确保正确的编码识别
-    m_logFile << "\xEF\xBB\xBF";
-    
-    // 写入日志头
-    m_logFile << wstringToUtf8(L"===================================") << std::endl;
-    m_logFile << wstringToUtf8(L"微钉 日志开始 - " + getCurrentTimeString()) << std::endl;
-    m_logFile << wstringToUtf8(L"===================================") << std::endl;
+    // 写入日志头，然后清理旧的日志段（记录删除操作）
+    writeFile(wstringToUtf8(L"===================================\r\n"
+                            L"微钉 日志开始 - " + getCurrentTimeString() + L"\r\n"
+                            L"===================================\r\n"));
+    cleanupOldLogFiles(KEEP_SEGMENTS);
     
+    m_stop = false;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_open = true;
+    }
+    m_writer = std::thread(&Logger::writerThread, this);
     m_initialized = true;
+    s_enabledLevel = int(m_logLevel.load());
     return true;
 }
 
 // 写入日志
 void Logger::log(LogLevel level, const std::wstring& message) {
-    if (level < m_logLevel || !m_initialized) {
+    if (!isEnabled(level)) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // 在调用线程中格式化，时间是调用时的时间
+    LogRecord record;
+    beginRecord(record, level);
+    LogFormat::appendWide(record.text, message);
+    push(std::move(record));
+}
+
+// 开始一行文本日志：时间和级别
+void Logger::beginRecord(LogRecord& record, LogLevel level) const {
+    record.level = level;
+    record.text.clear();
+    LogTimestamp::append(record.text);
+    record.text += " [";
+    record.text += BinaryLog::LEVEL_NAMES[int(level)];
+    record.text += "] ";
+}
+
+// 补上行尾后放入文本日志队列，按级别唤醒写入线程
+void Logger::push(LogRecord&& record) {
+    LogLevel level = record.level;
+    record.text += "\r\n";
     
-    if (m_logFile.is_open()) {
-        std::wstring logLine = getCurrentTimeString() + L" [" + getLevelString(level) + L"] " + message;
-        std::string utf8LogLine = wstringToUtf8(logLine);
-        
-        // 添加到缓冲区
-        m_logBuffer.push_back(utf8LogLine);
-        
-        // 检查是否需要立即刷新
-        if (shouldFlush(level)) {
-            flushBuffer();
-        }
+    // 队列满时等待写入线程取出
+    while (!m_queue.tryPush(std::move(record))) {
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    
+    if (level >= LogLevel::FATAL) {
+        // 致命错误后程序可能立即结束：等待写入并刷新到磁盘
+        flush(true);
+    } else if (level >= LogLevel::ERR || m_queue.approxSize() >= m_queue.capacity() / 4) {
+        wakeWriter();
     }
 }
 
-// 检查是否需要刷新缓冲区
-bool Logger::shouldFlush(LogLevel level) const {
-    // 错误和致命错误立即刷新
-    if (level >= LogLevel::ERR) {
+// 启用二进制日志
+bool Logger::enableBinaryLog() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    if (!m_initialized) {
+        return false;
+    }
+    if (m_binary) {
         return true;
     }
     
-    // 缓冲区满了需要刷新
-    if (m_logBuffer.size() >= m_bufferSize) {
-        return true;
+    std::wstring path = m_logFilePath.substr(0, m_logFilePath.find_last_of(L'.')) + L".tplog";
+    m_binaryFile = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                               nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_binaryFile == INVALID_HANDLE_VALUE) {
+        return false;
     }
     
-    // 超过时间间隔需要刷新
-    auto now = std::chrono::steady_clock::now();
-    if (now - m_lastFlush >= m_flushInterval) {
+    // 文件头记录开始时间和时区，解码时按本地时间输出
+    FILETIME utc, local;
+    GetSystemTimeAsFileTime(&utc);
+    FileTimeToLocalFileTime(&utc, &local);
+    int64_t utcTicks = (int64_t(utc.dwHighDateTime) << 32) | utc.dwLowDateTime;
+    int64_t localTicks = (int64_t(local.dwHighDateTime) << 32) | local.dwLowDateTime;
+    BinaryLog::Writer header;
+    header.writeHeader(currentTime(), int16_t((localTicks - utcTicks) / 600000000));
+    DWORD written = 0;
+    WriteFile(m_binaryFile, header.buffer().data(), DWORD(header.buffer().size()), &written, nullptr);
+    header.buffer().clear();
+    m_binaryWriter = std::move(header);     // 保留开始时间，之后的记录相对它计算时间差
+    
+    // 队列和文件准备好之后才允许写入
+    m_binaryQueue = std::make_unique<Foundation::MpscRing<BinaryEvent>>(4096);
+    m_binary = true;
+    LOG_INFO(L"结构化日志写入: " + path);
+    return true;
+}
+
+// 结构化日志放入队列后按级别唤醒写入线程，致命错误等待刷新到磁盘
+void Logger::binaryPushed(LogLevel level) {
+    if (level >= LogLevel::FATAL) {
+        flush(true);
+    } else if (level >= LogLevel::ERR || m_binaryQueue->approxSize() >= m_binaryQueue->capacity() / 4) {
+        wakeWriter();
+    }
+}
+
+// 登记调用点，返回编号
+uint32_t Logger::registerSite(LogSite& site, const char* format) {
+    std::lock_guard<std::mutex> lock(m_siteMutex);
+    uint32_t id = site.id.load(std::memory_order_relaxed);
+    if (!id) {
+        site.format = format;
+        m_sites.push_back(&site);
+        id = uint32_t(m_sites.size());
+        site.id.store(id, std::memory_order_release);
+    }
+    return id;
+}
+
+// 是否记录这一条：不记录时计数；记录时通过 repeated 返回此前省略的条数
+bool Logger::admit(LogSite& site, uint32_t& repeated) {
+    uint32_t index = site.rateSlot.load(std::memory_order_acquire);
+    if (!index) {
+        index = assignRateSlot(site);
+    }
+    if (index == NO_RATE_SLOT) {
         return true;
     }
+    RateSlot& slot = m_rateSlots[index - 1];
     
-    return false;
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t due = slot.due.load(std::memory_order_relaxed);
+    int64_t next;
+    do {
+        // 比现在提前超过 RATE_BURST-1 个间隔，说明突发的额度已经用完
+        if (due - now > (RATE_BURST - 1) * RATE_INTERVAL) {
+            slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        next = (std::max)(due, now) + RATE_INTERVAL;
+    } while (!slot.due.compare_exchange_weak(due, next, std::memory_order_relaxed));
+    
+    repeated = slot.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
 }
 
-// 批量写入缓冲区到文件
-void Logger::flushBuffer() {
-    if (m_logBuffer.empty() || !m_logFile.is_open()) {
-        return;
+// 为调用点分配频率限制槽位，返回槽位编号，已用完时返回 NO_RATE_SLOT
+uint32_t Logger::assignRateSlot(LogSite& site) {
+    std::lock_guard<std::mutex> lock(m_siteMutex);
+    uint32_t index = site.rateSlot.load(std::memory_order_relaxed);
+    if (!index) {
+        if (m_rateSiteCount < RATE_SLOTS) {
+            m_rateSites[m_rateSiteCount] = &site;
+            index = uint32_t(++m_rateSiteCount);
+        } else {
+            index = NO_RATE_SLOT;
+        }
+        site.rateSlot.store(index, std::memory_order_release);
     }
-    
-    // 批量写入所有缓冲的日志
-    for (const auto& logLine : m_logBuffer) {
-        m_logFile << logLine << std::endl;
+    return index;
+}
+
+// 记录调用点省略的条数
+void Logger::reportRepeated(const LogSite& site, uint32_t repeated) {
+    std::string_view file = site.file;
+    file.remove_prefix(file.find_last_of("\\/") + 1);
+    event(s_repeatSites[int(site.level)], "{}:{} 的日志省略了 {} 次", file, site.line, repeated);
+}
+
+// 关闭前输出所有调用点尚未报告的省略条数
+void Logger::reportAllRepeated() {
+    // 先复制调用点再输出，输出时可能需要登记调用点
+    const LogSite* sites[RATE_SLOTS];
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(m_siteMutex);
+        count = m_rateSiteCount;
+        std::copy(m_rateSites, m_rateSites + count, sites);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t repeated = m_rateSlots[i].suppressed.exchange(0, std::memory_order_relaxed);
+        if (repeated) {
+            reportRepeated(*sites[i], repeated);
+        }
+    }
+}
+
+// 写入线程：把结构化日志编码到 m_binaryWriter，需要时先写入新登记的调用点
+void Logger::encodeEvent(const BinaryEvent& ev) {
+    if (ev.site > m_sitesWritten) {
+        std::lock_guard<std::mutex> lock(m_siteMutex);
+        for (; m_sitesWritten < m_sites.size(); ++m_sitesWritten) {
+            const LogSite* site = m_sites[m_sitesWritten];
+            // 只保留源文件名
+            std::string_view file = site->file;
+            file.remove_prefix(file.find_last_of("\\/") + 1);
+            m_binaryWriter.writeSite(uint32_t(m_sitesWritten + 1), uint8_t(site->level), uint32_t(site->line),
+                                     file, site->format, ev.time);
+        }
+    }
+    m_binaryWriter.writeEvent(ev.site, ev.time, ev.args, ev.size);
+}
+
+// 1970年起的100纳秒数（UTC）。
+// 这是结构化日志调用线程中最耗时的一步（见 tools/LogLatencyBench），
+// 但 GetSystemTimeAsFileTime 的分辨率是时钟中断间隔，比文本日志的毫秒时间戳还粗，不能代替
+int64_t Logger::currentTime() {
+    using Ticks = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+    return std::chrono::duration_cast<Ticks>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 唤醒写入线程
+void Logger::wakeWriter() {
+    m_urgent = true;
+    if (m_writerWaiting) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+// 写入线程：取出队列中的日志，复制到映射的日志段
+void Logger::writerThread() {
+    for (;;) {
+        // 先读取停止标志再取出日志，停止前放入队列的日志都会写入
+        bool stop = m_stop;
+        m_urgent = false;
+        
+        uint64_t count, events;
+        writeQueued(count, events);
+        
+        // 请求之后才取出的日志可能没有包含在这次刷新中，等待的线程按刷新时的写入数判断
+        bool sync = m_syncRequested.exchange(false);
+        if (sync) {
+            syncFiles();
+        }
+        if (count > 0 || events > 0 || sync) {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_written += count;
+                m_binaryWritten += events;
+                if (sync) {
+                    m_synced = m_written;
+                    m_binarySynced = m_binaryWritten;
+                }
+            }
+            m_drained.notify_all();
+        }
+        
+        if (stop && count == 0 && events == 0) {
+            break;
+        }
+        
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_writerWaiting = true;
+        m_wake.wait_for(lock, m_flushInterval, [this] { return m_urgent || m_stop; });
+        m_writerWaiting = false;
+    }
+}
+
+// 取出队列中的日志写入文件，每个队列最多取出一圈（调用时没有其他线程在取）
+void Logger::writeQueued(uint64_t& count, uint64_t& events) {
+    count = 0;
+    events = 0;
+    LogRecord record;
+    while (count < m_queue.capacity() && m_queue.tryPop(record)) {
+        writeFile(record.text);
+        ++count;
     }
     
-    // 刷新文件流
-    m_logFile.flush();
-    
-    // 清空缓冲区并更新时间
-    m_logBuffer.clear();
-    m_lastFlush = std::chrono::steady_clock::now();
+    // 结构化日志
+    if (m_binary) {
+        // 在队列的槽中直接编码，不复制整条记录
+        auto encode = [this](const BinaryEvent& event) { encodeEvent(event); };
+        while (events < m_binaryQueue->capacity() && m_binaryQueue->tryConsume(encode)) {
+            ++events;
+        }
+        std::vector<uint8_t>& buf = m_binaryWriter.buffer();
+        if (!buf.empty()) {
+            DWORD written = 0;
+            WriteFile(m_binaryFile, buf.data(), DWORD(buf.size()), &written, nullptr);
+            buf.clear();
+        }
+    }
 }
 
-// 强制刷新缓冲区
-void Logger::flush() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    flushBuffer();
+// 把已写入的日志刷新到磁盘
+void Logger::syncFiles() {
+    m_segment.flush(m_segmentUsed);
+    if (m_binary) {
+        FlushFileBuffers(m_binaryFile);
+    }
+}
+
+// 停止写入线程，队列中的日志写完后返回
+void Logger::stopWriter() {
+    if (!m_writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+}
+
+// 写入当前日志段，写满时切换到下一段（调用时没有其他线程在写）
+void Logger::writeFile(std::string_view text) {
+    if (!m_segment.isOpen()) {
+        return;
+    }
+    if (text.size() > m_segment.size() - m_segmentUsed) {
+        rotateSegment();
+        if (!m_segment.isOpen()) {
+            return;
+        }
+        // 超过一段大小的单条日志截断
+        text = text.substr(0, m_segment.size() - m_segmentUsed);
+    }
+    memcpy(static_cast<char*>(m_segment.data()) + m_segmentUsed, text.data(), text.size());
+    m_segmentUsed += text.size();
+}
+
+// 等待此前的日志全部写入文件，sync 为 true 时还要等待刷新到磁盘
+void Logger::flush(bool sync) {
+    uint64_t target = m_queue.pushed();
+    uint64_t binaryTarget = m_binary ? m_binaryQueue->pushed() : 0;
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    auto pending = [&] {
+        return sync ? m_synced < target || m_binarySynced < binaryTarget
+                    : m_written < target || m_binaryWritten < binaryTarget;
+    };
+    // 关闭开始后写入线程仍会写完队列并处理刷新请求，写入线程结束后由 shutdown() 写完剩余的日志；
+    // 只有 shutdown() 完成后（或尚未初始化时）才不再等待
+    while (pending() && m_open) {
+        // 其他线程可能刚占用位置还没有写完日志，写入线程取不到时需要再次唤醒；
+        // 刷新请求可能已被写入线程在取出这些日志之前消耗，每次都重新请求
+        m_urgent = true;
+        if (sync) {
+            m_syncRequested = true;
+        }
+        m_wake.notify_one();
+        m_drained.wait_for(lock, std::chrono::milliseconds(10));
+    }
 }
 
 // 不同级别的日志方法
@@ -181,7 +508,11 @@ void Logger::fatal(const std::wstring& message) {
 
 // 设置日志级别
 void Logger::setLogLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_logLevel = level;
+    if (m_initialized) {
+        s_enabledLevel = int(level);
+    }
 }
 
 // 获取当前日志级别
@@ -189,38 +520,11 @@ LogLevel Logger::getLogLevel() const {
     return m_logLevel;
 }
 
-// 获取日志级别的字符串表示
-std::wstring Logger::getLevelString(LogLevel level) const {
-    switch (level) {
-        case LogLevel::DEBUG:   return L"调试";
-        case LogLevel::INFO:    return L"信息";
-        case LogLevel::WARNING: return L"警告";
-        case LogLevel::ERR:   return L"错误";
-        case LogLevel::FATAL:   return L"致命";
-        default:                return L"未知";
-    }
-}
-
 // 获取当前时间的字符串表示
 std::wstring Logger::getCurrentTimeString() const {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    
-    std::wstringstream ss;
-    std::tm tm_buf;
-    localtime_s(&tm_buf, &time);
-    
-    ss << std::setfill(L'0')
-       << std::setw(4) << (tm_buf.tm_year + 1900) << L'-'
-       << std::setw(2) << (tm_buf.tm_mon + 1) << L'-'
-       << std::setw(2) << tm_buf.tm_mday << L' '
-       << std::setw(2) << tm_buf.tm_hour << L':'
-       << std::setw(2) << tm_buf.tm_min << L':'
-       << std::setw(2) << tm_buf.tm_sec << L'.'
-       << std::setw(3) << ms.count();
-    
-    return ss.str();
+    std::string text;
+    LogTimestamp::append(text);
+    return std::wstring(text.begin(), text.end());     // 只有ASCII字符
 }
 
 // 将宽字符串转换为UTF-8
@@ -263,61 +567,133 @@ std::wstring Logger::generateLogFileName() const {
        << std::setw(2) << tm_buf.tm_mday << L"_"
        << std::setw(2) << tm_buf.tm_hour
        << std::setw(2) << tm_buf.tm_min
-       << std::setw(2) << tm_buf.tm_sec << L".log";
+       << std::setw(2) << tm_buf.tm_sec;
     
     return ss.str();
 }
 
-// 清理旧的日志文件，只保留最近的指定数量
-void Logger::cleanupOldLogFiles(int keepCount) {
-    if (!m_initialized || m_logDir.empty()) {
-        return;
-    }
-    
+// 读取日志目录中已有的日志段（只读取目录项，不读取文件属性），按文件名中的时间排序
+void Logger::scanLogFiles() {
+    m_logFiles.clear();
     try {
-        std::vector<std::filesystem::directory_entry> logFiles;
-        
-        // 遍历日志目录，收集所有日志文件
         for (const auto& entry : std::filesystem::directory_iterator(m_logDir)) {
-            if (entry.is_regular_file()) {
-                std::wstring filename = entry.path().filename().wstring();
-                // 检查是否是我们的日志文件（以tinypin_开头，以.log结尾）
-                if (filename.length() > 12 && 
-                    filename.substr(0, 8) == L"tinypin_" && 
-                    filename.substr(filename.length() - 4) == L".log") {
-                    logFiles.push_back(entry);
-                }
+            LogSegments::FileName file;
+            if (LogSegments::parse(entry.path().filename().wstring(), file)) {
+                m_logFiles.push_back(std::move(file));
             }
         }
+    } catch (const std::exception&) {
+        // 无法读取目录时不清理旧日志
+    }
+    
+    std::sort(m_logFiles.begin(), m_logFiles.end(), LogSegments::older);
+}
+
+// 上次运行没有正常结束时（例如被强制结束）日志段保持预先分配的大小，末尾是空字符：
+// 截断到实际写入的内容。更早的运行已经在之后的启动中处理过，只检查最近一次运行的日志段
+void Logger::trimOrphanedSegments() {
+    if (m_logFiles.empty()) {
+        return;
+    }
+    uint64_t last = m_logFiles.back().time;
+    for (auto it = m_logFiles.rbegin(); it != m_logFiles.rend() && it->time == last; ++it) {
+        std::wstring path = m_logDir + L"\\" + it->name;
         
-        // 如果日志文件数量不超过保留数量，则不需要清理
-        if (static_cast<int>(logFiles.size()) <= keepCount) {
-            return;
+        // 仍在写入的日志段（同时运行的其他实例）不共享写入权限，打开会失败
+        size_t length = 0;
+        {
+            Foundation::MappedFile file;
+            if (!file.open(path)) {
+                continue;
+            }
+            const char* data = static_cast<const char*>(file.data());
+            length = file.size();
+            if (data[length - 1] != '\0') {
+                continue;
+            }
+            while (length > 0 && data[length - 1] == '\0') {
+                --length;
+            }
         }
         
-        // 按修改时间排序（最新的在前）
-        std::sort(logFiles.begin(), logFiles.end(), 
-                  [](const std::filesystem::directory_entry& a, const std::filesystem::directory_entry& b) {
-                      return std::filesystem::last_write_time(a) > std::filesystem::last_write_time(b);
-                  });
-        
-        // 删除多余的旧文件
-        for (size_t i = keepCount; i < logFiles.size(); ++i) {
-            try {
-                std::filesystem::remove(logFiles[i].path());
-                // 记录删除操作（如果当前日志文件还可用的话）
-                if (m_logFile.is_open()) {
-                    std::wstring deletedFile = logFiles[i].path().filename().wstring();
-                    std::wstring logMessage = L"已删除旧日志文件: " + deletedFile;
-                    m_logFile << wstringToUtf8(getCurrentTimeString() + L" [信息] " + logMessage) << std::endl;
-                    m_logFile.flush();
-                }
-            } catch (const std::exception&) {
-                // 删除失败时忽略错误，避免影响程序正常退出
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            continue;
+        }
+        LARGE_INTEGER end;
+        end.QuadPart = LONGLONG(length);
+        if (SetFilePointerEx(file, end, nullptr, FILE_BEGIN)) {
+            SetEndOfFile(file);
+        }
+        CloseHandle(file);
+    }
+}
+
+// 新建并映射下一个日志段
+bool Logger::openSegment() {
+    // 同一秒内启动的其他进程可能已经用了这个段号，跳过已存在的文件
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        uint32_t index = m_segmentIndex++;
+        std::wstring name = m_logStem + (index ? L"_" + std::to_wstring(index) : std::wstring()) + L".log";
+        if (m_segment.create(m_logDir + L"\\" + name, SEGMENT_SIZE)) {
+            m_segmentUsed = 0;
+            LogSegments::FileName file;
+            LogSegments::parse(name, file);
+            m_logFiles.push_back(std::move(file));  // 当前的日志段总在最后，清理时不会删除
+            
+            // 每段都写入UTF-8 BOM以确保正确的编码识别
+            writeFile("\xEF\xBB\xBF");
+            return true;
+        }
+        if (GetLastError() != ERROR_FILE_EXISTS) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// 当前日志段写满：截断并关闭，打开下一段，删除多余的旧日志段
+void Logger::rotateSegment() {
+    m_segment.close(m_segmentUsed);
+    if (!openSegment()) {
+        return;     // 无法新建日志段时不再写入文本日志
+    }
+    
+    writeFile(wstringToUtf8(L"微钉 日志第 " + std::to_wstring(m_logFiles.back().segment + 1) +
+                            L" 段 - " + getCurrentTimeString() + L"\r\n"));
+    cleanupOldLogFiles(KEEP_SEGMENTS);
+}
+
+// 删除最旧的日志段，只保留最近的指定数量
+void Logger::cleanupOldLogFiles(size_t keepCount) {
+    LogSegments::trim(m_logFiles, keepCount,
+        [this](const std::wstring& name) {
+            // 删除失败时忽略错误，避免影响日志写入
+            std::error_code ec;
+            if (std::filesystem::remove(std::filesystem::path(m_logDir) / name, ec)) {
+                LogRecord record;
+                beginRecord(record, LogLevel::INFO);
+                LogFormat::appendWide(record.text, L"已删除旧日志文件: " + name);
+                record.text += "\r\n";
+                writeFile(record.text);
             }
+        },
+        [this](const std::wstring& stem) { removeBinaryLogs(stem); });
+}
+
+// 删除一次运行的二进制日志（tinypin_YYYYMMDD_HHMMSS[_段号].tplog），当前运行的除外
+void Logger::removeBinaryLogs(const std::wstring& stem) {
+    if (stem.empty() || stem == m_logStem) {
+        return;
+    }
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(m_logDir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::wstring name = it->path().filename().wstring();
+        if (name.compare(0, stem.size(), stem) == 0 && name.size() > 6 &&
+            name.compare(name.size() - 6, 6, L".tplog") == 0) {
+            std::error_code removeError;
+            std::filesystem::remove(it->path(), removeError);
         }
-        
-    } catch (const std::exception&) {
-        // 清理过程中出现异常时忽略，避免影响程序正常退出
     }
-}
\ No newline at end of file
+}
@@ -104,21 +104,20 @@ void localizeDialog(HWND dlg, const std::wstring& dialogName) {
         localizePropertySheetButtons(dlg, dialogName);
     }
     
-    // 本地化所有子控件
+    // 本地化所有子控件，对话框名称只解析一次
+    int dialog = LANG_MGR.dialogIndex(dialogName);
     EnumChildWindows(dlg, [](HWND child, LPARAM lParam) -> BOOL {
-        const std::wstring* baseDialogName = reinterpret_cast<const std::wstring*>(lParam);
-        
         int controlId = GetDlgCtrlID(child);
         
-        // 使用新的控件ID映射系统获取本地化文本
-        std::wstring text = LANG_MGR.getControlText(controlId, *baseDialogName);
+        // 使用新的控件ID映射系统获取本地化文本（以\0结尾）
+        std::wstring_view text = LANG_MGR.controlText(controlId, int(lParam));
         
         if (!text.empty()) {
-            SetWindowText(child, text.c_str());
+            SetWindowText(child, text.data());
         }
         
         return TRUE;
-    }, reinterpret_cast<LPARAM>(&dialogName));
+    }, LPARAM(dialog));
 }
 
 void localizePropertySheetButtons(HWND propSheet, const std::wstring& dialogName) {
@@ -126,15 +125,16 @@ void localizePropertySheetButtons(HWND propSheet, const std::wstring& dialogName
     
     // 属性表的标准按钮ID
     const int buttonIds[] = { IDOK, IDCANCEL, Constants::ID_APPLY_BUTTON }; // Apply按钮的ID
+    int dialog = LANG_MGR.dialogIndex(dialogName);
     
     for (int i = 0; i < 3; i++) {
         HWND button = GetDlgItem(propSheet, buttonIds[i]);
         if (button) {
             // 使用新的控件ID映射系统获取本地化文本
-            std::wstring text = LANG_MGR.getControlText(buttonIds[i], dialogName);
+            std::wstring_view text = LANG_MGR.controlText(buttonIds[i], dialog);
             
             if (!text.empty()) {
-                SetWindowText(button, text.c_str());
+                SetWindowText(button, text.data());
             }
         }
     }
@@ -144,9 +144,9 @@ void localizeDialogTitle(HWND dlg, const std::wstring& dialogName) {
     if (!dlg || !IsWindow(dlg)) return;
     
     // 使用新的控件ID映射系统获取对话框标题，使用0作为对话框标题的特殊ID
-    std::wstring title = LANG_MGR.getControlText(0, dialogName);
+    std::wstring_view title = LANG_MGR.controlText(0, LANG_MGR.dialogIndex(dialogName));
     if (!title.empty()) {
-        SetWindowText(dlg, title.c_str());
+        SetWindowText(dlg, title.data());
     }
 }
 
@@ -157,15 +157,25 @@ void localizeControl(HWND dlg, int controlId, const std::wstring& dialogName, co
     if (!control) return;
     
     // 使用新的控件ID映射系统获取本地化文本
-    std::wstring text = LANG_MGR.getControlText(controlId, dialogName);
+    std::wstring_view text = LANG_MGR.controlText(controlId, LANG_MGR.dialogIndex(dialogName));
     if (!text.empty()) {
-        SetWindowText(control, text.c_str());
+        SetWindowText(control, text.data());
     }
 }
 
-void localizeMenu(HMENU menu, const std::wstring& menuName) {
-    if (!menu) return;
-    
+// 设置菜单项文本，text 以\0结尾
+static void setMenuItemText(HMENU menu, UINT itemId, std::wstring_view text) {
+    MENUITEMINFO mii = {0};
+    mii.cbSize = sizeof(MENUITEMINFO);
+    mii.fMask = MIIM_STRING;
+    mii.dwTypeData = const_cast<LPWSTR>(text.data());
+    mii.cch = static_cast<UINT>(text.length());
+    
+    SetMenuItemInfo(menu, itemId, FALSE, &mii);
+}
+
+// 递归本地化菜单项，菜单名称已解析为编号
+static void localizeMenuItems(HMENU menu, int menuIndex) {
     int itemCount = GetMenuItemCount(menu);
     for (int i = 0; i < itemCount; i++) {
         MENUITEMINFO mii = {0};
@@ -178,29 +188,32 @@ void localizeMenu(HMENU menu, const std::wstring& menuName) {
         if (GetMenuItemInfo(menu, i, TRUE, &mii)) {
             if (mii.hSubMenu) {
                 // 递归处理子菜单
-                localizeMenu(mii.hSubMenu, menuName);
+                localizeMenuItems(mii.hSubMenu, menuIndex);
             } else if (mii.wID > 0) {
                 // 使用新的控件ID映射系统本地化菜单项
-                localizeMenuItem(menu, mii.wID, menuName, L"");
+                std::wstring_view text = LANG_MGR.controlText(mii.wID, menuIndex);
+                if (!text.empty()) {
+                    setMenuItemText(menu, mii.wID, text);
+                }
             }
         }
     }
 }
 
+void localizeMenu(HMENU menu, const std::wstring& menuName) {
+    if (!menu) return;
+    
+    localizeMenuItems(menu, LANG_MGR.dialogIndex(menuName));
+}
+
 void localizeMenuItem(HMENU menu, UINT itemId, const std::wstring& menuName, const std::wstring& itemName) {
     if (!menu) return;
     
     // 使用新的控件ID映射系统获取菜单项文本
-    std::wstring text = LANG_MGR.getControlText(itemId, menuName);
+    std::wstring_view text = LANG_MGR.controlText(itemId, LANG_MGR.dialogIndex(menuName));
     
     if (!text.empty()) {
-        MENUITEMINFO mii = {0};
-        mii.cbSize = sizeof(MENUITEMINFO);
-        mii.fMask = MIIM_STRING;
-        mii.dwTypeData = const_cast<LPWSTR>(text.c_str());
-        mii.cch = static_cast<UINT>(text.length());
-        
-        SetMenuItemInfo(menu, itemId, FALSE, &mii);
+        setMenuItemText(menu, itemId, text);
     }
 }
 
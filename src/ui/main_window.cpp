@@ -5,6 +5,9 @@
 #include "pin/pin_window.h"
 #include "pin/pin_layer_window.h"
 #include "pin/auto_pin_manager.h"
+#include "pin/event_recorder.h"
+#include "platform/directory_watcher.h"
+#include "foundation/file_change_detector.h"
 #include "window/window_monitor.h"
 #include "options/options.h"
 #include "options/options_dialog.h"
@@ -19,6 +22,13 @@
 LPCWSTR MainWnd::className = L"EFTinyPin";
 
 namespace {
+    // 配置文件热重载
+    enum ConfigFile { CONFIG_INI, CONFIG_RULES };
+    Foundation::FileChangeDetector s_configFiles;
+    Platform::DirectoryWatcher s_configWatcher;
+    Foundation::ChangeDebouncer s_configDebounce(std::chrono::milliseconds(Constants::CONFIG_RELOAD_DELAY));
+    bool s_configChanged[2] = { false, false };   // 已检测到变化、尚未重新加载
+
     // 常量定义
     constexpr struct {
         int id;
@@ -265,9 +275,38 @@ LRESULT CALLBACK MainWnd::proc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lparam)
             if (wparam == App::TIMERID_AUTOPIN) {
                 pendWnds.check(wnd, *opt);
             }
+            else if (wparam == App::TIMERID_CONFIGRELOAD) {
+                KillTimer(wnd, App::TIMERID_CONFIGRELOAD);
+                auto now = Foundation::ChangeDebouncer::Clock::now();
+                if (s_configDebounce.take(now)) {
+                    if (winCreMon) {
+                        reloadConfig(wnd, *winCreMon, opt);
+                    }
+                }
+                else if (s_configDebounce.pending()) {
+                    // 定时器启动之后又有通知，等到最后一次通知之后
+                    SetTimer(wnd, App::TIMERID_CONFIGRELOAD, UINT(s_configDebounce.remaining(now).count()), nullptr);
+                }
+            }
+            break;
+        case App::WM_CONFIGCHANGED:
+            // 配置文件往往分几次写入，最后一次通知之后稍等再重新加载
+            if (s_configDebounce.notify(Foundation::ChangeDebouncer::Clock::now())) {
+                SetTimer(wnd, App::TIMERID_CONFIGRELOAD, Constants::CONFIG_RELOAD_DELAY, nullptr);
+            }
             break;
         case App::WM_QUEUEWINDOW:
-            pendWnds.add(reinterpret_cast<HWND>(wparam));
+            if (winCreMon) {
+                static std::vector<HWND> created, renamed;
+                winCreMon->takeBatch(created, renamed);
+                pendWnds.add(created);
+                if (!renamed.empty()) {
+                    pendWnds.titleChanged(wnd, renamed, *opt);
+                }
+            }
+            break;
+        case App::WM_AUTOPIN_SWEEP:
+            pendWnds.sweep(wnd, *opt);
             break;
         case App::WM_PINSTATUS:
             handlePinStatus(lparam);
@@ -275,8 +314,13 @@ LRESULT CALLBACK MainWnd::proc(HWND wnd, UINT msg, WPARAM wparam, LPARAM lparam)
         case WM_COMMAND:
             return handleCommand(wnd, wparam, *winCreMon, opt);
         case WM_ENDSESSION:
-            if (wparam && opt) {
-                opt->save();
+            if (wparam) {
+                if (opt) {
+                    opt->save();
+                }
+                // 注销或关机时进程随后被结束，不会运行静态析构：
+                // 在这里写完队列中的日志并截断日志段
+                Logger::getInstance().shutdown();
             }
             return 0;
         case WM_DWMCOMPOSITIONCHANGED:
@@ -304,8 +348,14 @@ LRESULT MainWnd::handleCreate(HWND wnd, LPARAM lparam, std::unique_ptr<WindowCre
     opt = static_cast<Options*>(cs->lpCreateParams);
     app.mainWnd = wnd;
     
+    // 调试：录制自动图钉事件，供 tools/AutoPinReplay 回放
+    if (opt->recordEvents) {
+        startEventRecording();
+    }
+
     // 初始化窗口创建监控器
     winCreMon = std::make_unique<EventHookWindowCreationMonitor>();
+    winCreMon->setFilter(opt->autoPinFilter());
     if (opt->autoPinOn && !winCreMon->init(wnd, App::WM_QUEUEWINDOW)) {
         LOG_WARNING(L"无法初始化窗口创建监控器，自动图钉功能将被禁用");
         // 优先从本地化文件获取错误消息
@@ -335,10 +385,16 @@ LRESULT MainWnd::handleCreate(HWND wnd, LPARAM lparam, std::unique_ptr<WindowCre
     
     if (opt->autoPinOn) {
         SetTimer(wnd, App::TIMERID_AUTOPIN, opt->autoPinDelay.value, nullptr);
+        // 窗口创建完成后再扫描已打开的窗口
+        if (opt->autoPinSweep) {
+            PostMessage(wnd, App::WM_AUTOPIN_SWEEP, 0, 0);
+        }
     }
 
     initializeDpiSettings(wnd, opt);
     
+    startConfigWatcher(wnd, opt);
+    
     // 初始化图钉计数 - 计算已存在的图钉窗口数量
     int pinCount = 0;
     HWND pin = nullptr;
@@ -363,6 +419,8 @@ LRESULT MainWnd::handleDestroy(HWND wnd, std::unique_ptr<WindowCreationMonitor>&
         winCreMon->term();
         winCreMon.reset();
     }
+    Pin::EventRecorder::getInstance().stop();
+    s_configWatcher.stop();
 
     SendMessage(wnd, WM_COMMAND, CM_REMOVEPINS, 0);
 
@@ -499,6 +557,108 @@ void MainWnd::initializeDpiSettings(HWND wnd, Options* opt) {
     app.pinShape.initImageForDpi(dpi);
 }
 
+void MainWnd::startEventRecording() {
+    // 录制文件与日志放在同一目录，按启动时间命名
+    std::wstring appDir = Foundation::FileUtils::getDirPath(Foundation::FileUtils::getModulePath(app.inst));
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    WCHAR name[64];
+    swprintf_s(name, L"log\\autopin_%04u%02u%02u_%02u%02u%02u.trace",
+        st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+    Pin::EventRecorder::getInstance().start(appDir + name);
+}
+
+void MainWnd::startConfigWatcher(HWND wnd, Options* opt) {
+    std::wstring iniPath = opt->getIniFilePath();
+    s_configFiles.add(iniPath);
+    s_configFiles.add(opt->getRulesFilePath());
+    s_configWatcher.start(Foundation::FileUtils::getDirPath(iniPath), [wnd] {
+        PostMessage(wnd, App::WM_CONFIGCHANGED, 0, 0);
+    });
+}
+
+// 重新加载外部修改的配置文件，只重新应用变化的设置，图钉和其他状态保持不变
+void MainWnd::reloadConfig(HWND wnd, WindowCreationMonitor& winCreMon, Options* opt) {
+    // 内容与程序自己写入的相同时不算变化
+    s_configFiles.expect(CONFIG_INI, opt->savedIniContent());
+    s_configFiles.expect(CONFIG_RULES, opt->savedRulesContent());
+    for (size_t id : s_configFiles.poll()) {
+        s_configChanged[id] = true;
+    }
+    if (!s_configChanged[CONFIG_INI] && !s_configChanged[CONFIG_RULES]) {
+        return;
+    }
+
+    // 选项对话框中可能有未应用的修改，关闭后再重新加载；
+    // 程序自己的设置尚未写完时也稍后重试
+    OptionsDelta delta;
+    if (app.optionsDlg || !opt->reload(s_configChanged[CONFIG_INI], s_configChanged[CONFIG_RULES], delta)) {
+        s_configDebounce.notify(Foundation::ChangeDebouncer::Clock::now());
+        SetTimer(wnd, App::TIMERID_CONFIGRELOAD, Constants::CONFIG_RELOAD_DELAY, nullptr);
+        return;
+    }
+    s_configChanged[CONFIG_INI] = s_configChanged[CONFIG_RULES] = false;
+    if (delta.empty()) {
+        return;
+    }
+
+    if (delta.language) {
+        if (opt->language.empty()) {
+            LANG_MGR.autoSelectLanguage();
+        } else {
+            LANG_MGR.setLanguage(opt->language);
+        }
+        app.trayIcon.setTip(app.trayIconTip().c_str());
+    }
+
+    if (delta.pinImage) {
+        updateTrayIcon();
+    }
+
+    if (delta.trackRate) {
+        EnumWindows(OptPins::resetPinTimersEnumProc, opt->trackRate.value);
+    }
+
+    if (delta.hotkeys) {
+        bool allKeysSet = true;
+        allKeysSet &= OptHotKeys::changeHotkey(wnd, opt->hotEnterPin, opt->hotkeysOn, delta.oldEnterPin, delta.oldHotkeysOn);
+        allKeysSet &= OptHotKeys::changeHotkey(wnd, opt->hotTogglePin, opt->hotkeysOn, delta.oldTogglePin, delta.oldHotkeysOn);
+        if (!allKeysSet) {
+            LOG_WARNING(L"重新加载配置后部分热键注册失败");
+        }
+    }
+
+    if (delta.autoPinFilter) {
+        winCreMon.setFilter(opt->autoPinFilter());
+    }
+
+    if (delta.autoPin) {
+        if (opt->autoPinOn != delta.oldAutoPinOn) {
+            if (!opt->autoPinOn) {
+                winCreMon.term();
+            } else if (!winCreMon.init(wnd, App::WM_QUEUEWINDOW)) {
+                LOG_WARNING(L"无法初始化窗口创建监控器，自动图钉功能将被禁用");
+                opt->autoPinOn = false;
+            }
+        }
+        if (opt->autoPinOn) {
+            SetTimer(wnd, App::TIMERID_AUTOPIN, opt->autoPinDelay.value, nullptr);
+        } else {
+            KillTimer(wnd, App::TIMERID_AUTOPIN);
+        }
+    }
+
+    if (delta.recordEvents) {
+        if (opt->recordEvents) {
+            startEventRecording();
+        } else {
+            Pin::EventRecorder::getInstance().stop();
+        }
+    }
+
+    // 规则变化已经通过autoPinRulesChanged()记录，下次检查时只重新编译变化的规则
+    LOG_EVENT(LogLevel::INFO, "已重新加载配置文件，变化的规则数: {}", delta.rulesChanged);
+}
 
 
 void MainWnd::handlePinStatus(LPARAM lparam) {
@@ -1,18 +1,38 @@
 #include "core/stdafx.h"
 #include "window/window_monitor.h"
+#include "pin/event_recorder.h"
+#include "system/logger.h"
 
 HWINEVENTHOOK EventHookWindowCreationMonitor::hook = nullptr;
+HWINEVENTHOOK EventHookWindowCreationMonitor::nameHook = nullptr;
 HWND EventHookWindowCreationMonitor::wnd = nullptr;
 int EventHookWindowCreationMonitor::msgId = 0;
 
+WindowCreationFilter EventHookWindowCreationMonitor::filter;
+WindowCreationStats EventHookWindowCreationMonitor::stats;
+std::vector<HWND> EventHookWindowCreationMonitor::batch;
+std::vector<HWND> EventHookWindowCreationMonitor::renamed;
+std::vector<std::pair<HWND, ULONGLONG>> EventHookWindowCreationMonitor::recent;
+bool EventHookWindowCreationMonitor::posted = false;
+
 bool EventHookWindowCreationMonitor::init(HWND wnd, int msgId)
 {
     if (!hook) {
-        hook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_CREATE, 
+        hook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_CREATE,
             nullptr, proc, 0, 0, WINEVENT_OUTOFCONTEXT);
         if (hook) {
             this->wnd = wnd;
             this->msgId = msgId;
+            batch.clear();
+            renamed.clear();
+            recent.clear();
+            posted = false;
+            stats = WindowCreationStats();
+
+            // 标题变化单独挂钩：CREATE到NAMECHANGE之间包含LOCATIONCHANGE等高频事件。
+            // 挂钩失败时只是失去标题跟踪，创建监控仍然可用。
+            nameHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+                nullptr, proc, 0, 0, WINEVENT_OUTOFCONTEXT);
         }
     }
     return hook != nullptr;
@@ -20,19 +40,163 @@ bool EventHookWindowCreationMonitor::init(HWND wnd, int msgId)
 
 bool EventHookWindowCreationMonitor::term()
 {
+    if (nameHook && UnhookWinEvent(nameHook)) {
+        nameHook = nullptr;
+    }
     if (hook && UnhookWinEvent(hook)) {
         hook = nullptr;
+        batch.clear();
+        renamed.clear();
+        recent.clear();
+        posted = false;
+        logStats();
     }
     return !hook;
 }
 
+void EventHookWindowCreationMonitor::setFilter(const WindowCreationFilter& newFilter)
+{
+    filter = newFilter;
+}
+
+void EventHookWindowCreationMonitor::takeBatch(std::vector<HWND>& created, std::vector<HWND>& renamedWnds)
+{
+    // 交换而不是复制，两组缓冲区的容量可以反复使用
+    created.clear();
+    created.swap(batch);
+    renamedWnds.clear();
+    renamedWnds.swap(renamed);
+    posted = false;
+}
+
+WindowCreationStats EventHookWindowCreationMonitor::getStats() const
+{
+    return stats;
+}
+
+void EventHookWindowCreationMonitor::logStats()
+{
+    if (!stats.received)
+        return;
+
+    LOG_EVENT(LogLevel::INFO, "窗口创建监控统计: 收到 {}，过滤 {}，重复 {}，入队 {}，批次 {}，标题变化 {}，发送失败 {}",
+        stats.received, stats.filtered, stats.duplicates, stats.queued, stats.batches, stats.titleChanges,
+        stats.postFailures);
+}
+
+bool EventHookWindowCreationMonitor::accept(HWND hwnd, DWORD eventThread)
+{
+    // 忽略本程序UI线程创建的窗口（图钉、对话框等）
+    if (eventThread == GetCurrentThreadId())
+        return false;
+
+    LONG_PTR style = GetWindowLongPtr(hwnd, GWL_STYLE);
+    if (filter.topLevelOnly) {
+        if (style & WS_CHILD)
+            return false;
+        // 顶级窗口的父窗口是桌面；仅消息窗口的父窗口是HWND_MESSAGE
+        if (GetAncestor(hwnd, GA_PARENT) != GetDesktopWindow())
+            return false;
+    }
+
+    if (filter.skipToolWindows && (GetWindowLongPtr(hwnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW))
+        return false;
+
+    if (!filter.processes.empty() && !processAllowed(hwnd))
+        return false;
+
+    return true;
+}
+
+bool EventHookWindowCreationMonitor::processAllowed(HWND hwnd)
+{
+    // 每个进程只查询一次映像路径
+    auto info = Platform::ProcessInfoCache::getInstance().lookupWindow(hwnd);
+    for (const auto& allowedName : filter.processes) {
+        if (_wcsicmp(info->imageName.c_str(), allowedName.c_str()) == 0)
+            return true;
+    }
+    return false;
+}
+
+void EventHookWindowCreationMonitor::postBatch()
+{
+    // 没有尚未取走的消息时才发送；
+    // 在客户端取走之前到达的窗口都合并到同一批次。
+    // 发送失败（如消息队列已满）时不标记，下一个事件到达时重新发送，批次不会被遗忘
+    if (posted)
+        return;
+    if (PostMessage(wnd, msgId, 0, 0)) {
+        posted = true;
+        ++stats.batches;
+    } else {
+        ++stats.postFailures;
+    }
+}
+
+void EventHookWindowCreationMonitor::pruneRecent(ULONGLONG now)
+{
+    // 按入队时间排序，过期的记录都在前面
+    size_t expired = 0;
+    while (expired < recent.size() && now - recent[expired].second >= filter.titleWatchPeriod)
+        ++expired;
+    if (expired)
+        recent.erase(recent.begin(), recent.begin() + expired);
+}
+
+bool EventHookWindowCreationMonitor::isRecent(HWND hwnd)
+{
+    pruneRecent(GetTickCount64());
+    for (const auto& entry : recent) {
+        if (entry.first == hwnd)
+            return true;
+    }
+    return false;
+}
+
 VOID CALLBACK EventHookWindowCreationMonitor::proc(HWINEVENTHOOK hook, DWORD event,
     HWND hwnd, LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime)
 {
-    if (hook == EventHookWindowCreationMonitor::hook &&
-        event == EVENT_OBJECT_CREATE &&
-        idObject == OBJID_WINDOW)
-    {
-        PostMessage(wnd, msgId, (WPARAM)hwnd, 0);
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || !hwnd)
+        return;
+
+    if (hook == EventHookWindowCreationMonitor::nameHook && event == EVENT_OBJECT_NAMECHANGE) {
+        // 只关心最近入队的窗口，其余窗口的标题变化（如浏览器标签页）直接忽略
+        if (!isRecent(hwnd))
+            return;
+        // 先录制再去重：已经入队的窗口的标题变化也要录制，回放时才能按最新的标题匹配规则
+        Pin::EventRecorder::getInstance().titleChanged(hwnd);
+        if (std::find(renamed.begin(), renamed.end(), hwnd) != renamed.end())
+            return;
+        // 同一批次中刚创建的窗口会在首次检查时读取当前标题
+        if (std::find(batch.begin(), batch.end(), hwnd) != batch.end())
+            return;
+        renamed.push_back(hwnd);
+        ++stats.titleChanges;
+        postBatch();
+        return;
+    }
+
+    if (hook != EventHookWindowCreationMonitor::hook || event != EVENT_OBJECT_CREATE)
+        return;
+
+    ++stats.received;
+
+    if (!accept(hwnd, dwEventThread)) {
+        ++stats.filtered;
+        return;
+    }
+
+    if (std::find(batch.begin(), batch.end(), hwnd) != batch.end()) {
+        ++stats.duplicates;
+        return;
     }
-}
\ No newline at end of file
+
+    ULONGLONG now = GetTickCount64();
+    pruneRecent(now);
+    batch.push_back(hwnd);
+    recent.emplace_back(hwnd, now);
+    ++stats.queued;
+    Pin::EventRecorder::getInstance().windowCreated(hwnd);
+    postBatch();
+}
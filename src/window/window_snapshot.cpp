@@ -0,0 +1,52 @@
+#include "core/stdafx.h"
+#include "window/window_snapshot.h"
+
+namespace Window {
+
+void WindowSnapshot::capture()
+{
+    m_items.clear();
+    m_text.clear();
+    // 预留典型桌面所需的空间，避免枚举过程中反复扩容
+    m_items.reserve(Constants::MEDIUM_BUFFER_SIZE);
+    m_text.reserve(Constants::MEDIUM_BUFFER_SIZE * 64);
+    EnumWindows(enumProc, reinterpret_cast<LPARAM>(this));
+}
+
+UINT32 WindowSnapshot::appendText(const wchar_t* s, int len)
+{
+    UINT32 offset = static_cast<UINT32>(m_text.size());
+    m_text.insert(m_text.end(), s, s + len);
+    return offset;
+}
+
+BOOL CALLBACK WindowSnapshot::enumProc(HWND wnd, LPARAM param)
+{
+    WindowSnapshot* self = reinterpret_cast<WindowSnapshot*>(param);
+
+    if (!IsWindowVisible(wnd) || (GetWindowLongPtr(wnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW))
+        return TRUE;
+
+    DWORD pid = 0;
+    GetWindowThreadProcessId(wnd, &pid);
+    if (pid == GetCurrentProcessId())
+        return TRUE;
+
+    WCHAR title[Constants::MAX_WINDOWTEXT_LEN];
+    WCHAR cls[Constants::MAX_CLASSNAME_LEN];
+    // 跨进程时GetWindowText直接读取系统保存的标题，不会因目标窗口无响应而阻塞
+    int titleLen = GetWindowTextW(wnd, title, Constants::MAX_WINDOWTEXT_LEN);
+    int clsLen = GetClassNameW(wnd, cls, Constants::MAX_CLASSNAME_LEN);
+
+    Item item;
+    item.wnd = wnd;
+    item.pid = pid;
+    item.titleLen = static_cast<UINT32>(titleLen > 0 ? titleLen : 0);
+    item.title = self->appendText(title, item.titleLen);
+    item.clsLen = static_cast<UINT32>(clsLen > 0 ? clsLen : 0);
+    item.cls = self->appendText(cls, item.clsLen);
+    self->m_items.push_back(item);
+    return TRUE;
+}
+
+} // namespace Window
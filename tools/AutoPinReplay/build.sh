@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建自动图钉事件回放工具（pin/auto_pin_queue.h、pin/pin_placement.h、options/rule_file.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o AutoPinReplay main.cpp
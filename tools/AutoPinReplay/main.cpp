@@ -0,0 +1,479 @@
+// AutoPinReplay：自动图钉事件回放工具。
+//
+// 读取 TinyPin 录制的轨迹文件（[Debug] RecordEvents=1），在模拟的窗口系统上
+// 用与程序相同的 Pin::AutoPinQueue 和规则匹配代码回放，按虚拟时钟运行，
+// 不依赖 Windows，可用于回归测试和定位 CPU 性能退化。
+//
+// 用法：
+//   AutoPinReplay <轨迹文件> [--ini TinyPin.ini] [--delay 毫秒] [--repeat N]
+//   AutoPinReplay --synth <输出轨迹文件> [窗口数]
+//
+
+#include "pin/auto_pin_queue.h"
+#include "pin/autopin_trace.h"
+#include "pin/pin_placement.h"
+#include "options/rule_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using Pin::Trace::Record;
+    using Pin::Trace::RecordType;
+
+    const uint64_t DEFAULT_DELAY = 200;  // 与 Constants::DEFAULT_AUTOPIN_DELAY 相同
+    const int PIN_WIDTH = 24;
+
+
+    // 与 Options 中 AutoPinRule 对应的规则字段
+    struct SimRule {
+        std::wstring ttl;
+        std::wstring cls;
+        std::wstring proc;
+        Pin::ProcessField procField = Pin::ProcessField::ImageName;
+        bool enabled = true;
+        std::shared_ptr<Pin::RuleStats> stats = std::make_shared<Pin::RuleStats>();
+    };
+
+    struct SimWindow {
+        std::wstring title;
+        std::wstring cls;
+        std::wstring imageName;
+        std::wstring imagePath;
+        std::wstring packageFamily;
+        uint64_t created = 0;
+        bool pinned = false;
+        Pin::CaptionPlacement pinPos{0, 0};
+    };
+
+
+    // 模拟的窗口系统：虚拟时钟，窗口属性来自轨迹文件，图钉只记录结果。
+    //
+    class SimHost {
+    public:
+        typedef uint64_t Handle;
+        typedef const SimWindow* ProcessRef;
+
+        uint64_t clock = 0;
+        std::unordered_map<uint64_t, SimWindow> windows;
+        std::vector<uint64_t> latencies;  // 窗口创建到创建图钉的虚拟时间
+        size_t pinCalls = 0;
+
+        uint64_t now() const { return clock; }
+        bool isWindow(Handle wnd) const { return windows.count(wnd) != 0; }
+        std::wstring title(Handle wnd) const { return windows.at(wnd).title; }
+        std::wstring className(Handle wnd) const { return windows.at(wnd).cls; }
+        ProcessRef process(Handle wnd) const { return &windows.at(wnd); }
+
+        static void fillProcess(Pin::RuleTarget& target, const ProcessRef& info)
+        {
+            if (info) {
+                target.imageName = info->imageName;
+                target.imagePath = info->imagePath;
+                target.packageFamily = info->packageFamily;
+            }
+        }
+
+        void pin(const std::vector<Handle>& targets, std::vector<char>& pinned)
+        {
+            ++pinCalls;
+            for (size_t n = 0; n < targets.size(); ++n) {
+                auto it = windows.find(targets[n]);
+                if (it == windows.end() || it->second.pinned)
+                    continue;
+                it->second.pinned = true;
+                pinned[n] = 1;
+                latencies.push_back(clock - it->second.created);
+            }
+        }
+    };
+
+
+    struct ReplayResult {
+        size_t created = 0;
+        size_t titleChanges = 0;
+        size_t tracked = 0;
+        size_t pinMoves = 0;
+        size_t pinCalls = 0;
+        std::vector<uint64_t> latencies;
+        uint64_t virtualTime = 0;
+    };
+
+
+    std::wstring fromUtf8(const std::string& s)
+    {
+        std::wstring out;
+        for (size_t i = 0; i < s.size(); ) {
+            unsigned char c = s[i];
+            uint32_t cp;
+            int extra;
+            if (c < 0x80) { cp = c; extra = 0; }
+            else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+            else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+            else { cp = c & 0x07; extra = 3; }
+            ++i;
+            for (int n = 0; n < extra && i < s.size(); ++n, ++i)
+                cp = (cp << 6) | (static_cast<unsigned char>(s[i]) & 0x3F);
+            if (sizeof(wchar_t) == 2 && cp > 0xFFFF) {
+                cp -= 0x10000;
+                out.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+                out.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+            }
+            else {
+                out.push_back(static_cast<wchar_t>(cp));
+            }
+        }
+        return out;
+    }
+
+    bool readFile(const char* path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // 从规则文件（TinyPin.rules）读取规则
+    bool loadRuleFile(const std::string& path, std::vector<SimRule>& rules)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<RuleFile::Record> records;
+        RuleFile::parse(fromUtf8(content), records);
+        for (const auto& rec : records) {
+            SimRule rule;
+            rule.ttl = rec.title;
+            rule.cls = rec.cls;
+            rule.proc = rec.process;
+            if (rec.processField >= 0 && rec.processField <= 2)
+                rule.procField = static_cast<Pin::ProcessField>(rec.processField);
+            rule.enabled = rec.enabled;
+            rules.push_back(rule);
+        }
+        return true;
+    }
+
+    // 从 TinyPin.ini 读取自动图钉延迟，规则从同目录的 TinyPin.rules 读取；
+    // 没有规则文件时读取旧格式的 [AutoPinRuleN] 部分
+    bool loadIni(const char* path, std::vector<SimRule>& rules, uint64_t& delay)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        std::unordered_map<std::string, std::unordered_map<std::string, std::string>> sections;
+        std::string line, section;
+        while (std::getline(file, line)) {
+            if (line.size() >= 3 && line.compare(0, 3, "\xEF\xBB\xBF") == 0)
+                line.erase(0, 3);
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+                line.pop_back();
+            if (line.empty() || line[0] == ';')
+                continue;
+            if (line[0] == '[') {
+                section = line.substr(1, line.find(']') - 1);
+                continue;
+            }
+            size_t eq = line.find('=');
+            if (eq != std::string::npos)
+                sections[section][line.substr(0, eq)] = line.substr(eq + 1);
+        }
+
+        auto& autoPin = sections["AutoPin"];
+        if (!autoPin["Delay"].empty())
+            delay = std::strtoull(autoPin["Delay"].c_str(), nullptr, 10);
+
+        std::string rulesPath = path;
+        size_t dot = rulesPath.rfind('.');
+        if (dot != std::string::npos && rulesPath.find_first_of("/\\", dot) == std::string::npos)
+            rulesPath.erase(dot);
+        if (loadRuleFile(rulesPath + ".rules", rules))
+            return true;
+
+        int count = std::atoi(autoPin["RuleCount"].c_str());
+        for (int n = 0; n < count; ++n) {
+            auto it = sections.find("AutoPinRule" + std::to_string(n));
+            if (it == sections.end())
+                continue;
+            auto& values = it->second;
+            SimRule rule;
+            rule.ttl = fromUtf8(values["Title"]);
+            rule.cls = fromUtf8(values["Class"]);
+            rule.proc = fromUtf8(values["Process"]);
+            int field = std::atoi(values["ProcessField"].c_str());
+            if (field >= 0 && field <= 2)
+                rule.procField = static_cast<Pin::ProcessField>(field);
+            rule.enabled = values["Enabled"].empty() || std::atoi(values["Enabled"].c_str()) != 0;
+            rules.push_back(rule);
+        }
+        return true;
+    }
+
+    // 回放一遍轨迹。定时器按自动图钉延迟触发，与主窗口的 TIMERID_AUTOPIN 相同。
+    ReplayResult replay(const std::vector<Record>& records, const std::vector<SimRule>& rules, uint64_t delay)
+    {
+        SimHost host;
+        Pin::AutoPinQueue<SimHost> queue(host);
+        queue.timing.delay = delay;
+        queue.setProfiling(true);   // 最后输出每条规则的统计
+        queue.setRules(rules.begin(), rules.end());
+
+        ReplayResult result;
+        uint64_t nextTick = delay;
+        auto runTimer = [&](uint64_t until) {
+            while (nextTick <= until) {
+                host.clock = nextTick;
+                queue.check();
+                nextTick += delay;
+            }
+        };
+
+        for (const Record& rec : records) {
+            runTimer(rec.time);
+            host.clock = rec.time;
+
+            switch (rec.type) {
+                case RecordType::WindowCreated: {
+                    SimWindow& wnd = host.windows[rec.wnd];
+                    wnd = SimWindow();
+                    wnd.title = rec.title;
+                    wnd.cls = rec.cls;
+                    wnd.imageName = rec.imageName;
+                    wnd.imagePath = rec.imagePath;
+                    wnd.packageFamily = rec.packageFamily;
+                    wnd.created = rec.time;
+                    queue.add(rec.wnd);
+                    ++result.created;
+                    break;
+                }
+                case RecordType::TitleChanged: {
+                    auto it = host.windows.find(rec.wnd);
+                    if (it == host.windows.end())
+                        break;
+                    it->second.title = rec.title;
+                    queue.titleChanged(std::vector<uint64_t>(1, rec.wnd));
+                    ++result.titleChanges;
+                    break;
+                }
+                case RecordType::PinTracked: {
+                    // 模拟图钉引擎的跟踪：按与图钉窗口相同的公式重新计算图钉位置
+                    ++result.tracked;
+                    auto it = host.windows.find(rec.wnd);
+                    bool modern = it != host.windows.end() && !it->second.packageFamily.empty();
+                    Pin::CaptionPlacement pos = Pin::placeOnCaption(rec.left, rec.top, rec.right, PIN_WIDTH, modern);
+                    if (it != host.windows.end()) {
+                        if (pos.x != it->second.pinPos.x || pos.y != it->second.pinPos.y)
+                            ++result.pinMoves;
+                        it->second.pinPos = pos;
+                    }
+                    break;
+                }
+            }
+        }
+
+        // 继续运行定时器直到队列清空（最多一个跟踪时长）
+        uint64_t end = host.clock + queue.timing.watchPeriod + delay;
+        while (queue.size() && nextTick <= end)
+            runTimer(nextTick);
+
+        result.pinCalls = host.pinCalls;
+        result.latencies = host.latencies;
+        result.virtualTime = host.clock;
+        return result;
+    }
+
+    // 生成合成轨迹：普通窗口、创建后才设置标题的窗口、打包应用窗口和跟踪移动混合
+    bool synthesize(const char* path, size_t count)
+    {
+        Pin::Trace::Writer writer;
+        writer.writeHeader();
+
+        uint64_t time = 0;
+        uint32_t seed = 12345;
+        auto rnd = [&seed](uint32_t range) {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) % range;
+        };
+
+        for (size_t n = 0; n < count; ++n) {
+            time += 5 + rnd(50);
+            Record rec;
+            rec.type = RecordType::WindowCreated;
+            rec.time = time;
+            rec.wnd = 0x10000 + n * 4;
+            rec.pid = 1000 + rnd(20);
+            uint32_t kind = rnd(4);
+            rec.cls = kind == 3 ? L"ApplicationFrameWindow" : L"Notepad";
+            rec.title = kind == 1 ? L"" : L"文档 " + std::to_wstring(n) + L" - 记事本";
+            rec.imageName = kind == 3 ? L"applicationframehost.exe" : L"notepad.exe";
+            rec.imagePath = L"c:\\windows\\system32\\" + rec.imageName;
+            if (kind == 3)
+                rec.packageFamily = L"microsoft.windowscalculator_8wekyb3d8bbwe";
+            writer.write(rec);
+
+            if (kind == 1) {
+                Record title;
+                title.type = RecordType::TitleChanged;
+                title.time = time + 100 + rnd(400);
+                title.wnd = rec.wnd;
+                title.title = L"文档 " + std::to_wstring(n) + L" - 记事本";
+                writer.write(title);
+                time = title.time;
+            }
+
+            for (uint32_t move = rnd(5); move > 0; --move) {
+                Record track;
+                track.type = RecordType::PinTracked;
+                track.time = time + 20;
+                track.wnd = rec.wnd;
+                track.left = int32_t(rnd(1600)) - 100;
+                track.top = int32_t(rnd(900));
+                track.right = track.left + 400 + int32_t(rnd(800));
+                track.bottom = track.top + 300;
+                writer.write(track);
+                time = track.time;
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        const auto& buf = writer.buffer();
+        file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+        return bool(file);
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: AutoPinReplay <trace> [--ini TinyPin.ini] [--delay ms] [--repeat N]\n"
+            "       AutoPinReplay --synth <trace> [windows]\n");
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+
+    if (std::strcmp(argv[1], "--synth") == 0) {
+        if (argc < 3) {
+            usage();
+            return 2;
+        }
+        size_t count = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000;
+        if (!synthesize(argv[2], count)) {
+            std::fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+
+    const char* tracePath = argv[1];
+    const char* iniPath = nullptr;
+    long long delayArg = -1;
+    int repeat = 1;
+    for (int n = 2; n < argc; ++n) {
+        if (std::strcmp(argv[n], "--ini") == 0 && n + 1 < argc)
+            iniPath = argv[++n];
+        else if (std::strcmp(argv[n], "--delay") == 0 && n + 1 < argc)
+            delayArg = std::atoll(argv[++n]);
+        else if (std::strcmp(argv[n], "--repeat") == 0 && n + 1 < argc)
+            repeat = (std::max)(1, std::atoi(argv[++n]));
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(tracePath, data)) {
+        std::fprintf(stderr, "cannot read %s\n", tracePath);
+        return 1;
+    }
+    Pin::Trace::Reader reader(data.data(), data.size());
+    if (!reader.readHeader()) {
+        std::fprintf(stderr, "%s: not a TinyPin trace file\n", tracePath);
+        return 1;
+    }
+    std::vector<Record> records;
+    Record rec;
+    while (reader.next(rec))
+        records.push_back(rec);
+    if (reader.corrupt())
+        std::fprintf(stderr, "warning: trace truncated after %zu records\n", records.size());
+
+    std::vector<SimRule> rules;
+    uint64_t delay = DEFAULT_DELAY;
+    if (iniPath) {
+        if (!loadIni(iniPath, rules, delay)) {
+            std::fprintf(stderr, "cannot read %s\n", iniPath);
+            return 1;
+        }
+    }
+    else {
+        // 没有配置文件时所有窗口都匹配，用于测量队列和跟踪本身的开销
+        SimRule all;
+        all.ttl = L"*";
+        all.cls = L"*";
+        rules.push_back(all);
+    }
+    if (delayArg > 0)
+        delay = static_cast<uint64_t>(delayArg);
+
+    ReplayResult result;
+    std::clock_t cpuStart = std::clock();
+    auto wallStart = std::chrono::steady_clock::now();
+    for (int n = 0; n < repeat; ++n)
+        result = replay(records, rules, delay);
+    double cpuMs = double(std::clock() - cpuStart) * 1000.0 / CLOCKS_PER_SEC;
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::vector<uint64_t> lat = result.latencies;
+    std::sort(lat.begin(), lat.end());
+    uint64_t sum = 0;
+    for (uint64_t v : lat)
+        sum += v;
+
+    std::printf("records        %zu\n", records.size());
+    std::printf("rules          %zu\n", rules.size());
+    std::printf("windows        %zu\n", result.created);
+    std::printf("title changes  %zu\n", result.titleChanges);
+    std::printf("tracking       %zu (pin moves %zu)\n", result.tracked, result.pinMoves);
+    std::printf("pinned         %zu in %zu batches\n", lat.size(), result.pinCalls);
+    if (!lat.empty()) {
+        std::printf("pin latency    min %llu / avg %llu / p95 %llu / max %llu ms\n",
+            (unsigned long long)lat.front(), (unsigned long long)(sum / lat.size()),
+            (unsigned long long)lat[lat.size() * 95 / 100], (unsigned long long)lat.back());
+    }
+    std::printf("virtual time   %.1f s\n", result.virtualTime / 1000.0);
+    std::printf("replay         %d x, cpu %.2f ms, wall %.2f ms, %.2f ms/pass\n",
+        repeat, cpuMs, wallMs, wallMs / repeat);
+
+    // 规则统计（所有回放次数累计）
+    std::printf("\n%-5s %12s %10s %10s %8s %12s\n", "rule", "evaluations", "matches", "pins", "failed", "time(us)");
+    for (size_t n = 0; n < rules.size(); ++n) {
+        const Pin::RuleStats& stats = *rules[n].stats;
+        std::printf("%-5zu %12llu %10llu %10llu %8llu %12.1f\n", n,
+            (unsigned long long)stats.evaluations.load(), (unsigned long long)stats.matches.load(),
+            (unsigned long long)stats.pinsCreated.load(), (unsigned long long)stats.pinsFailed.load(),
+            stats.matchTime.load() / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建配置文件热重载测试（文件变化检测、options/options_delta.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -pthread -I../../include -o ConfigWatchTest main.cpp
@@ -0,0 +1,389 @@
+// ConfigWatchTest：配置文件热重载的测试。
+//
+// 测试 Foundation::ChangeDebouncer 合并连续通知的逻辑、
+// Foundation::FileChangeDetector 排除程序自己写入的逻辑，
+// Foundation::FileWatcher 接口（用一个定时轮询的实现代替 Windows 的目录通知），
+// 以及 Options::reload() 中设置和规则的比较（options/options_delta.h）。
+// 在临时目录中读写文件。
+//
+// 用法：
+//   ConfigWatchTest
+//
+
+#include "foundation/file_change_detector.h"
+#include "foundation/file_watcher.h"
+#include "options/options_delta.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Foundation::ChangeDebouncer;
+    using Foundation::FileChangeDetector;
+    namespace fs = std::filesystem;
+    typedef std::chrono::milliseconds ms;
+
+    int g_failed = 0;
+
+    void check(bool ok, const char* what)
+    {
+        if (!ok) {
+            std::printf("FAIL: %s\n", what);
+            ++g_failed;
+        }
+    }
+
+    void writeFile(const fs::path& path, const std::string& content)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+
+    // 定时比较目录中文件状态的 FileWatcher 实现，代替 Platform::DirectoryWatcher
+    class PollingWatcher : public Foundation::FileWatcher {
+    public:
+        ~PollingWatcher() { stop(); }
+
+        bool start(const std::wstring& dir, Callback onChange) override
+        {
+            stop();
+            std::error_code ec;
+            if (!fs::is_directory(dir, ec))
+                return false;
+            m_stop = false;
+            m_thread = std::thread([this, dir, onChange] {
+                std::vector<std::pair<fs::path, fs::file_time_type>> last = scan(dir);
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!m_wake.wait_for(lock, ms(10), [this] { return m_stop; })) {
+                    auto now = scan(dir);
+                    if (now != last) {
+                        last = std::move(now);
+                        onChange();
+                    }
+                }
+            });
+            return true;
+        }
+
+        void stop() override
+        {
+            if (!m_thread.joinable())
+                return;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_one();
+            m_thread.join();
+        }
+
+    private:
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stop = false;
+
+        static std::vector<std::pair<fs::path, fs::file_time_type>> scan(const std::wstring& dir)
+        {
+            std::vector<std::pair<fs::path, fs::file_time_type>> files;
+            std::error_code ec;
+            for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                std::error_code timeError;
+                files.emplace_back(it->path(), it->last_write_time(timeError));
+            }
+            std::sort(files.begin(), files.end());
+            return files;
+        }
+    };
+
+
+    void testDebounce()
+    {
+        ChangeDebouncer debounce(ms(300));
+        ChangeDebouncer::Clock::time_point t0{};
+
+        check(!debounce.pending(), "debounce: idle at start");
+        check(!debounce.take(t0), "debounce: nothing to take at start");
+        check(debounce.remaining(t0) == ms(0), "debounce: no wait at start");
+
+        // 第一次通知需要启动定时器，之后的通知只推迟到期时间
+        check(debounce.notify(t0), "debounce: first notify starts the timer");
+        check(!debounce.notify(t0 + ms(100)), "debounce: second notify reuses the timer");
+        check(!debounce.notify(t0 + ms(250)), "debounce: third notify reuses the timer");
+
+        // 定时器在第一次通知后300ms到期，此时距离最后一次通知只有50ms
+        check(!debounce.take(t0 + ms(300)), "debounce: not due 50ms after the last notify");
+        check(debounce.pending(), "debounce: still pending before due");
+        check(debounce.remaining(t0 + ms(300)) == ms(250), "debounce: remaining wait");
+        check(debounce.remaining(t0 + ms(300) + std::chrono::microseconds(500)) == ms(250),
+              "debounce: remaining wait rounds up");
+
+        check(debounce.take(t0 + ms(550)), "debounce: due 300ms after the last notify");
+        check(!debounce.pending(), "debounce: idle after take");
+        check(!debounce.take(t0 + ms(600)), "debounce: taken only once");
+
+        // 之后的通知重新开始
+        check(debounce.notify(t0 + ms(1000)), "debounce: notify after take starts a new timer");
+        check(debounce.take(t0 + ms(1300)), "debounce: new notify due after the delay");
+    }
+
+    void testOwnWrites(const fs::path& dir)
+    {
+        fs::path ini = dir / "TinyPin.ini";
+        fs::path rules = dir / "TinyPin.rules";
+        writeFile(ini, "[Settings]\nLanguage=\n");
+
+        FileChangeDetector detector;
+        size_t iniId = detector.add(ini);
+        size_t rulesId = detector.add(rules);
+        check(detector.poll().empty(), "detector: no change right after add");
+
+        // 程序自己写入：内容与记录的相同，不报告
+        std::string own = "[Settings]\nLanguage=zh_CN\n";
+        detector.expect(iniId, own);
+        writeFile(ini, own);
+        check(detector.poll().empty(), "detector: own write is ignored");
+
+        // 外部修改：大小不同
+        writeFile(ini, "[Settings]\nLanguage=en_US;\n");
+        auto changed = detector.poll();
+        check(changed.size() == 1 && changed[0] == iniId, "detector: external edit with a different size");
+
+        // 外部修改：大小相同、内容不同（需要比较内容）
+        writeFile(ini, "[Settings]\nLanguage=en_GB\n");
+        std::this_thread::sleep_for(ms(20));
+        writeFile(ini, "[Settings]\nLanguage=en_US\n");
+        changed = detector.poll();
+        check(changed.size() == 1 && changed[0] == iniId, "detector: external edit with the same size");
+
+        // 外部写入恰好与程序写入的内容相同，同样不需要重新加载
+        writeFile(ini, own);
+        check(detector.poll().empty(), "detector: external write equal to own content");
+
+        // 不确定内容（例如写入失败）时每次变化都报告
+        detector.expect(iniId, std::string());
+        writeFile(ini, "[Settings]\nLanguage=\n");
+        changed = detector.poll();
+        check(changed.size() == 1 && changed[0] == iniId, "detector: no expected content reports every change");
+
+        // 创建和删除
+        detector.expect(rulesId, "# rules\n");
+        writeFile(rules, "# rules\nrule\n");
+        changed = detector.poll();
+        check(changed.size() == 1 && changed[0] == rulesId, "detector: created file");
+        fs::remove(rules);
+        changed = detector.poll();
+        check(changed.size() == 1 && changed[0] == rulesId, "detector: deleted file");
+        check(detector.poll().empty(), "detector: change reported once");
+    }
+
+    // 模拟主窗口：监视线程的通知交给消息循环，合并后检测文件变化
+    void testWatcher(const fs::path& dir)
+    {
+        fs::path ini = dir / "TinyPin.ini";
+        writeFile(ini, "a\n");
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        int notifications = 0;
+
+        PollingWatcher watcher;
+        Foundation::FileWatcher& base = watcher;
+        check(base.start(dir.wstring(), [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++notifications;
+            cv.notify_one();
+        }), "watcher: start");
+
+        FileChangeDetector detector;
+        size_t iniId = detector.add(ini);
+        ChangeDebouncer debounce(ms(50));
+
+        // 分三次写入，最后一次写入之后才重新加载一次
+        writeFile(ini, "ab\n");
+        std::this_thread::sleep_for(ms(20));
+        writeFile(ini, "abc\n");
+        std::this_thread::sleep_for(ms(20));
+        writeFile(ini, "abcd\n");
+
+        int reloads = 0;
+        auto deadline = ChangeDebouncer::Clock::now() + ms(2000);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (ChangeDebouncer::Clock::now() < deadline && reloads == 0) {
+            int seen = notifications;
+            cv.wait_for(lock, ms(10));
+            auto now = ChangeDebouncer::Clock::now();
+            if (notifications != seen)
+                debounce.notify(now);
+            if (debounce.take(now)) {
+                auto changed = detector.poll();
+                check(changed.size() == 1 && changed[0] == iniId, "watcher: ini reported as changed");
+                ++reloads;
+            }
+        }
+        lock.unlock();
+        base.stop();
+
+        check(reloads == 1, "watcher: one reload after the burst of writes");
+        check(notifications >= 1, "watcher: callback invoked");
+    }
+
+    // 与 Options 构造时的默认设置相同（热键为 Ctrl+F11 和 Ctrl+F12）
+    OptionsReload::Settings defaultSettings()
+    {
+        OptionsReload::Settings settings;
+        settings.pinImagePath = L"assets\\images\\TinyPin.png";
+        settings.trackRate = { 20, 10, 1000 };
+        settings.hotkeysOn = true;
+        settings.hotEnterPin = { 0x7A, 0x0002 };
+        settings.hotTogglePin = { 0x7B, 0x0002 };
+        settings.autoPinDelay = { 200, 100, 10000 };
+        return settings;
+    }
+
+    // 按 Options::reloadIni() 的做法：从默认值开始读取文件，与当前设置比较
+    OptionsReload::Changes reloadSettings(OptionsReload::Settings& current, const std::wstring& text)
+    {
+        Foundation::IniDocument ini;
+        ini.parse(text);
+        OptionsReload::Settings fresh = defaultSettings();
+        OptionsReload::readSettings(ini, fresh);
+        OptionsReload::Changes changes;
+        OptionsReload::compare(current, fresh, changes);
+        current = fresh;
+        return changes;
+    }
+
+    void testSettingsDelta()
+    {
+        const std::wstring base =
+            L"[Settings]\nLanguage=zh_CN\n"
+            L"[Pins]\nTrackRate=50\n"
+            L"[Hotkeys]\nEnabled=1\nEnterPin_VK=122\nEnterPin_MOD=2\n"
+            L"[AutoPin]\nEnabled=1\nDelay=300\nProcessFilter=notepad.exe; Code.exe \n";
+
+        OptionsReload::Settings current = defaultSettings();
+        OptionsReload::Changes changes = reloadSettings(current, base);
+        check(changes.language && changes.trackRate && changes.autoPin && changes.autoPinFilter,
+              "settings: changes from the defaults");
+        check(!changes.hotkeys && !changes.pinImage && !changes.recordEvents,
+              "settings: values equal to the defaults are not changes");
+        check(current.autoPinProcesses == std::vector<std::wstring>{ L"notepad.exe", L"Code.exe" },
+              "settings: allowlist split and trimmed");
+
+        check(reloadSettings(current, base).empty(), "settings: same file has no changes");
+
+        // 只修改白名单
+        changes = reloadSettings(current, L"[Settings]\nLanguage=zh_CN\n"
+            L"[Pins]\nTrackRate=50\n"
+            L"[AutoPin]\nEnabled=1\nDelay=300\nProcessFilter=notepad.exe;;chrome.exe\n");
+        check(changes.autoPinFilter && !changes.autoPin && !changes.language && !changes.trackRate,
+              "settings: changed allowlist only");
+        check(current.autoPinProcesses == std::vector<std::wstring>{ L"notepad.exe", L"chrome.exe" },
+              "settings: empty allowlist entries skipped");
+
+        changes = reloadSettings(current, L"[Settings]\nLanguage=zh_CN\n"
+            L"[Pins]\nTrackRate=50\n"
+            L"[AutoPin]\nEnabled=1\nDelay=300\n");
+        check(changes.autoPinFilter && current.autoPinProcesses.empty(), "settings: removed allowlist");
+
+        // 超出范围的值被忽略，删除的设置恢复为默认值
+        changes = reloadSettings(current, L"[Pins]\nTrackRate=5\n[AutoPin]\nDelay=300\nEnabled=1\n");
+        check(changes.language && changes.trackRate && current.trackRate.value == 20,
+              "settings: out of range and removed values use the defaults");
+
+        // 热键
+        changes = reloadSettings(current, L"[Pins]\nTrackRate=5\n[AutoPin]\nDelay=300\nEnabled=1\n"
+            L"[Hotkeys]\nTogglePin_VK=0\nTogglePin_MOD=4\n");
+        check(changes.hotkeys && current.hotTogglePin.vk == 0 && current.hotTogglePin.mod == 0,
+              "settings: hotkey without a key clears the modifiers");
+    }
+
+    std::vector<std::wstring> lines(std::initializer_list<const wchar_t*> items)
+    {
+        return std::vector<std::wstring>(items.begin(), items.end());
+    }
+
+    void testRuleLinesDiff()
+    {
+        using OptionsReload::RuleLinesDiff;
+        using OptionsReload::diffRuleLines;
+        const size_t NEW = RuleLinesDiff::NEW_LINE;
+        const std::vector<std::wstring> base = lines({ L"a", L"b", L"c", L"d", L"e" });
+
+        RuleLinesDiff diff = diffRuleLines(base, base);
+        check(diff.changed() == 0 && diff.previous == std::vector<size_t>{ 0, 1, 2, 3, 4 }, "rules: unchanged");
+
+        // 调整顺序：把一条规则移到最前面只移动了一条
+        diff = diffRuleLines(base, lines({ L"d", L"a", L"b", L"c", L"e" }));
+        check(diff.moved == 1 && diff.added == 0 && diff.removed == 0, "rules: one rule moved to the front");
+        check(diff.previous == std::vector<size_t>{ 3, 0, 1, 2, 4 }, "rules: moved rule keeps its object");
+
+        diff = diffRuleLines(base, lines({ L"b", L"a", L"d", L"c", L"e" }));
+        check(diff.moved == 2 && diff.changed() == 2, "rules: two swapped pairs");
+
+        diff = diffRuleLines(base, lines({ L"e", L"d", L"c", L"b", L"a" }));
+        check(diff.moved == 4, "rules: reversed list");
+
+        // 新增和删除
+        diff = diffRuleLines(base, lines({ L"a", L"b", L"x", L"c", L"d", L"e", L"y" }));
+        check(diff.added == 2 && diff.removed == 0 && diff.moved == 0, "rules: added rules");
+        check(diff.previous == std::vector<size_t>{ 0, 1, NEW, 2, 3, 4, NEW }, "rules: added rules are new");
+
+        diff = diffRuleLines(base, lines({ L"a", L"c", L"e" }));
+        check(diff.removed == 2 && diff.added == 0 && diff.moved == 0, "rules: removed rules");
+
+        // 修改一条规则：删除旧行并新增一行
+        diff = diffRuleLines(base, lines({ L"a", L"b", L"C", L"d", L"e" }));
+        check(diff.added == 1 && diff.removed == 1 && diff.changed() == 2, "rules: edited rule");
+
+        diff = diffRuleLines(base, lines({ L"x", L"e", L"a", L"c" }));
+        check(diff.added == 1 && diff.removed == 2 && diff.moved == 1, "rules: added, removed and moved");
+
+        // 重复的行按出现顺序对应，不算作移动
+        diff = diffRuleLines(lines({ L"a", L"b", L"a", L"b" }), lines({ L"a", L"b", L"a", L"b" }));
+        check(diff.changed() == 0 && diff.previous == std::vector<size_t>{ 0, 1, 2, 3 }, "rules: duplicate lines");
+        diff = diffRuleLines(lines({ L"a", L"b", L"a" }), lines({ L"a", L"a" }));
+        check(diff.removed == 1 && diff.moved == 0 && diff.previous == std::vector<size_t>{ 0, 2 },
+              "rules: removed line between duplicates");
+
+        diff = diffRuleLines(std::vector<std::wstring>(), base);
+        check(diff.added == base.size() && diff.changed() == base.size(), "rules: all new");
+        diff = diffRuleLines(base, std::vector<std::wstring>());
+        check(diff.removed == base.size() && diff.previous.empty(), "rules: all removed");
+    }
+
+} // namespace
+
+int main()
+{
+    std::error_code ec;
+    fs::path dir = fs::temp_directory_path(ec) / ("ConfigWatchTest." + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    if (ec || !fs::create_directories(dir, ec)) {
+        std::printf("无法创建临时目录\n");
+        return 2;
+    }
+
+    testDebounce();
+    testOwnWrites(dir);
+    testWatcher(dir);
+    testSettingsDelta();
+    testRuleLinesDiff();
+
+    fs::remove_all(dir, ec);
+    if (g_failed) {
+        std::printf("%d check(s) failed\n", g_failed);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
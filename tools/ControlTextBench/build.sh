@@ -0,0 +1,7 @@
+#!/bin/sh
+# 构建控件文本基准（system/control_text_table.h）
+# 控件映射表从 src/system/language_manager.cpp 中提取，与程序使用的相同
+set -e
+cd "$(dirname "$0")"
+sed -n 's/.*m_controlMappings\[.*\] = \({.*}\);.*/\1,/p' ../../src/system/language_manager.cpp > mappings.inc
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o ControlTextBench main.cpp
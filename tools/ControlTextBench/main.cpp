@@ -0,0 +1,312 @@
+// ControlTextBench：对话框本地化中控件文本查找的测试与基准。
+//
+// 用程序中的控件映射表（构建时从 language_manager.cpp 提取）和语言文件编译出的字符串表，
+// 模拟 localizeDialog / localizeMenu 对每个对话框（标题、全部子控件和没有映射的控件）取一次文本，比较：
+//   旧的做法：按控件ID查哈希表，拼接 "dialogs." + 对话框 + "." + 元素，在字符串表中查找，复制结果
+//   现在的做法：ControlTextTable（include/system/control_text_table.h）按控件ID和对话框编号取已解析的视图
+// 并检查两者的文本相同。不包括 SetWindowText 和英文回退文本。
+//
+// 用法：
+//   ControlTextBench [语言文件]      默认为 ../../assets/locales/en_US.json
+//
+
+#include "core/common.h"
+#include "resource.h"
+#include "system/control_text_table.h"
+#include "system/locale_blob.h"
+#include "system/locale_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+// Windows 中的标准按钮ID
+#ifndef IDOK
+#define IDOK 1
+#define IDCANCEL 2
+#endif
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    const ControlMapping MAPPINGS[] = {
+#include "mappings.inc"
+    };
+
+    // 编译后的字符串表。Linux 上字符串表使用 UTF-16（char16_t），查找和取出时转换
+    class Strings {
+    public:
+        bool load(const std::string& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::string pool;
+            std::string error;
+            if (LocaleParser::flatten(data.data(), data.size(), pool, error) < 0)
+                return false;
+            LocaleBlob::Builder builder;
+            std::wstring wide = Foundation::Json::toWide(pool);
+            LocaleParser::split(std::wstring_view(wide), [&](std::wstring_view key, std::wstring_view value) {
+                builder.add(key, value);
+            });
+            m_blob = builder.build(0, 0);
+            return m_view.open(m_blob.data(), m_blob.size());
+        }
+
+        bool find(const std::wstring& key, std::wstring& value) const
+        {
+            m_key.clear();
+            LocaleBlob::detail::append(m_key, key);
+            LocaleBlob::StringView text;
+            if (!m_view.find(m_key, text))
+                return false;
+            value.assign(text.begin(), text.end());
+            return true;
+        }
+
+    private:
+        std::vector<char> m_blob;
+        LocaleBlob::View m_view;
+        mutable std::basic_string<LocaleBlob::Char> m_key;
+    };
+
+    // 旧的 LanguageManager::getControlText（没有英文回退）
+    class OldLookup {
+    public:
+        explicit OldLookup(const Strings& strings) : m_strings(strings)
+        {
+            for (const auto& mapping : MAPPINGS)
+                m_controlMappings[mapping.controlId] = mapping;
+        }
+
+        std::wstring getControlText(int controlId, const std::wstring& dialogName) const
+        {
+            auto it = m_controlMappings.find(controlId);
+            if (it != m_controlMappings.end()) {
+                const ControlMapping* mapping = &it->second;
+                std::wstring targetDialog = dialogName.empty() ? mapping->dialogName : dialogName;
+                std::wstring key;
+                if (targetDialog == L"tray")
+                    key = L"tray." + mapping->elementName;
+                else if (targetDialog == L"strings")
+                    key = L"strings." + mapping->elementName;
+                else
+                    key = L"dialogs." + targetDialog + L"." + mapping->elementName;
+
+                std::wstring value;
+                if (m_strings.find(key, value))
+                    return value;
+            }
+            return L"";
+        }
+
+    private:
+        const Strings& m_strings;
+        std::unordered_map<int, ControlMapping> m_controlMappings;
+    };
+
+    // 现在的 LanguageManager::controlText（没有英文回退）
+    class NewLookup {
+    public:
+        explicit NewLookup(const Strings& strings) : m_strings(strings)
+        {
+            for (const auto& mapping : MAPPINGS)
+                m_controlMappings[mapping.controlId] = mapping;
+            m_table.build(m_controlMappings);
+        }
+
+        int dialogIndex(const std::wstring& dialogName) { return m_table.dialogIndex(dialogName); }
+
+        std::wstring_view controlText(int controlId, int dialog)
+        {
+            return m_table.text(controlId, dialog, [this](int slot, int target) -> std::wstring_view {
+                std::wstring value;
+                if (!m_strings.find(m_table.textKey(slot, target), value))
+                    return std::wstring_view(L"");
+                m_texts.push_back(std::move(value));
+                return m_texts.back();
+            });
+        }
+
+        // 切换语言
+        void reset()
+        {
+            m_table.reset();
+            m_texts.clear();
+        }
+
+        const ControlTextTable& table() const { return m_table; }
+
+    private:
+        const Strings& m_strings;
+        std::unordered_map<int, ControlMapping> m_controlMappings;
+        ControlTextTable m_table;
+        std::deque<std::wstring> m_texts;
+    };
+
+    // 一个对话框或菜单：名称和 localizeDialog 依次取文本的控件ID
+    struct Dialog {
+        std::wstring name;
+        std::vector<int> controls;
+    };
+
+    std::vector<Dialog> makeDialogs()
+    {
+        std::vector<Dialog> dialogs;
+        for (const auto& mapping : MAPPINGS) {
+            if (mapping.dialogName.empty() || mapping.dialogName == L"strings")
+                continue;
+            auto it = std::find_if(dialogs.begin(), dialogs.end(),
+                [&](const Dialog& d) { return d.name == mapping.dialogName; });
+            if (it == dialogs.end()) {
+                // 标题使用ID 0；对话框还有没有映射的静态文本（IDC_STATIC 为 -1）和其他控件
+                Dialog dialog{ mapping.dialogName, { 0 } };
+                if (mapping.dialogName != L"tray") {
+                    dialog.controls.insert(dialog.controls.end(), { -1, -1, -1, 40001, 40002 });
+                }
+                dialogs.push_back(dialog);
+                it = dialogs.end() - 1;
+            }
+            it->controls.push_back(mapping.controlId);
+        }
+        // 托盘菜单不取标题
+        for (auto& dialog : dialogs) {
+            if (dialog.name == L"tray")
+                dialog.controls.erase(dialog.controls.begin());
+        }
+        return dialogs;
+    }
+
+    template<class F>
+    double bestNs(int calls, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i)
+                f();
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = (std::min)(best, ns / calls);
+        }
+        return best;
+    }
+
+    void testTable(NewLookup& lookup, const OldLookup& old, const std::vector<Dialog>& dialogs)
+    {
+        const ControlTextTable& table = lookup.table();
+        size_t unique = 0;
+        {
+            std::vector<int> ids;
+            for (const auto& mapping : MAPPINGS)
+                ids.push_back(mapping.controlId);
+            std::sort(ids.begin(), ids.end());
+            unique = size_t(std::unique(ids.begin(), ids.end()) - ids.begin());
+        }
+        check(table.size() == unique, "every mapping has a slot");
+        for (const auto& mapping : MAPPINGS) {
+            int slot = table.findSlot(mapping.controlId);
+            check(slot >= 0 && table.mapping(slot).controlId == mapping.controlId, "slot maps back to the control");
+        }
+        check(table.findSlot(-1) == -1 && table.findSlot(0x10000) == -1 && table.findSlot(40001) == -1,
+            "unmapped ids have no slot");
+        check(lookup.dialogIndex(L"") == 0, "empty dialog name is 0");
+        int autopin = lookup.dialogIndex(L"autopin");
+        check(autopin > 0 && lookup.dialogIndex(L"autopin") == autopin, "dialog index is stable");
+
+        // 每个控件在每个对话框（以及不指定对话框）下的文本与旧的做法相同，重复取得同一个视图
+        std::vector<std::wstring> names{ L"", L"strings" };
+        for (const auto& dialog : dialogs)
+            names.push_back(dialog.name);
+        int compared = 0;
+        int mismatched = 0;
+        for (const auto& name : names) {
+            int index = lookup.dialogIndex(name);
+            for (const auto& mapping : MAPPINGS) {
+                std::wstring_view text = lookup.controlText(mapping.controlId, index);
+                ++compared;
+                if (text != old.getControlText(mapping.controlId, name) ||
+                    lookup.controlText(mapping.controlId, index).data() != text.data())
+                    ++mismatched;
+            }
+        }
+        check(compared > 0 && mismatched == 0, "texts match the old lookup",
+            std::to_string(mismatched) + "/" + std::to_string(compared));
+        check(lookup.controlText(40001, autopin).empty() && lookup.controlText(0, 1000).empty(),
+            "unmapped control or unknown dialog gives an empty text");
+        check(!lookup.controlText(IDOK, lookup.dialogIndex(L"options")).empty(), "options ok button");
+
+        // 切换语言后重新解析
+        std::wstring before(lookup.controlText(0, autopin));
+        lookup.reset();
+        std::wstring_view after = lookup.controlText(0, autopin);
+        check(after == before && !after.empty(), "texts resolved again after reset");
+    }
+
+    void benchmark(NewLookup& lookup, const OldLookup& old, const std::vector<Dialog>& dialogs)
+    {
+        const int CALLS = 100000;
+        std::printf("%-10s %8s | %12s %12s %12s\n", "dialog", "controls", "old ns", "new ns", "first ns");
+        size_t sink = 0;
+        for (const auto& dialog : dialogs) {
+            // 旧的做法每个控件都查找并复制文本
+            double oldNs = bestNs(CALLS, [&] {
+                for (int id : dialog.controls)
+                    sink += old.getControlText(id, dialog.name).size();
+            });
+            // 现在的做法：对话框名称每次本地化解析一次，之后按编号取视图
+            double newNs = bestNs(CALLS, [&] {
+                int index = lookup.dialogIndex(dialog.name);
+                for (int id : dialog.controls)
+                    sink += lookup.controlText(id, index).size();
+            });
+            // 切换语言后第一次打开对话框：每个控件解析一次
+            double firstNs = bestNs(CALLS / 10, [&] {
+                lookup.reset();
+                int index = lookup.dialogIndex(dialog.name);
+                for (int id : dialog.controls)
+                    sink += lookup.controlText(id, index).size();
+            });
+            std::printf("%-10s %8zu | %12.0f %12.0f %12.0f\n", Foundation::Json::toUtf8(dialog.name).c_str(),
+                dialog.controls.size(), oldNs, newNs, firstNs);
+        }
+        check(sink > 0, "benchmark produced text");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string path = argc > 1 ? argv[1] : "../../assets/locales/en_US.json";
+    Strings strings;
+    if (!strings.load(path)) {
+        std::printf("无法读取语言文件: %s\n", path.c_str());
+        return 2;
+    }
+
+    OldLookup old(strings);
+    NewLookup lookup(strings);
+    std::vector<Dialog> dialogs = makeDialogs();
+    std::printf("%zu 个控件映射，%zu 个控件编号，%zu 页\n",
+        sizeof(MAPPINGS) / sizeof(MAPPINGS[0]), lookup.table().size(), lookup.table().pageCount());
+
+    testTable(lookup, old, dialogs);
+    benchmark(lookup, old, dialogs);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
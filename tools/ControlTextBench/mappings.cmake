@@ -0,0 +1,10 @@
+# 从 language_manager.cpp 提取控件映射表，生成 mappings.inc（与 build.sh 中的 sed 相同）
+#   cmake -DSOURCE=<language_manager.cpp> -DOUTPUT=<mappings.inc> -P mappings.cmake
+file(READ ${SOURCE} text)
+string(REGEX MATCHALL "m_controlMappings\\[[^]\n]*\\] = {[^;\n]*}" entries "${text}")
+set(out "")
+foreach(entry IN LISTS entries)
+    string(REGEX REPLACE "^[^{]*({.*})$" "\\1" mapping "${entry}")
+    string(APPEND out "${mapping},\n")
+endforeach()
+file(WRITE ${OUTPUT} "${out}")
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建INI加载基准（foundation/ini_document.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o IniLoadBench main.cpp
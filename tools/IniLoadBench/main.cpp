@@ -0,0 +1,261 @@
+// IniLoadBench：TinyPin.ini 加载时间的基准。
+//
+// 生成与 Options 写出格式相同的 INI 文件（设置节加上 N 个 [AutoPinRuleN] 节），
+// 比较旧的 Options::readUtf8IniValue（每读一个值都重新读取整个文件、转换为UTF-16再查找）
+// 与 Foundation::IniDocument（解析一次，按节名索引）读出全部设置和规则的耗时，
+// 并检查两种做法读出的值相同。
+//
+// 用法：
+//   IniLoadBench [临时文件路径]
+//
+
+#include "foundation/ini_document.h"
+#include "foundation/json_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cwchar>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what)
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s\n", what);
+            ++g_failed;
+        }
+    }
+
+    // 旧的 Options::readUtf8IniValue，只把字符串转换换成标准库实现
+    std::wstring oldReadValue(const std::string& path, const std::wstring& section,
+        const std::wstring& key, const std::wstring& defaultValue)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return defaultValue;
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::wstring wideContent = Foundation::Json::toWide(content);
+
+        std::wstring sectionHeader = L"[" + section + L"]";
+        size_t sectionPos = wideContent.find(sectionHeader);
+        if (sectionPos == std::wstring::npos)
+            return defaultValue;
+        size_t searchStart = sectionPos + sectionHeader.length();
+        size_t nextSectionPos = wideContent.find(L"[", searchStart);
+        if (nextSectionPos == std::wstring::npos)
+            nextSectionPos = wideContent.length();
+        std::wstring sectionContent = wideContent.substr(searchStart, nextSectionPos - searchStart);
+
+        std::wstring keyPattern = key + L"=";
+        size_t keyPos = sectionContent.find(keyPattern);
+        if (keyPos == std::wstring::npos)
+            return defaultValue;
+        if (keyPos > 0) {
+            wchar_t prevChar = sectionContent[keyPos - 1];
+            if (prevChar != L'\n' && prevChar != L'\r' && prevChar != L' ' && prevChar != L'\t') {
+                size_t nextPos = keyPos + keyPattern.length();
+                while (nextPos < sectionContent.length()) {
+                    keyPos = sectionContent.find(keyPattern, nextPos);
+                    if (keyPos == std::wstring::npos)
+                        return defaultValue;
+                    if (keyPos == 0 || sectionContent[keyPos - 1] == L'\n' || sectionContent[keyPos - 1] == L'\r')
+                        break;
+                    nextPos = keyPos + keyPattern.length();
+                }
+            }
+        }
+
+        size_t valueStart = keyPos + keyPattern.length();
+        size_t lineEnd = sectionContent.find(L'\n', valueStart);
+        if (lineEnd == std::wstring::npos)
+            lineEnd = sectionContent.length();
+        std::wstring value = sectionContent.substr(valueStart, lineEnd - valueStart);
+        if (!value.empty() && value.back() == L'\r')
+            value.pop_back();
+        return value;
+    }
+
+    int toInt(const std::wstring& s)
+    {
+        return static_cast<int>(std::wcstol(s.c_str(), nullptr, 10));
+    }
+
+    struct Rule {
+        std::wstring descr, ttl, cls, proc;
+        int procField = 0;
+        bool enabled = true;
+
+        bool operator==(const Rule& o) const
+        {
+            return descr == o.descr && ttl == o.ttl && cls == o.cls && proc == o.proc &&
+                procField == o.procField && enabled == o.enabled;
+        }
+    };
+
+    // 读出的全部内容，用于比较两种做法的结果
+    struct Loaded {
+        std::vector<std::wstring> settings;
+        std::vector<Rule> rules;
+    };
+
+    // loadSettingsFromIni 读取的键
+    const std::pair<const wchar_t*, const wchar_t*> SETTING_KEYS[] = {
+        { L"Settings", L"Language" },
+        { L"Pins", L"PinImagePath" }, { L"Pins", L"TrackRate" }, { L"Pins", L"TrayDblClick" },
+        { L"Hotkeys", L"Enabled" },
+        { L"Hotkeys", L"EnterPin_VK" }, { L"Hotkeys", L"EnterPin_MOD" },
+        { L"Hotkeys", L"TogglePin_VK" }, { L"Hotkeys", L"TogglePin_MOD" },
+        { L"AutoPin", L"Enabled" }, { L"AutoPin", L"Delay" },
+        { L"AutoPin", L"ProcessFilter" }, { L"AutoPin", L"StartupSweep" },
+        { L"Debug", L"RecordEvents" },
+    };
+
+    // 旧的 loadSettingsFromIni + loadAutoPinRulesFromIni，ruleLimit 限制读取的规则数
+    Loaded loadOld(const std::string& path, int ruleLimit)
+    {
+        Loaded out;
+        for (const auto& k : SETTING_KEYS)
+            out.settings.push_back(oldReadValue(path, k.first, k.second, L""));
+        int ruleCount = toInt(oldReadValue(path, L"AutoPin", L"RuleCount", L"0"));
+        if (ruleCount > ruleLimit)
+            ruleCount = ruleLimit;
+        for (int i = 0; i < ruleCount; ++i) {
+            std::wstring sectionName = L"AutoPinRule" + std::to_wstring(i);
+            Rule rule;
+            rule.descr = oldReadValue(path, sectionName, L"Description", L"");
+            rule.ttl = oldReadValue(path, sectionName, L"Title", L"");
+            rule.cls = oldReadValue(path, sectionName, L"Class", L"");
+            rule.proc = oldReadValue(path, sectionName, L"Process", L"");
+            rule.procField = toInt(oldReadValue(path, sectionName, L"ProcessField", L"0"));
+            rule.enabled = toInt(oldReadValue(path, sectionName, L"Enabled", L"1")) != 0;
+            out.rules.push_back(rule);
+        }
+        return out;
+    }
+
+    // 现在的做法：IniDocument::load 读取一次，再从索引中取值
+    Loaded loadNew(const std::string& path)
+    {
+        Loaded out;
+        Foundation::IniDocument ini;
+        std::ifstream file(path, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        ini.parse(Foundation::Json::toWide(content));
+
+        for (const auto& k : SETTING_KEYS)
+            out.settings.push_back(ini.get(k.first, k.second));
+        int ruleCount = ini.getInt(L"AutoPin", L"RuleCount", 0);
+        std::wstring sectionName;
+        for (int i = 0; i < ruleCount; ++i) {
+            sectionName = L"AutoPinRule" + std::to_wstring(i);
+            Rule rule;
+            rule.descr = ini.get(sectionName, L"Description");
+            rule.ttl = ini.get(sectionName, L"Title");
+            rule.cls = ini.get(sectionName, L"Class");
+            rule.proc = ini.get(sectionName, L"Process");
+            rule.procField = ini.getInt(sectionName, L"ProcessField", 0);
+            rule.enabled = ini.getInt(sectionName, L"Enabled", 1) != 0;
+            out.rules.push_back(rule);
+        }
+        return out;
+    }
+
+    // 按旧版 Options::saveSettingsToIni 的格式写出配置文件
+    void writeIni(const std::string& path, int ruleCount)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "\xEF\xBB\xBF";
+        file << "; 微钉 配置文件\n; 此文件包含所有 微钉 设置\n; 自动生成 - 支持手动编辑\n\n";
+        file << "[Settings]\n; 语言设置 (例如：zh_CN, en_US, 空值表示自动检测)\nLanguage=zh_CN\n\n";
+        file << "[Pins]\n; 图钉图像文件路径 (相对于程序目录)\nPinImagePath=\n"
+                "; 窗口跟踪频率，单位毫秒 (10-1000)\nTrackRate=100\n"
+                "; 托盘图标双击行为 (0=单击, 1=双击)\nTrayDblClick=0\n\n";
+        file << "[Hotkeys]\n; 启用热键 (0=禁用, 1=启用)\nEnabled=1\n"
+                "; 进入图钉模式热键 (VK=虚拟键码, MOD=修饰键)\n; 修饰键: 1=Alt, 2=Ctrl, 4=Shift, 8=Win\n"
+                "EnterPin_VK=80\nEnterPin_MOD=6\n; 切换图钉热键\nTogglePin_VK=84\nTogglePin_MOD=6\n\n";
+        file << "[AutoPin]\n; 启用自动图钉 (0=禁用, 1=启用)\nEnabled=1\n"
+                "; 自动图钉延迟时间，单位毫秒 (100-10000)\nDelay=200\n"
+                "; 只对这些进程的窗口自动图钉，以分号分隔 (例如：notepad.exe;calc.exe，空值表示所有进程)\n"
+                "ProcessFilter=notepad.exe;calc.exe\n"
+                "; 启动时对已打开的窗口应用规则 (0=禁用, 1=启用)\nStartupSweep=0\n"
+                "; 自动图钉规则数量\nRuleCount=" << ruleCount << "\n\n";
+        file << "[Debug]\n; 录制自动图钉事件到 log 目录，供 AutoPinReplay 回放 (0=禁用, 1=启用)\nRecordEvents=0\n\n";
+        for (int i = 0; i < ruleCount; ++i) {
+            file << "[AutoPinRule" << i << "]\n";
+            file << "; 规则描述\nDescription=规则 " << i << "\n";
+            file << "; 窗口标题匹配模式 (* 表示通配符)\nTitle=*文档 " << i << " - 记事本*\n";
+            file << "; 窗口类名匹配模式\nClass=" << (i % 3 ? "Notepad" : "") << "\n";
+            file << "; 进程匹配模式，不区分大小写 (* 表示通配符，空值表示所有进程)\nProcess="
+                 << (i % 2 ? "notepad.exe" : "") << "\n";
+            file << "; 进程匹配属性 (0=映像名, 1=完整路径, 2=包系列名)\nProcessField=" << i % 3 << "\n";
+            file << "; 规则启用状态 (0=禁用, 1=启用)\nEnabled=" << (i % 5 ? 1 : 0) << "\n";
+            if (i + 1 < ruleCount)
+                file << "\n";
+        }
+    }
+
+    template<class F>
+    double timeMs(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 旧的做法最多实际读取这么多条规则，更多时按每条规则的耗时推算
+    const int OLD_RULE_LIMIT = 100;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string path = argc > 1 ? argv[1] : "IniLoadBench.tmp.ini";
+
+    std::printf("%8s %10s %14s %12s %10s\n", "rules", "file KB", "old ms", "new ms", "speedup");
+    for (int ruleCount : { 10, 1000, 10000 }) {
+        writeIni(path, ruleCount);
+        long long bytes = 0;
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            bytes = static_cast<long long>(file.tellg());
+        }
+
+        // 新做法取多次中最快的一次
+        Loaded fresh;
+        double newMs = 1e300;
+        for (int run = 0; run < 5; ++run) {
+            double ms = timeMs([&] { fresh = loadNew(path); });
+            if (ms < newMs)
+                newMs = ms;
+        }
+
+        Loaded old;
+        double oldMs = timeMs([&] { old = loadOld(path, OLD_RULE_LIMIT); });
+        bool estimated = ruleCount > OLD_RULE_LIMIT;
+        if (estimated) {
+            // 设置部分照常计时，规则部分按实际读取的条数线性推算
+            double settingsMs = timeMs([&] { loadOld(path, 0); });
+            oldMs = settingsMs + (oldMs - settingsMs) * ruleCount / OLD_RULE_LIMIT;
+        }
+
+        check(fresh.settings == old.settings, "settings differ");
+        check(fresh.rules.size() == static_cast<size_t>(ruleCount), "rule count");
+        check(std::equal(old.rules.begin(), old.rules.end(), fresh.rules.begin()), "rules differ");
+
+        std::printf("%8d %10.1f %13.1f%s %12.3f %9.0fx\n", ruleCount, bytes / 1024.0,
+            oldMs, estimated ? "*" : " ", newMs, oldMs / newMs);
+    }
+    std::remove(path.c_str());
+    std::printf("* 只读取前 %d 条规则，按条数推算\n", OLD_RULE_LIMIT);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建预编译语言文件的测试与基准（system/locale_blob.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LocaleBlobTest main.cpp
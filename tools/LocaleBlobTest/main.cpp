@@ -0,0 +1,353 @@
+// LocaleBlobTest：预编译语言文件（system/locale_blob.h）的测试与基准。
+//
+// 一致性：0 到 100000 个键的二进制块中每个键都能找到对应的值，不存在的键找不到，
+// 重复的键保留第一个值，截断或损坏的二进制块被拒绝，
+// assets/locales 下的语言文件编译后与解析JSON得到的键值相同。
+// 基准：读取语言文件的二进制块并校验（打开）与读取JSON、解析并填充键值表的耗时，
+// 10000 和 100000 个键时的查找（与 unordered_map<wstring, wstring> 比较）和构造二进制块的耗时。
+//
+// 用法：
+//   LocaleBlobTest [语言文件目录]
+//
+
+#include "system/locale_blob.h"
+#include "system/locale_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    using PoolString = std::basic_string<LocaleBlob::Char>;
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // 宽字符串转换为块中的字符（wchar_t为32位时拆分为代理对）
+    PoolString toPool(std::wstring_view s)
+    {
+        PoolString out;
+        LocaleBlob::detail::append(out, s);
+        return out;
+    }
+
+    std::wstring makeKey(size_t n)
+    {
+        return L"dialogs.section" + std::to_wstring(n % 97) + L".item" + std::to_wstring(n);
+    }
+
+    std::wstring makeValue(size_t n)
+    {
+        return L"值 " + std::to_wstring(n * 7);
+    }
+
+    std::vector<char> makeBlob(size_t count)
+    {
+        LocaleBlob::Builder builder;
+        for (size_t n = 0; n < count; ++n)
+            builder.add(makeKey(n), makeValue(n));
+        return builder.build(count, count * 3);
+    }
+
+    // 每个键都能找到，值正确；不存在的键找不到
+    void testRoundTrip()
+    {
+        for (size_t count : { 0, 1, 2, 3, 4, 5, 7, 16, 100, 1000, 10000, 100000 }) {
+            std::string label = std::to_string(count) + " keys";
+            std::vector<char> blob = makeBlob(count);
+            LocaleBlob::View view;
+            if (!view.open(blob.data(), blob.size())) {
+                check(false, "round trip: blob opens", label);
+                continue;
+            }
+
+            size_t wrong = 0;
+            LocaleBlob::StringView value;
+            for (size_t n = 0; n < count; ++n) {
+                if (!view.find(toPool(makeKey(n)), value) || value != toPool(makeValue(n)))
+                    ++wrong;
+            }
+            size_t found = 0;
+            for (size_t n = count; n < count + 1000; ++n)
+                found += view.find(toPool(makeKey(n)), value);
+            found += view.find(toPool(L""), value);
+            found += view.find(toPool(makeKey(0) + L"x"), value);
+
+            check(view.size() == count && view.sourceSize() == count && view.sourceTime() == count * 3,
+                  "round trip: header", label);
+            check(wrong == 0, "round trip: every key found", label + ", " + std::to_string(wrong) + " wrong");
+            check(found == 0, "round trip: missing keys rejected", label);
+        }
+    }
+
+    void testEntries()
+    {
+        LocaleBlob::Builder builder;
+        builder.add(L"menu.exit", L"Exit");
+        builder.add(L"menu.about", L"About");
+        builder.add(L"menu.exit", L"Quit");
+        builder.add(L"", L"empty key");
+        builder.add(L"emoji", L"\U0001F4CC 图钉");
+        builder.add(L"empty.value", L"");
+        check(builder.size() == 5, "entries: duplicate key not added");
+
+        std::vector<char> blob = builder.build(0, 0);
+        LocaleBlob::View view;
+        check(view.open(blob.data(), blob.size()), "entries: blob opens");
+
+        LocaleBlob::StringView value;
+        check(view.find(toPool(L"menu.exit"), value) && value == toPool(L"Exit"), "entries: duplicate keeps the first value");
+        check(view.find(toPool(L""), value) && value == toPool(L"empty key"), "entries: empty key");
+        check(view.find(toPool(L"emoji"), value) && value == toPool(L"\U0001F4CC 图钉"), "entries: non-BMP value");
+        check(view.find(toPool(L"empty.value"), value) && value.empty() && value.data()[0] == 0, "entries: empty value");
+        check(view.find(toPool(L"menu.about"), value) && value.data()[value.size()] == 0, "entries: values are null-terminated");
+
+        // 按槽遍历得到全部条目
+        size_t seen = 0;
+        for (size_t i = 0; i < view.size(); ++i) {
+            LocaleBlob::StringView found;
+            seen += view.find(view.key(i), found) && found == view.value(i);
+        }
+        check(seen == 5, "entries: iteration covers every entry");
+    }
+
+    template <typename T>
+    void patch(std::vector<char>& blob, size_t offset, T value)
+    {
+        std::memcpy(blob.data() + offset, &value, sizeof(value));
+    }
+
+    bool opens(const std::vector<char>& blob, size_t size)
+    {
+        LocaleBlob::View view;
+        return view.open(blob.data(), size);
+    }
+
+    void testCorrupt()
+    {
+        const std::vector<char> good = makeBlob(50);
+        check(opens(good, good.size()), "corrupt: intact blob opens");
+        check(!opens(good, 0) && !LocaleBlob::View().open(nullptr, 100), "corrupt: empty input");
+
+        size_t truncated = 0;
+        for (size_t size = 1; size < good.size(); ++size)
+            truncated += opens(good, size);
+        check(truncated == 0, "corrupt: every truncation rejected");
+        std::vector<char> longer = good;
+        longer.push_back(0);
+        check(!opens(longer, longer.size()), "corrupt: trailing bytes rejected");
+
+        const size_t seedsOffset = sizeof(LocaleBlob::Header);
+        uint32_t bucketCount = 0;
+        std::memcpy(&bucketCount, good.data() + offsetof(LocaleBlob::Header, bucketCount), sizeof(bucketCount));
+        const size_t entriesOffset = seedsOffset + bucketCount * sizeof(uint32_t);
+
+        std::vector<char> blob = good;
+        blob[0] = 'X';
+        check(!opens(blob, blob.size()), "corrupt: magic");
+        blob = good;
+        patch(blob, offsetof(LocaleBlob::Header, version), LocaleBlob::VERSION + 1);
+        check(!opens(blob, blob.size()), "corrupt: version");
+        blob = good;
+        patch(blob, offsetof(LocaleBlob::Header, count), uint32_t(49));
+        check(!opens(blob, blob.size()), "corrupt: entry count");
+        blob = good;
+        patch(blob, offsetof(LocaleBlob::Header, bucketCount), uint32_t(0));
+        check(!opens(blob, blob.size()), "corrupt: buckets without entries");
+        blob = good;
+        patch(blob, entriesOffset + offsetof(LocaleBlob::Entry, valueOffset), uint32_t(0xFFFFFFF0));
+        check(!opens(blob, blob.size()), "corrupt: value outside the pool");
+        blob = good;
+        patch(blob, entriesOffset + offsetof(LocaleBlob::Entry, keyLength), uint32_t(1));
+        check(!opens(blob, blob.size()), "corrupt: key not null-terminated");
+
+        // 直接记录槽位置的桶超出槽数
+        size_t direct = 0;
+        for (uint32_t b = 0; b < bucketCount; ++b) {
+            uint32_t seed = 0;
+            std::memcpy(&seed, good.data() + seedsOffset + b * sizeof(uint32_t), sizeof(seed));
+            if (!(seed & LocaleBlob::detail::DIRECT))
+                continue;
+            blob = good;
+            patch(blob, seedsOffset + b * sizeof(uint32_t), uint32_t(LocaleBlob::detail::DIRECT | 50));
+            direct += !opens(blob, blob.size());
+            break;
+        }
+        check(direct == 1, "corrupt: direct slot outside the table");
+    }
+
+    std::string readAll(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // 解析JSON并填充键值表（切换语言时旧的做法），重复的键保留第一个
+    bool parseLocale(const std::string& data, std::unordered_map<std::wstring, std::wstring>& strings)
+    {
+        std::string pool, error;
+        long count = LocaleParser::flatten(data.data(), data.size(), pool, error);
+        strings.clear();
+        if (count < 0)
+            return false;
+        std::wstring wide = Foundation::Json::toWide(pool);
+        strings.reserve(size_t(count));
+        LocaleParser::split(std::wstring_view(wide), [&](std::wstring_view key, std::wstring_view value) {
+            strings.emplace(std::wstring(key), std::wstring(value));
+        });
+        return true;
+    }
+
+    std::vector<char> compileLocale(const std::string& data)
+    {
+        std::string pool, error;
+        if (LocaleParser::flatten(data.data(), data.size(), pool, error) < 0)
+            return {};
+        LocaleBlob::Builder builder;
+        LocaleParser::split(std::string_view(pool), [&](std::string_view key, std::string_view value) {
+            builder.add(Foundation::Json::toWide(key), Foundation::Json::toWide(value));
+        });
+        return builder.build(data.size(), 0);
+    }
+
+    template <typename F>
+    double bestUs(int runs, int repeat, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i)
+                f();
+            best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeat);
+        }
+        return best;
+    }
+
+    // 语言文件编译后与解析JSON的结果相同，并比较两种做法切换语言时的耗时
+    void testLocales(const fs::path& dir)
+    {
+        std::vector<fs::path> files;
+        std::error_code ec;
+        for (const auto& file : fs::directory_iterator(dir, ec)) {
+            if (file.is_regular_file() && file.path().extension() == ".json")
+                files.push_back(file.path());
+        }
+        std::sort(files.begin(), files.end());
+        check(!files.empty(), "locales: found locale files", dir.string());
+
+        std::printf("%-12s %7s %5s %9s | %13s %13s\n", "locale", "json", "keys", "blob", "read+open us", "read+parse us");
+        for (const fs::path& path : files) {
+            std::string name = path.filename().string();
+            std::string data = readAll(path);
+            std::unordered_map<std::wstring, std::wstring> strings;
+            std::vector<char> blob = compileLocale(data);
+            LocaleBlob::View view;
+            if (!parseLocale(data, strings) || !view.open(blob.data(), blob.size())) {
+                check(false, "locales: compiles", name);
+                continue;
+            }
+
+            size_t wrong = 0;
+            LocaleBlob::StringView value;
+            for (const auto& item : strings) {
+                if (!view.find(toPool(item.first), value) || value != toPool(item.second))
+                    ++wrong;
+            }
+            check(view.size() == strings.size() && wrong == 0, "locales: blob matches the parsed JSON", name);
+
+            // 两种做法都从文件读取：二进制块写入临时目录
+            fs::path binPath = fs::temp_directory_path() / (path.stem().string() + ".LocaleBlobTest.bin");
+            std::ofstream(binPath, std::ios::binary).write(blob.data(), std::streamsize(blob.size()));
+            size_t opened = 0;
+            double openUs = bestUs(7, 100, [&] {
+                std::string bytes = readAll(binPath);
+                LocaleBlob::View v;
+                opened += v.open(bytes.data(), bytes.size());
+            });
+            double parseUs = bestUs(7, 100, [&] { parseLocale(readAll(path), strings); });
+            fs::remove(binPath, ec);
+            check(opened == 700, "locales: blob file opens", name);
+            std::printf("%-12s %7zu %5zu %9zu | %13.1f %13.1f\n", name.c_str(), data.size(), view.size(), blob.size(), openUs, parseUs);
+        }
+    }
+
+    void benchmarkLookup(size_t count)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<char> blob = makeBlob(count);
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LocaleBlob::View view;
+        view.open(blob.data(), blob.size());
+
+        std::unordered_map<std::wstring, std::wstring> map;
+        map.reserve(count);
+        for (size_t n = 0; n < count; ++n)
+            map.emplace(makeKey(n), makeValue(n));
+
+        // 按随机顺序查找，两种做法使用同样的键（块中的键已转换为池中的字符）
+        std::vector<size_t> order(count);
+        for (size_t n = 0; n < count; ++n)
+            order[n] = n;
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+        std::vector<std::wstring> keys;
+        std::vector<PoolString> poolKeys;
+        for (size_t n : order) {
+            keys.push_back(makeKey(n));
+            poolKeys.push_back(toPool(keys.back()));
+        }
+
+        size_t sink = 0;
+        double blobNs = bestUs(5, 1, [&] {
+            LocaleBlob::StringView value;
+            for (const PoolString& key : poolKeys)
+                sink += view.find(key, value) ? value.size() : 0;
+        }) * 1000 / count;
+        double mapNs = bestUs(5, 1, [&] {
+            for (const std::wstring& key : keys) {
+                auto it = map.find(key);
+                sink += it != map.end() ? it->second.size() : 0;
+            }
+        }) * 1000 / count;
+
+        std::printf("%6zu keys: lookup %6.1f ns (unordered_map %6.1f ns), build %6.1f ms\n", count, blobNs, mapNs, buildMs);
+        check(sink > 0, "bench: lookups found values");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    fs::path dir = argc > 1 ? argv[1] : "../../assets/locales";
+
+    testRoundTrip();
+    testEntries();
+    testCorrupt();
+    testLocales(dir);
+    std::printf("\n");
+    benchmarkLookup(10000);
+    benchmarkLookup(100000);
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建语言文件编译工具（生成 system/locale_blob.h 的 .bin 和 locale_manifest.h 的清单）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LocaleCompiler main.cpp
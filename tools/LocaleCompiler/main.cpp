@@ -0,0 +1,222 @@
+// LocaleCompiler：把JSON语言文件编译为预编译的二进制语言文件。
+//
+// 对每个 assets/locales/xx_XX.json 生成同目录的 xx_XX.bin（格式见 include/system/locale_blob.h），
+// 程序启动和切换语言时直接映射 .bin 文件，不再解析JSON。
+// 编译目录时同时生成语言文件清单 locales.manifest（格式见 include/system/locale_manifest.h）。
+// .bin 文件记录了JSON文件的大小和修改时间，JSON修改后程序会自动重新编译，
+// 这个工具用于在打包前生成，使安装后的第一次启动也不需要解析JSON。
+//
+// 用法：
+//   LocaleCompiler [--verify] [JSON文件或目录...]
+//
+
+#include "system/locale_blob.h"
+#include "system/locale_manifest.h"
+#include "system/locale_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    // 与程序相同的源文件时间：FILETIME（1601年起的100纳秒数）
+    bool sourceInfo(const fs::path& path, uint64_t& size, uint64_t& time)
+    {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attr;
+        if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attr))
+            return false;
+        size = (uint64_t(attr.nFileSizeHigh) << 32) | attr.nFileSizeLow;
+        time = (uint64_t(attr.ftLastWriteTime.dwHighDateTime) << 32) | attr.ftLastWriteTime.dwLowDateTime;
+#else
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            return false;
+#ifdef __APPLE__
+        const struct timespec& mtime = st.st_mtimespec;
+#else
+        const struct timespec& mtime = st.st_mtim;
+#endif
+        size = uint64_t(st.st_size);
+        time = (uint64_t(mtime.tv_sec) + 11644473600ull) * 10000000ull + uint64_t(mtime.tv_nsec) / 100;
+#endif
+        return true;
+    }
+
+    bool readFile(const fs::path& path, std::string& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    bool writeFile(const fs::path& path, const std::vector<char>& data)
+    {
+        fs::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), std::streamsize(data.size()));
+            if (!file)
+                return false;
+        }
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+        return !ec;
+    }
+
+    // 检查每个条目都能通过完美哈希找回
+    bool verify(const std::vector<char>& blob, size_t count)
+    {
+        LocaleBlob::View view;
+        if (!view.open(blob.data(), blob.size()) || view.size() != count)
+            return false;
+        for (size_t i = 0; i < view.size(); ++i) {
+            LocaleBlob::StringView value;
+            if (!view.find(view.key(i), value) || value.data() != view.value(i).data())
+                return false;
+        }
+        return true;
+    }
+
+    bool compile(const fs::path& jsonPath, bool check, LocaleManifest::Entry& entry)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::string data;
+        uint64_t sourceSize = 0, sourceTime = 0;
+        if (!sourceInfo(jsonPath, sourceSize, sourceTime) || !readFile(jsonPath, data)) {
+            std::fprintf(stderr, "%s: cannot read\n", jsonPath.string().c_str());
+            return false;
+        }
+
+        std::string pool, error;
+        if (LocaleParser::flatten(data.data(), data.size(), pool, error) < 0) {
+            std::fprintf(stderr, "%s: %s\n", jsonPath.string().c_str(), error.c_str());
+            return false;
+        }
+
+        LocaleBlob::Builder builder;
+        entry.named = true;
+        LocaleParser::split(std::string_view(pool), [&](std::string_view key, std::string_view value) {
+            std::wstring text = Foundation::Json::toWide(value);
+            if (key == "language_info.name" && entry.name.empty())
+                entry.name = text;
+            builder.add(Foundation::Json::toWide(key), text);
+        });
+        entry.code = jsonPath.stem().wstring();
+        entry.size = sourceSize;
+        entry.time = sourceTime;
+        std::vector<char> blob = builder.build(sourceSize, sourceTime);
+        if (blob.empty()) {
+            std::fprintf(stderr, "%s: cannot build perfect hash\n", jsonPath.string().c_str());
+            return false;
+        }
+        if (check && !verify(blob, builder.size())) {
+            std::fprintf(stderr, "%s: verification failed\n", jsonPath.string().c_str());
+            return false;
+        }
+
+        fs::path blobPath = jsonPath;
+        blobPath.replace_extension(".bin");
+        if (!writeFile(blobPath, blob)) {
+            std::fprintf(stderr, "%s: cannot write\n", blobPath.string().c_str());
+            return false;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %zu strings, %zu -> %zu bytes, %.1f ms\n", blobPath.string().c_str(),
+            builder.size(), data.size(), blob.size(), ms);
+        return true;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: LocaleCompiler [--verify] [file.json | directory]...\n"
+            "       without paths, compiles ../../assets/locales\n");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool check = false;
+    std::vector<fs::path> inputs;
+    for (int n = 1; n < argc; ++n) {
+        if (std::strcmp(argv[n], "--verify") == 0)
+            check = true;
+        else if (argv[n][0] == '-') {
+            usage();
+            return 2;
+        }
+        else
+            inputs.push_back(argv[n]);
+    }
+    if (inputs.empty())
+        inputs.push_back("../../assets/locales");
+
+    int compiled = 0;
+    int failed = 0;
+    for (const fs::path& input : inputs) {
+        std::error_code ec;
+        if (!fs::is_directory(input, ec)) {
+            LocaleManifest::Entry entry;
+            compile(input, check, entry) ? ++compiled : ++failed;
+            continue;
+        }
+
+        // 目录：编译其中所有语言文件并生成清单
+        std::vector<LocaleManifest::Entry> manifest;
+        bool complete = true;
+        for (const auto& file : fs::directory_iterator(input, ec)) {
+            if (!file.is_regular_file() || file.path().extension() != ".json")
+                continue;
+            LocaleManifest::Entry entry;
+            if (compile(file.path(), check, entry)) {
+                manifest.push_back(std::move(entry));
+                ++compiled;
+            }
+            else {
+                complete = false;
+                ++failed;
+            }
+        }
+        if (complete && !manifest.empty()) {
+            std::sort(manifest.begin(), manifest.end(),
+                [](const LocaleManifest::Entry& a, const LocaleManifest::Entry& b) { return a.code < b.code; });
+            std::string text = LocaleManifest::format(manifest);
+            fs::path manifestPath = input / "locales.manifest";
+            if (!writeFile(manifestPath, std::vector<char>(text.begin(), text.end()))) {
+                std::fprintf(stderr, "%s: cannot write\n", manifestPath.string().c_str());
+                ++failed;
+            }
+            else {
+                std::printf("%s: %zu locales\n", manifestPath.string().c_str(), manifest.size());
+            }
+        }
+    }
+    if (compiled + failed == 0) {
+        std::fprintf(stderr, "no locale files found\n");
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建语言文件清单的测试与基准（system/locale_manifest.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LocaleManifestTest main.cpp
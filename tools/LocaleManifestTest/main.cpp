@@ -0,0 +1,268 @@
+// LocaleManifestTest：语言文件清单（system/locale_manifest.h）的测试与基准。
+//
+// 一致性：清单的生成和读取（包括CRLF换行和格式错误的清单），生成时跳过没有名称的条目，
+// 与目录扫描结果合并时大小和修改时间都没有变化的语言文件沿用名称，
+// 修改过的和新的语言文件需要重新读取名称，删除的语言文件从清单中去掉；
+// 用 assets/locales 模拟第一次启动（没有清单）和之后的启动。
+// 基准：列出语言时打开每个语言文件读取 language_info.name，与读取清单的耗时。
+//
+// 用法：
+//   LocaleManifestTest [语言文件目录]
+//
+
+#include "system/locale_manifest.h"
+#include "system/locale_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    using LocaleManifest::Entry;
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    Entry entry(const wchar_t* code, uint64_t size, uint64_t time, const wchar_t* name = nullptr)
+    {
+        Entry e;
+        e.code = code;
+        e.size = size;
+        e.time = time;
+        if (name) {
+            e.name = name;
+            e.named = true;
+        }
+        return e;
+    }
+
+    bool same(const std::vector<Entry>& a, const std::vector<Entry>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Entry& x, const Entry& y) {
+            return x.code == y.code && x.name == y.name && x.size == y.size && x.time == y.time && x.named == y.named;
+        });
+    }
+
+    void testFormat()
+    {
+        std::vector<Entry> entries = {
+            entry(L"zh_CN", 6885, 133500000000000001ull, L"简体中文"),
+            entry(L"en_US", 6898, 133500000000000002ull, L"English"),
+            entry(L"ja_JP", 8842, 0, L""),
+        };
+        std::vector<Entry> parsed;
+        check(LocaleManifest::parse(LocaleManifest::format(entries), parsed), "format: output parses");
+        std::vector<Entry> sorted = { entries[1], entries[2], entries[0] };
+        check(same(parsed, sorted), "format: round trip sorted by code");
+
+        // 名称中的制表符和换行不能破坏行格式
+        entries = { entry(L"de_DE", 1, 2, L"Deutsch\tDE\r\nx") };
+        check(LocaleManifest::parse(LocaleManifest::format(entries), parsed) && parsed.size() == 1
+              && parsed[0].name == L"Deutsch DE  x", "format: separators in names replaced");
+
+        // 没有名称的条目不写入
+        entries = { entry(L"en_US", 1, 2, L"English"), entry(L"fr_FR", 3, 4) };
+        check(LocaleManifest::parse(LocaleManifest::format(entries), parsed) && parsed.size() == 1
+              && parsed[0].code == L"en_US", "format: unnamed entries skipped");
+        check(LocaleManifest::format({}) == std::string(LocaleManifest::HEADER) + "\n", "format: empty manifest");
+    }
+
+    void testParse()
+    {
+        std::string header = LocaleManifest::HEADER;
+        std::vector<Entry> parsed;
+        check(LocaleManifest::parse(header + "\r\nen_US\t10\t20\tEnglish\r\n\r\nfr_FR\t30\t40\tFran\xC3\xA7" "ais\r\n", parsed)
+              && same(parsed, { entry(L"en_US", 10, 20, L"English"), entry(L"fr_FR", 30, 40, L"Français") }),
+              "parse: CRLF line endings and blank lines");
+        check(LocaleManifest::parse(header, parsed) && parsed.empty(), "parse: header without a newline");
+        check(LocaleManifest::parse(header + "\nen_US\t10\t20\tEnglish", parsed) && parsed.size() == 1,
+              "parse: last line without a newline");
+
+        const char* const malformed[] = {
+            "",
+            "# TinyPin locale manifest 2\n",
+            "en_US\t10\t20\tEnglish\n",
+            "\nen_US\t10\t20\tEnglish\n",
+            "en_US\t10\t20\n",
+            "en_US 10 20 English\n",
+            "en_US\t\t20\tEnglish\n",
+            "en_US\t10x\t20\tEnglish\n",
+            "en_US\t10\t-\tEnglish\n",
+            "\t10\t20\tEnglish\n",
+        };
+        int accepted = 0;
+        for (size_t n = 0; n < std::size(malformed); ++n) {
+            std::string text = n < 4 ? malformed[n] : header + "\n" + malformed[n];
+            accepted += LocaleManifest::parse(text, parsed);
+        }
+        check(accepted == 0, "parse: malformed manifests rejected", std::to_string(accepted) + " accepted");
+        check(parsed.empty(), "parse: rejected manifest leaves no entries");
+    }
+
+    void testMerge()
+    {
+        const std::vector<Entry> manifest = {
+            entry(L"de_DE", 100, 1, L"Deutsch"),
+            entry(L"en_US", 200, 2, L"English"),
+            entry(L"fr_FR", 300, 3, L"Français"),
+            entry(L"ja_JP", 400, 4, L"日本語"),
+        };
+
+        // 全部没有变化
+        std::vector<Entry> merged = manifest;
+        check(!LocaleManifest::merge(merged, { entry(L"ja_JP", 400, 4), entry(L"en_US", 200, 2),
+                                              entry(L"fr_FR", 300, 3), entry(L"de_DE", 100, 1) }) && same(merged, manifest),
+              "merge: unchanged files keep their names");
+
+        // 大小变化、修改时间变化、新增和删除
+        merged = manifest;
+        bool changed = LocaleManifest::merge(merged, { entry(L"de_DE", 101, 1), entry(L"en_US", 200, 5),
+                                                      entry(L"ja_JP", 400, 4), entry(L"zh_CN", 500, 6) });
+        check(changed, "merge: changes reported");
+        check(same(merged, { entry(L"de_DE", 101, 1), entry(L"en_US", 200, 5), manifest[3], entry(L"zh_CN", 500, 6) }),
+              "merge: changed and new files unnamed, removed file dropped");
+
+        // 只删除了语言文件
+        merged = manifest;
+        check(LocaleManifest::merge(merged, { entry(L"en_US", 200, 2) }) && same(merged, { manifest[1] }),
+              "merge: removal alone is a change");
+
+        // 清单中没有名称的条目不沿用
+        merged = { entry(L"en_US", 200, 2) };
+        check(LocaleManifest::merge(merged, { entry(L"en_US", 200, 2) }) && !merged[0].named,
+              "merge: unnamed manifest entry stays unnamed");
+    }
+
+    std::string readAll(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // 目录扫描：代码、大小和修改时间（程序中来自 FindFirstFile 的目录项）
+    std::vector<Entry> scan(const fs::path& dir)
+    {
+        std::vector<Entry> scanned;
+        std::error_code ec;
+        for (const auto& file : fs::directory_iterator(dir, ec)) {
+            if (!file.is_regular_file() || file.path().extension() != ".json")
+                continue;
+            Entry e;
+            e.code = file.path().stem().wstring();
+            e.size = file.file_size();
+            e.time = uint64_t(file.last_write_time().time_since_epoch().count());
+            scanned.push_back(std::move(e));
+        }
+        return scanned;
+    }
+
+    // 打开语言文件读取 language_info.name（LanguageManager::getLanguageNameFromFile）
+    std::wstring readName(const fs::path& dir, const std::wstring& code)
+    {
+        std::ifstream file(dir / (code + L".json"), std::ios::binary);
+        std::string value;
+        if (!LocaleParser::findString(file, "language_info.name", value))
+            return std::wstring();
+        return Foundation::Json::toWide(value);
+    }
+
+    // 按程序中的顺序：扫描目录、读取并合并清单、为没有名称的语言文件读取名称、保存清单
+    std::vector<Entry> startup(const fs::path& dir, const fs::path& manifestPath, size_t& namesRead)
+    {
+        std::vector<Entry> locales;
+        if (!LocaleManifest::parse(readAll(manifestPath), locales))
+            locales.clear();
+        bool changed = LocaleManifest::merge(locales, scan(dir));
+        namesRead = 0;
+        for (Entry& e : locales) {
+            if (!e.named) {
+                e.name = readName(dir, e.code);
+                e.named = true;
+                ++namesRead;
+            }
+        }
+        if (changed)
+            std::ofstream(manifestPath, std::ios::binary) << LocaleManifest::format(locales);
+        return locales;
+    }
+
+    template <typename F>
+    double bestUs(int runs, int repeat, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i)
+                f();
+            best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeat);
+        }
+        return best;
+    }
+
+    void testLocales(const fs::path& dir)
+    {
+        fs::path manifestPath = fs::temp_directory_path() / "LocaleManifestTest.manifest";
+        std::error_code ec;
+        fs::remove(manifestPath, ec);
+
+        size_t namesRead = 0;
+        std::vector<Entry> first = startup(dir, manifestPath, namesRead);
+        check(!first.empty() && namesRead == first.size(), "locales: first start reads every name", dir.string());
+        size_t named = 0;
+        for (const Entry& e : first)
+            named += !e.name.empty();
+        check(named == first.size(), "locales: every locale has a name");
+
+        std::vector<Entry> second = startup(dir, manifestPath, namesRead);
+        check(namesRead == 0 && same(first, second), "locales: next start reads only the manifest");
+
+        // 基准：列出语言时的名称
+        std::vector<Entry> scanned = scan(dir);
+        size_t sink = 0;
+        double filesUs = bestUs(7, 100, [&] {
+            for (const Entry& e : scanned)
+                sink += readName(dir, e.code).size();
+        });
+        double manifestUs = bestUs(7, 100, [&] {
+            std::vector<Entry> locales;
+            LocaleManifest::parse(readAll(manifestPath), locales);
+            sink += locales.size();
+        });
+        fs::remove(manifestPath, ec);
+
+        std::printf("%zu locale names: open each locale file %.1f us, read the manifest %.1f us\n",
+                    scanned.size(), filesUs, manifestUs);
+        check(sink > 0, "bench: names read");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    fs::path dir = argc > 1 ? argv[1] : "../../assets/locales";
+
+    testFormat();
+    testParse();
+    testMerge();
+    testLocales(dir);
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
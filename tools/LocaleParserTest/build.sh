@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建语言文件解析测试与基准（system/locale_parser.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LocaleParserTest main.cpp
@@ -0,0 +1,357 @@
+// LocaleParserTest：语言文件解析器的一致性测试与吞吐量基准。
+//
+// 一致性：LocaleParser::flatten / split / findString（include/system/locale_parser.h）
+// 对任意空白、转义、\u 转义（包括代理对）、BOM、非字符串值、数组和嵌套对象的处理，
+// 错误的 JSON 被拒绝，assets/locales 下的全部语言文件都能解析并读出语言名称。
+// 基准：旧的 LanguageManager::parseJsonFile（getline 逐行读取，每个键值单独转换为UTF-16）
+// 与现在的做法（单遍展开为字符串池，整体转换一次）解析同一文件到键值表的耗时，
+// 并检查两者读出的内容相同。
+//
+// 用法：
+//   LocaleParserTest [语言文件目录]      默认为 ../../assets/locales
+//
+
+#include "system/locale_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    typedef std::map<std::string, std::string> Flat;
+
+    // 展开为有序的键值表，出错时返回false并设置error
+    bool flatten(const std::string& json, Flat& out, std::string* error = nullptr)
+    {
+        std::string pool;
+        std::string err;
+        out.clear();
+        long count = LocaleParser::flatten(json.data(), json.size(), pool, err);
+        if (count < 0) {
+            if (error)
+                *error = err;
+            return false;
+        }
+        LocaleParser::split(std::string_view(pool), [&](std::string_view key, std::string_view value) {
+            out.emplace(std::string(key), std::string(value));
+        });
+        return true;
+    }
+
+    Flat flat(const std::string& json)
+    {
+        Flat out;
+        std::string error;
+        check(flatten(json, out, &error), "parse", json + " -> " + error);
+        return out;
+    }
+
+    bool findString(const std::string& json, const char* key, std::string& value)
+    {
+        std::istringstream in(json);
+        return LocaleParser::findString(in, key, value);
+    }
+
+    std::string readAll(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    const char* const LOCALES[] = { "en_US", "zh_CN", "ja_JP", "de_DE", "fr_FR" };
+
+    void testConformance(const std::string& dir)
+    {
+        // 嵌套对象展开为点分键，同一层的后续键不受内层影响
+        Flat m = flat("{\"a\":\"1\",\"b\":{\"c\":\"2\",\"d\":{\"e\":\"3\"}},\"f\":\"4\"}");
+        check(m == Flat{ { "a", "1" }, { "b.c", "2" }, { "b.d.e", "3" }, { "f", "4" } }, "nested keys");
+        m = flat("{\"deep\":{\"a\":{\"b\":{\"c\":{\"d\":\"e\"}}},\"after\":\"z\"}}");
+        check(m["deep.a.b.c.d"] == "e" && m["deep.after"] == "z", "path truncated after object");
+
+        // 任意空白和换行，空对象
+        m = flat(" \r\n\t{ \"a\" \n:\n \"x\" , \"o\" : { } , \"p\":{\"q\"   :\"y\"}}\n\n");
+        check(m == Flat{ { "a", "x" }, { "p.q", "y" } }, "whitespace");
+        m = flat("{\"a\":\"x\",\"b\":{\"c\":\"y\"}}");
+        check(m.size() == 2, "minified");
+
+        // 转义
+        m = flat("{\"s\":\"q\\\"b\\\\s\\/t\\b\\f\\n\\r\\tz\"}");
+        check(m["s"] == "q\"b\\s/t\b\f\n\r\tz", "escapes");
+        m = flat("{\"u\":\"\\u00e9\\u4e2d\\ud83d\\ude00\"}");
+        check(m["u"] == "\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80", "unicode escapes and surrogate pair");
+        m = flat("{\"k\\u002ey\":\"v\"}");
+        check(m.count("k.y") == 1, "escaped key");
+        // 值中的 \0 会破坏字符串池的分隔，被丢弃
+        m = flat("{\"nul\":\"a\\u0000b\"}");
+        check(m["nul"] == "ab", "nul dropped");
+
+        // UTF-8 原样保留，BOM 被跳过
+        m = flat("{\"utf8\":\"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E Fran\xC3\xA7" "ais\"}");
+        check(m["utf8"] == "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E Fran\xC3\xA7" "ais", "utf-8");
+        m = flat("\xEF\xBB\xBF{\"bom\":\"ok\"}");
+        check(m["bom"] == "ok", "bom");
+
+        // 只收集字符串值：数字、布尔、null、数组被跳过
+        m = flat("{\"n\":1,\"t\":true,\"f\":false,\"z\":null,\"arr\":[1,{\"x\":\"y\"},[\"s\"]],\"s\":\"v\",\"e\":-1.5e+10}");
+        check(m == Flat{ { "s", "v" } }, "non-string values skipped");
+
+        // 重复的键以第一个为准；带点的键与嵌套键并存
+        m = flat("{\"dup\":\"1\",\"dup\":\"2\"}");
+        check(m["dup"] == "1", "duplicate key");
+        m = flat("{\"a.b\":\"dotted\",\"a\":{\"c\":\"x\"}}");
+        check(m["a.b"] == "dotted" && m["a.c"] == "x", "dotted key");
+
+        // 错误的 JSON 被拒绝
+        const char* const bad[] = {
+            "", "[]", "\"s\"", "{", "{\"a\"}", "{\"a\":}", "{\"a\":\"x\",}", "{\"a\":\"x\"} {}",
+            "{\"a\":'x'}", "{\"a\":\"x\n\"}", "{\"a\":\"\\x\"}", "{\"a\":\"\\ud800\"}", "{\"a\":tru}",
+            "{\"a\":\"x\" \"b\":\"y\"}", "{a:\"x\"}", "{\"a\":01x}", "{\"a\":[1,2}", "{\"a\":\"unterminated}",
+        };
+        for (const char* json : bad) {
+            Flat out;
+            check(!flatten(json, out), "rejected", json);
+        }
+
+        // findString 只取目标路径上的值
+        std::string value;
+        check(findString("{\"language_info\":{\"code\":\"x\",\"name\":\"Deutsch\"},\"dialogs\":{\"name\":\"no\"}}",
+            "language_info.name", value) && value == "Deutsch", "findString");
+        check(findString("{\"a\":{\"language_info\":{\"name\":\"no\"}},"
+            "\"language_info\":{\"x\":[1,{\"name\":\"no\"}],\"name\":\"yes\"}}",
+            "language_info.name", value) && value == "yes", "findString skips other paths");
+        check(!findString("{\"language_info\":{\"names\":\"no\"}}", "language_info.name", value),
+            "findString prefix is not a match");
+        check(!findString("{\"language_info\":{\"name\":1}}", "language_info.name", value),
+            "findString needs a string");
+
+        // 实际的语言文件
+        for (const char* locale : LOCALES) {
+            std::string path = dir + "/" + locale + ".json";
+            std::string json = readAll(path);
+            check(!json.empty(), "read locale", path);
+            Flat out;
+            std::string error;
+            check(flatten(json, out, &error), "parse locale", path + " " + error);
+            check(out.count("language_info.name") == 1, "locale has a name", path);
+            std::ifstream file(path, std::ios::binary);
+            std::string name;
+            check(LocaleParser::findString(file, "language_info.name", name) && name == out["language_info.name"],
+                "findString in locale", path);
+        }
+    }
+
+    // 旧的 LanguageManager::parseJsonFile，只把字符串转换换成标准库实现。
+    // 要求每行一个键，值中只处理 \n 和 \r\n 转义
+    void oldParse(std::istream& file, std::unordered_map<std::wstring, std::wstring>& strings)
+    {
+        auto trimString = [](std::string& str) {
+            str.erase(0, str.find_first_not_of(" \t\r\n"));
+            str.erase(str.find_last_not_of(" \t\r\n") + 1);
+        };
+        auto extractJsonValue = [](const std::string& line, size_t colonPos) {
+            std::string value = line.substr(colonPos + 1);
+            value.erase(0, value.find_first_not_of(" \t\""));
+            if (!value.empty() && value.back() == ',')
+                value.pop_back();
+            if (!value.empty() && value.back() == '\"')
+                value.pop_back();
+            return value;
+        };
+        auto processEscapeSequences = [](std::wstring& str) {
+            size_t pos = 0;
+            while ((pos = str.find(L"\\r\\n", pos)) != std::wstring::npos) {
+                str.replace(pos, 4, L"\r\n");
+                pos += 2;
+            }
+            pos = 0;
+            while ((pos = str.find(L"\\n", pos)) != std::wstring::npos) {
+                str.replace(pos, 2, L"\n");
+                pos += 1;
+            }
+        };
+        using Foundation::Json::toWide;
+
+        strings.clear();
+        std::string line;
+        std::vector<std::wstring> keyStack;
+        while (std::getline(file, line)) {
+            trimString(line);
+            if (line.empty() || line == "{")
+                continue;
+            if (line == "}" || line == "},") {
+                if (!keyStack.empty())
+                    keyStack.pop_back();
+                continue;
+            }
+            if (line.back() == '{') {
+                keyStack.push_back(toWide(line.substr(1, line.find('\"', 1) - 1)));
+                continue;
+            }
+            size_t colonPos = line.find(':');
+            if (colonPos != std::string::npos) {
+                std::string key = line.substr(1, line.find('\"', 1) - 1);
+                std::string value = extractJsonValue(line, colonPos);
+                std::wstring fullKey;
+                if (!keyStack.empty()) {
+                    for (size_t i = 0; i < keyStack.size(); ++i) {
+                        if (i > 0)
+                            fullKey += L".";
+                        fullKey += keyStack[i];
+                    }
+                    fullKey += L"." + toWide(key);
+                }
+                else {
+                    fullKey = toWide(key);
+                }
+                std::wstring wvalue = toWide(value);
+                processEscapeSequences(wvalue);
+                strings[fullKey] = wvalue;
+            }
+        }
+    }
+
+    // 现在的做法（LocaleTable::compile）：展开为字符串池，整体转换一次，再逐项取出
+    void newParse(const std::string& data, std::unordered_map<std::wstring, std::wstring>& strings)
+    {
+        std::string pool;
+        std::string error;
+        long count = LocaleParser::flatten(data.data(), data.size(), pool, error);
+        strings.clear();
+        if (count < 0)
+            return;
+        std::wstring wide = Foundation::Json::toWide(pool);
+        strings.reserve(size_t(count));
+        LocaleParser::split(std::wstring_view(wide), [&](std::wstring_view key, std::wstring_view value) {
+            strings.emplace(std::wstring(key), std::wstring(value));
+        });
+    }
+
+    // 直接读取字符串内容的流缓冲区
+    class MemoryBuf : public std::streambuf {
+    public:
+        explicit MemoryBuf(const std::string& data)
+        {
+            char* p = const_cast<char*>(data.data());
+            setg(p, p, p + data.size());
+        }
+    };
+
+    template<class F>
+    double bestMs(int runs, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = (std::min)(best, ms);
+        }
+        return best;
+    }
+
+    // 每行一个键的大文件：20 节 x 20 小节 x 100 个键，混合中英文和 \n 转义
+    std::string makeLargeLocale()
+    {
+        std::string s = "{\n  \"language_info\": {\n    \"code\": \"xx\",\n    \"name\": \"Synthetic\"\n  },\n";
+        for (int a = 0; a < 20; ++a) {
+            s += "  \"section" + std::to_string(a) + "\": {\n";
+            for (int b = 0; b < 20; ++b) {
+                s += "    \"group" + std::to_string(b) + "\": {\n";
+                for (int c = 0; c < 100; ++c) {
+                    s += "      \"key_" + std::to_string(c) + "\": \"Value \xE5\x80\xBC " + std::to_string(c) +
+                        " with some longer text\\n second line\"" + (c < 99 ? ",\n" : "\n");
+                }
+                s += std::string("    }") + (b < 19 ? ",\n" : "\n");
+            }
+            s += std::string("  }") + (a < 19 ? ",\n" : "\n");
+        }
+        s += "}\n";
+        return s;
+    }
+
+    void benchmarkOne(const std::string& name, const std::string& data, int runs, int repeat)
+    {
+        std::unordered_map<std::wstring, std::wstring> oldStrings, newStrings;
+        double oldMs = bestMs(runs, [&] {
+            for (int i = 0; i < repeat; ++i) {
+                std::istringstream in(data);
+                oldParse(in, oldStrings);
+            }
+        }) / repeat;
+        double newMs = bestMs(runs, [&] {
+            for (int i = 0; i < repeat; ++i)
+                newParse(data, newStrings);
+        }) / repeat;
+        check(oldStrings == newStrings, "old and new parsers agree", name);
+
+        double mb = data.size() / 1e6;
+        std::printf("%-14s %9zu %7zu | %10.1f %8.1f | %10.1f %8.1f\n", name.c_str(), data.size(), newStrings.size(),
+            oldMs * 1000, mb / (oldMs / 1000), newMs * 1000, mb / (newMs / 1000));
+    }
+
+    void benchmark(const std::string& dir)
+    {
+        std::printf("%-14s %9s %7s | %10s %8s | %10s %8s\n", "file", "bytes", "keys", "old us", "MB/s", "new us", "MB/s");
+        for (const char* locale : LOCALES)
+            benchmarkOne(std::string(locale) + ".json", readAll(dir + "/" + locale + ".json"), 7, 100);
+        std::string large = makeLargeLocale();
+        benchmarkOne("synthetic", large, 7, 1);
+
+        // 压缩成一行的文件只有新的解析器能读取
+        std::string minified;
+        for (char ch : large) {
+            if (ch != '\n' && ch != ' ')
+                minified += ch;
+        }
+        std::string pool;
+        std::string error;
+        long count = 0;
+        double flattenMs = bestMs(7, [&] {
+            count = LocaleParser::flatten(minified.data(), minified.size(), pool, error);
+        });
+        check(count == 40002, "minified synthetic keys");
+        std::printf("minified synthetic %.2f MB: flatten %.1f ms (%.0f MB/s)\n",
+            minified.size() / 1e6, flattenMs, minified.size() / 1e3 / flattenMs);
+
+        // 列出语言时只读取语言名称，流直接读取内存中的文件内容，不复制
+        double findUs = bestMs(7, [&] {
+            for (int i = 0; i < 1000; ++i) {
+                MemoryBuf buf(large);
+                std::istream in(&buf);
+                std::string value;
+                LocaleParser::findString(in, "language_info.name", value);
+            }
+        });
+        std::printf("findString(language_info.name) on synthetic: %.2f us\n", findUs);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string dir = argc > 1 ? argv[1] : "../../assets/locales";
+
+    testConformance(dir);
+    benchmark(dir);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建二进制日志解码工具（system/log_binary.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LogDecoder main.cpp
@@ -0,0 +1,159 @@
+// LogDecoder：二进制日志解码工具。
+//
+// 读取 TinyPin 写入的结构化日志（[Debug] BinaryLog=1 时的 log\tinypin_*.tplog），
+// 按每个调用点登记的格式字符串把记录还原为与文本日志相同格式的UTF-8文本。
+// 只依赖 include/system/log_binary.h，不依赖 Windows。
+//
+// 用法：
+//   LogDecoder [--sites] <日志文件>...
+//
+
+#include "system/log_binary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    struct Site {
+        uint8_t level = 0;
+        uint32_t line = 0;
+        std::string file;
+        std::string format;
+        uint64_t count = 0;
+    };
+
+    // 1970年起的天数转换为年月日
+    void civilFromDays(int64_t days, int& year, unsigned& month, unsigned& day)
+    {
+        days += 719468;
+        int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        unsigned doe = unsigned(days - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = int(yoe + era * 400 + (month <= 2));
+    }
+
+    // 与文本日志相同的时间格式：YYYY-MM-DD HH:MM:SS.mmm
+    void appendTime(std::string& out, int64_t ticks)
+    {
+        int64_t ms = ticks / 10000;
+        int64_t secs = ms / 1000;
+        int64_t days = secs / 86400;
+        if (secs % 86400 < 0)
+            --days;
+        int64_t rem = secs - days * 86400;
+        int year;
+        unsigned month, day;
+        civilFromDays(days, year, month, day);
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d:%02d.%03d", year, month, day,
+            int(rem / 3600), int(rem / 60 % 60), int(rem % 60), int(((ms % 1000) + 1000) % 1000));
+        out += buf;
+    }
+
+    bool decode(const char* path, bool listSites)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "%s: cannot open\n", path);
+            return false;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        BinaryLog::Reader reader(data.data(), data.size());
+        if (!reader.readHeader()) {
+            std::fprintf(stderr, "%s: not a TinyPin binary log\n", path);
+            return false;
+        }
+        const int64_t offset = int64_t(reader.utcOffset()) * 600000000;
+
+        std::unordered_map<uint32_t, Site> sites;
+        std::string line;
+        uint64_t events = 0;
+        BinaryLog::Record rec;
+        while (reader.next(rec)) {
+            if (rec.type == BinaryLog::RecordType::Site) {
+                Site& site = sites[rec.id];
+                site.level = rec.level;
+                site.line = rec.line;
+                site.file.assign(rec.file);
+                site.format.assign(rec.format);
+                continue;
+            }
+
+            ++events;
+            auto it = sites.find(rec.id);
+            if (it != sites.end())
+                ++it->second.count;
+            if (listSites)
+                continue;
+
+            line.clear();
+            appendTime(line, rec.time + offset);
+            if (it == sites.end()) {
+                line += " [?] <unknown site " + std::to_string(rec.id) + ">";
+            }
+            else {
+                line += " [";
+                line += it->second.level < BinaryLog::LEVEL_COUNT ? BinaryLog::LEVEL_NAMES[it->second.level] : "?";
+                line += "] ";
+                BinaryLog::render(it->second.format, rec.args, rec.argsSize, line);
+            }
+            line += '\n';
+            std::fwrite(line.data(), 1, line.size(), stdout);
+        }
+        if (!reader.atEnd())
+            std::fprintf(stderr, "%s: truncated record at end of file\n", path);
+
+        if (listSites) {
+            // 按调用次数从多到少列出调用点，用于找出最频繁的日志
+            std::vector<std::pair<uint32_t, const Site*>> order;
+            for (const auto& entry : sites)
+                order.emplace_back(entry.first, &entry.second);
+            std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+                return a.second->count != b.second->count ? a.second->count > b.second->count : a.first < b.first;
+            });
+            std::printf("%s: %llu events, %zu sites, %zu bytes\n", path,
+                (unsigned long long)events, sites.size(), data.size());
+            for (const auto& entry : order) {
+                const Site& site = *entry.second;
+                std::printf("%10llu  %s:%u  [%s] %s\n", (unsigned long long)site.count, site.file.c_str(), site.line,
+                    site.level < BinaryLog::LEVEL_COUNT ? BinaryLog::LEVEL_NAMES[site.level] : "?",
+                    site.format.c_str());
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool listSites = false;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sites") == 0)
+            listSites = true;
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "usage: LogDecoder [--sites] <file.tplog>...\n");
+        return 2;
+    }
+
+    bool ok = true;
+    for (const char* path : files)
+        ok = decode(path, listSites) && ok;
+    return ok ? 0 : 1;
+}
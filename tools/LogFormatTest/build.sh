@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建日志宏和格式化测试（system/log_format.h、system/log_level.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LogFormatTest main.cpp
@@ -0,0 +1,251 @@
+// LogFormatTest：日志宏和日志格式化的测试与基准。
+//
+// 一致性：LogFormat::format 直接格式化的文本日志与二进制日志经 BinaryLog::render
+// 解码的结果必须相同（LogDecoder 与文本日志输出一致），另有一组固定的期望输出。
+// 基准：比较旧的做法（先构造宽字符串再检查级别）与 system/log_level.h 中的日志宏
+// 在级别关闭（运行时关闭、编译时去除）和开启时每次调用的耗时。
+// 日志宏展开为对 Logger 的调用，这里提供只在内存中格式化的 Logger，
+// 测量的是宏和格式化本身，不包括写入线程和文件。
+//
+// 用法：
+//   LogFormatTest [每项基准的调用次数]
+//
+
+#include "system/log_format.h"
+#include "system/log_level.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// 日志宏使用的 Logger：与 system/logger.h 中的接口相同，格式化到内存后丢弃
+class Logger {
+public:
+    static Logger& getInstance()
+    {
+        static Logger instance;
+        return instance;
+    }
+
+    static bool isEnabled(LogLevel level)
+    {
+        return int(level) >= s_enabledLevel.load(std::memory_order_relaxed);
+    }
+
+    static void setLevel(LogLevel level) { s_enabledLevel.store(int(level), std::memory_order_relaxed); }
+
+    void debug(const std::wstring& message) { log(LogLevel::DEBUG, message); }
+    void info(const std::wstring& message) { log(LogLevel::INFO, message); }
+    void warning(const std::wstring& message) { log(LogLevel::WARNING, message); }
+    void error(const std::wstring& message) { log(LogLevel::ERR, message); }
+    void fatal(const std::wstring& message) { log(LogLevel::FATAL, message); }
+
+    template <typename... Args>
+    void event(LogSite&, const char* format, const Args&... args)
+    {
+        m_line.clear();
+        LogFormat::format(m_line, format, args...);
+        m_bytes += m_line.size();
+    }
+
+    template <typename... Args>
+    void limitedEvent(LogSite& site, const char* format, const Args&... args)
+    {
+        event(site, format, args...);
+    }
+
+    size_t bytes() const { return m_bytes; }
+
+private:
+    static std::atomic<int> s_enabledLevel;
+    std::string m_line;
+    size_t m_bytes = 0;
+
+    void log(LogLevel, const std::wstring& message)
+    {
+        m_line.clear();
+        LogFormat::appendWide(m_line, message);
+        m_bytes += m_line.size();
+    }
+};
+
+std::atomic<int> Logger::s_enabledLevel(int(LogLevel::WARNING));
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // 文本日志与二进制日志解码的结果相同，返回文本日志的结果
+    template <typename... Args>
+    std::string formatBoth(const char* format, const Args&... args)
+    {
+        std::string text;
+        LogFormat::format(text, format, args...);
+
+        uint8_t buf[BinaryLog::MAX_ARGS_SIZE];
+        BinaryLog::ArgWriter writer(buf, sizeof(buf));
+        (writer.add(args), ...);
+        std::string decoded;
+        BinaryLog::render(format, buf, writer.size(), decoded);
+
+        check(text == decoded, format, "text=\"" + text + "\" binary=\"" + decoded + "\"");
+        return text;
+    }
+
+    template <typename... Args>
+    void expect(const std::string& expected, const char* format, const Args&... args)
+    {
+        std::string text = formatBoth(format, args...);
+        check(text == expected, format, "got \"" + text + "\" expected \"" + expected + "\"");
+    }
+
+    enum class Color { Red = 2 };
+
+    void testConformance()
+    {
+        expect("plain text", "plain text");
+        expect("n=42", "n={}", 42);
+        expect("-7 7", "{} {}", -7, 7u);
+        expect("-9223372036854775808", "{}", INT64_MIN);
+        expect("18446744073709551615", "{}", UINT64_MAX);
+        expect("ff", "{:x}", 255);
+        expect("ffffffffffffffff", "{:x}", -1);
+        expect("1 0", "{} {}", true, false);
+        expect("1.5 -0.25", "{} {}", 1.5, -0.25);
+        expect("2", "{}", Color::Red);
+        expect("abc", "{}", "abc");
+        expect("", "{}", static_cast<const char*>(nullptr));
+        expect(u8"窗口: 记事本", u8"窗口: {}", L"记事本");
+        expect(u8"emoji 😀", "emoji {}", std::wstring(L"\U0001F600"));
+        expect("std string", "{} {}", std::string("std"), std::string_view("string"));
+        expect("{} {x}", "{{}} {{x}}");
+        expect("a=1 b={}", "a={} b={}", 1);
+        expect("only 1", "only {}", 1, 2, 3);
+        expect("0x1000", "{}", reinterpret_cast<const void*>(uintptr_t(0x1000)));
+        expect(u8"规则 3 匹配 \"Notepad\" 用时 0.5 ms", u8"规则 {} 匹配 \"{}\" 用时 {} ms", 3, L"Notepad", 0.5);
+
+        // 超过参数缓冲区的字符串：二进制日志截断，文本日志完整
+        std::string longText(BinaryLog::MAX_ARGS_SIZE * 2, 'x');
+        std::string text;
+        LogFormat::format(text, "{}", longText);
+        check(text == longText, "long argument is not truncated in text logs");
+
+        // 宽字符串在二进制日志中截断时不拆开代理对：截断处之前的字符完整，后面的参数不再写入
+        for (size_t prefix : { 0, 1, 2 }) {
+            std::wstring wide(prefix, L'a');
+            while (wide.size() < BinaryLog::MAX_ARGS_SIZE)
+                wide += L"\U0001F600";
+            uint8_t buf[BinaryLog::MAX_ARGS_SIZE];
+            BinaryLog::ArgWriter writer(buf, sizeof(buf));
+            writer.add(wide);
+            writer.add(1);
+            std::string decoded;
+            BinaryLog::render("{}|{}", buf, writer.size(), decoded);
+            std::string expected(prefix, 'a');
+            for (size_t units = prefix; units + 2 <= (BinaryLog::MAX_ARGS_SIZE - 4) / 2; units += 2)
+                expected += u8"\U0001F600";
+            check(decoded == expected + "|{}", "long wide argument truncated at a whole character",
+                  "got " + std::to_string(decoded.size()) + " bytes, expected " + std::to_string(expected.size() + 3));
+        }
+    }
+
+    // 旧的日志调用：参数先构造为宽字符串，调用后才检查级别
+    std::atomic<int> g_oldLevel(int(LogLevel::WARNING));
+    size_t g_oldBytes = 0;
+
+    __attribute__((noinline)) void oldLog(LogLevel level, const std::wstring& message)
+    {
+        if (int(level) < g_oldLevel.load(std::memory_order_relaxed))
+            return;
+        std::string line;
+        LogFormat::appendWide(line, message);
+        g_oldBytes += line.size();
+    }
+
+    __attribute__((noinline)) void callOld(LogLevel level, const std::wstring& name, int i)
+    {
+        oldLog(level, L"窗口: " + name + L" 编号 " + std::to_wstring(i));
+    }
+
+    __attribute__((noinline)) void callMacroInfo(const std::wstring& name, int i)
+    {
+        LOG_INFO(L"窗口: " + name + L" 编号 " + std::to_wstring(i));
+    }
+
+    __attribute__((noinline)) void callEventInfo(const std::wstring& name, int i)
+    {
+        LOGF_INFO(u8"窗口: {} 编号 {}", name, i);
+    }
+
+    __attribute__((noinline)) void callEventDebug(const std::wstring& name, int i)
+    {
+        LOGF_DEBUG(u8"窗口: {} 编号 {}", name, i);
+    }
+
+    __attribute__((noinline)) void callEventWarning(const std::wstring& name, int i)
+    {
+        LOGF_WARNING(u8"窗口: {} 编号 {}", name, i);
+    }
+
+    template <typename Fn>
+    double bestNs(int calls, Fn fn)
+    {
+        double best = 1e18;
+        for (int round = 0; round < 5; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i)
+                fn(i);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ns / calls);
+        }
+        return best;
+    }
+
+    void benchmark(int calls)
+    {
+        const std::wstring name = L"无标题 - 记事本";
+        Logger::setLevel(LogLevel::WARNING);
+        g_oldLevel = int(LogLevel::WARNING);
+
+        std::printf("LOG_MIN_LEVEL=%d，运行时级别为警告，每项 %d 次调用（5轮取最好）\n", LOG_MIN_LEVEL, calls);
+        std::printf("级别关闭的调用:\n");
+        std::printf("  旧的做法（先构造消息）      %8.1f ns\n", bestNs(calls, [&](int i) { callOld(LogLevel::INFO, name, i); }));
+        std::printf("  LOG_INFO（运行时关闭）      %8.1f ns\n", bestNs(calls, [&](int i) { callMacroInfo(name, i); }));
+        std::printf("  LOGF_INFO（运行时关闭）     %8.1f ns\n", bestNs(calls, [&](int i) { callEventInfo(name, i); }));
+        std::printf("  LOGF_DEBUG（编译时去除）    %8.1f ns\n", bestNs(calls, [&](int i) { callEventDebug(name, i); }));
+        std::printf("级别开启的调用（格式化为UTF-8日志行）:\n");
+        std::printf("  旧的做法（宽字符串再转换）  %8.1f ns\n", bestNs(calls, [&](int i) { callOld(LogLevel::WARNING, name, i); }));
+        std::printf("  LOGF_WARNING（直接格式化）  %8.1f ns\n", bestNs(calls, [&](int i) { callEventWarning(name, i); }));
+
+        // 两种做法写出的字节数相同
+        check(g_oldBytes == Logger::getInstance().bytes(), "old and new calls produce the same text");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int calls = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    if (calls <= 0) {
+        std::printf("用法: LogFormatTest [每项基准的调用次数]\n");
+        return 2;
+    }
+
+    testConformance();
+    benchmark(calls);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
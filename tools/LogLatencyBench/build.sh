@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建日志调用线程的延迟基准（生产者和写入线程使用 std::thread）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -pthread -I../../include -o LogLatencyBench main.cpp
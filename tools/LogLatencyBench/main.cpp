@@ -0,0 +1,424 @@
+// LogLatencyBench：日志调用线程的延迟基准。
+//
+// 多个生产者线程按 Logger 的做法写日志：时间和级别（LogTimestamp）、LogFormat::format 格式化、
+// 放入 Foundation::MpscRing（容量4096，满时唤醒写入线程并让出CPU），
+// 由一个写入线程按 Logger::writerThread 的策略取出（2秒写入间隔，队列积累到四分之一时提前唤醒）
+// 并复制到4 MB的缓冲区（代替映射的日志段）。Logger 依赖 Windows，这里复制了它的 push 和写入循环，
+// 队列和格式化使用 include 下的同一份代码。
+// 分别用1、4、16个生产者线程测量每次调用的耗时（p50/p99/最大值），
+// 检查写入的日志条数以及每个线程的日志顺序。
+//
+// 另外测量启用二进制日志时 Logger::event 的调用线程部分（单线程，每次调用的平均耗时）：
+// 读取时间、登记过的调用点编号和 BinaryLog::ArgWriter 编码的参数直接写入队列的槽中
+// （MpscRing::tryEmplace），与以前在栈上组装 BinaryEvent 再复制进队列的做法比较，
+// 并单独列出读取时钟的耗时。写入线程的编码不计入，检查解码结果与文本日志相同。
+//
+// 两种负载：
+//   突发：每个线程连续写 BURST 条后休眠1毫秒，队列不会写满
+//   持续：不休眠，队列写满时生产者等待写入线程
+//
+// 用法：
+//   LogLatencyBench [每个线程的日志条数]
+//
+
+#include "foundation/mpsc_ring.h"
+#include "system/log_binary.h"
+#include "system/log_format.h"
+#include "system/log_level.h"
+#include "system/log_timestamp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    const size_t BURST = 100;
+    const size_t SEGMENT_SIZE = 4 * 1024 * 1024;
+
+    // 与 Logger::LogRecord 相同
+    struct LogRecord {
+        std::string text;
+        LogLevel level = LogLevel::DEBUG;
+    };
+
+    // Logger 的文本日志部分：调用线程的 beginRecord/push 与写入线程的循环
+    class TextLogger {
+    public:
+        TextLogger() : m_queue(4096), m_segment(new char[SEGMENT_SIZE]) {}
+
+        void start() { m_writer = std::thread(&TextLogger::writerThread, this); }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_stop = true;
+            }
+            m_wake.notify_one();
+            m_writer.join();
+        }
+
+        template <typename... Args>
+        void event(LogLevel level, const char* format, const Args&... args)
+        {
+            LogRecord record;
+            beginRecord(record, level);
+            LogFormat::format(record.text, format, args...);
+            push(std::move(record));
+        }
+
+        uint64_t written() const { return m_written; }
+        uint64_t misordered() const { return m_misordered; }
+
+    private:
+        void beginRecord(LogRecord& record, LogLevel level) const
+        {
+            record.level = level;
+            record.text.clear();
+            LogTimestamp::append(record.text);
+            record.text += " [";
+            record.text += BinaryLog::LEVEL_NAMES[int(level)];
+            record.text += "] ";
+        }
+
+        void push(LogRecord&& record)
+        {
+            LogLevel level = record.level;
+            record.text += "\r\n";
+            while (!m_queue.tryPush(std::move(record))) {
+                wakeWriter();
+                std::this_thread::yield();
+            }
+            if (level >= LogLevel::ERR || m_queue.approxSize() >= m_queue.capacity() / 4) {
+                wakeWriter();
+            }
+        }
+
+        void wakeWriter()
+        {
+            m_urgent = true;
+            if (m_writerWaiting) {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_wake.notify_one();
+            }
+        }
+
+        void writerThread()
+        {
+            LogRecord record;
+            for (;;) {
+                bool stop = m_stop;
+                m_urgent = false;
+
+                uint64_t count = 0;
+                while (count < m_queue.capacity() && m_queue.tryPop(record)) {
+                    writeFile(record.text);
+                    ++count;
+                }
+                m_written += count;
+
+                if (stop && count == 0) {
+                    break;
+                }
+
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_writerWaiting = true;
+                m_wake.wait_for(lock, std::chrono::milliseconds(2000), [this] { return m_urgent || m_stop; });
+                m_writerWaiting = false;
+            }
+        }
+
+        // 复制到日志段，写满后从头开始；同时检查每个线程的序号是否连续
+        void writeFile(const std::string& text)
+        {
+            if (text.size() > SEGMENT_SIZE - m_segmentUsed) {
+                m_segmentUsed = 0;
+            }
+            std::memcpy(m_segment.get() + m_segmentUsed, text.data(), text.size());
+            m_segmentUsed += text.size();
+
+            const char* p = std::strstr(text.c_str(), "线程 ");
+            if (!p) {
+                ++m_misordered;
+                return;
+            }
+            char* end = nullptr;
+            unsigned long thread = std::strtoul(p + std::strlen("线程 "), &end, 10);
+            p = std::strstr(end, "序号 ");
+            unsigned long long seq = p ? std::strtoull(p + std::strlen("序号 "), nullptr, 10) : 0;
+            if (thread >= m_nextSeq.size()) {
+                m_nextSeq.resize(thread + 1, 0);
+            }
+            if (!p || seq != m_nextSeq[thread]) {
+                ++m_misordered;
+            }
+            m_nextSeq[thread] = seq + 1;
+        }
+
+        Foundation::MpscRing<LogRecord> m_queue;
+        std::thread m_writer;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+        std::atomic<bool> m_writerWaiting{ false };
+        std::atomic<bool> m_urgent{ false };
+        std::atomic<bool> m_stop{ false };
+
+        // 只在写入线程中使用，停止后读取
+        std::unique_ptr<char[]> m_segment;
+        size_t m_segmentUsed = 0;
+        uint64_t m_written = 0;
+        uint64_t m_misordered = 0;
+        std::vector<unsigned long long> m_nextSeq;
+    };
+
+    struct Result {
+        double p50 = 0, p99 = 0, max = 0;   // 纳秒
+    };
+
+    // 与 Logger::BinaryEvent 相同
+    struct BinaryEvent {
+        int64_t time = 0;
+        uint32_t site = 0;
+        uint16_t size = 0;
+        uint8_t args[BinaryLog::MAX_ARGS_SIZE];
+    };
+
+    // 与 Logger::currentTime 相同
+    int64_t currentTime()
+    {
+        using Ticks = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+        return std::chrono::duration_cast<Ticks>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    enum class BinaryPush {
+        Copy,           // 以前的做法：栈上的 BinaryEvent 用 tryPush 复制进队列
+        InPlace,        // Logger::event：用 tryEmplace 直接写入槽中
+        InPlaceNoClock, // 同上，但不读取时间
+    };
+
+    const char* const BINARY_FORMAT = "窗口 {} \"{}\" 进程 {} 已置顶";
+
+    template <typename... Args>
+    void fillEvent(BinaryEvent& ev, uint32_t site, int64_t time, const Args&... args)
+    {
+        ev.time = time;
+        ev.site = site;
+        BinaryLog::ArgWriter writer(ev.args, sizeof(ev.args));
+        (writer.add(args), ...);
+        ev.size = uint16_t(writer.size());
+    }
+
+    // calls 为 BATCH 的整数倍。每次连续调用 BATCH 次（队列不会写满）并计时，然后由写入线程的做法取出、编码（不计时）。
+    // 取5轮中最好的一轮，返回每次调用的纳秒数
+    double binaryPerCall(BinaryPush mode, size_t calls, std::string& lastLine)
+    {
+        const size_t BATCH = 1024;
+        Foundation::MpscRing<BinaryEvent> queue(4096);
+        BinaryLog::Writer writer;
+        const std::wstring title = L"无标题 - 记事本";
+        const void* hwnd = reinterpret_cast<const void*>(uintptr_t(0x30F2A));
+        const uint32_t site = 7;
+
+        double best = 1e18;
+        uint64_t pushed = 0, encoded = 0;
+        BinaryEvent last;
+        for (int round = 0; round < 5; ++round) {
+            double total = 0;
+            for (size_t done = 0; done < calls; done += BATCH) {
+                auto begin = Clock::now();
+                for (size_t i = 0; i < BATCH; ++i) {
+                    unsigned pid = unsigned(4242 + done + i);
+                    if (mode == BinaryPush::Copy) {
+                        BinaryEvent ev;
+                        fillEvent(ev, site, currentTime(), hwnd, title, pid);
+                        pushed += queue.tryPush(std::move(ev));
+                    } else {
+                        const bool clock = mode == BinaryPush::InPlace;
+                        pushed += queue.tryEmplace([&](BinaryEvent& ev) {
+                            fillEvent(ev, site, clock ? currentTime() : 0, hwnd, title, pid);
+                        });
+                    }
+                }
+                total += std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+
+                while (queue.tryConsume([&](const BinaryEvent& ev) {
+                    writer.writeEvent(ev.site, ev.time, ev.args, ev.size);
+                    last = ev;
+                })) {
+                    ++encoded;
+                }
+                writer.buffer().clear();
+            }
+            best = (std::min)(best, total / double(calls));
+        }
+
+        check(encoded == pushed && pushed == 5 * calls, "all binary events encoded");
+        lastLine.clear();
+        BinaryLog::render(BINARY_FORMAT, last.args, last.size, lastLine);
+        return best;
+    }
+
+    // 读取一次 Logger::currentTime 的耗时
+    double binaryClock()
+    {
+        const int count = 1000000;
+        int64_t sum = 0;
+        auto begin = Clock::now();
+        for (int i = 0; i < count; ++i) {
+            sum += currentTime();
+        }
+        auto end = Clock::now();
+        if (sum == 42)
+            std::printf("\n");
+        return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+    }
+
+    // 每个线程写 lines 条日志，返回每次调用耗时的分布
+    Result run(unsigned threads, size_t lines, bool bursts)
+    {
+        TextLogger logger;
+        logger.start();
+
+        std::vector<std::vector<uint32_t>> samples(threads);
+        std::vector<std::thread> producers;
+        std::atomic<bool> go{ false };
+        const std::wstring title = L"无标题 - 记事本";
+        for (unsigned t = 0; t < threads; ++t) {
+            producers.emplace_back([&, t] {
+                std::vector<uint32_t>& times = samples[t];
+                times.reserve(lines);
+                const void* hwnd = reinterpret_cast<const void*>(uintptr_t(0x10000 + t * 0x100));
+                while (!go) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < lines; ++i) {
+                    auto begin = Clock::now();
+                    logger.event(LogLevel::WARNING, "线程 {} 序号 {}: 窗口 {} \"{}\" 进程 {} 已置顶",
+                                 t, i, hwnd, title, 4242 + t);
+                    auto end = Clock::now();
+                    times.push_back(uint32_t((std::min)(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+                        std::chrono::nanoseconds::rep(UINT32_MAX))));
+                    if (bursts && (i + 1) % BURST == 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+            });
+        }
+        go = true;
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        logger.stop();
+
+        std::vector<uint32_t> all;
+        for (const std::vector<uint32_t>& times : samples) {
+            all.insert(all.end(), times.begin(), times.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        Result result;
+        if (!all.empty()) {
+            result.p50 = all[all.size() / 2];
+            result.p99 = all[all.size() * 99 / 100];
+            result.max = all.back();
+        }
+
+        char detail[96];
+        std::snprintf(detail, sizeof(detail), "(%u threads, %s)", threads, bursts ? "bursts" : "sustained");
+        check(logger.written() == uint64_t(threads) * lines, "all lines written", detail);
+        check(logger.misordered() == 0, "per-thread order preserved", detail);
+        return result;
+    }
+
+    // 连续两次读取时钟的耗时，测量值中包含一次
+    double clockOverhead()
+    {
+        const int count = 1000000;
+        auto begin = Clock::now();
+        for (int i = 0; i < count - 1; ++i) {
+            (void)Clock::now();
+        }
+        auto end = Clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+    }
+
+    std::string formatNs(double ns)
+    {
+        char buf[32];
+        if (ns >= 1000)
+            std::snprintf(buf, sizeof(buf), "%.1f us", ns / 1000);
+        else
+            std::snprintf(buf, sizeof(buf), "%.0f ns", ns);
+        return buf;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    if (lines == 0)
+        lines = 20000;
+
+    std::printf("LogLatencyBench: %zu lines per thread, ring capacity 4096, %u hardware threads\n",
+                lines, std::thread::hardware_concurrency());
+    std::printf("clock read: %s (included once in every sample)\n\n", formatNs(clockOverhead()).c_str());
+    std::printf("%-10s %-8s %10s %10s %10s\n", "load", "threads", "p50", "p99", "max");
+
+    for (bool bursts : { true, false }) {
+        for (unsigned threads : { 1u, 4u, 16u }) {
+            Result result = run(threads, lines, bursts);
+            std::printf("%-10s %-8u %10s %10s %10s\n", bursts ? "bursts" : "sustained", threads,
+                        formatNs(result.p50).c_str(), formatNs(result.p99).c_str(), formatNs(result.max).c_str());
+        }
+    }
+
+    // 二进制日志
+    size_t calls = (lines + 1023) / 1024 * 1024;
+    std::printf("\nbinary LOG_EVENT, 1 thread, mean per call (writer encoding not included):\n");
+    struct { BinaryPush mode; const char* name; } modes[] = {
+        { BinaryPush::Copy, "stack event + tryPush copy" },
+        { BinaryPush::InPlace, "tryEmplace in place" },
+        { BinaryPush::InPlaceNoClock, "tryEmplace, no clock read" },
+    };
+    for (const auto& m : modes) {
+        std::string line;
+        double ns = binaryPerCall(m.mode, calls, line);
+        std::printf("  %-28s %10s\n", m.name, formatNs(ns).c_str());
+
+        std::string expected;
+        LogFormat::format(expected, BINARY_FORMAT, reinterpret_cast<const void*>(uintptr_t(0x30F2A)),
+                          std::wstring(L"无标题 - 记事本"), unsigned(4242 + calls - 1));
+        check(line == expected, "binary event decodes like the text log",
+              "\"" + line + "\"");
+    }
+    std::printf("  %-28s %10s\n", "clock read (system_clock)", formatNs(binaryClock()).c_str());
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建日志段文件名和保留策略的测试与基准（system/log_segments.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LogSegmentTest main.cpp
@@ -0,0 +1,233 @@
+// LogSegmentTest：文本日志段文件名和保留策略（system/log_segments.h）的测试与基准。
+//
+// 一致性：日志段文件名的解析（各种不是日志段的文件名被拒绝），按启动时间和段号排序，
+// 删除旧日志段时只保留指定数量、总是保留当前的日志段，
+// 一次运行的日志段全部删除后才删除它的二进制日志。
+// 基准：日志目录中有 2000 个日志段时，扫描目录并按文件名排序（Logger::scanLogFiles），
+// 与旧的 cleanupOldLogFiles 在比较函数中读取修改时间排序的耗时。
+//
+// 用法：
+//   LogSegmentTest [日志段数]
+//
+
+#include "system/log_segments.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    using LogSegments::FileName;
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    std::string narrow(const std::wstring& s)
+    {
+        return std::string(s.begin(), s.end());
+    }
+
+    void testParse()
+    {
+        struct Case { const wchar_t* name; bool valid; uint64_t time; uint32_t segment; };
+        const Case cases[] = {
+            { L"tinypin_20240305_142233.log", true, 20240305142233ull, 0 },
+            { L"tinypin_20240305_142233_1.log", true, 20240305142233ull, 1 },
+            { L"tinypin_20240305_142233_1234567.log", true, 20240305142233ull, 1234567 },
+            { L"tinypin_20240305_142233_12345678.log", false, 0, 0 },
+            { L"tinypin_20240305_142233_.log", false, 0, 0 },
+            { L"tinypin_20240305_142233-1.log", false, 0, 0 },
+            { L"tinypin_20240305_142233_1a.log", false, 0, 0 },
+            { L"tinypin_20240305-142233.log", false, 0, 0 },
+            { L"tinypin_2024030X_142233.log", false, 0, 0 },
+            { L"tinypin_20240305_142233.tplog", false, 0, 0 },
+            { L"tinypin_20240305_142233.LOG", false, 0, 0 },
+            { L"TinyPin_20240305_142233.log", false, 0, 0 },
+            { L"tinypin_2024.log", false, 0, 0 },
+            { L"", false, 0, 0 },
+        };
+        for (const Case& c : cases) {
+            FileName file;
+            bool valid = LogSegments::parse(c.name, file);
+            check(valid == c.valid && (!valid || (file.time == c.time && file.segment == c.segment && file.name == c.name)),
+                  "parse", narrow(c.name));
+        }
+    }
+
+    FileName segment(uint64_t time, uint32_t n)
+    {
+        std::wstring clock = std::to_wstring(time % 1000000);
+        std::wstring name = L"tinypin_" + std::to_wstring(time / 1000000) + L"_" + std::wstring(6 - clock.size(), L'0') + clock;
+        if (n)
+            name += L"_" + std::to_wstring(n);
+        FileName file;
+        LogSegments::parse(name + L".log", file);
+        return file;
+    }
+
+    std::vector<std::wstring> names(const std::deque<FileName>& files)
+    {
+        std::vector<std::wstring> out;
+        for (const FileName& file : files)
+            out.push_back(file.name);
+        return out;
+    }
+
+    void testOrder()
+    {
+        // 段号按数值排序（按文件名字符串排序时 _10 在 _2 之前）
+        std::vector<FileName> files = { segment(20240306090000ull, 10), segment(20240305142233ull, 2),
+                                        segment(20240306090000ull, 2), segment(20240305142233ull, 0),
+                                        segment(20240306090000ull, 0) };
+        std::sort(files.begin(), files.end(), LogSegments::older);
+        std::vector<std::pair<uint64_t, uint32_t>> order;
+        for (const FileName& file : files)
+            order.emplace_back(file.time, file.segment);
+        check(order == std::vector<std::pair<uint64_t, uint32_t>>{ { 20240305142233ull, 0 }, { 20240305142233ull, 2 },
+                                                                   { 20240306090000ull, 0 }, { 20240306090000ull, 2 },
+                                                                   { 20240306090000ull, 10 } },
+              "order: by start time, then by segment number");
+    }
+
+    void testTrim()
+    {
+        const uint64_t runA = 20240301080000ull, runB = 20240302080000ull, current = 20240303080000ull;
+        auto make = [&] {
+            return std::deque<FileName>{ segment(runA, 0), segment(runA, 1), segment(runA, 2),
+                                         segment(runB, 0), segment(runB, 1), segment(current, 0) };
+        };
+
+        std::vector<std::wstring> removed, retired;
+        auto remove = [&removed](const std::wstring& name) { removed.push_back(name); };
+        auto retire = [&retired](const std::wstring& stem) { retired.push_back(stem); };
+
+        std::deque<FileName> files = make();
+        LogSegments::trim(files, 2, remove, retire);
+        check(names(files) == std::vector<std::wstring>{ segment(runB, 1).name, segment(current, 0).name },
+              "trim: newest segments kept");
+        check(removed == std::vector<std::wstring>{ segment(runA, 0).name, segment(runA, 1).name, segment(runA, 2).name,
+                                                    segment(runB, 0).name },
+              "trim: oldest segments removed first");
+        check(retired == std::vector<std::wstring>{ L"tinypin_20240301_080000" },
+              "trim: binary logs retired only after the run's last segment");
+
+        // 再删除一段：第二次运行的日志段也全部删除
+        removed.clear();
+        retired.clear();
+        LogSegments::trim(files, 1, remove, retire);
+        check(retired == std::vector<std::wstring>{ L"tinypin_20240302_080000" } && files.size() == 1,
+              "trim: second run retired");
+
+        // 至少保留当前的日志段
+        files = make();
+        removed.clear();
+        retired.clear();
+        LogSegments::trim(files, 0, remove, retire);
+        check(names(files) == std::vector<std::wstring>{ segment(current, 0).name } && removed.size() == 5
+              && retired.size() == 2, "trim: current segment always kept");
+
+        files = make();
+        removed.clear();
+        LogSegments::trim(files, 6, remove, retire);
+        check(files.size() == 6 && removed.empty(), "trim: nothing removed within the limit");
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // 在临时目录中创建日志段（每次运行 10 段），修改时间与文件名的顺序一致
+    void bench(size_t count)
+    {
+        fs::path dir = fs::temp_directory_path() / "LogSegmentTest";
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+        fs::create_directories(dir);
+
+        const auto base = fs::file_time_type::clock::now() - std::chrono::hours(24 * 365);
+        std::vector<std::wstring> created;
+        for (size_t i = 0; i < count; ++i) {
+            size_t run = i / 10;                                    // 每次运行相隔一分钟
+            uint64_t time = 20240101000000ull + (run / 60) * 10000 + (run % 60) * 100;
+            FileName file = segment(time, uint32_t(i % 10));
+            fs::path path = dir / file.name;
+            std::ofstream(path) << "x";
+            fs::last_write_time(path, base + std::chrono::seconds(i));
+            created.push_back(file.name);
+        }
+        std::ofstream(dir / "tinypin_20240101_000000.tplog") << "x";
+
+        // 现在的做法：只读取目录项中的文件名
+        auto begin = Clock::now();
+        std::deque<FileName> files;
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            FileName file;
+            if (LogSegments::parse(entry.path().filename().wstring(), file))
+                files.push_back(std::move(file));
+        }
+        std::sort(files.begin(), files.end(), LogSegments::older);
+        double byName = msSince(begin);
+
+        // 旧的做法：比较函数中读取修改时间（最新的在前）
+        begin = Clock::now();
+        std::vector<fs::directory_entry> entries;
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                std::wstring name = entry.path().filename().wstring();
+                if (name.length() > 12 && name.substr(0, 8) == L"tinypin_" && name.substr(name.length() - 4) == L".log")
+                    entries.push_back(entry);
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const fs::directory_entry& a, const fs::directory_entry& b) {
+            return fs::last_write_time(a) > fs::last_write_time(b);
+        });
+        double byTime = msSince(begin);
+
+        std::vector<std::wstring> newest;
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+            newest.push_back(it->path().filename().wstring());
+        check(names(files) == created, "bench: segments sorted by name");
+        check(newest == created, "bench: same order as by modification time");
+        fs::remove_all(dir, ec);
+
+        std::printf("\n%zu segments:\n", count);
+        std::printf("  %-40s %8.2f ms\n", "scan and sort by file name", byName);
+        std::printf("  %-40s %8.2f ms\n", "scan and sort by last_write_time (old)", byTime);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testParse();
+    testOrder();
+    testTrim();
+
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    bench(count ? count : 2000);
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
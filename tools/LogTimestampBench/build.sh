@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建日志时间戳基准（system/log_timestamp.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o LogTimestampBench main.cpp
@@ -0,0 +1,147 @@
+// LogTimestampBench：日志时间戳格式化的测试与基准。
+//
+// 检查 LogTimestamp::Cache 的输出与逐次格式化的结果相同（同一秒内、跨秒、跨日、时间回拨），
+// 再比较旧的做法（wstringstream 加 setw/setfill 格式化宽字符串，再转换为UTF-8）
+// 与按秒缓存、只改写毫秒数字的做法每次调用的耗时。
+//
+// 用法：
+//   LogTimestampBench [调用次数]
+//
+
+#include "system/log_timestamp.h"
+#include "system/log_format.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // 旧的 Logger::getCurrentTimeString()，时间由参数给出
+    std::wstring oldTimeString(long long ms)
+    {
+        std::time_t time = static_cast<std::time_t>(ms / 1000);
+        std::tm tm_buf = {};
+        localtime_r(&time, &tm_buf);
+        std::wstringstream ss;
+        ss << std::setfill(L'0')
+           << std::setw(4) << (tm_buf.tm_year + 1900) << L'-'
+           << std::setw(2) << (tm_buf.tm_mon + 1) << L'-'
+           << std::setw(2) << tm_buf.tm_mday << L' '
+           << std::setw(2) << tm_buf.tm_hour << L':'
+           << std::setw(2) << tm_buf.tm_min << L':'
+           << std::setw(2) << tm_buf.tm_sec << L'.'
+           << std::setw(3) << (ms % 1000);
+        return ss.str();
+    }
+
+    // 旧的做法写入日志行：宽字符串转换为UTF-8
+    std::string oldTimestamp(long long ms)
+    {
+        std::string out;
+        LogFormat::appendWide(out, oldTimeString(ms));
+        return out;
+    }
+
+    void testCache()
+    {
+        LogTimestamp::Cache cache;
+        // 2026-01-01 附近的本地时间，毫秒覆盖 0、个位、十位、百位和 999
+        const long long base = 1767225600000LL;
+        const long long offsets[] = {
+            0, 1, 9, 10, 99, 100, 999, 1000, 1001, 59999, 60000, 3599999, 3600000,
+            86399999, 86400000, 500, 400, 86400000 * 31LL + 123,
+            -86400000 * 200LL + 7,   // 时间回拨到半年前（跨夏令时）
+        };
+        for (long long offset : offsets) {
+            long long ms = base + offset;
+            std::string text;
+            cache.append(text, ms);
+            std::string expected = oldTimestamp(ms);
+            check(text == expected, "cached timestamp", text + " != " + expected);
+            check(text.size() == LogTimestamp::LENGTH, "timestamp length");
+        }
+
+        // 追加而不是覆盖
+        std::string line = "prefix ";
+        cache.append(line, base);
+        check(line == "prefix " + oldTimestamp(base), "append keeps existing text");
+
+        // 当前时间
+        std::string now;
+        LogTimestamp::append(now);
+        check(now.size() == LogTimestamp::LENGTH && now[4] == '-' && now[10] == ' ' && now[19] == '.',
+              "current time layout", now);
+    }
+
+    long long nowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    template <typename Fn>
+    double bestNs(int calls, Fn fn)
+    {
+        double best = 1e18;
+        for (int round = 0; round < 5; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i)
+                fn();
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ns / calls);
+        }
+        return best;
+    }
+
+    void benchmark(int calls)
+    {
+        size_t sink = 0;
+        std::string line;
+        line.reserve(128);
+
+        double old = bestNs(calls, [&] { sink += oldTimestamp(nowMs()).size(); });
+        double cached = bestNs(calls, [&] {
+            line.clear();
+            LogTimestamp::append(line);
+            sink += line.size();
+        });
+        double clock = bestNs(calls, [&] { sink += static_cast<size_t>(nowMs()); });
+
+        std::printf("每项 %d 次调用（5轮取最好）:\n", calls);
+        std::printf("  旧的做法（wstringstream + UTF-8转换）  %8.1f ns\n", old);
+        std::printf("  按秒缓存（只改写毫秒）                 %8.1f ns\n", cached);
+        std::printf("  其中读取系统时钟                       %8.1f ns\n", clock);
+        if (sink == 0)
+            std::printf("\n");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int calls = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    if (calls <= 0) {
+        std::printf("用法: LogTimestampBench [调用次数]\n");
+        return 2;
+    }
+
+    testCache();
+    benchmark(calls);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
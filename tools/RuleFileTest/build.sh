@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建规则文件读写测试与基准（options/rule_file.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o RuleFileTest main.cpp
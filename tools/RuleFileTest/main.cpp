@@ -0,0 +1,284 @@
+// RuleFileTest：自动图钉规则文件（TinyPin.rules）的测试与基准。
+//
+// 一致性：RuleFile::format 写出的行经 RuleFile::parse 读回后与原规则相同（包括需要转义的字符），
+// 注释、空行、CRLF、BOM、字段数不对的行和中断追加留下的半行按文件格式的约定处理。
+// 基准：比较旧的 INI 格式（每条规则一个 [AutoPinRuleN] 节，由 IniDocument 读取）
+// 与规则文件在 1000、5000 和 10000 条规则时的保存、加载，以及添加一条规则的耗时。
+// 文件内容的UTF-8转换与程序中一样在整个文件上进行一次。
+//
+// 用法：
+//   RuleFileTest [临时文件目录]
+//
+
+#include "options/rule_file.h"
+#include "foundation/ini_document.h"
+#include "foundation/json_stream.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what)
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s\n", what);
+            ++g_failed;
+        }
+    }
+
+    bool sameRecord(const RuleFile::Record& a, const RuleFile::Record& b)
+    {
+        return a.descr == b.descr && a.title == b.title && a.cls == b.cls && a.process == b.process &&
+            a.processField == b.processField && a.enabled == b.enabled;
+    }
+
+    RuleFile::Record makeRecord(const std::wstring& descr, const std::wstring& title,
+        const std::wstring& cls = std::wstring(), const std::wstring& process = std::wstring(),
+        int processField = 0, bool enabled = true)
+    {
+        RuleFile::Record rec;
+        rec.descr = descr;
+        rec.title = title;
+        rec.cls = cls;
+        rec.process = process;
+        rec.processField = processField;
+        rec.enabled = enabled;
+        return rec;
+    }
+
+    std::vector<RuleFile::Record> parseText(const std::wstring& text)
+    {
+        std::vector<RuleFile::Record> records;
+        RuleFile::parse(text, records);
+        return records;
+    }
+
+    void testConformance()
+    {
+        // 往返：各种字符都能原样读回
+        std::vector<RuleFile::Record> rules = {
+            makeRecord(L"记事本", L"*无标题 - 记事本*", L"Notepad", L"notepad.exe"),
+            makeRecord(L"制表符\t换行\n回车\r", L"反斜杠\\t不是制表符", L"\\", L"C:\\Windows\\*", 1, false),
+            makeRecord(L"", L"", L"", L"", 2, true),
+            makeRecord(L"结尾的反斜杠\\", L"\\\\", L"#不是注释", L"Microsoft.WindowsCalculator_8wekyb3d8bbwe", 2),
+            makeRecord(L"代理对 \U0001F4CC", L"*", L"", L"", 0, true),
+        };
+        std::wstring text = RuleFile::HEADER;
+        for (const auto& rec : rules)
+            RuleFile::format(text, rec);
+        auto back = parseText(text);
+        check(back.size() == rules.size(), "roundtrip count");
+        for (size_t i = 0; i < rules.size() && i < back.size(); ++i)
+            check(sameRecord(rules[i], back[i]), "roundtrip record");
+
+        // 每条规则恰好一行，字段中的特殊字符都被转义
+        std::wstring line;
+        RuleFile::format(line, rules[1]);
+        check(line == L"0\t1\t制表符\\t换行\\n回车\\r\t反斜杠\\\\t不是制表符\t\\\\\tC:\\\\Windows\\\\*\n",
+            "escaped line");
+        size_t newlines = 0;
+        for (wchar_t ch : text)
+            newlines += ch == L'\n';
+        check(newlines == rules.size() + 1, "one line per rule");
+
+        // 文件头、注释、空行和BOM被忽略，CRLF行尾被接受
+        back = parseText(L"\xFEFF# TinyPin autopin rules 1\r\n\r\n# 注释\r\n1\t0\ta\tb\tc\td\r\n\n");
+        check(back.size() == 1 && sameRecord(back[0], makeRecord(L"a", L"b", L"c", L"d")), "crlf and comments");
+
+        // 最后一行没有换行符时也能读取
+        back = parseText(L"1\t0\ta\tb\tc\td");
+        check(back.size() == 1, "last line without newline");
+
+        // 字段数不对、字段不是数字的行被跳过，其他行不受影响
+        back = parseText(
+            L"1\t0\ta\tb\tc\n"              // 少一个字段
+            L"1\t0\ta\tb\tc\td\te\n"        // 多一个字段
+            L"x\t0\ta\tb\tc\td\n"           // 启用不是数字
+            L"1\t-1\ta\tb\tc\td\n"          // 负数
+            L"1\t\ta\tb\tc\td\n"            // 空字段
+            L"0\t2\t有效\t\t\t\n");
+        check(back.size() == 1 && sameRecord(back[0], makeRecord(L"有效", L"", L"", L"", 2, false)),
+            "malformed lines skipped");
+
+        // 追加被中断留下的半行不影响前后的规则
+        text = RuleFile::HEADER;
+        RuleFile::format(text, rules[0]);
+        text += L"1\t0\t中断";
+        back = parseText(text);
+        check(back.size() == 1 && sameRecord(back[0], rules[0]), "partial tail skipped");
+        // 如果之后的追加接在半行后面，合成的一行被丢弃（所以 appendLines 拒绝这样追加）
+        RuleFile::format(text, rules[2]);
+        back = parseText(text);
+        check(back.size() == 1, "append after partial line is lost");
+
+        // 未知的转义保留被转义的字符
+        back = parseText(L"1\t0\t\\a\\#\t\t\t\n");
+        check(back.size() == 1 && back[0].descr == L"a#", "unknown escape");
+
+        // 文件头本身是注释
+        check(parseText(RuleFile::HEADER).empty(), "header only");
+        check(std::wstring(RuleFile::HEADER).back() == L'\n', "header ends with newline");
+    }
+
+    std::string readAll(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void writeAll(const std::string& path, const std::string& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << data;
+    }
+
+    void appendAll(const std::string& path, const std::string& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << data;
+    }
+
+    // 旧格式：按 Options 写出 [AutoPinRuleN] 节的方式保存
+    void saveIni(const std::string& path, const std::vector<RuleFile::Record>& rules)
+    {
+        using Foundation::Json::toUtf8;
+        std::ostringstream file;
+        file << "\xEF\xBB\xBF; 微钉 配置文件\n\n";
+        file << "[AutoPin]\n; 自动图钉规则数量\nRuleCount=" << rules.size() << "\n\n";
+        for (size_t i = 0; i < rules.size(); ++i) {
+            const auto& rule = rules[i];
+            file << "[AutoPinRule" << i << "]\n";
+            file << "; 规则描述\nDescription=" << toUtf8(rule.descr) << "\n";
+            file << "; 窗口标题匹配模式 (* 表示通配符)\nTitle=" << toUtf8(rule.title) << "\n";
+            file << "; 窗口类名匹配模式\nClass=" << toUtf8(rule.cls) << "\n";
+            file << "; 进程匹配模式，不区分大小写 (* 表示通配符，空值表示所有进程)\nProcess="
+                 << toUtf8(rule.process) << "\n";
+            file << "; 进程匹配属性 (0=映像名, 1=完整路径, 2=包系列名)\nProcessField=" << rule.processField << "\n";
+            file << "; 规则启用状态 (0=禁用, 1=启用)\nEnabled=" << (rule.enabled ? 1 : 0) << "\n";
+            if (i + 1 < rules.size())
+                file << "\n";
+        }
+        writeAll(path, file.str());
+    }
+
+    // 旧格式：IniDocument 解析一次，再逐条读取
+    std::vector<RuleFile::Record> loadIni(const std::string& path)
+    {
+        Foundation::IniDocument ini;
+        ini.parse(Foundation::Json::toWide(readAll(path)));
+        std::vector<RuleFile::Record> rules;
+        int ruleCount = ini.getInt(L"AutoPin", L"RuleCount", 0);
+        rules.reserve(ruleCount);
+        std::wstring sectionName;
+        for (int i = 0; i < ruleCount; ++i) {
+            sectionName = L"AutoPinRule" + std::to_wstring(i);
+            rules.push_back(makeRecord(ini.get(sectionName, L"Description"), ini.get(sectionName, L"Title"),
+                ini.get(sectionName, L"Class"), ini.get(sectionName, L"Process"),
+                ini.getInt(sectionName, L"ProcessField", 0), ini.getInt(sectionName, L"Enabled", 1) != 0));
+        }
+        return rules;
+    }
+
+    void saveRules(const std::string& path, const std::vector<RuleFile::Record>& rules)
+    {
+        std::wstring text = RuleFile::HEADER;
+        for (const auto& rec : rules)
+            RuleFile::format(text, rec);
+        writeAll(path, Foundation::Json::toUtf8(text));
+    }
+
+    std::vector<RuleFile::Record> loadRules(const std::string& path)
+    {
+        std::vector<RuleFile::Record> rules;
+        RuleFile::parse(Foundation::Json::toWide(readAll(path)), rules);
+        return rules;
+    }
+
+    // 添加一条规则：规则文件只追加一行
+    void appendRule(const std::string& path, const RuleFile::Record& rec)
+    {
+        std::wstring line;
+        RuleFile::format(line, rec);
+        appendAll(path, Foundation::Json::toUtf8(line));
+    }
+
+    // 多次运行中最快一次的毫秒数
+    template<class F>
+    double bestMs(int runs, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    void benchmark(const std::string& dir)
+    {
+        const std::string iniPath = dir + "/RuleFileTest.tmp.ini";
+        const std::string rulesPath = dir + "/RuleFileTest.tmp.rules";
+        const int RUNS = 5;
+
+        std::printf("%7s | %9s %9s %9s %9s | %9s %9s %9s %9s\n", "rules",
+            "INI KB", "save ms", "load ms", "add ms", "rules KB", "save ms", "load ms", "add ms");
+        for (int ruleCount : { 1000, 5000, 10000 }) {
+            std::vector<RuleFile::Record> rules;
+            rules.reserve(ruleCount + 1);
+            for (int i = 0; i < ruleCount; ++i) {
+                rules.push_back(makeRecord(L"规则 " + std::to_wstring(i), L"*文档 " + std::to_wstring(i) + L" - 记事本*",
+                    i % 3 ? L"Notepad" : L"", i % 2 ? L"notepad.exe" : L"", i % 3, i % 5 != 0));
+            }
+            RuleFile::Record added = makeRecord(L"新规则", L"*新窗口*", L"", L"calc.exe");
+
+            double iniSave = bestMs(RUNS, [&] { saveIni(iniPath, rules); });
+            long long iniBytes = static_cast<long long>(readAll(iniPath).size());
+            std::vector<RuleFile::Record> iniLoaded;
+            double iniLoad = bestMs(RUNS, [&] { iniLoaded = loadIni(iniPath); });
+            // 旧格式添加规则也要重写整个文件
+            rules.push_back(added);
+            double iniAdd = bestMs(RUNS, [&] { saveIni(iniPath, rules); });
+            rules.pop_back();
+
+            double rulesSave = bestMs(RUNS, [&] { saveRules(rulesPath, rules); });
+            long long rulesBytes = static_cast<long long>(readAll(rulesPath).size());
+            std::vector<RuleFile::Record> rulesLoaded;
+            double rulesLoad = bestMs(RUNS, [&] { rulesLoaded = loadRules(rulesPath); });
+            double rulesAdd = bestMs(RUNS, [&] { appendRule(rulesPath, added); });
+
+            bool same = iniLoaded.size() == rules.size() && rulesLoaded.size() == rules.size();
+            for (size_t i = 0; same && i < rules.size(); ++i)
+                same = sameRecord(iniLoaded[i], rules[i]) && sameRecord(rulesLoaded[i], rules[i]);
+            check(same, "both formats load the saved rules");
+            check(loadRules(rulesPath).size() == rules.size() + RUNS, "appended rules load");
+
+            std::printf("%7d | %9.0f %9.2f %9.2f %9.2f | %9.0f %9.2f %9.2f %9.3f\n", ruleCount,
+                iniBytes / 1024.0, iniSave, iniLoad, iniAdd, rulesBytes / 1024.0, rulesSave, rulesLoad, rulesAdd);
+        }
+        std::remove(iniPath.c_str());
+        std::remove(rulesPath.c_str());
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string dir = argc > 1 ? argv[1] : ".";
+
+    testConformance();
+    benchmark(dir);
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建规则导入导出测试（options/rule_exchange.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o RuleImportTest main.cpp
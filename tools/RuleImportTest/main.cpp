@@ -0,0 +1,283 @@
+// RuleImportTest：自动图钉规则JSON导入导出（options/rule_exchange.h）的测试与基准。
+//
+// 一致性：exportRules 写出的文件经 importRules 读回后与原规则相同；
+// 格式错误的JSON和不符合文件格式的文档返回错误和出错位置；
+// 与已有规则描述相同时按 Skip、Overwrite、KeepBoth 三种方式合并（包括导入文件内部的重复）。
+// 基准：10000 和 50000 条规则时导出、导入到空规则集、按三种方式合并到相同规则集的耗时。
+//
+// 用法：
+//   RuleImportTest [基准的规则数]
+//
+
+#include "options/rule_exchange.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // 与 AutoPinRule 的成员相同
+    struct Rule {
+        std::wstring descr;
+        std::wstring ttl;
+        std::wstring cls;
+        std::wstring proc;
+        Pin::ProcessField procField = Pin::ProcessField::ImageName;
+        bool enabled = true;
+
+        bool operator==(const Rule& other) const
+        {
+            return descr == other.descr && ttl == other.ttl && cls == other.cls && proc == other.proc &&
+                procField == other.procField && enabled == other.enabled;
+        }
+    };
+
+    using Rules = std::vector<Rule>;
+    using RuleExchange::MergePolicy;
+
+    Rule makeRule(const std::wstring& descr, const std::wstring& title, const std::wstring& cls = std::wstring(),
+        const std::wstring& proc = std::wstring(), Pin::ProcessField field = Pin::ProcessField::ImageName,
+        bool enabled = true)
+    {
+        Rule rule;
+        rule.descr = descr;
+        rule.ttl = title;
+        rule.cls = cls;
+        rule.proc = proc;
+        rule.procField = field;
+        rule.enabled = enabled;
+        return rule;
+    }
+
+    std::string exportText(const Rules& rules)
+    {
+        std::ostringstream out;
+        RuleExchange::exportRules(out, rules.begin(), rules.end());
+        return out.str();
+    }
+
+    RuleExchange::ImportResult importText(const std::string& text, Rules& rules, MergePolicy policy)
+    {
+        std::istringstream in(text);
+        return RuleExchange::importRules(in, rules, policy);
+    }
+
+    void testRoundTrip()
+    {
+        Rules rules = {
+            makeRule(L"记事本", L"*无标题 - 记事本*", L"Notepad", L"notepad.exe"),
+            makeRule(L"引号\"反斜杠\\制表符\t换行\n", L"\\*", L"", L"C:\\Windows\\*", Pin::ProcessField::ImagePath, false),
+            makeRule(L"", L"", L"", L"", Pin::ProcessField::PackageFamily),
+            makeRule(L"代理对 \U0001F4CC 和控制字符 \x01", L"*", L"", L"Microsoft.WindowsCalculator_8wekyb3d8bbwe",
+                     Pin::ProcessField::PackageFamily),
+        };
+        std::string text = exportText(rules);
+        Rules back;
+        auto res = importText(text, back, MergePolicy::KeepBoth);
+        check(res.ok(), "roundtrip import", res.error);
+        check(back == rules, "roundtrip rules");
+        check(res.added == rules.size() && res.total() == rules.size(), "roundtrip counts");
+
+        // 只有规则数组的文档、未知的键（包括嵌套的值）、数字形式的 processField
+        Rules bare;
+        res = importText(u8R"([{"description":"a","title":"x","extra":{"n":[1,2,{"k":null}]},"processField":1},
+                               {"description":"b","enabled":false}])", bare, MergePolicy::Skip);
+        check(res.ok() && bare.size() == 2, "bare array", res.error);
+        if (bare.size() == 2) {
+            check(bare[0].procField == Pin::ProcessField::ImagePath && bare[0].ttl == L"x", "numeric processField");
+            check(!bare[1].enabled && bare[1].ttl.empty(), "missing keys keep defaults");
+        }
+
+        Rules empty;
+        res = importText(u8R"({"format":"tinypin-autopin-rules","version":1,"comment":"x","rules":[]})",
+                         empty, MergePolicy::Skip);
+        check(res.ok() && empty.empty() && res.total() == 0, "empty rules array", res.error);
+    }
+
+    // 导入失败：返回错误，位置在文档范围内
+    void expectError(const char* what, const std::string& text)
+    {
+        Rules rules;
+        auto res = importText(text, rules, MergePolicy::KeepBoth);
+        check(!res.ok(), what, "accepted");
+        check(res.offset <= text.size(), what, "offset " + std::to_string(res.offset));
+    }
+
+    void testMalformed()
+    {
+        const std::string head = u8R"({"format":"tinypin-autopin-rules","version":1,"rules":)";
+
+        // 不是JSON
+        expectError("empty input", "");
+        expectError("whitespace only", "  \r\n ");
+        expectError("not json", "[AutoPinRule0]\r\nDescr=x\r\n");
+        expectError("truncated document", head + u8R"([{"description":"a")");
+        expectError("truncated string", head + u8R"([{"description":"a)");
+        expectError("missing comma", head + u8R"([{"description":"a" "title":"b"}]})");
+        expectError("trailing comma", head + u8R"([{"description":"a"},]})");
+        expectError("bad escape", head + u8R"([{"description":"\q"}]})");
+        expectError("bad unicode escape", head + u8R"([{"description":"\u12"}]})");
+        expectError("unquoted key", head + u8R"([{description:"a"}]})");
+        expectError("trailing data", head + u8R"([]} [])");
+        expectError("bad literal", head + u8R"([{"enabled":tru}]})");
+
+        // 是JSON但不是规则文件
+        expectError("wrong format", u8R"({"format":"something-else","version":1,"rules":[]})");
+        expectError("future version", u8R"({"format":"tinypin-autopin-rules","version":2,"rules":[]})");
+        expectError("zero version", u8R"({"format":"tinypin-autopin-rules","version":0,"rules":[]})");
+        expectError("no rules", u8R"({"format":"tinypin-autopin-rules","version":1})");
+        expectError("rules not array", head + u8R"({}})");
+        expectError("rule not object", head + u8R"(["a"]})");
+        expectError("description not string", head + u8R"([{"description":1}]})");
+        expectError("title not string", head + u8R"([{"title":null}]})");
+        expectError("bad processField name", head + u8R"([{"processField":"windowTitle"}]})");
+        expectError("processField out of range", head + u8R"([{"processField":3}]})");
+        expectError("enabled not bool", head + u8R"([{"enabled":1}]})");
+        expectError("top level string", u8R"("rules")");
+
+        // 出错位置：第二条规则的错误位于第一条之后
+        std::string text = head + u8R"([{"description":"a"},{"description":"b","enabled":"yes"}]})";
+        Rules rules;
+        auto res = importText(text, rules, MergePolicy::KeepBoth);
+        check(!res.ok() && res.offset > text.find("\"b\""), "error offset after earlier rules",
+              std::to_string(res.offset));
+        check(res.error.find("enabled") != std::string::npos, "error names the property", res.error);
+    }
+
+    // 已有 记事本、计算器；导入 记事本（新标题）、画图、记事本（文件内重复）
+    void testMerge()
+    {
+        const Rules existing = {
+            makeRule(L"记事本", L"旧标题"),
+            makeRule(L"计算器", L"计算器"),
+        };
+        const Rules incoming = {
+            makeRule(L"记事本", L"新标题一"),
+            makeRule(L"画图", L"*画图"),
+            makeRule(L"记事本", L"新标题二"),
+        };
+        const std::string text = exportText(incoming);
+
+        // Skip：已有的和先导入的保留，重复的跳过
+        Rules rules = existing;
+        auto res = importText(text, rules, MergePolicy::Skip);
+        check(res.ok() && res.added == 1 && res.skipped == 2 && res.replaced == 0, "skip counts", res.error);
+        check(rules.size() == 3 && rules[0].ttl == L"旧标题" && rules[2].descr == L"画图", "skip keeps existing");
+
+        // Overwrite：原位置替换，文件内后出现的覆盖先出现的
+        rules = existing;
+        res = importText(text, rules, MergePolicy::Overwrite);
+        check(res.ok() && res.added == 1 && res.replaced == 2 && res.skipped == 0, "overwrite counts", res.error);
+        check(rules.size() == 3 && rules[0].descr == L"记事本" && rules[0].ttl == L"新标题二", "overwrite in place");
+        check(rules[1] == existing[1] && rules[2].descr == L"画图", "overwrite leaves others");
+
+        // KeepBoth：重复的依次改名为 (2)、(3)
+        rules = existing;
+        res = importText(text, rules, MergePolicy::KeepBoth);
+        check(res.ok() && res.added == 3 && res.replaced == 0 && res.skipped == 0, "keep both counts", res.error);
+        check(rules.size() == 5, "keep both size");
+        if (rules.size() == 5) {
+            check(rules[0] == existing[0], "keep both keeps existing");
+            check(rules[2].descr == L"记事本 (2)" && rules[2].ttl == L"新标题一", "keep both renames first");
+            check(rules[3].descr == L"画图", "keep both adds new");
+            check(rules[4].descr == L"记事本 (3)" && rules[4].ttl == L"新标题二", "keep both renames second");
+        }
+
+        // KeepBoth：改名后的描述与已有规则重复时继续编号
+        rules = { makeRule(L"记事本", L"a"), makeRule(L"记事本 (2)", L"b") };
+        res = importText(exportText({ makeRule(L"记事本", L"c") }), rules, MergePolicy::KeepBoth);
+        check(res.ok() && rules.size() == 3 && rules[2].descr == L"记事本 (3)", "keep both skips taken names");
+
+        // 已有规则中的重复描述：合并到第一条
+        rules = { makeRule(L"记事本", L"a"), makeRule(L"记事本", L"b") };
+        res = importText(exportText({ makeRule(L"记事本", L"c") }), rules, MergePolicy::Overwrite);
+        check(res.ok() && rules.size() == 2 && rules[0].ttl == L"c" && rules[1].ttl == L"b",
+              "overwrite targets first duplicate");
+
+        // 描述只是大小写不同的不算重复
+        rules = { makeRule(L"Notepad", L"a") };
+        res = importText(exportText({ makeRule(L"notepad", L"b") }), rules, MergePolicy::Skip);
+        check(res.ok() && res.added == 1 && rules.size() == 2, "descriptions are case-sensitive");
+    }
+
+    double msSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void bench(size_t count)
+    {
+        Rules rules;
+        rules.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::wstring n = std::to_wstring(i);
+            rules.push_back(makeRule(L"规则 " + n, L"*文档" + n + L" - 编辑器*", L"EditorWindow" + n,
+                                     L"editor" + n + L".exe", Pin::ProcessField(i % 3), i % 7 != 0));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::string text = exportText(rules);
+        double exportMs = msSince(start);
+        double mb = text.size() / (1024.0 * 1024.0);
+
+        std::printf("%zu rules, %.2f MB:\n", count, mb);
+        std::printf("  %-28s %8.1f ms  %6.0f MB/s\n", "export", exportMs, mb / exportMs * 1000);
+
+        Rules imported;
+        start = std::chrono::steady_clock::now();
+        auto res = importText(text, imported, MergePolicy::KeepBoth);
+        double importMs = msSince(start);
+        check(res.ok() && imported == rules, "bench import roundtrip", res.error);
+        std::printf("  %-28s %8.1f ms  %6.0f MB/s\n", "import into empty set", importMs, mb / importMs * 1000);
+
+        // 每条规则都与已有规则重复
+        static const struct { MergePolicy policy; const char* name; } policies[] = {
+            { MergePolicy::Skip, "merge duplicates: skip" },
+            { MergePolicy::Overwrite, "merge duplicates: overwrite" },
+            { MergePolicy::KeepBoth, "merge duplicates: keep both" },
+        };
+        for (const auto& p : policies) {
+            Rules target = rules;
+            start = std::chrono::steady_clock::now();
+            res = importText(text, target, p.policy);
+            double ms = msSince(start);
+            check(res.ok() && res.total() == count, "bench merge", p.name);
+            check(target.size() == (p.policy == MergePolicy::KeepBoth ? 2 * count : count), "bench merge size", p.name);
+            std::printf("  %-28s %8.1f ms  %6.0f MB/s\n", p.name, ms, mb / ms * 1000);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testRoundTrip();
+    testMalformed();
+    testMerge();
+
+    if (argc > 1) {
+        bench(std::strtoul(argv[1], nullptr, 10));
+    }
+    else {
+        bench(10000);
+        bench(50000);
+    }
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建编辑规则时的匹配预览测试与基准（pin/rule_preview.h）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o RulePreviewBench main.cpp
@@ -0,0 +1,242 @@
+// RulePreviewBench：编辑规则时匹配预览（pin/rule_preview.h）的测试与基准。
+//
+// 一致性：模拟在编辑规则对话框中逐个输入标题、类名和进程模式，每次 RulePreview::update 之后
+// 匹配的窗口与同一规则编译为 CompiledRuleSet 后逐个窗口 match 的结果相同，
+// 按 removed()/inserted() 修改上次的结果得到新的结果，内容不变时不更新。
+// 基准：1000 个窗口时一系列标题和类名编辑中每次更新的耗时（最慢的一次和平均值），
+// 与每次都重新评估全部窗口的做法比较。
+//
+// 用法：
+//   RulePreviewBench [窗口数]
+//
+
+#include "pin/rule_preview.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // 与 AutoPinRule 中规则集编译用到的成员相同
+    struct Rule {
+        std::wstring ttl;
+        std::wstring cls;
+        std::wstring proc;
+        Pin::ProcessField procField = Pin::ProcessField::ImageName;
+        bool enabled = true;
+        std::shared_ptr<Pin::RuleStats> stats = std::make_shared<Pin::RuleStats>();
+    };
+
+    using Window = Pin::RulePreview::Window;
+
+    std::vector<Window> makeWindows(size_t count)
+    {
+        struct App { const wchar_t* title; const wchar_t* cls; const wchar_t* image; const wchar_t* package; };
+        const App apps[] = {
+            { L"无标题 - 记事本", L"Notepad", L"notepad.exe", L"" },
+            { L"计算器", L"ApplicationFrameWindow", L"applicationframehost.exe", L"microsoft.windowscalculator_8wekyb3d8bbwe" },
+            { L"YouTube - Google Chrome", L"Chrome_WidgetWin_1", L"chrome.exe", L"" },
+            { L"Windows PowerShell", L"CASCADIA_HOSTING_WINDOW_CLASS", L"windowsterminal.exe", L"microsoft.windowsterminal_8wekyb3d8bbwe" },
+            { L"report.docx - Word", L"OpusApp", L"winword.exe", L"" },
+            { L"Inbox - Outlook", L"rctrl_renwnd32", L"outlook.exe", L"" },
+            { L"main.cpp - Visual Studio Code", L"Chrome_WidgetWin_1", L"code.exe", L"" },
+            { L"下载", L"CabinetWClass", L"explorer.exe", L"" },
+        };
+        std::vector<Window> windows;
+        windows.reserve(count);
+        for (size_t n = 0; n < count; ++n) {
+            const App& app = apps[n % 8];
+            Window w;
+            w.id = 0x10000 + n * 4;
+            w.title = std::to_wstring(n) + L" " + app.title;
+            w.cls = app.cls;
+            w.imageName = app.image;
+            w.imagePath = std::wstring(L"c:\\program files\\") + app.image;
+            w.packageFamily = app.package;
+            windows.push_back(std::move(w));
+        }
+        return windows;
+    }
+
+    // 同一规则编译为规则集后逐个窗口匹配
+    std::vector<size_t> reference(const Rule& rule, const std::vector<Window>& windows)
+    {
+        Rule copy = rule;
+        copy.stats = std::make_shared<Pin::RuleStats>();
+        Pin::CompiledRuleSet set;
+        set.assign(&copy, &copy + 1);
+        std::vector<size_t> matched;
+        for (size_t n = 0; n < windows.size(); ++n) {
+            Pin::RuleTarget target;
+            target.title = windows[n].title;
+            target.cls = windows[n].cls;
+            target.imageName = windows[n].imageName;
+            target.imagePath = windows[n].imagePath;
+            target.packageFamily = windows[n].packageFamily;
+            if (set.match(target) != Pin::CompiledRuleSet::npos)
+                matched.push_back(n);
+        }
+        return matched;
+    }
+
+    // 编辑的一步：修改规则的一个字段
+    struct Edit {
+        enum Field { Title, Class, Process, ProcessField } field;
+        std::wstring text;
+        Pin::ProcessField procField = Pin::ProcessField::ImageName;
+    };
+
+    // 逐个字符输入 text，每个前缀为一步
+    void typeInto(std::vector<Edit>& edits, Edit::Field field, const std::wstring& text)
+    {
+        for (size_t n = 0; n <= text.size(); ++n)
+            edits.push_back({ field, text.substr(0, n) });
+    }
+
+    std::vector<Edit> editSequence()
+    {
+        std::vector<Edit> edits;
+        typeInto(edits, Edit::Title, L"*Chrome");
+        typeInto(edits, Edit::Class, L"Chrome_WidgetWin_1");
+        typeInto(edits, Edit::Title, L"*Code");
+        typeInto(edits, Edit::Title, L"*");
+        typeInto(edits, Edit::Process, L"CODE.exe");
+        edits.push_back({ Edit::ProcessField, L"", Pin::ProcessField::ImagePath });
+        typeInto(edits, Edit::Process, L"*\\code.exe");
+        edits.push_back({ Edit::Process, L"" });
+        typeInto(edits, Edit::Class, L"App*");
+        typeInto(edits, Edit::Title, L"*计算器");
+        edits.push_back({ Edit::ProcessField, L"", Pin::ProcessField::PackageFamily });
+        typeInto(edits, Edit::Process, L"Microsoft.WindowsCalculator_*");
+        typeInto(edits, Edit::Class, L"");
+        typeInto(edits, Edit::Title, L"*下载");
+        return edits;
+    }
+
+    void apply(Rule& rule, const Edit& edit)
+    {
+        switch (edit.field) {
+            case Edit::Title:        rule.ttl = edit.text; break;
+            case Edit::Class:        rule.cls = edit.text; break;
+            case Edit::Process:      rule.proc = edit.text; break;
+            case Edit::ProcessField: rule.procField = edit.procField; break;
+        }
+    }
+
+    void testEdits()
+    {
+        std::vector<Window> windows = makeWindows(200);
+        Pin::RulePreview preview;
+        preview.setWindows(windows);
+
+        Rule rule;
+        rule.stats->recordMatch(0);
+        const uint64_t matchesBefore = rule.stats->matches.load();
+
+        std::vector<size_t> shown;      // 按 removed/inserted 修改的列表，代替列表控件
+        bool first = true;
+        int mismatches = 0, listErrors = 0, spurious = 0;
+        for (const Edit& edit : editSequence()) {
+            Rule before = rule;
+            apply(rule, edit);
+            bool changed = preview.update(rule);
+            bool same = !first && before.ttl == rule.ttl && before.cls == rule.cls && before.proc == rule.proc
+                && before.procField == rule.procField;
+            first = false;
+
+            if (preview.matched() != reference(rule, windows))
+                ++mismatches;
+            if (same && changed)
+                ++spurious;
+
+            for (size_t pos : preview.removed())
+                shown.erase(shown.begin() + pos);
+            for (size_t pos : preview.inserted())
+                shown.insert(shown.begin() + pos, preview.matched()[pos]);
+            if (shown != preview.matched())
+                ++listErrors;
+        }
+        check(mismatches == 0, "preview: same windows as the compiled rule set", std::to_string(mismatches) + " edits differ");
+        check(listErrors == 0, "preview: removed/inserted turn the old rows into the new ones", std::to_string(listErrors) + " edits");
+        check(spurious == 0, "preview: unchanged rule reports no change");
+        check(rule.stats->matches.load() == matchesBefore, "preview: rule statistics untouched");
+
+        // 内容不变时不更新
+        check(!preview.update(rule) && preview.removed().empty() && preview.inserted().empty(), "preview: repeated update is a no-op");
+
+        // 新的窗口快照从头评估
+        preview.setWindows(makeWindows(8));
+        check(preview.matched().empty(), "preview: new snapshot starts empty");
+        preview.update(rule);
+        check(preview.matched() == reference(rule, makeWindows(8)), "preview: new snapshot evaluated");
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    void bench(size_t count)
+    {
+        std::vector<Window> windows = makeWindows(count);
+        std::vector<Edit> edits = editSequence();
+
+        // 增量更新
+        Pin::RulePreview preview;
+        preview.setWindows(windows);
+        Rule rule;
+        double worst = 0, total = 0;
+        for (const Edit& edit : edits) {
+            apply(rule, edit);
+            auto begin = Clock::now();
+            preview.update(rule);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            worst = (std::max)(worst, ms);
+            total += ms;
+        }
+
+        // 每次都重新评估全部窗口：新的预览对象
+        Rule full;
+        double fullWorst = 0, fullTotal = 0;
+        for (const Edit& edit : edits) {
+            apply(full, edit);
+            Pin::RulePreview fresh;
+            fresh.setWindows(windows);
+            auto begin = Clock::now();
+            fresh.update(full);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            fullWorst = (std::max)(fullWorst, ms);
+            fullTotal += ms;
+        }
+
+        std::printf("\n%zu windows, %zu edits:\n", count, edits.size());
+        std::printf("  %-28s %8.3f ms worst %8.3f ms mean\n", "incremental update", worst, total / edits.size());
+        std::printf("  %-28s %8.3f ms worst %8.3f ms mean\n", "full re-evaluation", fullWorst, fullTotal / edits.size());
+        check(preview.matched() == reference(rule, windows), "bench: final result");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testEdits();
+
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    bench(count ? count : 1000);
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+// RuleViewBench：自动图钉规则页列表模型（options/rule_view.h）的测试与基准。
+//
+// 一致性：RuleView 的过滤（不区分大小写，过滤文本变长时只在可见条目中筛选）、
+// 新添加和编辑过的规则在过滤文本改变前保持可见、删除、上下移动（包括过滤时）、
+// 按描述前缀的键入查找，结果与直接在规则vector上计算的相同。
+// 基准：50000 条规则时设置规则、移动和删除5000条选中的规则、第一次过滤（生成小写文本）、
+// 逐个输入字符的过滤和重新过滤的耗时。
+//
+// 用法：
+//   RuleViewBench [基准的规则数]
+//
+
+#include "options/rule_view.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <string>
+#include <vector>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what, const std::string& detail = std::string())
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s %s\n", what, detail.c_str());
+            ++g_failed;
+        }
+    }
+
+    // RuleView 需要的 AutoPinRule 成员
+    struct Rule {
+        std::wstring descr;
+        std::wstring ttl;
+        std::wstring cls;
+    };
+
+    using View = RuleView<Rule>;
+
+    std::wstring lower(std::wstring s)
+    {
+        for (wchar_t& ch : s)
+            ch = wchar_t(std::towlower(ch));
+        return s;
+    }
+
+    bool contains(const std::wstring& text, const std::wstring& filter)
+    {
+        return lower(text).find(lower(filter)) != std::wstring::npos;
+    }
+
+    // 可见条目的描述
+    std::vector<std::wstring> visible(const View& view)
+    {
+        std::vector<std::wstring> out;
+        for (size_t i = 0; i < view.size(); ++i)
+            out.push_back(view.at(i).descr);
+        return out;
+    }
+
+    // 直接在规则上计算应当可见的描述
+    std::vector<std::wstring> expected(const std::vector<Rule>& rules, const std::wstring& filter)
+    {
+        std::vector<std::wstring> out;
+        for (const Rule& rule : rules) {
+            if (filter.empty() || contains(rule.descr, filter) || contains(rule.ttl, filter) || contains(rule.cls, filter))
+                out.push_back(rule.descr);
+        }
+        return out;
+    }
+
+    std::vector<Rule> sampleRules()
+    {
+        return {
+            { L"Notepad", L"*Notepad", L"Notepad" },
+            { L"Calculator", L"Calculator", L"ApplicationFrameWindow" },
+            { L"Chrome video", L"*YouTube*", L"Chrome_WidgetWin_1" },
+            { L"Terminal", L"*", L"CASCADIA_HOSTING_WINDOW_CLASS" },
+            { L"Paint", L"*Paint", L"MSPaintApp" },
+            { L"Notes", L"便笺", L"ApplicationFrameWindow" },
+        };
+    }
+
+    void testFilter()
+    {
+        View view;
+        std::vector<Rule> rules = sampleRules();
+        view.assign(rules);
+        check(visible(view) == expected(rules, L""), "filter: all rules visible without a filter");
+        check(!view.filtered(), "filter: not filtered at start");
+
+        // 逐个输入字符：只在当前可见条目中筛选，结果与重新计算相同
+        std::wstring typed;
+        for (wchar_t ch : std::wstring(L"noTE")) {
+            typed += ch;
+            check(view.setFilter(typed), "filter: narrowing changes the filter");
+            check(visible(view) == expected(rules, typed), "filter: narrowing result", "filter length " + std::to_string(typed.size()));
+        }
+        check(!view.setFilter(L"note"), "filter: same text in another case is unchanged");
+
+        // 删除字符后重新过滤
+        check(view.setFilter(L"app"), "filter: shorter text refilters");
+        check(visible(view) == expected(rules, L"app"), "filter: class names are matched");
+        check(view.setFilter(L"便"), "filter: non-ASCII text");
+        check(visible(view) == expected(rules, L"便"), "filter: non-ASCII title");
+        check(view.setFilter(L""), "filter: cleared");
+        check(visible(view) == expected(rules, L""), "filter: all rules visible again");
+    }
+
+    void testEdit()
+    {
+        View view;
+        std::vector<Rule> rules = sampleRules();
+        view.assign(rules);
+        view.setFilter(L"note");
+
+        // 新添加的规则不匹配也保持可见，过滤文本改变后才隐藏
+        size_t added = view.add({ L"New Rule", L"", L"" });
+        check(added == view.size() - 1 && view.at(added).descr == L"New Rule", "edit: added rule is the last row");
+        check(view.rules().size() == rules.size() + 1, "edit: added rule is stored");
+
+        // 编辑后更新过滤用的文本
+        view.at(added).ttl = L"*Notebook*";
+        view.updated(added);
+        view.setFilter(L"noteb");
+        check(view.size() == 1 && view.at(0).descr == L"New Rule", "edit: edited rule matches by its new title");
+
+        view.setFilter(L"note");
+        view.at(0).descr = L"Renamed";
+        view.at(0).ttl = L"Other";
+        view.at(0).cls = L"Edit";
+        view.updated(0);
+        check(view.size() == 3 && view.at(0).descr == L"Renamed", "edit: edited rule stays visible");
+        view.setFilter(L"notep");
+        check(view.size() == 0, "edit: edited rule is hidden after the filter changes");
+    }
+
+    void testRemoveAndMove()
+    {
+        View view;
+        std::vector<Rule> rules = sampleRules();
+        view.assign(rules);
+
+        // 删除第1、3、4条
+        view.remove({ 1, 3, 4 });
+        check(visible(view) == std::vector<std::wstring>{ L"Notepad", L"Chrome video", L"Notes" }, "remove: remaining rules in order");
+        check(view.rules().size() == 3, "remove: rules compacted");
+
+        view.assign(rules);
+        std::vector<int> sel{ 1, 2 };
+        check(view.moveUp(sel), "move: up");
+        check(sel == std::vector<int>{ 0, 1 }, "move: selection follows");
+        check(visible(view) == std::vector<std::wstring>{ L"Calculator", L"Chrome video", L"Notepad", L"Terminal", L"Paint", L"Notes" },
+              "move: up result");
+        check(!view.moveUp(sel), "move: not past the top");
+
+        sel = { 0, 5 };
+        check(!view.moveDown(sel), "move: not past the bottom");
+        sel = { 3, 4 };
+        check(view.moveDown(sel) && sel == std::vector<int>{ 4, 5 }, "move: down");
+        check(view.rules().back().descr == L"Paint" && view.rules()[4].descr == L"Terminal", "move: down result");
+
+        // 过滤时只在可见条目之间移动，隐藏的规则位置不变
+        view.assign(rules);
+        view.setFilter(L"applicationframe");
+        check(visible(view) == std::vector<std::wstring>{ L"Calculator", L"Notes" }, "move: filtered rows");
+        sel = { 1 };
+        check(view.moveUp(sel) && sel == std::vector<int>{ 0 }, "move: up among filtered rows");
+        std::vector<std::wstring> order;
+        for (const Rule& rule : view.rules())
+            order.push_back(rule.descr);
+        check(order == std::vector<std::wstring>{ L"Notepad", L"Notes", L"Chrome video", L"Terminal", L"Paint", L"Calculator" },
+              "move: hidden rules keep their positions");
+
+        // 过滤时删除
+        view.remove({ 0 });
+        check(visible(view) == std::vector<std::wstring>{ L"Calculator" } && view.rules().size() == 5, "remove: filtered row");
+    }
+
+    void testFindPrefix()
+    {
+        View view;
+        view.assign(sampleRules());
+        check(view.findPrefix(L"no", 0) == 0, "find: first match");
+        check(view.findPrefix(L"NO", 1) == 5, "find: case-insensitive, from the start row");
+        check(view.findPrefix(L"no", 5) == 5, "find: the start row itself");
+        check(view.findPrefix(L"calc", 3) == 1, "find: wraps around");
+        check(view.findPrefix(L"xyz", 0) == -1, "find: no match");
+        check(view.findPrefix(L"", 0) == -1, "find: empty prefix");
+        check(view.findPrefix(L"Notepad++", 0) == -1, "find: prefix longer than the description");
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    void bench(size_t count)
+    {
+        const wchar_t* const apps[] = { L"Notepad", L"Calculator", L"Chrome", L"Terminal", L"Explorer", L"Paint", L"Outlook", L"Teams" };
+        std::vector<Rule> rules;
+        rules.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::wstring app = apps[i % 8];
+            rules.push_back({ app + L" rule " + std::to_wstring(i), L"*" + app + L"* - Window " + std::to_wstring(i % 997),
+                              app + L"_Class_" + std::to_wstring(i % 31) });
+        }
+
+        std::printf("\n%zu rules:\n", count);
+        View view;
+        auto begin = Clock::now();
+        view.assign(rules);
+        std::printf("  %-36s %8.2f ms\n", "assign", msSince(begin));
+
+        // 每隔10条选中一条
+        std::vector<int> sel;
+        for (size_t i = 5; i < count; i += 10)
+            sel.push_back(int(i));
+        begin = Clock::now();
+        view.moveUp(sel);
+        std::printf("  %-36s %8.2f ms\n", ("move " + std::to_string(sel.size()) + " selected rules").c_str(), msSince(begin));
+
+        begin = Clock::now();
+        view.remove(sel);
+        std::printf("  %-36s %8.2f ms\n", ("remove " + std::to_string(sel.size()) + " rules").c_str(), msSince(begin));
+        check(view.rules().size() == count - sel.size(), "bench: rules removed");
+
+        begin = Clock::now();
+        view.setFilter(L"c");
+        std::printf("  %-36s %8.2f ms\n", "first filter (builds the keys)", msSince(begin));
+
+        // 逐个输入字符
+        std::wstring typed = L"c";
+        double slowest = 0;
+        for (wchar_t ch : std::wstring(L"hrome* - window 12")) {
+            typed += ch;
+            begin = Clock::now();
+            view.setFilter(typed);
+            slowest = (std::max)(slowest, msSince(begin));
+        }
+        std::printf("  %-36s %8.2f ms\n", "slowest narrowing keystroke", slowest);
+        check(view.size() > 0, "bench: narrowed filter still matches");
+
+        begin = Clock::now();
+        view.setFilter(L"teams");
+        std::printf("  %-36s %8.2f ms\n", "refilter (keys already built)", msSince(begin));
+        check(view.size() == expected(view.rules(), L"teams").size(), "bench: refilter result");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testFilter();
+    testEdit();
+    testRemoveAndMove();
+    testFindPrefix();
+
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    bench(count ? count : 50000);
+
+    std::printf("\n%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}
@@ -29,6 +29,21 @@ if not exist "%ISCC_PATH%" (
     exit /b 1
 )
 
+REM 预编译语言文件（assets\locales\*.json -> *.bin）并生成语言文件清单，随 assets 目录一起打包
+echo 预编译语言文件...
+if not exist "%PROJECT_ROOT%\build" mkdir "%PROJECT_ROOT%\build"
+cl /nologo /std:c++17 /O2 /EHsc /utf-8 /I"%PROJECT_ROOT%\include" /Fo"%PROJECT_ROOT%\build\\" /Fe"%PROJECT_ROOT%\build\LocaleCompiler.exe" "%PROJECT_ROOT%\tools\LocaleCompiler\main.cpp" >nul
+if %errorlevel% neq 0 (
+    echo 错误：语言文件编译工具构建失败
+    goto :error
+)
+"%PROJECT_ROOT%\build\LocaleCompiler.exe" --verify "%PROJECT_ROOT%\assets\locales"
+if %errorlevel% neq 0 (
+    echo 错误：语言文件预编译失败
+    goto :error
+)
+echo.
+
 REM 构建 x64 平台
 echo [1/3] 构建 x64 平台...
 echo 编译 x64 版本...
@@ -0,0 +1,5 @@
+#!/bin/sh
+# 构建启动扫描基准（pin/auto_pin_rules.h 的规则集匹配）
+set -e
+cd "$(dirname "$0")"
+${CXX:-g++} -std=c++17 -O2 -Wall -Wextra -I../../include -o SweepBench main.cpp
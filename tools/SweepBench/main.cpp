@@ -0,0 +1,222 @@
+// SweepBench：启动扫描（对已经打开的窗口应用自动图钉规则）的匹配基准。
+//
+// 用一份紧凑的窗口快照（标题和类名存放在同一缓冲区中，与 Window::WindowSnapshot 相同）
+// 和编译后的规则集，比较在当前线程逐个匹配与 CompiledRuleSet::matchAll 分段交给工作线程
+// 匹配（自动选择的线程数以及 1、2、4、8 个线程）的耗时，并检查匹配结果相同。
+// 规则分析关闭（默认）和开启时各运行一遍：关闭时不统计评估次数，开启时各线程的规则统计全部合并。
+// 枚举窗口和创建图钉依赖 Windows，不在测量范围内。
+//
+// 用法：
+//   SweepBench [窗口数] [规则数]
+//
+
+#include "pin/auto_pin_rules.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+    int g_failed = 0;
+    int g_checks = 0;
+
+    void check(bool ok, const char* what)
+    {
+        ++g_checks;
+        if (!ok) {
+            std::printf("FAIL: %s\n", what);
+            ++g_failed;
+        }
+    }
+
+    // 与 AutoPinRule 中规则集编译用到的成员相同
+    struct Rule {
+        std::wstring ttl;
+        std::wstring cls;
+        std::wstring proc;
+        Pin::ProcessField procField = Pin::ProcessField::ImageName;
+        bool enabled = true;
+        std::shared_ptr<Pin::RuleStats> stats = std::make_shared<Pin::RuleStats>();
+    };
+
+    // 与 Window::WindowSnapshot 相同的紧凑布局，进程属性已转换为小写
+    class Snapshot {
+    public:
+        void add(const std::wstring& title, const std::wstring& cls, const std::wstring& image)
+        {
+            m_items.push_back({ append(title), append(cls), append(image) });
+        }
+
+        size_t size() const { return m_items.size(); }
+        std::wstring_view title(size_t n) const { return view(m_items[n].title); }
+        std::wstring_view className(size_t n) const { return view(m_items[n].cls); }
+        std::wstring_view imageName(size_t n) const { return view(m_items[n].image); }
+
+        void fill(size_t n, Pin::RuleTarget& target) const
+        {
+            target.title = title(n);
+            target.cls = className(n);
+            target.imageName = imageName(n);
+        }
+
+    private:
+        struct Span { uint32_t offset, length; };
+        struct Item { Span title, cls, image; };
+        std::vector<Item> m_items;
+        std::wstring m_text;
+
+        Span append(const std::wstring& s)
+        {
+            Span span{ static_cast<uint32_t>(m_text.size()), static_cast<uint32_t>(s.size()) };
+            m_text += s;
+            return span;
+        }
+
+        std::wstring_view view(Span span) const
+        {
+            return std::wstring_view(m_text.data() + span.offset, span.length);
+        }
+    };
+
+    const wchar_t* const APPS[][3] = {
+        { L" - 记事本", L"Notepad", L"notepad.exe" },
+        { L" - Google Chrome", L"Chrome_WidgetWin_1", L"chrome.exe" },
+        { L" - Visual Studio Code", L"Chrome_WidgetWin_1", L"code.exe" },
+        { L" - Word", L"OpusApp", L"winword.exe" },
+        { L" - 文件资源管理器", L"CabinetWClass", L"explorer.exe" },
+        { L" - Mozilla Firefox", L"MozillaWindowClass", L"firefox.exe" },
+        { L"", L"ConsoleWindowClass", L"conhost.exe" },
+        { L" - 微信", L"WeChatMainWndForPC", L"wechat.exe" },
+    };
+    const size_t APP_COUNT = sizeof(APPS) / sizeof(APPS[0]);
+
+    Snapshot makeSnapshot(size_t windows)
+    {
+        Snapshot snapshot;
+        for (size_t n = 0; n < windows; ++n) {
+            const auto& app = APPS[n % APP_COUNT];
+            snapshot.add(L"文档 " + std::to_wstring(n) + app[0], app[1], app[2]);
+        }
+        return snapshot;
+    }
+
+    // 常见形式混合：精确、前缀、后缀、包含、带 ? 的一般模式，一部分限制进程。
+    // 规则大多不匹配，多数窗口要评估全部规则，是扫描最慢的情况
+    std::vector<Rule> makeRules(size_t count, size_t windows)
+    {
+        std::vector<Rule> rules(count);
+        for (size_t n = 0; n < count; ++n) {
+            Rule& rule = rules[n];
+            const auto& app = APPS[n % APP_COUNT];
+            // 每隔 20 条规则有一条匹配某个窗口
+            size_t target = n % 20 == 0 ? (n / 20 * 37) % windows : windows + n;
+            std::wstring doc = L"文档 " + std::to_wstring(target);
+            switch (n % 5) {
+                case 0: rule.ttl = doc + L"*"; break;
+                case 1: rule.ttl = L"*" + doc + app[0]; break;
+                case 2: rule.ttl = L"*" + doc + L" *"; rule.cls = app[1]; break;
+                case 3: rule.ttl = doc + app[0]; rule.cls = L"*"; break;
+                default: rule.ttl = L"文档 ?" + std::to_wstring(target) + L"*"; break;
+            }
+            if (rule.cls.empty())
+                rule.cls = L"*";
+            if (n % 3 == 0)
+                rule.proc = app[2];
+            else
+                rule.proc = L"*";
+            rule.enabled = n % 10 != 9;
+        }
+        return rules;
+    }
+
+    uint64_t totalEvaluations(const std::vector<Rule>& rules)
+    {
+        uint64_t total = 0;
+        for (const auto& rule : rules)
+            total += rule.stats->evaluations.load();
+        return total;
+    }
+
+    template<class F>
+    double bestMs(int runs, F&& f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    // profiling 为 true 时启用规则分析（统计评估次数并抽样计时），程序默认不启用
+    void run(size_t windows, size_t ruleCount, bool profiling)
+    {
+        const int RUNS = 20;
+        Snapshot snapshot = makeSnapshot(windows);
+        std::vector<Rule> rules = makeRules(ruleCount, windows);
+        Pin::CompiledRuleSet set;
+        set.setProfiling(profiling);
+        double compileMs = bestMs(1, [&] { set.assign(rules.begin(), rules.end()); });
+
+        // 当前线程逐个匹配（也是工作量较小时 matchAll 的做法）
+        std::vector<size_t> serial(windows);
+        double serialMs = bestMs(RUNS, [&] {
+            for (size_t n = 0; n < windows; ++n) {
+                Pin::RuleTarget target;
+                snapshot.fill(n, target);
+                serial[n] = set.match(target);
+            }
+        });
+        uint64_t serialEvaluations = totalEvaluations(rules);
+        check(profiling ? serialEvaluations > 0 : serialEvaluations == 0, "evaluations counted only when profiling");
+
+        size_t matched = 0;
+        for (size_t m : serial)
+            matched += m != Pin::CompiledRuleSet::npos;
+        std::printf("%zu 个窗口 x %zu 条规则（启用 %zu），规则分析%s：匹配 %zu 个，编译 %.2f ms\n",
+            windows, ruleCount, set.size(), profiling ? "开启" : "关闭", matched, compileMs);
+        std::printf("  单线程逐个匹配  %7.3f ms\n", serialMs);
+
+        // 0 为 sweep 使用的自动选择，其余为指定的线程数
+        for (size_t workers : { size_t(0), size_t(1), size_t(2), size_t(4), size_t(8) }) {
+            std::vector<size_t> parallel;
+            uint64_t before = totalEvaluations(rules);
+            set.matchAll(windows, [&](size_t n, Pin::RuleTarget& target) { snapshot.fill(n, target); },
+                parallel, workers);
+            check(parallel == serial, "matchAll matches the same rules");
+            check(totalEvaluations(rules) - before == serialEvaluations / RUNS, "per-thread statistics are merged");
+
+            double ms = bestMs(RUNS, [&] {
+                set.matchAll(windows, [&](size_t n, Pin::RuleTarget& target) { snapshot.fill(n, target); },
+                    parallel, workers);
+            });
+            if (workers)
+                std::printf("  matchAll %zu 个线程 %7.3f ms\n", workers, ms);
+            else
+                std::printf("  matchAll 自动     %7.3f ms\n", ms);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t windows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    size_t ruleCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    if (windows == 0 || ruleCount == 0) {
+        std::printf("用法: SweepBench [窗口数] [规则数]\n");
+        return 2;
+    }
+
+    for (bool profiling : { false, true }) {
+        run(windows, ruleCount, profiling);
+        // 工作量低于并行阈值时在当前线程匹配
+        run(20, 100, profiling);
+    }
+
+    std::printf("%d/%d checks passed\n", g_checks - g_failed, g_checks);
+    return g_failed ? 1 : 0;
+}